@@ -0,0 +1,148 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file BenchmarkCase.h
+ *   Declaration of the benchmark case interface and measurement context.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Recommended way of creating benchmark cases. Just provide the benchmark case name.
+/// Automatically instantiates the proper benchmark case object and registers it with the harness.
+/// Treat this macro as a function declaration; the benchmark case is the function body, which has
+/// access to a measurement context object named `context`.
+#define BENCHMARK_CASE(name)                                                                       \
+  inline constexpr wchar_t kBenchmarkName__##name[] = L#name;                                      \
+  ::XidiBenchmark::BenchmarkCase<kBenchmarkName__##name> benchmarkCaseInstance__##name;            \
+  void ::XidiBenchmark::BenchmarkCase<kBenchmarkName__##name>::Run(                                \
+      ::XidiBenchmark::BenchmarkContext& context) const
+
+namespace XidiBenchmark
+{
+  /// Holds the result of a single measurement taken within a benchmark case.
+  struct SMeasurement
+  {
+    /// Label that identifies the measurement within its benchmark case.
+    std::wstring label;
+
+    /// Number of operations that were timed.
+    uint64_t numOperations;
+
+    /// Average time per operation, in nanoseconds.
+    double nanosecondsPerOperation;
+
+    /// Average number of heap allocations per operation.
+    double allocationsPerOperation;
+  };
+
+  /// Retrieves the number of heap allocations made by the benchmark program so far. Allocations are
+  /// counted by replacing the global allocation functions for the whole benchmark program.
+  /// @return Number of heap allocations made so far.
+  uint64_t GetAllocationCount(void);
+
+  /// Forces the compiler to treat the specified object as used so that computations that produce it
+  /// are not optimized away. Implemented out-of-line in a separate translation unit.
+  /// @param [in] value Address of the object to be treated as used.
+  void ConsumeValue(const void* value);
+
+  /// Convenience wrapper for forcing the compiler to treat a value as used.
+  /// @tparam ValueType Type of value to consume.
+  /// @param [in] value Value to consume.
+  template <typename ValueType> inline void DoNotOptimize(const ValueType& value)
+  {
+    ConsumeValue(&value);
+  }
+
+  /// Measurement context passed to each benchmark case. Times operations and collects the results.
+  class BenchmarkContext
+  {
+  public:
+
+    /// Fraction of the number of timed operations that are run beforehand to warm up caches and
+    /// branch predictors, expressed as a divisor.
+    static constexpr uint64_t kWarmupDivisor = 10;
+
+    /// Runs an operation repeatedly and records the average time taken and the average number of
+    /// heap allocations made per operation.
+    /// @tparam OperationType Callable type that accepts a single `uint64_t` iteration index.
+    /// @param [in] label Label that identifies this measurement within the benchmark case.
+    /// @param [in] numOperations Number of times to run the operation while timing.
+    /// @param [in] operation Operation to be run.
+    template <typename OperationType> void Measure(
+        std::wstring_view label, uint64_t numOperations, OperationType operation)
+    {
+      for (uint64_t i = 0; i < (numOperations / kWarmupDivisor); ++i)
+        operation(i);
+
+      const uint64_t startAllocationCount = GetAllocationCount();
+      const auto startTime = std::chrono::steady_clock::now();
+      for (uint64_t i = 0; i < numOperations; ++i)
+        operation(i);
+      const auto endTime = std::chrono::steady_clock::now();
+      const uint64_t endAllocationCount = GetAllocationCount();
+
+      const double elapsedNanoseconds =
+          (double)std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+      measurements.push_back(
+          {.label = std::wstring(label),
+           .numOperations = numOperations,
+           .nanosecondsPerOperation =
+               ((0 == numOperations) ? 0.0 : (elapsedNanoseconds / (double)numOperations)),
+           .allocationsPerOperation =
+               ((0 == numOperations)
+                    ? 0.0
+                    : ((double)(endAllocationCount - startAllocationCount) /
+                       (double)numOperations))});
+    }
+
+    /// Retrieves all of the measurements that have been recorded in this context.
+    /// @return Read-only reference to the recorded measurements.
+    inline const std::vector<SMeasurement>& GetMeasurements(void) const
+    {
+      return measurements;
+    }
+
+  private:
+
+    /// All measurements recorded so far, in the order in which they were taken.
+    std::vector<SMeasurement> measurements;
+  };
+
+  /// Benchmark case interface.
+  class IBenchmarkCase
+  {
+  public:
+
+    IBenchmarkCase(std::wstring_view name);
+
+    virtual ~IBenchmarkCase(void) = default;
+
+    /// Runs the benchmark case represented by this object. Implementations are generated when
+    /// benchmark cases are created using the #BENCHMARK_CASE macro.
+    /// @param [in, out] context Measurement context that collects results.
+    virtual void Run(BenchmarkContext& context) const = 0;
+  };
+
+  /// Concrete benchmark case object template. Each benchmark case created by #BENCHMARK_CASE
+  /// instantiates an object of this type with a different template parameter.
+  /// @tparam kName Name of the benchmark case.
+  template <const wchar_t* kName> class BenchmarkCase : public IBenchmarkCase
+  {
+  public:
+
+    inline BenchmarkCase(void) : IBenchmarkCase(kName) {}
+
+    // IBenchmarkCase
+    void Run(BenchmarkContext& context) const override;
+  };
+} // namespace XidiBenchmark
@@ -0,0 +1,74 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file BenchmarkHarness.h
+ *   Declaration of the benchmark harness.
+ **************************************************************************************************/
+
+#pragma once
+
+#include "BenchmarkCase.h"
+
+#include <map>
+#include <string_view>
+
+namespace XidiBenchmark
+{
+  /// Registers and runs all benchmarks. Reports results in a machine-readable comma-separated
+  /// format, one line per measurement. Implemented as a singleton object. Benchmark cases are run
+  /// in alphabetical order by name, irrespective of the order in which they are registered.
+  class BenchmarkHarness
+  {
+  public:
+
+    /// Registers a benchmark case to be run by the harness.
+    /// Typically, registration happens automatically using the #BENCHMARK_CASE macro, which is the
+    /// recommended way of creating benchmark cases.
+    /// @param [in] benchmarkCase Benchmark case object to register.
+    /// @param [in] name Name of the benchmark case.
+    static inline void RegisterBenchmarkCase(
+        const IBenchmarkCase* const benchmarkCase, std::wstring_view name)
+    {
+      GetInstance().RegisterBenchmarkCaseInternal(benchmarkCase, name);
+    }
+
+    /// Runs all benchmarks registered by the harness whose names begin with the specified prefix.
+    /// Typically invoked only once by the entry point to the benchmark program.
+    /// @param [in] prefixToMatch Prefix against which to compare benchmark case names.
+    /// @return Number of benchmark cases that were run.
+    static inline int RunBenchmarksWithMatchingPrefix(std::wstring_view prefixToMatch)
+    {
+      return GetInstance().RunBenchmarksWithMatchingPrefixInternal(prefixToMatch);
+    }
+
+  private:
+
+    BenchmarkHarness(void) = default;
+
+    BenchmarkHarness(const BenchmarkHarness&) = delete;
+
+    /// Returns a reference to the singleton instance of this class.
+    /// Not intended to be invoked externally.
+    /// @return Reference to the singleton instance.
+    static BenchmarkHarness& GetInstance(void);
+
+    /// Internal implementation of benchmark case registration.
+    /// @param [in] benchmarkCase Benchmark case object to register.
+    /// @param [in] name Name of the benchmark case.
+    void RegisterBenchmarkCaseInternal(
+        const IBenchmarkCase* const benchmarkCase, std::wstring_view name);
+
+    /// Internal implementation of running all benchmarks whose names begin with the specified
+    /// prefix.
+    /// @param [in] prefixToMatch Prefix against which to compare benchmark case names.
+    /// @return Number of benchmark cases that were run.
+    int RunBenchmarksWithMatchingPrefixInternal(std::wstring_view prefixToMatch);
+
+    /// Holds all registered benchmark cases in alphabetical order.
+    std::map<std::wstring_view, const IBenchmarkCase*> benchmarkCases;
+  };
+} // namespace XidiBenchmark
@@ -23,5 +23,6 @@
 
 // clang-format on
 
+#include <cfgmgr32.h>
 #include <psapi.h>
 #include <shlobj.h>
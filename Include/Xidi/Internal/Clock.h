@@ -0,0 +1,54 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file Clock.h
+ *   Declaration of the monotonic high-resolution clock used for all internal timekeeping.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+namespace Xidi
+{
+  namespace Clock
+  {
+    /// Type used for timestamps, which are tick counts of a monotonic high-resolution clock that
+    /// is unaffected by changes to the system time or by the system timer resolution. The clock
+    /// starts at an arbitrary point, so only differences between timestamps are meaningful.
+    using TTimestamp = uint64_t;
+
+    /// Retrieves the frequency of the clock, which is fixed at system boot.
+    /// @return Clock frequency, in ticks per second.
+    uint64_t GetFrequency(void);
+
+    /// Retrieves the current time.
+    /// @return Current clock tick count.
+    TTimestamp Now(void);
+
+    /// Converts a number of milliseconds to the equivalent number of clock ticks, rounding up so
+    /// that converting the result back to milliseconds produces the original value.
+    /// @param [in] milliseconds Number of milliseconds to convert.
+    /// @return Equivalent number of clock ticks.
+    TTimestamp TicksFromMilliseconds(uint64_t milliseconds);
+
+    /// Converts a number of clock ticks to milliseconds, rounding down.
+    /// @param [in] ticks Number of clock ticks to convert.
+    /// @return Equivalent number of milliseconds.
+    uint64_t TicksToMilliseconds(TTimestamp ticks);
+
+    /// Converts a number of clock ticks to microseconds, rounding down.
+    /// @param [in] ticks Number of clock ticks to convert.
+    /// @return Equivalent number of microseconds.
+    uint64_t TicksToMicroseconds(TTimestamp ticks);
+
+    /// Converts a number of clock ticks to nanoseconds, rounding down.
+    /// @param [in] ticks Number of clock ticks to convert.
+    /// @return Equivalent number of nanoseconds.
+    uint64_t TicksToNanoseconds(TTimestamp ticks);
+  } // namespace Clock
+} // namespace Xidi
@@ -12,7 +12,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
 
 #include "ControllerTypes.h"
 
@@ -50,6 +56,265 @@ namespace Xidi
       uint8_t ApplyRawTriggerTransform(
           uint8_t triggerValue, unsigned int deadzonePercent, unsigned int saturationPercent);
 
+      /// Holds the result of #ApplyRawAnalogTransform for every possible analog value, given one
+      /// particular deadzone and saturation, so that applying the transformation is a single
+      /// indexed load. Objects are built on first request and shared by all users of the same
+      /// transformation parameters, and are destroyed once the last of those users releases them.
+      class RawAnalogTransformTable
+      {
+      public:
+
+        /// Retrieves the table for the specified transformation parameters, building it if no
+        /// table for those parameters is currently in use. Concurrency-safe.
+        /// @param [in] deadzonePercent Deadzone percentage, as accepted by
+        /// #ApplyRawAnalogTransform.
+        /// @param [in] saturationPercent Saturation percentage, as accepted by
+        /// #ApplyRawAnalogTransform.
+        /// @return Shared read-only pointer to the table.
+        static std::shared_ptr<const RawAnalogTransformTable> Get(
+            unsigned int deadzonePercent, unsigned int saturationPercent);
+
+        /// Applies the transformation represented by this table to a raw analog value.
+        /// @param [in] analogValue Analog value to transform.
+        /// @return Transformed analog value.
+        inline int16_t Apply(int16_t analogValue) const
+        {
+          return transformedValues[(uint16_t)analogValue];
+        }
+
+      private:
+
+        /// Fills the table by applying the transformation to every possible analog value.
+        /// Objects are only created by #Get.
+        /// @param [in] deadzonePercent Deadzone percentage.
+        /// @param [in] saturationPercent Saturation percentage.
+        RawAnalogTransformTable(unsigned int deadzonePercent, unsigned int saturationPercent);
+
+        /// Transformed analog values, indexed by the bit pattern of the raw analog value
+        /// reinterpreted as unsigned.
+        std::array<int16_t, 1 + std::numeric_limits<uint16_t>::max()> transformedValues;
+      };
+
+      /// Holds the result of #ApplyRawTriggerTransform for every possible trigger value, given one
+      /// particular deadzone and saturation, so that applying the transformation is a single
+      /// indexed load. Objects are built on first request and shared by all users of the same
+      /// transformation parameters, and are destroyed once the last of those users releases them.
+      class RawTriggerTransformTable
+      {
+      public:
+
+        /// Retrieves the table for the specified transformation parameters, building it if no
+        /// table for those parameters is currently in use. Concurrency-safe.
+        /// @param [in] deadzonePercent Deadzone percentage, as accepted by
+        /// #ApplyRawTriggerTransform.
+        /// @param [in] saturationPercent Saturation percentage, as accepted by
+        /// #ApplyRawTriggerTransform.
+        /// @return Shared read-only pointer to the table.
+        static std::shared_ptr<const RawTriggerTransformTable> Get(
+            unsigned int deadzonePercent, unsigned int saturationPercent);
+
+        /// Applies the transformation represented by this table to a raw trigger value.
+        /// @param [in] triggerValue Trigger value to transform.
+        /// @return Transformed trigger value.
+        inline uint8_t Apply(uint8_t triggerValue) const
+        {
+          return transformedValues[triggerValue];
+        }
+
+      private:
+
+        /// Fills the table by applying the transformation to every possible trigger value.
+        /// Objects are only created by #Get.
+        /// @param [in] deadzonePercent Deadzone percentage.
+        /// @param [in] saturationPercent Saturation percentage.
+        RawTriggerTransformTable(unsigned int deadzonePercent, unsigned int saturationPercent);
+
+        /// Transformed trigger values, indexed by raw trigger value.
+        std::array<uint8_t, 1 + std::numeric_limits<uint8_t>::max()> transformedValues;
+      };
+
+      /// Computes the integer square root of a value, rounded down. Uses only integer operations,
+      /// one iteration per pair of significant bits in the input, so it is both exact and fast
+      /// enough for use on the hot path.
+      /// @param [in] value Value whose square root is desired.
+      /// @return Largest integer whose square does not exceed the value.
+      constexpr uint32_t IntegerSquareRoot(uint64_t value)
+      {
+        if (0 == value) return 0;
+
+        uint64_t result = 0;
+        uint64_t bit = (uint64_t)1 << ((63 - std::countl_zero(value)) & ~1);
+
+        while (0 != bit)
+        {
+          if (value >= (result + bit))
+          {
+            value -= (result + bit);
+            result = (result >> 1) + bit;
+          }
+          else
+          {
+            result >>= 1;
+          }
+
+          bit >>= 2;
+        }
+
+        return (uint32_t)result;
+      }
+
+      /// Applies deadzone, saturation, and optional anti-deadzone and circle-to-square
+      /// transformations to both axes of an analog stick together, treating them as a single
+      /// two-dimensional vector. Unlike #ApplyRawAnalogTransform, which operates on each axis
+      /// independently and therefore produces a square deadzone that snaps readings onto the axes,
+      /// the deadzone and saturation here are circular and only the magnitude of the vector is
+      /// rescaled, so its direction is preserved. Cutoffs and scaling factors are precomputed at
+      /// construction time, and application uses only integer arithmetic. Magnitudes are computed
+      /// in fixed-point with fractional bits so that readings close to neutral keep their
+      /// direction accurately even when an anti-deadzone greatly magnifies them.
+      class RadialStickTransform
+      {
+      public:
+
+        /// Default constructor. Creates a transformation that leaves all analog values unchanged.
+        constexpr RadialStickTransform(void) : RadialStickTransform(0, 100, 0, false) {}
+
+        /// Initialization constructor. Precomputes cutoffs and scaling factors from percentages of
+        /// the analog range, measured from neutral.
+        /// @param [in] deadzonePercent Percentage within which the stick is reported as neutral.
+        /// @param [in] saturationPercent Percentage beyond which the stick is reported as extreme.
+        /// @param [in] antiDeadzonePercent Percentage reported as soon as the stick leaves its
+        /// deadzone, which can compensate for a deadzone that an application applies internally.
+        /// @param [in] circleToSquare Whether or not to stretch the circular range of the stick
+        /// so that diagonal readings at full magnitude reach the corners of the square range.
+        constexpr RadialStickTransform(
+            unsigned int deadzonePercent,
+            unsigned int saturationPercent,
+            unsigned int antiDeadzonePercent,
+            bool circleToSquare)
+            : deadzoneCutoffSquared(
+                  (uint32_t)(MagnitudeForPercent(deadzonePercent) *
+                             MagnitudeForPercent(deadzonePercent))),
+              deadzoneCutoff(FixedPointMagnitudeForPercent(deadzonePercent)),
+              saturationCutoff(FixedPointMagnitudeForPercent(saturationPercent)),
+              antiDeadzoneMagnitude(FixedPointMagnitudeForPercent(antiDeadzonePercent)),
+              magnitudeScale(
+                  (saturationCutoff > deadzoneCutoff)
+                      ? ((FixedPointMagnitudeForPercent(100) - antiDeadzoneMagnitude)
+                         << kScaleFractionBits) /
+                          (saturationCutoff - deadzoneCutoff)
+                      : 0),
+              circleToSquare(circleToSquare)
+        {}
+
+        /// Applies the transformation to both axes of an analog stick in place. Inputs must
+        /// already have been filtered to the virtual controller's analog range.
+        /// @param [in, out] analogValueX Horizontal axis value to transform.
+        /// @param [in, out] analogValueY Vertical axis value to transform.
+        inline void Apply(int16_t& analogValueX, int16_t& analogValueY) const
+        {
+          const int32_t displacementX = std::abs((int32_t)analogValueX - kAnalogValueNeutral);
+          const int32_t displacementY = std::abs((int32_t)analogValueY - kAnalogValueNeutral);
+
+          const uint32_t magnitudeSquared = (uint32_t)(displacementX * displacementX) +
+              (uint32_t)(displacementY * displacementY);
+          if (magnitudeSquared <= deadzoneCutoffSquared)
+          {
+            analogValueX = kAnalogValueNeutral;
+            analogValueY = kAnalogValueNeutral;
+            return;
+          }
+
+          const int64_t magnitude = (int64_t)IntegerSquareRoot(
+              (uint64_t)magnitudeSquared << (2 * kMagnitudeFractionBits));
+          const int64_t transformedMagnitude =
+              ((magnitude >= saturationCutoff)
+                   ? FixedPointMagnitudeForPercent(100)
+                   : antiDeadzoneMagnitude +
+                       (((magnitude - deadzoneCutoff) * magnitudeScale) >> kScaleFractionBits));
+
+          // For circle-to-square mapping the transformed magnitude is applied to the larger of the
+          // two displacements rather than to the length of the vector, which pushes diagonals out
+          // towards the corners while leaving readings along the axes unchanged.
+          const int64_t referenceMagnitude =
+              ((true == circleToSquare)
+                   ? ((int64_t)std::max(displacementX, displacementY) << kMagnitudeFractionBits)
+                   : magnitude);
+          const int64_t scaleFactor =
+              (transformedMagnitude << kScaleFractionBits) / referenceMagnitude;
+
+          analogValueX = ScaleDisplacement(analogValueX, displacementX, scaleFactor);
+          analogValueY = ScaleDisplacement(analogValueY, displacementY, scaleFactor);
+        }
+
+      private:
+
+        /// Number of fractional bits in fixed-point magnitudes.
+        static constexpr unsigned int kMagnitudeFractionBits = 8;
+
+        /// Number of fractional bits in fixed-point scaling factors.
+        static constexpr unsigned int kScaleFractionBits = 16;
+
+        /// Largest possible magnitude of an analog stick displacement from neutral along one axis.
+        static constexpr int32_t kMagnitudeMax = kAnalogValueMax - kAnalogValueNeutral;
+
+        /// Converts a percentage of the analog range into a magnitude, using the same rounding as
+        /// #ApplyRawAnalogTransform.
+        /// @param [in] percent Percentage of the analog range, measured from neutral.
+        /// @return Corresponding magnitude.
+        static constexpr int32_t MagnitudeForPercent(unsigned int percent)
+        {
+          return (kMagnitudeMax * (int32_t)percent) / 100;
+        }
+
+        /// Converts a percentage of the analog range into a fixed-point magnitude.
+        /// @param [in] percent Percentage of the analog range, measured from neutral.
+        /// @return Corresponding fixed-point magnitude.
+        static constexpr int64_t FixedPointMagnitudeForPercent(unsigned int percent)
+        {
+          return (int64_t)MagnitudeForPercent(percent) << kMagnitudeFractionBits;
+        }
+
+        /// Scales the displacement of a single axis value by a fixed-point factor, preserving its
+        /// direction and saturating the result at the extremes of the analog range.
+        /// @param [in] analogValue Original axis value, which supplies the direction.
+        /// @param [in] displacement Absolute displacement of the original axis value from neutral.
+        /// @param [in] scaleFactor Fixed-point scaling factor.
+        /// @return Transformed axis value.
+        static inline int16_t ScaleDisplacement(
+            int16_t analogValue, int32_t displacement, int64_t scaleFactor)
+        {
+          const int32_t scaledDisplacement = (int32_t)std::min(
+              (((int64_t)displacement * scaleFactor) + ((int64_t)1 << (kScaleFractionBits - 1))) >>
+                  kScaleFractionBits,
+              (int64_t)kMagnitudeMax);
+
+          return (int16_t)(
+              (analogValue >= kAnalogValueNeutral) ? (kAnalogValueNeutral + scaledDisplacement)
+                                                   : (kAnalogValueNeutral - scaledDisplacement));
+        }
+
+        /// Square of the integer magnitude at or below which the stick is reported as neutral,
+        /// which allows the deadzone check to skip the square root.
+        uint32_t deadzoneCutoffSquared;
+
+        /// Fixed-point magnitude at or below which the stick is reported as neutral.
+        int64_t deadzoneCutoff;
+
+        /// Fixed-point magnitude at or beyond which the stick is reported as extreme.
+        int64_t saturationCutoff;
+
+        /// Fixed-point magnitude reported as soon as the stick leaves its deadzone.
+        int64_t antiDeadzoneMagnitude;
+
+        /// Fixed-point factor that maps magnitudes between the deadzone and saturation cutoffs onto
+        /// the range between the anti-deadzone magnitude and the maximum magnitude.
+        int64_t magnitudeScale;
+
+        /// Whether or not circular readings are stretched to cover the square range.
+        bool circleToSquare;
+      };
+
       /// Determines if an analog reading is considered "pressed" as a digital button in the
       /// negative direction.
       /// @param [in] analogValue Analog reading from the XInput controller.
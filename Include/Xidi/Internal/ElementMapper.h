@@ -19,9 +19,12 @@
 #include <optional>
 #include <vector>
 
+#include "ControllerMath.h"
 #include "ControllerTypes.h"
+#include "ElementMapperArena.h"
 #include "Keyboard.h"
 #include "Mouse.h"
+#include "ResponseCurve.h"
 
 namespace Xidi
 {
@@ -36,6 +39,23 @@ namespace Xidi
 
       virtual ~IElementMapper(void) = default;
 
+      /// Allocates memory for an element mapper object, either from the heap or from the element
+      /// mapper arena in use on the current thread.
+      /// @param [in] size Size of the object, in bytes.
+      /// @return Pointer to the allocated memory.
+      static inline void* operator new(size_t size)
+      {
+        return ElementMapperArena::AllocateElementMapper(size);
+      }
+
+      /// Releases memory for an element mapper object. Memory that came from an element mapper
+      /// arena is not actually freed until the arena is destroyed.
+      /// @param [in] ptr Pointer to the memory being released.
+      static inline void operator delete(void* ptr)
+      {
+        ElementMapperArena::ReleaseElementMapper(ptr);
+      }
+
       /// Allocates, constructs, and returns a pointer to a copy of this element mapper.
       /// @return Smart pointer to a copy of this element mapper.
       virtual std::unique_ptr<IElementMapper> Clone(void) const = 0;
@@ -100,15 +120,90 @@ namespace Xidi
     /// triggers because they can share an axis, but it is implemented by range mapping for analog
     /// stick axes as well. For buttons, the value is either negative extreme if the button is not
     /// pressed or positive extreme if the value is pressed. Use a half-axis configuration to map to
-    /// either neutral (not pressed) or extreme value (pressed).
+    /// either neutral (not pressed) or extreme value (pressed). An optional response curve
+    /// reshapes analog stick and trigger values before they are contributed. Button values are
+    /// unaffected because curves always map extremes to extremes and neutral to neutral.
     class AxisMapper : public IElementMapper
     {
     public:
 
-      inline constexpr AxisMapper(EAxis axis, EAxisDirection direction = EAxisDirection::Both)
-          : IElementMapper(), axis(axis), direction(direction)
+      inline constexpr AxisMapper(
+          EAxis axis,
+          EAxisDirection direction = EAxisDirection::Both,
+          const ResponseCurve* responseCurve = nullptr)
+          : IElementMapper(), axis(axis), direction(direction), responseCurve(responseCurve)
       {}
 
+      /// Computes the value that an axis mapper contributes to its axis from an analog reading.
+      /// Shared between element mapper objects and their compiled form.
+      /// @param [in] direction Axis direction to which the contribution is targeted.
+      /// @param [in] analogValue Analog reading from the XInput controller.
+      /// @return Value to add to the target axis.
+      static constexpr int32_t AxisValueFromAnalogValue(
+          EAxisDirection direction, int16_t analogValue)
+      {
+        switch (direction)
+        {
+          case EAxisDirection::Positive:
+            return ((int32_t)analogValue - kAnalogValueMin) >> 1;
+
+          case EAxisDirection::Negative:
+            return ((int32_t)analogValue - kAnalogValueMax) >> 1;
+
+          default:
+            return (int32_t)analogValue;
+        }
+      }
+
+      /// Computes the value that an axis mapper contributes to its axis from a button reading.
+      /// Shared between element mapper objects and their compiled form.
+      /// @param [in] direction Axis direction to which the contribution is targeted.
+      /// @param [in] buttonPressed Button state from the XInput controller.
+      /// @return Value to add to the target axis.
+      static constexpr int32_t AxisValueFromButtonValue(
+          EAxisDirection direction, bool buttonPressed)
+      {
+        switch (direction)
+        {
+          case EAxisDirection::Positive:
+            return (buttonPressed ? kAnalogValueMax : kAnalogValueNeutral);
+
+          case EAxisDirection::Negative:
+            return (buttonPressed ? kAnalogValueMin : kAnalogValueNeutral);
+
+          default:
+            return (buttonPressed ? kAnalogValueMax : kAnalogValueMin);
+        }
+      }
+
+      /// Computes the value that an axis mapper contributes to its axis from a trigger reading.
+      /// Shared between element mapper objects and their compiled form.
+      /// @param [in] direction Axis direction to which the contribution is targeted.
+      /// @param [in] triggerValue Trigger reading from the XInput controller.
+      /// @return Value to add to the target axis.
+      static constexpr int32_t AxisValueFromTriggerValue(
+          EAxisDirection direction, uint8_t triggerValue)
+      {
+        constexpr double kBidirectionalStepSize = (double)(kAnalogValueMax - kAnalogValueMin) /
+            (double)(kTriggerValueMax - kTriggerValueMin);
+        constexpr double kPositiveStepSize =
+            (double)kAnalogValueMax / (double)(kTriggerValueMax - kTriggerValueMin);
+        constexpr double kNegativeStepSize =
+            (double)kAnalogValueMin / (double)(kTriggerValueMax - kTriggerValueMin);
+
+        switch (direction)
+        {
+          case EAxisDirection::Positive:
+            return (int32_t)((double)triggerValue * kPositiveStepSize) + kAnalogValueNeutral;
+
+          case EAxisDirection::Negative:
+            return (int32_t)((double)triggerValue * kNegativeStepSize) - kAnalogValueNeutral;
+
+          default:
+            return (int32_t)((double)triggerValue * kBidirectionalStepSize) + kAnalogValueMin;
+        }
+      }
+
       /// Retrieves and returns the axis to which this mapper should contribute.
       /// @return Target axis.
       inline EAxis GetAxis(void) const
@@ -124,6 +219,14 @@ namespace Xidi
         return direction;
       }
 
+      /// Retrieves and returns the response curve that this mapper applies to analog stick and
+      /// trigger values.
+      /// @return Pointer to the response curve, or `nullptr` if values are contributed linearly.
+      inline const ResponseCurve* GetResponseCurve(void) const
+      {
+        return responseCurve;
+      }
+
       // IElementMapper
       std::unique_ptr<IElementMapper> Clone(void) const override;
       void ContributeFromAnalogValue(
@@ -151,6 +254,10 @@ namespace Xidi
       /// axis. If set to anything other than both directions, the contribution is to half of
       /// the axis only.
       const EAxisDirection direction;
+
+      /// Response curve applied to analog stick and trigger values before they are contributed,
+      /// or `nullptr` to contribute them linearly. Not owned by this object.
+      const ResponseCurve* const responseCurve;
     };
 
     /// Maps a single XInput controller element such that it contributes to a button reading on a
@@ -276,6 +383,29 @@ namespace Xidi
           : AxisMapper(axis, direction)
       {}
 
+      /// Computes the value that a digital axis mapper contributes to its axis from an analog
+      /// reading. Shared between element mapper objects and their compiled form.
+      /// @param [in] direction Axis direction to which the contribution is targeted.
+      /// @param [in] analogValue Analog reading from the XInput controller.
+      /// @return Value to add to the target axis.
+      static constexpr int32_t DigitalAxisValueFromAnalogValue(
+          EAxisDirection direction, int16_t analogValue)
+      {
+        switch (direction)
+        {
+          case EAxisDirection::Positive:
+            return (Math::IsAnalogPressedPositive(analogValue) ? kAnalogValueMax : 0);
+
+          case EAxisDirection::Negative:
+            return (Math::IsAnalogPressedNegative(analogValue) ? kAnalogValueMin : 0);
+
+          default:
+            if (Math::IsAnalogPressedNegative(analogValue)) return kAnalogValueMin;
+            if (Math::IsAnalogPressedPositive(analogValue)) return kAnalogValueMax;
+            return 0;
+        }
+      }
+
       // AxisMapper
       std::unique_ptr<IElementMapper> Clone(void) const override;
       void ContributeFromAnalogValue(
@@ -0,0 +1,139 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ElementMapperArena.h
+ *   Declaration of arena allocation for element mapper objects, which allows all of the element
+ *   mappers owned by a mapper to be laid out contiguously in memory.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Holds element mapper objects contiguously, in the order in which they are allocated, using a
+    /// small number of large memory blocks instead of one heap allocation per object. Element
+    /// mappers are allocated from an arena, rather than from the heap, whenever they are created
+    /// on a thread that is using the arena by means of a #ScopedUse object. Because a tree of
+    /// element mappers is cloned by allocating each parent before its children, cloning a tree into
+    /// an arena lays it out in traversal order. Objects allocated from an arena are still owned and
+    /// destroyed by smart pointers in the usual way, but destroying them does not free any memory.
+    /// All memory is freed at once when the arena itself is destroyed, which must therefore not
+    /// happen until every object allocated from it has been destroyed. Not concurrency-safe: each
+    /// arena should only be used by one thread at a time.
+    class ElementMapperArena
+    {
+    public:
+
+      /// Default size of each memory block, in bytes. Large enough to hold the complete set of
+      /// element mappers for any typical mapper.
+      static constexpr size_t kDefaultBlockSize = 4096;
+
+      /// Causes all element mappers created on the current thread to be allocated from a
+      /// particular arena for as long as an object of this type exists. Objects of this type can
+      /// be nested, in which case the innermost one takes precedence.
+      class ScopedUse
+      {
+      public:
+
+        /// Initialization constructor. Begins using the specified arena on the current thread.
+        /// @param [in] arena Arena from which to allocate element mappers.
+        explicit ScopedUse(ElementMapperArena& arena);
+
+        ScopedUse(const ScopedUse& other) = delete;
+
+        ~ScopedUse(void);
+
+      private:
+
+        /// Arena that was in use on the current thread before this object was created.
+        ElementMapperArena* const previousArena;
+      };
+
+      ElementMapperArena(void) = default;
+
+      ElementMapperArena(const ElementMapperArena& other) = delete;
+
+      /// Allocates memory for a single element mapper object. Memory comes from the arena in use
+      /// on the current thread, if there is one, and from the heap otherwise. Intended to be used
+      /// to implement memory allocation for element mappers.
+      /// @param [in] size Size of the object, in bytes.
+      /// @return Pointer to the allocated memory. Never `nullptr`.
+      static void* AllocateElementMapper(size_t size);
+
+      /// Releases memory for a single element mapper object that was allocated using
+      /// #AllocateElementMapper. Memory that came from the heap is freed immediately, whereas
+      /// memory that came from an arena is not freed until the arena is destroyed. Intended to be
+      /// used to implement memory deallocation for element mappers.
+      /// @param [in] ptr Pointer to the memory being released. May be `nullptr`.
+      static void ReleaseElementMapper(void* ptr);
+
+      /// Determines if the specified object was allocated from this arena.
+      /// @param [in] ptr Address of the object to check.
+      /// @return `true` if so, `false` otherwise.
+      bool Contains(const void* ptr) const;
+
+      /// Retrieves the number of objects that have been allocated from this arena. Without this
+      /// arena, each of them would have been a separate heap allocation.
+      /// @return Number of objects allocated from this arena.
+      inline unsigned int GetAllocationCount(void) const
+      {
+        return allocationCount;
+      }
+
+      /// Retrieves the number of memory blocks that this arena has allocated from the heap.
+      /// @return Number of memory blocks.
+      inline unsigned int GetBlockCount(void) const
+      {
+        return (unsigned int)blocks.size();
+      }
+
+      /// Retrieves the number of bytes that have been allocated from this arena, including
+      /// per-object bookkeeping.
+      /// @return Number of bytes in use.
+      inline size_t GetBytesUsed(void) const
+      {
+        return bytesUsed;
+      }
+
+    private:
+
+      /// Holds one contiguous memory block.
+      struct SBlock
+      {
+        /// Memory owned by this block.
+        std::unique_ptr<uint8_t[]> memory;
+
+        /// Size of the memory owned by this block, in bytes.
+        size_t size;
+
+        /// Number of bytes at the start of the block that have been allocated.
+        size_t used;
+      };
+
+      /// Allocates the specified number of bytes from this arena.
+      /// @param [in] size Number of bytes to allocate, already rounded up for alignment.
+      /// @return Pointer to the allocated memory.
+      void* Allocate(size_t size);
+
+      /// All memory blocks owned by this arena. Only the last block is used for new allocations.
+      std::vector<SBlock> blocks;
+
+      /// Number of objects allocated from this arena.
+      unsigned int allocationCount = 0;
+
+      /// Number of bytes allocated from this arena.
+      size_t bytesUsed = 0;
+    };
+  } // namespace Controller
+} // namespace Xidi
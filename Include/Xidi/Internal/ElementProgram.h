@@ -0,0 +1,178 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ElementProgram.h
+ *   Declaration of the compiled form of element mappers, which is a flat array of operations that
+ *   can be evaluated without walking a tree of element mapper objects.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ControllerTypes.h"
+#include "ElementMapper.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Compiled form of the element mappers for a sequence of XInput controller elements. Each
+    /// element mapper tree is lowered into a contiguous run of tagged operations, all of which are
+    /// stored together in a single array and evaluated by a single loop without any virtual
+    /// function calls. Compound mappers disappear entirely, inversion is folded into the operations
+    /// that read the inverted value, and split mappers become conditional forward jumps. Element
+    /// mappers whose contributions are side effects outside the virtual controller state, such as
+    /// keyboard and mouse mappers, remain objects and are invoked through their interface. Compiled
+    /// operations refer to, but do not own, the element mapper objects from which they were
+    /// compiled, so those objects must outlive this object.
+    class ElementProgram
+    {
+    public:
+
+      /// Enumerates the kinds of operations that can appear in a compiled element program.
+      enum class EOpcode : uint8_t
+      {
+        /// Contributes to an axis in the same way as #AxisMapper without a response curve.
+        AxisWrite,
+
+        /// Contributes to an axis in the same way as #AxisMapper with a response curve. The
+        /// element mapper pointer identifies the axis mapper, whose response curve is applied
+        /// through a direct table lookup rather than a virtual function call.
+        CurvedAxisWrite,
+
+        /// Contributes to an axis in the same way as #DigitalAxisMapper.
+        DigitalAxisWrite,
+
+        /// Contributes to a button in the same way as #ButtonMapper.
+        ButtonWrite,
+
+        /// Contributes to a POV direction in the same way as #PovMapper.
+        PovWrite,
+
+        /// Continues with the next operation if the input value selects the positive branch of a
+        /// split mapper, otherwise jumps forward to the negative branch.
+        Split,
+
+        /// Jumps forward unconditionally, used to skip the negative branch of a split mapper.
+        Jump,
+
+        /// Invokes an element mapper object through its interface. Used for keyboard and mouse
+        /// mappers, whose contributions are side effects, and for any element mapper type that the
+        /// compiler does not recognize.
+        SideEffect
+      };
+
+      /// Single compiled operation.
+      struct SOperation
+      {
+        /// Kind of operation.
+        EOpcode opcode;
+
+        /// Bitwise combination of flags, defined by the implementation, that determine how the
+        /// operation obtains its input value.
+        uint8_t flags;
+
+        /// Target axis, button, or POV direction, interpreted according to the opcode.
+        uint8_t target;
+
+        /// Target axis direction, for operations that write to axes.
+        EAxisDirection direction;
+
+        /// Number of operations by which to jump forward, for split and jump operations.
+        uint16_t jumpDistance;
+
+        /// Element mapper object to invoke, for side effect operations, or from which to obtain the
+        /// response curve, for curved axis write operations.
+        const IElementMapper* elementMapper;
+      };
+
+      static_assert(sizeof(SOperation) <= 16, "Data structure size constraint violation.");
+
+      /// Compiles an element mapper tree and appends the result as the next element in the
+      /// program. Elements are identified by the order in which they are appended.
+      /// @param [in] elementMapper Root of the element mapper tree to compile, or `nullptr` if the
+      /// element is not used.
+      void AppendElement(const IElementMapper* elementMapper);
+
+      /// Evaluates the compiled form of the specified element for an analog reading. Equivalent to
+      /// calling the same method on the element mapper tree from which it was compiled.
+      /// @param [in] elementIndex Index of the element to evaluate.
+      /// @param [in,out] controllerState Controller state data structure to be updated.
+      /// @param [in] analogValue Analog reading from the XInput controller.
+      /// @param [in] sourceIdentifier Opaque identifier for the specific controller element that is
+      /// triggering the contribution.
+      void ContributeFromAnalogValue(
+          unsigned int elementIndex,
+          SState& controllerState,
+          int16_t analogValue,
+          uint32_t sourceIdentifier) const;
+
+      /// Evaluates the compiled form of the specified element for a button reading. Equivalent to
+      /// calling the same method on the element mapper tree from which it was compiled.
+      /// @param [in] elementIndex Index of the element to evaluate.
+      /// @param [in,out] controllerState Controller state data structure to be updated.
+      /// @param [in] buttonPressed Button state from the XInput controller.
+      /// @param [in] sourceIdentifier Opaque identifier for the specific controller element that is
+      /// triggering the contribution.
+      void ContributeFromButtonValue(
+          unsigned int elementIndex,
+          SState& controllerState,
+          bool buttonPressed,
+          uint32_t sourceIdentifier) const;
+
+      /// Evaluates the compiled form of the specified element for a trigger reading. Equivalent to
+      /// calling the same method on the element mapper tree from which it was compiled.
+      /// @param [in] elementIndex Index of the element to evaluate.
+      /// @param [in,out] controllerState Controller state data structure to be updated.
+      /// @param [in] triggerValue Trigger reading from the XInput controller.
+      /// @param [in] sourceIdentifier Opaque identifier for the specific controller element that is
+      /// triggering the contribution.
+      void ContributeFromTriggerValue(
+          unsigned int elementIndex,
+          SState& controllerState,
+          uint8_t triggerValue,
+          uint32_t sourceIdentifier) const;
+
+      /// Retrieves the number of elements that have been appended to this program.
+      /// @return Number of elements.
+      inline unsigned int GetElementCount(void) const
+      {
+        return (unsigned int)elementBoundaries.size() - 1;
+      }
+
+      /// Retrieves the number of compiled operations for the specified element.
+      /// Primarily useful for tests.
+      /// @param [in] elementIndex Index of the element of interest.
+      /// @return Number of operations.
+      inline size_t GetOperationCount(unsigned int elementIndex) const
+      {
+        return elementBoundaries[elementIndex + 1] - elementBoundaries[elementIndex];
+      }
+
+      /// Retrieves the amount of memory used by this program, including this object itself.
+      /// @return Memory footprint, in bytes.
+      inline size_t GetMemoryFootprint(void) const
+      {
+        return sizeof(*this) + (operations.capacity() * sizeof(SOperation)) +
+            (elementBoundaries.capacity() * sizeof(uint32_t));
+      }
+
+    private:
+
+      /// All compiled operations for all elements, in element order.
+      std::vector<SOperation> operations;
+
+      /// Position within the operation array at which each element begins, followed by the total
+      /// number of operations. Element `i` consists of the operations in the range from
+      /// `elementBoundaries[i]` up to but not including `elementBoundaries[i + 1]`.
+      std::vector<uint32_t> elementBoundaries = {0};
+    };
+  } // namespace Controller
+} // namespace Xidi
@@ -212,8 +212,8 @@ namespace Xidi
         /// If so, no effects produce any output and time stops.
         bool stateEffectsArePaused;
 
-        /// Base timestamp, used to establish a way of transforming system uptime to
-        /// relative time elapsed since object creation.
+        /// Base timestamp, used to establish a way of transforming the current time, as read from
+        /// the high-resolution clock, to relative time elapsed since object creation.
         TEffectTimeMs timestampBase;
 
         /// Caches the relative timestamp of the last playback operation.
@@ -0,0 +1,146 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file LatencyTrace.h
+ *   Declaration of optional end-to-end input latency tracing, from physical controller read to
+ *   application read.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "Clock.h"
+#include "ControllerTypes.h"
+
+namespace Xidi
+{
+  namespace LatencyTrace
+  {
+    /// Type used for trace timestamps, which are clock timestamps. A value of 0 means no timestamp
+    /// is available, either because tracing is disabled or because nothing has been traced yet.
+    using TTimestamp = Clock::TTimestamp;
+
+    /// Enumerates the stages of the input pipeline at which latency is measured. Each stage is
+    /// measured from the start of the physical controller read that produced a state change.
+    enum class EStage : uint8_t
+    {
+      /// Physical controller state was read and found to have changed.
+      PhysicalRead,
+
+      /// Raw virtual controller state was mapped and published by the physical controller module.
+      RawVirtualStateUpdate,
+
+      /// A virtual controller object refreshed its processed state.
+      VirtualControllerRefresh,
+
+      /// A virtual controller object signalled the application's state change event.
+      StateChangeEventSignal,
+
+      /// The application read virtual controller state or buffered events for the first time
+      /// after a change.
+      ApplicationRead,
+
+      /// Sentinel value, total number of enumerators.
+      Count
+    };
+
+    /// Histogram of latency samples with log-linear buckets. Values below 64 ns each get their own
+    /// bucket, and above that each power of two is divided into 32 equal buckets, which bounds the
+    /// relative error of any reported percentile to about 3%. Concurrency-safe.
+    class Histogram
+    {
+    public:
+
+      /// Number of low-order values that have a bucket all to themselves.
+      static constexpr unsigned int kNumLinearBuckets = 64;
+
+      /// Number of buckets per power of two above the linear range.
+      static constexpr unsigned int kNumSubBucketsPerPowerOfTwo = 32;
+
+      /// Largest power of two that is tracked. Samples greater than this are clamped.
+      static constexpr unsigned int kMaxTrackedExponent = 35;
+
+      /// Total number of buckets.
+      static constexpr unsigned int kNumBuckets = kNumLinearBuckets +
+          ((kMaxTrackedExponent - 5) * kNumSubBucketsPerPowerOfTwo);
+
+      /// Computes the index of the bucket that holds the specified value.
+      /// @param [in] value Value for which a bucket is needed.
+      /// @return Index of the corresponding bucket.
+      static unsigned int BucketIndexForValue(uint64_t value);
+
+      /// Computes the smallest value that maps to the specified bucket.
+      /// @param [in] bucketIndex Index of the bucket of interest.
+      /// @return Lower bound of the bucket's range of values.
+      static uint64_t LowerBoundForBucketIndex(unsigned int bucketIndex);
+
+      /// Retrieves the total number of samples recorded.
+      /// @return Number of samples.
+      uint64_t GetCount(void) const;
+
+      /// Computes the specified percentile of the samples recorded so far.
+      /// @param [in] percentile Desired percentile, from 0 to 100.
+      /// @return Lower bound of the bucket that holds the requested percentile, or 0 if there are
+      /// no samples.
+      uint64_t GetPercentile(double percentile) const;
+
+      /// Records a sample.
+      /// @param [in] value Sample value to record.
+      void Record(uint64_t value);
+
+    private:
+
+      /// Number of samples in each bucket.
+      std::array<std::atomic<uint32_t>, kNumBuckets> bucketCounts = {};
+    };
+
+    /// Retrieves a read-only reference to the histogram for the specified stage. Samples are in
+    /// nanoseconds.
+    /// @param [in] stage Stage of interest.
+    /// @return Histogram of latency samples for the stage.
+    const Histogram& GetStageHistogram(EStage stage);
+
+    /// Retrieves the timestamp of the physical controller read that produced the most recently
+    /// published raw virtual controller state for the specified controller.
+    /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+    /// @return Timestamp of the originating read, or 0 if not available.
+    TTimestamp GetPublishedOrigin(Controller::TControllerIdentifier controllerIdentifier);
+
+    /// Enables tracing if it is enabled in the configuration file, and starts periodic output of
+    /// a summary to the log. Idempotent and concurrency-safe.
+    void InitializeIfConfigured(void);
+
+    /// Determines whether or not tracing is enabled.
+    /// @return `true` if so, `false` if not.
+    bool IsEnabled(void);
+
+    /// Outputs a summary of latency percentiles for each stage to the log.
+    void OutputSummary(void);
+
+    /// Associates the timestamp of a physical controller read with the raw virtual controller state
+    /// about to be published for the specified controller, so that later stages can measure
+    /// latency relative to it.
+    /// @param [in] controllerIdentifier Identifier of the physical controller.
+    /// @param [in] origin Timestamp of the originating read.
+    void PublishOrigin(Controller::TControllerIdentifier controllerIdentifier, TTimestamp origin);
+
+    /// Records the time elapsed between the specified origin timestamp and now as a sample for the
+    /// specified stage. Does nothing if tracing is disabled or the origin timestamp is not
+    /// available.
+    /// @param [in] stage Stage being traced.
+    /// @param [in] origin Timestamp of the originating physical controller read.
+    void RecordStage(EStage stage, TTimestamp origin);
+
+    /// Captures a timestamp for the purpose of tracing. Does not query the clock at all if tracing
+    /// is disabled.
+    /// @return Current clock timestamp, or 0 if tracing is disabled.
+    TTimestamp TraceTimestamp(void);
+  } // namespace LatencyTrace
+} // namespace Xidi
@@ -12,14 +12,20 @@
 
 #pragma once
 
+#include <array>
+#include <functional>
 #include <memory>
 #include <string_view>
 
 #include "ApiBitSet.h"
 #include "ApiWindows.h"
+#include "Configuration.h"
 #include "ControllerTypes.h"
 #include "ElementMapper.h"
+#include "ElementMapperArena.h"
+#include "ElementProgram.h"
 #include "ForceFeedbackTypes.h"
+#include "TransformProfile.h"
 
 /// Computes the index of the specified named controller element in the unnamed array representation
 /// of the element map.
@@ -41,6 +47,10 @@ namespace Xidi
 {
   namespace Controller
   {
+    /// Builds custom mappers from blueprints. Declared here because mappers can be asked to build
+    /// custom mappers on demand, but builders themselves depend on mappers.
+    class MapperBuilder;
+
     /// Maps a physical controller layout to a virtual controller layout.
     /// Each instance of this class represents a different virtual controller layout.
     class Mapper
@@ -73,6 +83,10 @@ namespace Xidi
         std::unique_ptr<const IElementMapper> buttonRS = nullptr;
       };
 
+      /// Number of element mappers in a complete element map, one per physical controller element.
+      static constexpr unsigned int kElementMapCount =
+          sizeof(SElementMap) / sizeof(std::unique_ptr<const IElementMapper>);
+
       /// Physical force feedback actuator mappers, one per force feedback actuator.
       /// For force feedback actuators that are not used, the `valid` bit is set to 0.
       /// Names correspond to the enumerators in the #ForceFeedback::EActuator enumeration.
@@ -93,8 +107,7 @@ namespace Xidi
       union UElementMap
       {
         SElementMap named;
-        std::unique_ptr<const IElementMapper>
-            all[sizeof(SElementMap) / sizeof(std::unique_ptr<const IElementMapper>)];
+        std::unique_ptr<const IElementMapper> all[kElementMapCount];
 
         static_assert(sizeof(named) == sizeof(all), "Element map field mismatch.");
 
@@ -150,6 +163,44 @@ namespace Xidi
           sizeof(UForceFeedbackActuatorMap::named) == sizeof(UForceFeedbackActuatorMap::all),
           "Force feedback actuator field mismatch.");
 
+      /// Holds the intermediate results of a previous mapping operation so that the next one can
+      /// re-run only those element mappers whose physical controller inputs have changed. Contents
+      /// are owned by whoever performs the mapping, typically one object per physical controller,
+      /// and should otherwise be treated as opaque. A default-constructed object is invalid, which
+      /// causes the next incremental mapping operation to be a full remap.
+      struct SIncrementalMappingCache
+      {
+        /// Whether or not the rest of the contents of this object are valid.
+        bool isValid = false;
+
+        /// Mapper that produced the cached contents.
+        const Mapper* mapper = nullptr;
+
+        /// Opaque identifier of the physical controller associated with the cached contents.
+        uint32_t sourceControllerIdentifier = 0;
+
+        /// Raw analog transformations that were applied to produce the cached contents.
+        const TransformProfile* transformProfile = nullptr;
+
+        /// Physical controller state that was most recently mapped, after raw analog
+        /// transformations were applied to it.
+        SPhysicalState physicalState = {};
+
+        /// Contribution of each individual element mapper, in element map order, each computed
+        /// independently of all the others starting from a completely zeroed controller state.
+        std::array<SState, kElementMapCount> elementContributions = {};
+
+        /// Combination of all the element mapper contributions. Axis values are not saturated.
+        SState combinedContributions = {};
+
+        /// Marks the contents of this object as invalid so that the next mapping operation that
+        /// uses it is a full remap.
+        inline void Invalidate(void)
+        {
+          isValid = false;
+        }
+      };
+
       /// Set of axes that must be present on all virtual controllers.
       /// Contents are based on expectations of both DirectInput and WinMM state data structures.
       /// If no element mappers contribute to these axes then they will be continually reported as
@@ -196,19 +247,42 @@ namespace Xidi
       /// However, tests may create mappers as temporaries that end up being destroyed.
       ~Mapper(void);
 
+      /// Creates a mapper object that has a name but is not registered, so it cannot be located by
+      /// name and does not conflict with a registered mapper of the same name. Used for mappers
+      /// that are built to replace existing mappers while running.
+      /// @param [in] name Name of the mapper.
+      /// @param [in] elements Element mappers, which become owned by the new mapper.
+      /// @param [in] forceFeedbackActuators Force feedback actuator map.
+      /// @return Newly-created mapper object.
+      static std::unique_ptr<const Mapper> CreateUnregistered(
+          const std::wstring_view name,
+          SElementMap&& elements,
+          SForceFeedbackActuatorMap forceFeedbackActuators = kDefaultForceFeedbackActuatorMap);
+
       /// Dumps information about all registered mappers.
       static void DumpRegisteredMappers(void);
 
       /// Retrieves and returns a pointer to the mapper object whose name is specified.
-      /// Mapper objects are created and managed internally, so this operation does not dynamically
-      /// allocate or deallocate memory, nor should the caller attempt to free the returned pointer.
-      /// @param [in] mapperName Name of the desired mapper. Supported built-in values are defined
-      /// in "MapperDefinitions.cpp" as mapper instances, but more could be built and registered at
-      /// runtime.
+      /// Mapper objects are created and managed internally, so the caller should not attempt to
+      /// free the returned pointer. If no mapper of the specified name has been built yet but the
+      /// deferred builder holds a blueprint for it, then the mapper is built now, along with any
+      /// templates on which it depends. Built-in mappers are likewise created on first request.
+      /// @param [in] mapperName Name of the desired mapper. Supported built-in values are described
+      /// in "MapperDefinitions.cpp" and are created on first request, but more could be built and
+      /// registered at runtime. An empty name requests the default mapper.
       /// @return Pointer to the mapper of specified name, or `nullptr` if said mapper is
       /// unavailable.
       static const Mapper* GetByName(std::wstring_view mapperName);
 
+      /// Retrieves and returns a pointer to the mapper object whose name is specified, but only if
+      /// it has already been built and registered or is a built-in mapper. Never builds custom
+      /// mappers, so mapper builders use this method to look up existing mappers and templates
+      /// while they are building.
+      /// @param [in] mapperName Name of the desired mapper.
+      /// @return Pointer to the mapper of specified name, or `nullptr` if said mapper is not
+      /// registered.
+      static const Mapper* GetByNameIfBuilt(std::wstring_view mapperName);
+
       /// Retrieves and returns a pointer to the mapper object whose type is read from the
       /// configuration file for the specified controller identifier. If no mapper specified there,
       /// then the default mapper type is used instead.
@@ -216,6 +290,19 @@ namespace Xidi
       /// requested.
       static const Mapper* GetConfigured(TControllerIdentifier controllerIdentifier);
 
+      /// Resolves the mapper types specified in the specified configuration data for all
+      /// controllers. Per-controller type settings take precedence over the
+      /// controller-independent type setting, which in turn takes precedence over the default
+      /// mapper. This is the logic behind #GetConfigured, exposed so that the same rules can be
+      /// applied to configuration data that is read again while running.
+      /// @param [in] configData Configuration data from which to read.
+      /// @param [in] lookupByName Function that locates a mapper by name, returning `nullptr` if
+      /// no such mapper exists. An empty name requests the default mapper.
+      /// @return Resolved mapper for each controller, none of which is `nullptr`.
+      static std::array<const Mapper*, kPhysicalControllerCount> ResolveConfigured(
+          const Configuration::ConfigurationData& configData,
+          const std::function<const Mapper*(std::wstring_view)>& lookupByName);
+
       /// Retrieves and returns a pointer to the default mapper object.
       /// @return Pointer to the default mapper object, or `nullptr` if there is no default.
       static inline const Mapper* GetDefault(void)
@@ -229,13 +316,19 @@ namespace Xidi
       /// @return Pointer to the null mapper object.
       static const Mapper* GetNull(void);
 
-      /// Checks if a mapper of the specified name is known and registered.
+      /// Checks if a mapper of the specified name is known, meaning that it is a built-in mapper,
+      /// it is registered, or it is described by a blueprint that the deferred builder has not yet
+      /// attempted to build. Never builds anything.
       /// @param [in] mapperName Name of the mapper to check.
-      /// @return `true` if it is registered, `false` otherwise.
-      static inline bool IsMapperNameKnown(std::wstring_view mapperName)
-      {
-        return (nullptr != GetByName(mapperName));
-      }
+      /// @return `true` if it is known, `false` otherwise.
+      static bool IsMapperNameKnown(std::wstring_view mapperName);
+
+      /// Sets the mapper builder whose blueprints are built on demand the first time a mapper they
+      /// describe is requested by name. Building is deferred because configuration files can
+      /// define many custom mappers, most of which are typically not used by any controller. The
+      /// builder must remain valid until it is replaced.
+      /// @param [in] mapperBuilder Mapper builder to use, or `nullptr` to stop building on demand.
+      static void SetDeferredBuilder(MapperBuilder* mapperBuilder);
 
       /// Returns a copy of this mapper's element map.
       /// Useful for dynamically generating new mappers using this mapper as a template.
@@ -253,6 +346,15 @@ namespace Xidi
         return elements;
       }
 
+      /// Returns a read-only reference to the compiled form of this mapper's element map, which is
+      /// what is actually evaluated when mapping physical controller state to virtual controller
+      /// state. Primarily useful for tests and benchmarks.
+      /// @return Read-only reference to this mapper's compiled element map.
+      inline const ElementProgram& CompiledElementMap(void) const
+      {
+        return program;
+      }
+
       /// Retrieves and returns the capabilities of the virtual controller layout implemented by the
       /// mapper. Controller capabilities act as metadata that are used internally and can be
       /// presented to applications.
@@ -262,6 +364,14 @@ namespace Xidi
         return capabilities;
       }
 
+      /// Returns a read-only reference to the arena that holds all of this mapper's element
+      /// mappers. Primarily useful for tests and benchmarks.
+      /// @return Read-only reference to this mapper's element mapper arena.
+      inline const ElementMapperArena& GetElementMapperArena(void) const
+      {
+        return elementMapperArena;
+      }
+
       /// Returns this mapper's force feedback actuator map.
       /// @return Copy of this mapper's force feedback actuator map.
       inline UForceFeedbackActuatorMap GetForceFeedbackActuatorMap(void) const
@@ -292,9 +402,35 @@ namespace Xidi
       /// @param [in] physicalState Physical controller state from which to read.
       /// @param [in] sourceControllerIdentifier Opaque identifier of the physical controller
       /// associated with the state being mapped.
+      /// @param [in] transformProfile Raw analog transformations to apply to the physical
+      /// controller state before mapping it. Typically the profile configured for the physical
+      /// controller whose state is being mapped.
       /// @return Controller state object that was filled as a result of the mapping.
       SState MapStatePhysicalToVirtual(
-          SPhysicalState physicalState, uint32_t sourceControllerIdentifier) const;
+          SPhysicalState physicalState,
+          uint32_t sourceControllerIdentifier,
+          const TransformProfile& transformProfile = TransformProfile::GetIdentity()) const;
+
+      /// Maps from physical controller state to virtual controller state, re-running only those
+      /// element mappers whose physical controller inputs differ from the previous mapping
+      /// operation recorded in the supplied cache. Result is identical to a full mapping operation
+      /// because all element mapper contributions are either additive (axes) or inclusive (buttons
+      /// and POV directions), so they can be computed separately and recombined. Does not apply any
+      /// properties configured by the application, such as deadzone and range.
+      /// @param [in] physicalState Physical controller state from which to read.
+      /// @param [in] sourceControllerIdentifier Opaque identifier of the physical controller
+      /// associated with the state being mapped.
+      /// @param [in, out] cache Results of the previous mapping operation, updated to hold the
+      /// results of this one. An invalid or mismatched cache causes a full remap.
+      /// @param [in] transformProfile Raw analog transformations to apply to the physical
+      /// controller state before mapping it. Must be an object with a stable address, such as one
+      /// obtained from #TransformProfile::GetConfigured, because it is recorded in the cache.
+      /// @return Controller state object that was filled as a result of the mapping.
+      SState MapStatePhysicalToVirtual(
+          SPhysicalState physicalState,
+          uint32_t sourceControllerIdentifier,
+          SIncrementalMappingCache& cache,
+          const TransformProfile& transformProfile = TransformProfile::GetIdentity()) const;
 
       /// Maps from physical controller state to virtual controller state in which the physical
       /// controller is completely neutral and possibly even disconnected. Does not apply any
@@ -306,9 +442,33 @@ namespace Xidi
 
     private:
 
-      /// All controller element mappers.
+      /// Creates a mapper object and, if requested, registers it by name. Objects that are not
+      /// registered are only created by #CreateUnregistered.
+      /// @param [in] name Name of the mapper.
+      /// @param [in] elements Element mappers, which become owned by the new mapper.
+      /// @param [in] forceFeedbackActuators Force feedback actuator map.
+      /// @param [in] registerName Whether or not to register the new mapper by name.
+      Mapper(
+          const std::wstring_view name,
+          SElementMap&& elements,
+          SForceFeedbackActuatorMap forceFeedbackActuators,
+          bool registerName);
+
+      /// Holds all controller element mappers contiguously in traversal order. Must be declared
+      /// before #elements so that it is destroyed only after all of the element mappers it holds.
+      ElementMapperArena elementMapperArena;
+
+      /// All controller element mappers, which are allocated from #elementMapperArena.
+      /// Initialization of this member depends on prior initialization of #elementMapperArena so
+      /// it must come after.
       const UElementMap elements;
 
+      /// Compiled form of all controller element mappers, used for mapping. The element mappers
+      /// themselves remain the source of truth, for example when cloning them to build new mappers.
+      /// Initialization of this member depends on prior initialization of #elements so it must come
+      /// after.
+      const ElementProgram program;
+
       /// All force feedback actuator mappings.
       const UForceFeedbackActuatorMap forceFeedbackActuators;
 
@@ -319,6 +479,9 @@ namespace Xidi
 
       /// Name of this mapper.
       const std::wstring_view name;
+
+      /// Whether or not this mapper is registered by name.
+      const bool isRegistered;
     };
   } // namespace Controller
 } // namespace Xidi
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <optional>
@@ -27,7 +28,10 @@ namespace Xidi
   namespace Controller
   {
     /// Encapsulates all functionality for managing a set of partially-built mappers and
-    /// constructing them into full mapper objects.
+    /// constructing them into full mapper objects. By default, built mappers are registered by name
+    /// and owned by the internal mapper registry. Detached builders instead hold the mappers they
+    /// build without registering them, which allows a configuration file to be read again while
+    /// the custom mappers built from its previous contents are still in use.
     class MapperBuilder
     {
     public:
@@ -72,6 +76,21 @@ namespace Xidi
         bool buildCanAttempt = true;
       };
 
+      /// Maps from mapper name to mapper object for mappers built by a detached builder.
+      /// Ownership is shared so that mappers can outlive the builder that created them for as long
+      /// as anything still uses them.
+      using TDetachedMapperMap = std::map<std::wstring_view, std::shared_ptr<const Mapper>>;
+
+      /// Default constructor. Creates a builder whose mappers are registered by name.
+      MapperBuilder(void) = default;
+
+      /// Initialization constructor. Creates a builder that is optionally detached. Detached
+      /// builders do not register the mappers they build, and they treat custom mappers built
+      /// previously by other builders as though they do not exist, so that blueprints can reuse
+      /// their names. Built-in mappers remain visible, both as templates and by name.
+      /// @param [in] isDetached Whether or not the new builder is detached.
+      explicit MapperBuilder(bool isDetached);
+
       /// Attempts to build mapper objects based on all of the blueprints known to this mapper
       /// builder object. Once a build attempt is made on a blueprint, that blueprint can no longer
       /// be modified.
@@ -83,15 +102,18 @@ namespace Xidi
       /// This method will fail if a mapper already exists with the specified name or if there is a
       /// blueprint template issue. If this method succeeds, then a mapper object was successfully
       /// created and can now be referenced by name. Any returned pointers are owned by the internal
-      /// mapper registry.
+      /// mapper registry or, for detached builders, by this object's detached mapper map.
       /// @param [in] mapperName Name that identifies the mapper described by a blueprint.
       /// @return Pointer to the new mapper object if successful, `nullptr` otherwise.
       const Mapper* Build(std::wstring_view mapperName);
 
-      /// Deletes all blueprints held by this object, resetting it to a pristine state.
+      /// Deletes all blueprints held by this object, resetting it to a pristine state. Detached
+      /// builders also release their built mappers, although any of them still in use elsewhere
+      /// remain valid.
       inline void Clear(void)
       {
         blueprints.clear();
+        detachedMappers.clear();
       }
 
       /// Removes an element mapper from this blueprint's element map specification so it is not
@@ -140,11 +162,19 @@ namespace Xidi
 
       /// Creates a new mapper blueprint object with the specified mapper name.
       /// This method will fail if a mapper or mapper blueprint already exists with the specified
-      /// name.
+      /// name. For detached builders, only mappers visible via #GetMapper are considered.
       /// @param [in] mapperName Name that identifies the mapper to be described by the blueprint.
       /// @return `true` if successful, `false` otherwise.
       bool CreateBlueprint(std::wstring_view mapperName);
 
+      /// Retrieves the number of blueprints held by this object, whether or not they have been
+      /// built.
+      /// @return Number of blueprints.
+      inline size_t GetBlueprintCount(void) const
+      {
+        return blueprints.size();
+      }
+
       /// Determines if the specified mapper name already exists as a blueprint within this object.
       /// @param [in] mapperName Name that identifies the mapper described by a possibly-existing
       /// blueprint.
@@ -176,6 +206,36 @@ namespace Xidi
       /// @return Template name associated with the blueprint if the blueprint exists.
       std::optional<std::wstring_view> GetBlueprintTemplate(std::wstring_view mapperName) const;
 
+      /// Retrieves all mappers built so far by a detached builder. Always empty for other builders.
+      /// @return Read-only reference to the detached mapper map.
+      inline const TDetachedMapperMap& GetDetachedMappers(void) const
+      {
+        return detachedMappers;
+      }
+
+      /// Locates a built mapper by name, as seen by this builder. For builders that are not
+      /// detached this is the same as looking up a registered mapper by name without building
+      /// anything on demand. Detached builders first consult their own built mappers and then fall
+      /// back to built-in mappers, ignoring custom mappers built or held by any other builder. An
+      /// empty name requests the default mapper.
+      /// @param [in] mapperName Name of the desired mapper.
+      /// @return Pointer to the mapper if it exists, or `nullptr` otherwise.
+      const Mapper* GetMapper(std::wstring_view mapperName) const;
+
+      /// Determines if the specified mapper name identifies a blueprint on which no build attempt
+      /// has been made yet. Used to build mappers on demand, the first time they are requested.
+      /// @param [in] mapperName Name that identifies the mapper described by a possibly-existing
+      /// blueprint.
+      /// @return `true` if the blueprint exists and has not been built, `false` otherwise.
+      bool IsBlueprintBuildPending(std::wstring_view mapperName) const;
+
+      /// Determines if this builder is detached.
+      /// @return `true` if so, `false` otherwise.
+      inline bool IsDetached(void) const
+      {
+        return isDetached;
+      }
+
       /// Marks a blueprint as invalid such that it cannot be built. Does nothing if the blueprint
       /// does not exist. Useful for marking a partially-parsed blueprint as invalid in response to
       /// a parse error. This method will fail if the mapper name does not identify an existing
@@ -255,6 +315,12 @@ namespace Xidi
 
       /// Holds all known mapper blueprints.
       std::map<std::wstring_view, SBlueprint> blueprints;
+
+      /// Whether or not this builder is detached.
+      bool isDetached = false;
+
+      /// Holds all mappers built by this builder, if it is detached.
+      TDetachedMapperMap detachedMappers;
     };
   } // namespace Controller
 } // namespace Xidi
@@ -0,0 +1,355 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file MapperDefinitions.h
+ *   Declaration of the compile-time descriptions of all built-in mapper types and of the
+ *   functionality for turning them into mapper objects on demand.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "ControllerTypes.h"
+#include "Mapper.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    namespace MapperDefinitions
+    {
+      /// Enumerates the types of element mappers that built-in mappers use.
+      enum class EElementMapperType : uint8_t
+      {
+        None,
+        Axis,
+        Button,
+        DigitalAxis,
+        Pov
+      };
+
+      /// Compile-time description of a single element mapper within a built-in mapper. Only the
+      /// fields that are relevant to the element mapper type are meaningful.
+      struct SElementMapperDescription
+      {
+        /// Type of element mapper being described. #EElementMapperType::None means that the
+        /// physical controller element is not mapped.
+        EElementMapperType type = EElementMapperType::None;
+
+        /// Target axis, for axis and digital axis element mappers.
+        EAxis axis = EAxis::X;
+
+        /// Target axis direction, for axis and digital axis element mappers.
+        EAxisDirection axisDirection = EAxisDirection::Both;
+
+        /// Target button, for button element mappers.
+        EButton button = EButton::B1;
+
+        /// Target POV direction, for POV element mappers.
+        EPovDirection povDirection = EPovDirection::Up;
+
+        /// Retrieves the number of virtual controller elements to which the described element
+        /// mapper contributes, in the same way as #IElementMapper::GetTargetElementCount does for
+        /// the element mapper object.
+        /// @return Number of target virtual controller elements.
+        constexpr int GetTargetElementCount(void) const
+        {
+          return ((EElementMapperType::None == type) ? 0 : 1);
+        }
+
+        /// Identifies a virtual controller element to which the described element mapper
+        /// contributes, in the same way as #IElementMapper::GetTargetElementAt does for the
+        /// element mapper object.
+        /// @param [in] index Index of the target element, which should be less than the value
+        /// returned by #GetTargetElementCount.
+        /// @return Identifier of the target virtual controller element, if there is one.
+        constexpr std::optional<SElementIdentifier> GetTargetElementAt(int index) const
+        {
+          if (0 != index) return std::nullopt;
+
+          switch (type)
+          {
+            case EElementMapperType::Axis:
+            case EElementMapperType::DigitalAxis:
+              return SElementIdentifier({.type = EElementType::Axis, .axis = axis});
+
+            case EElementMapperType::Button:
+              return SElementIdentifier({.type = EElementType::Button, .button = button});
+
+            case EElementMapperType::Pov:
+              return SElementIdentifier({.type = EElementType::Pov});
+
+            default:
+              return std::nullopt;
+          }
+        }
+      };
+
+      /// Describes an #AxisMapper.
+      /// @param [in] axis Target axis.
+      /// @param [in] axisDirection Target axis direction.
+      /// @return Element mapper description.
+      constexpr SElementMapperDescription Axis(
+          EAxis axis, EAxisDirection axisDirection = EAxisDirection::Both)
+      {
+        return {
+            .type = EElementMapperType::Axis, .axis = axis, .axisDirection = axisDirection};
+      }
+
+      /// Describes a #ButtonMapper.
+      /// @param [in] button Target button.
+      /// @return Element mapper description.
+      constexpr SElementMapperDescription Button(EButton button)
+      {
+        return {.type = EElementMapperType::Button, .button = button};
+      }
+
+      /// Describes a #DigitalAxisMapper.
+      /// @param [in] axis Target axis.
+      /// @param [in] axisDirection Target axis direction.
+      /// @return Element mapper description.
+      constexpr SElementMapperDescription DigitalAxis(
+          EAxis axis, EAxisDirection axisDirection = EAxisDirection::Both)
+      {
+        return {
+            .type = EElementMapperType::DigitalAxis,
+            .axis = axis,
+            .axisDirection = axisDirection};
+      }
+
+      /// Describes a #PovMapper.
+      /// @param [in] povDirection Target POV direction.
+      /// @return Element mapper description.
+      constexpr SElementMapperDescription Pov(EPovDirection povDirection)
+      {
+        return {.type = EElementMapperType::Pov, .povDirection = povDirection};
+      }
+
+      /// Compile-time description of an element map. Field names and order match those of
+      /// #Mapper::SElementMap.
+      struct SElementMapDescription
+      {
+        SElementMapperDescription stickLeftX;
+        SElementMapperDescription stickLeftY;
+        SElementMapperDescription stickRightX;
+        SElementMapperDescription stickRightY;
+        SElementMapperDescription dpadUp;
+        SElementMapperDescription dpadDown;
+        SElementMapperDescription dpadLeft;
+        SElementMapperDescription dpadRight;
+        SElementMapperDescription triggerLT;
+        SElementMapperDescription triggerRT;
+        SElementMapperDescription buttonA;
+        SElementMapperDescription buttonB;
+        SElementMapperDescription buttonX;
+        SElementMapperDescription buttonY;
+        SElementMapperDescription buttonLB;
+        SElementMapperDescription buttonRB;
+        SElementMapperDescription buttonBack;
+        SElementMapperDescription buttonStart;
+        SElementMapperDescription buttonLS;
+        SElementMapperDescription buttonRS;
+
+        /// Collects all of the element mapper descriptions into an array, in the same order as
+        /// the `all` member of #Mapper::UElementMap.
+        /// @return Array of element mapper descriptions.
+        constexpr std::array<SElementMapperDescription, Mapper::kElementMapCount> All(void) const
+        {
+          return {
+              stickLeftX,
+              stickLeftY,
+              stickRightX,
+              stickRightY,
+              dpadUp,
+              dpadDown,
+              dpadLeft,
+              dpadRight,
+              triggerLT,
+              triggerRT,
+              buttonA,
+              buttonB,
+              buttonX,
+              buttonY,
+              buttonLB,
+              buttonRB,
+              buttonBack,
+              buttonStart,
+              buttonLS,
+              buttonRS};
+        }
+      };
+
+      static_assert(
+          sizeof(SElementMapDescription) ==
+              (Mapper::kElementMapCount * sizeof(SElementMapperDescription)),
+          "Element map description field mismatch.");
+
+      /// Derives the capabilities of the virtual controller described by an element map
+      /// description and a force feedback actuator map. Follows exactly the same rules as are used
+      /// for mapper objects, but can be evaluated by the compiler.
+      /// @param [in] elements Element map description.
+      /// @param [in] forceFeedbackActuators Force feedback actuator map.
+      /// @return Virtual controller capabilities.
+      constexpr SCapabilities DeriveCapabilities(
+          const SElementMapDescription& elements,
+          const Mapper::SForceFeedbackActuatorMap& forceFeedbackActuators =
+              Mapper::kDefaultForceFeedbackActuatorMap)
+      {
+        bool axesPresent[(int)EAxis::Count] = {};
+        bool axesForceFeedback[(int)EAxis::Count] = {};
+
+        for (int axis = 0; axis < (int)EAxis::Count; ++axis)
+        {
+          axesPresent[axis] = Mapper::kRequiredAxes.contains(axis);
+          axesForceFeedback[axis] = Mapper::kRequiredForceFeedbackAxes.contains(axis);
+        }
+
+        int highestButtonSeen = Mapper::kMinNumButtons - 1;
+        bool povPresent = Mapper::kIsPovRequired;
+
+        for (const auto& element : elements.All())
+        {
+          for (int i = 0; i < element.GetTargetElementCount(); ++i)
+          {
+            const std::optional<SElementIdentifier> maybeTargetElement =
+                element.GetTargetElementAt(i);
+            if (false == maybeTargetElement.has_value()) continue;
+
+            const SElementIdentifier targetElement = maybeTargetElement.value();
+            switch (targetElement.type)
+            {
+              case EElementType::Axis:
+                if ((int)targetElement.axis < (int)EAxis::Count)
+                  axesPresent[(int)targetElement.axis] = true;
+                break;
+
+              case EElementType::Button:
+                if ((int)targetElement.button < (int)EButton::Count)
+                {
+                  if ((int)targetElement.button > highestButtonSeen)
+                    highestButtonSeen = (int)targetElement.button;
+                }
+                break;
+
+              case EElementType::Pov:
+                povPresent = true;
+                break;
+
+              default:
+                break;
+            }
+          }
+        }
+
+        // The union that allows actuators to be accessed as an array cannot be used by the
+        // compiler, so the actuators are listed individually.
+        static_assert(
+            sizeof(Mapper::SForceFeedbackActuatorMap) ==
+                ((int)ForceFeedback::EActuator::Count * sizeof(ForceFeedback::SActuatorElement)),
+            "Force feedback actuator field mismatch.");
+
+        for (const auto& actuator :
+             {forceFeedbackActuators.leftMotor,
+              forceFeedbackActuators.rightMotor,
+              forceFeedbackActuators.leftImpulseTrigger,
+              forceFeedbackActuators.rightImpulseTrigger})
+        {
+          if (false == actuator.isPresent) continue;
+
+          switch (actuator.mode)
+          {
+            case ForceFeedback::EActuatorMode::SingleAxis:
+              axesPresent[(int)actuator.singleAxis.axis] = true;
+              axesForceFeedback[(int)actuator.singleAxis.axis] = true;
+              break;
+
+            case ForceFeedback::EActuatorMode::MagnitudeProjection:
+              axesPresent[(int)actuator.magnitudeProjection.axisFirst] = true;
+              axesPresent[(int)actuator.magnitudeProjection.axisSecond] = true;
+              axesForceFeedback[(int)actuator.magnitudeProjection.axisFirst] = true;
+              axesForceFeedback[(int)actuator.magnitudeProjection.axisSecond] = true;
+              break;
+
+            default:
+              break;
+          }
+        }
+
+        SCapabilities capabilities = {};
+        for (int axis = 0; axis < (int)EAxis::Count; ++axis)
+        {
+          if (true == axesPresent[axis])
+            capabilities.AppendAxis(
+                {.type = (EAxis)axis, .supportsForceFeedback = axesForceFeedback[axis]});
+        }
+
+        capabilities.numButtons = highestButtonSeen + 1;
+        capabilities.hasPov = povPresent;
+
+        return capabilities;
+      }
+
+      /// Compile-time description of a built-in mapper.
+      struct SMapperDescription
+      {
+        /// Name of the mapper.
+        std::wstring_view name;
+
+        /// Element mappers.
+        SElementMapDescription elements;
+
+        /// Capabilities of the virtual controller, which are derived from the element mappers.
+        SCapabilities capabilities;
+      };
+
+      /// Creates a built-in mapper description and derives its capabilities.
+      /// @param [in] name Name of the mapper.
+      /// @param [in] elements Element mappers.
+      /// @return Built-in mapper description.
+      constexpr SMapperDescription Describe(
+          std::wstring_view name, const SElementMapDescription& elements)
+      {
+        return {.name = name, .elements = elements, .capabilities = DeriveCapabilities(elements)};
+      }
+
+      /// Creates a new mapper object from a built-in mapper description. The new mapper is not
+      /// registered, so the caller owns it. Most callers should use #GetMapper instead, which
+      /// creates each built-in mapper only once.
+      /// @param [in] index Index of the built-in mapper, which must be less than #GetCount.
+      /// @return Newly-created mapper object.
+      std::unique_ptr<const Mapper> CreateMapper(unsigned int index);
+
+      /// Locates a built-in mapper by name using a perfect hash table that is built by the
+      /// compiler. Does not create any mapper objects.
+      /// @param [in] name Name of the desired mapper.
+      /// @return Index of the built-in mapper, if it exists.
+      std::optional<unsigned int> FindByName(std::wstring_view name);
+
+      /// Retrieves the number of built-in mappers.
+      /// @return Number of built-in mappers.
+      unsigned int GetCount(void);
+
+      /// Retrieves the description of a built-in mapper, which includes its name and capabilities.
+      /// Does not create any mapper objects.
+      /// @param [in] index Index of the built-in mapper, which must be less than #GetCount.
+      /// @return Read-only reference to the built-in mapper description.
+      const SMapperDescription& GetDescription(unsigned int index);
+
+      /// Retrieves the mapper object for a built-in mapper, creating it the first time it is
+      /// requested. Built-in mappers are therefore never created unless they are used.
+      /// Concurrency-safe. The first built-in mapper is the default mapper.
+      /// @param [in] index Index of the built-in mapper, which must be less than #GetCount.
+      /// @return Pointer to the mapper object, which is never destroyed.
+      const Mapper* GetMapper(unsigned int index);
+    } // namespace MapperDefinitions
+  } // namespace Controller
+} // namespace Xidi
@@ -20,6 +20,7 @@
 #include "ElementMapper.h"
 #include "ForceFeedbackTypes.h"
 #include "Mapper.h"
+#include "ResponseCurve.h"
 #include "ValueOrError.h"
 
 namespace Xidi
@@ -39,6 +40,11 @@ namespace Xidi
       using ForceFeedbackActuatorOrError =
           ValueOrError<ForceFeedback::SActuatorElement, std::wstring>;
 
+      /// Type alias for representing either a response curve pointer or an error message. Intended
+      /// to be returned from functions that parse response curve strings and can be used to hold
+      /// semantically-rich error messages for the user.
+      using ResponseCurveOrError = ValueOrError<const ResponseCurve*, std::wstring>;
+
       /// Holds a partially-separated representation of a string that has been parsed at the very
       /// highest level. This view of the input string is separated into type and parameter
       /// portions. For example, the string "Axis(RotY, +)" would be separated into "Axis" as the
@@ -188,8 +194,9 @@ namespace Xidi
 
       /// Internal function exposed for testing.
       /// Attempts to build an #AxisMapper using the supplied parameters.
-      /// Parameter string should consist of a string representing an axis and optionally a second
-      /// string representing an axis direction.
+      /// Parameter string should consist of a string representing an axis, optionally a second
+      /// string representing an axis direction, and optionally a final string representing a
+      /// response curve. The response curve may be supplied without an axis direction.
       /// @param [in] params Parameter string.
       /// @return Pointer to the new mapper object if successful, error message string otherwise.
       ElementMapperOrError MakeAxisMapper(std::wstring_view params);
@@ -322,6 +329,16 @@ namespace Xidi
       /// @return Force feedback actuator description object if successful, error message string
       /// otherwise.
       ForceFeedbackActuatorOrError ParseForceFeedbackActuator(std::wstring_view ffActuatorString);
+
+      /// Internal function exposed for testing.
+      /// Consumes all of the input string and attempts to parse it into a response curve. Response
+      /// curve strings are structured like element mapper strings, for example "Exponential(200)"
+      /// or "Piecewise(25:10, 75:50)", and are not allowed to have a remainder.
+      /// @param [in] responseCurveString Input string supposedly containing the representation of
+      /// a response curve.
+      /// @return Pointer to the compiled response curve if successful, error message string
+      /// otherwise.
+      ResponseCurveOrError ParseResponseCurve(std::wstring_view responseCurveString);
     } // namespace MapperParser
   }   // namespace Controller
 } // namespace Xidi
@@ -0,0 +1,105 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file MappingConfiguration.h
+ *   Declaration of the per-controller mapping configuration, which can be reloaded from the
+ *   configuration file while running.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "Configuration.h"
+#include "ControllerTypes.h"
+#include "Mapper.h"
+#include "MapperBuilder.h"
+#include "ReadCopyUpdate.h"
+#include "TransformProfile.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Everything needed to map the state of one physical controller to the state of a virtual
+    /// controller. Objects are published as a whole and are read-only once published.
+    struct SMappingConfiguration
+    {
+      /// Mapper used to map physical controller state to virtual controller state.
+      const Mapper* mapper;
+
+      /// Raw analog transformations applied to physical controller state before it is mapped.
+      TransformProfile transformProfile;
+
+      /// Keeps the mapper alive if it was built by a configuration reload, in which case it is not
+      /// owned by the mapper registry. Empty otherwise.
+      std::shared_ptr<const Mapper> mapperOwner;
+    };
+
+    namespace MappingConfiguration
+    {
+      /// Type of object that provides read access to the mapping configuration of one controller.
+      using TReadGuard = ReadCopyUpdate<SMappingConfiguration>::ReadGuard;
+
+      /// Obtains read access to the current mapping configuration of the specified controller.
+      /// Initially this is the configuration resolved from the configuration file at startup,
+      /// as given by #Mapper::GetConfigured and #TransformProfile::GetConfigured. Never waits on
+      /// a lock, even while a reload is in progress. Callers should not hold on to the returned
+      /// guard any longer than needed, because a reload cannot retire the configuration it
+      /// replaces until every guard that refers to it is destroyed.
+      /// @param [in] controllerIdentifier Identifier of the controller of interest, which must be
+      /// in range.
+      /// @return Read guard through which the mapping configuration can be accessed. Its
+      /// generation changes every time a new configuration is published for the controller.
+      TReadGuard Read(TControllerIdentifier controllerIdentifier);
+
+      /// Determines the mapping configuration that should replace the current mapping
+      /// configuration of one controller. Does not publish anything. The new mapper is only
+      /// accepted if its capabilities are identical to those of the current mapper, in which case
+      /// the result shares ownership of it if it is one of the detached mappers of the specified
+      /// builder. Otherwise the current mapper and its owner are kept. The new raw analog
+      /// transformations are used either way.
+      /// @param [in] currentConfiguration Mapping configuration currently in use.
+      /// @param [in] newMapper Mapper resolved from the new configuration data.
+      /// @param [in] newTransformProfile Raw analog transformations resolved from the new
+      /// configuration data.
+      /// @param [in] customMapperBuilder Detached builder that was used to build the custom
+      /// mappers defined in the new configuration data.
+      /// @return Mapping configuration to publish.
+      SMappingConfiguration ResolveReplacement(
+          const SMappingConfiguration& currentConfiguration,
+          const Mapper* newMapper,
+          const TransformProfile& newTransformProfile,
+          const MapperBuilder& customMapperBuilder);
+
+      /// Resolves new mapping configurations for all controllers from the specified
+      /// configuration data and the custom mappers that were built from it, and publishes them.
+      /// Replacements are determined by #ResolveReplacement, because applications and virtual
+      /// controller objects consult capabilities once and expect them never to change. A warning
+      /// is output for each controller whose current mapper is kept.
+      /// Waits for all readers of each replaced configuration to finish before destroying it.
+      /// @param [in] configData Configuration data from which to resolve mapper types and raw
+      /// analog transformations.
+      /// @param [in] customMapperBuilder Detached builder that was used to build the custom
+      /// mappers defined in the configuration data.
+      void Publish(
+          const Configuration::ConfigurationData& configData,
+          const MapperBuilder& customMapperBuilder);
+
+      /// Reads the configuration file again, builds all of the custom mappers it defines, and
+      /// publishes the resulting mapping configurations. Nothing is published if the
+      /// configuration file contains errors.
+      /// @return `true` if new mapping configurations were published, `false` otherwise.
+      bool Reload(void);
+
+      /// Starts watching the configuration file for changes, if enabled in the configuration
+      /// file, and reloads it whenever it changes. Idempotent and concurrency-safe.
+      void WatchForChangesIfConfigured(void);
+    } // namespace MappingConfiguration
+  } // namespace Controller
+} // namespace Xidi
@@ -36,6 +36,11 @@ namespace Xidi
     inline constexpr int kMouseMovementUnitsNeutral =
         (kMouseMovementUnitsMax + kMouseMovementUnitsMin) / 2;
 
+    /// Number of distinct sources that can contribute mouse movement. Each source has its own
+    /// contribution slot per mouse axis, so source identifiers passed to #SubmitMouseMovement must
+    /// be less than this value.
+    inline constexpr unsigned int kMouseMovementSourceCount = 128;
+
     /// Enumeration of possible mouse axes.
     enum class EMouseAxis
     {
@@ -91,7 +96,9 @@ namespace Xidi
     /// @param [in] axis Mouse axis that is affected.
     /// @param [in] mouseMovementUnits Number of internal mouse movement units along the target
     /// mouse axis.
-    /// @param [in] sourceIdentifier Opaque identifier for the source of the mouse movement event.
+    /// @param [in] sourceIdentifier Opaque identifier for the source of the mouse movement event,
+    /// which must be less than #kMouseMovementSourceCount. Movements from out-of-range sources are
+    /// ignored.
     void SubmitMouseMovement(EMouseAxis axis, int mouseMovementUnits, uint32_t sourceIdentifier);
   } // namespace Mouse
 } // namespace Xidi
@@ -32,6 +32,12 @@ namespace Xidi
     /// the last attempt resulted in an error, such as the controller being disconnected.
     inline constexpr unsigned int kPhysicalErrorBackoffPeriodMilliseconds = 100;
 
+    /// Default maximum number of milliseconds to wait between polling attempts while a physical
+    /// controller is disconnected. The period starts at #kPhysicalErrorBackoffPeriodMilliseconds
+    /// and doubles after each unsuccessful attempt up to this limit, which can be overridden in the
+    /// configuration file.
+    inline constexpr unsigned int kPhysicalDisconnectedBackoffMaxPeriodMilliseconds = 2000;
+
     /// Retrieves and returns the capabilities of the controller layout implemented by the mapper
     /// associated with the specified physical controller. Controller capabilities act as metadata
     /// that are used internally and can be presented to applications. Concurrency-safe.
@@ -81,21 +87,5 @@ namespace Xidi
         TControllerIdentifier controllerIdentifier,
         SPhysicalState& state,
         std::stop_token stopToken = std::stop_token());
-
-    /// Waits for the specified physical controller's raw virtual state to change. When it does,
-    /// retrieves and returns the new state. This function is fully concurrency-safe. If needed, the
-    /// caller can interrupt the wait using a stop token.
-    /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
-    /// @param [in,out] state On input, used to identify the last-known physical controller state
-    /// for the calling thread. On output, filled in with the updated state of the physical
-    /// controller.
-    /// @param [in] stopToken Token that allows the weight to be interrupted. Defaults to an empty
-    /// token that does not allow interruption.
-    /// @return `true` if the wait succeeded and the output structure was updated, `false` if no
-    /// updates were made due to invalid parameter or interrupted wait.
-    bool WaitForRawVirtualControllerStateChange(
-        TControllerIdentifier controllerIdentifier,
-        SState& state,
-        std::stop_token stopToken = std::stop_token());
   } // namespace Controller
 } // namespace Xidi
@@ -0,0 +1,276 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file PhysicalControllerRecording.h
+ *   Declaration of functionality for recording and replaying physical controller state streams.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "ApiWindows.h"
+#include "ControllerTypes.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    namespace Recording
+    {
+      /// Signature that appears at the start of every recording file, which is "XIDR" when viewed
+      /// as little-endian bytes.
+      inline constexpr uint32_t kRecordingFileSignature = 0x52444958;
+
+      /// Version of the recording file format produced by this implementation.
+      inline constexpr uint16_t kRecordingFileVersion = 1;
+
+      /// Header that appears at the very start of a recording file.
+      struct SRecordingFileHeader
+      {
+        /// Identifies the file as a recording file. Must be equal to #kRecordingFileSignature.
+        uint32_t signature;
+
+        /// Version of the recording file format.
+        uint16_t version;
+
+        /// Size of each record in bytes, which allows for a basic consistency check.
+        uint16_t recordSize;
+
+        /// Number of timestamp ticks per second.
+        uint64_t timestampFrequency;
+
+        /// Number of complete records that follow the header. Updated after each record is
+        /// appended, so the file remains readable even if the recording is interrupted.
+        uint64_t recordCount;
+      };
+
+      static_assert(24 == sizeof(SRecordingFileHeader), "Recording file header size mismatch.");
+
+      /// Single recorded physical controller state change. One record is written each time the
+      /// state of any physical controller changes, so a recording is a stream of timestamped
+      /// deltas with respect to time, and each record holds the complete state of one controller.
+      struct SRecord
+      {
+        /// Time at which the state was read, measured in ticks since the recording started.
+        uint64_t timestamp;
+
+        /// Identifier of the physical controller whose state changed.
+        uint8_t controllerIdentifier;
+
+        /// Physical device status, one of the #EPhysicalDeviceStatus enumerators.
+        uint8_t deviceStatus;
+
+        /// Analog trigger values.
+        std::array<uint8_t, (size_t)EPhysicalTrigger::Count> trigger;
+
+        /// Digital button values, one bit per possible button.
+        uint16_t button;
+
+        /// Analog stick values.
+        std::array<int16_t, (size_t)EPhysicalStick::Count> stick;
+
+        /// Unused, always zero. Present for alignment.
+        uint16_t reserved;
+      };
+
+      static_assert(24 == sizeof(SRecord), "Recording file record size mismatch.");
+
+      /// Creates a record that captures the specified physical controller state.
+      /// @param [in] timestamp Time at which the state was read, in ticks since the start of
+      /// recording.
+      /// @param [in] controllerIdentifier Identifier of the physical controller.
+      /// @param [in] physicalState Physical controller state to be captured.
+      /// @return Record that represents the specified state.
+      SRecord RecordFromPhysicalState(
+          uint64_t timestamp,
+          TControllerIdentifier controllerIdentifier,
+          const SPhysicalState& physicalState);
+
+      /// Reconstructs a physical controller state from a record.
+      /// @param [in] record Record from which to obtain the state.
+      /// @return Physical controller state that was captured by the record.
+      SPhysicalState PhysicalStateFromRecord(const SRecord& record);
+
+      /// Appends physical controller state changes to a memory-mapped recording file.
+      /// The file grows in large increments so that appending a record is usually just a copy into
+      /// already-mapped memory. Concurrency-safe.
+      class Recorder
+      {
+      public:
+
+        /// Number of records by which the recording file grows whenever it is full.
+        static constexpr size_t kRecordGrowthIncrement = 65536;
+
+        ~Recorder(void);
+
+        /// Creates a new recording file, replacing any existing file with the same name.
+        /// @param [in] filename Name of the file to create.
+        /// @return Recorder object on success, `nullptr` on failure.
+        static std::unique_ptr<Recorder> Create(std::wstring_view filename);
+
+        /// Appends a physical controller state change to the recording. The timestamp is taken
+        /// at the time of the call.
+        /// @param [in] controllerIdentifier Identifier of the physical controller.
+        /// @param [in] physicalState Physical controller state to record.
+        /// @return `true` if the record was appended successfully, `false` otherwise.
+        bool Append(TControllerIdentifier controllerIdentifier, const SPhysicalState& physicalState);
+
+        /// Retrieves the number of records appended so far.
+        /// @return Number of records in the recording.
+        uint64_t GetRecordCount(void) const;
+
+      private:
+
+        Recorder(HANDLE fileHandle, uint64_t startTimestamp, uint64_t timestampFrequency);
+
+        /// Maps enough of the recording file to hold the specified number of records, growing the
+        /// file as needed. Not concurrency-safe, so the caller must hold the lock.
+        /// @param [in] newRecordCapacity Number of records the mapped view should be able to hold.
+        /// @return `true` on success, `false` on failure.
+        bool MapWithCapacity(size_t newRecordCapacity);
+
+        /// Releases the mapped view and file mapping object, if they exist. Not concurrency-safe,
+        /// so the caller must hold the lock.
+        void Unmap(void);
+
+        /// Handle to the recording file itself.
+        HANDLE fileHandle;
+
+        /// Handle to the file mapping object for the recording file.
+        HANDLE mappingHandle;
+
+        /// Mapped view of the recording file. Begins with the header, followed by the records.
+        SRecordingFileHeader* mappedHeader;
+
+        /// Number of records that fit into the currently-mapped view.
+        size_t recordCapacity;
+
+        /// Performance counter value at the time recording started.
+        uint64_t startTimestamp;
+
+        /// Performance counter frequency, in ticks per second.
+        uint64_t timestampFrequency;
+
+        /// Serializes appends, which can come from multiple polling threads.
+        mutable std::mutex recorderMutex;
+      };
+
+      /// Replays physical controller state changes from a recording. Replay can be driven by the
+      /// caller, either by requesting state as of an explicit timestamp or by stepping through
+      /// each controller's state changes in order, both of which are fully deterministic. It can
+      /// also be driven by wall-clock time at the original or a scaled speed.
+      /// Concurrency-safe once constructed.
+      class Player
+      {
+      public:
+
+        /// Creates a player from an in-memory copy of a recording file. Primarily useful for
+        /// testing. The buffer is copied and need not remain valid after construction.
+        /// @param [in] recordingData Pointer to the start of the recording file contents.
+        /// @param [in] recordingSize Size of the recording file contents in bytes.
+        /// @param [in] speedPercent Playback speed as a percentage of the original speed.
+        Player(const void* recordingData, size_t recordingSize, unsigned int speedPercent = 100);
+
+        /// Opens an existing recording file for replay.
+        /// @param [in] filename Name of the file to open.
+        /// @param [in] speedPercent Playback speed as a percentage of the original speed.
+        /// @return Player object on success, `nullptr` on failure.
+        static std::unique_ptr<Player> Open(std::wstring_view filename, unsigned int speedPercent);
+
+        /// Retrieves the total duration of the recording.
+        /// @return Timestamp of the last record, in recording ticks.
+        uint64_t GetDuration(void) const;
+
+        /// Retrieves the number of records in the recording.
+        /// @return Number of valid records.
+        inline size_t GetRecordCount(void) const
+        {
+          return records.size();
+        }
+
+        /// Retrieves the record at the specified position in the recording.
+        /// @param [in] index Position of the desired record, which must be less than the record
+        /// count.
+        /// @return Read-only reference to the record.
+        inline const SRecord& GetRecord(size_t index) const
+        {
+          return records[index];
+        }
+
+        /// Retrieves the number of records in the recording for the specified physical controller.
+        /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+        /// @return Number of records for the identified controller.
+        size_t GetRecordCountForController(TControllerIdentifier controllerIdentifier) const;
+
+        /// Retrieves the state that the specified physical controller had after the specified
+        /// number of its own state changes were applied, which allows the caller to step through
+        /// the recording one state change at a time regardless of timestamps. Positions past the
+        /// end of the recording hold the last recorded state. Controllers with no records are
+        /// reported as not connected.
+        /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+        /// @param [in] position Zero-based position within the identified controller's records.
+        /// @return Physical controller state as of the specified position.
+        SPhysicalState GetStateAtPosition(
+            TControllerIdentifier controllerIdentifier, size_t position) const;
+
+        /// Retrieves the state that the specified physical controller had as of the specified time
+        /// in the recording. Controllers with no record yet at that time are reported as not
+        /// connected.
+        /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+        /// @param [in] timestamp Time within the recording, in recording ticks.
+        /// @return Physical controller state as of the specified time.
+        SPhysicalState GetStateAt(
+            TControllerIdentifier controllerIdentifier, uint64_t timestamp) const;
+
+        /// Retrieves the state that the specified physical controller has right now, based on the
+        /// time elapsed since the player was created and the configured playback speed. Once the
+        /// end of the recording is reached, the last recorded state is held indefinitely.
+        /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+        /// @return Physical controller state as of the current playback position.
+        SPhysicalState ReadState(TControllerIdentifier controllerIdentifier) const;
+
+        /// Determines if the recording contents were successfully loaded.
+        /// @return `true` if the recording is valid, `false` otherwise.
+        inline bool IsValid(void) const
+        {
+          return isValid;
+        }
+
+      private:
+
+        /// All records in the recording, in timestamp order.
+        std::vector<SRecord> records;
+
+        /// Positions within the record list of the records for each physical controller, in
+        /// timestamp order. Allows state lookups for one controller to be done by binary search.
+        std::array<std::vector<size_t>, kPhysicalControllerCount> recordIndicesByController;
+
+        /// Number of recording timestamp ticks per second.
+        uint64_t timestampFrequency;
+
+        /// Performance counter value at the time playback started.
+        uint64_t playbackStartTimestamp;
+
+        /// Performance counter frequency, in ticks per second.
+        uint64_t playbackTimestampFrequency;
+
+        /// Playback speed as a percentage of the original speed.
+        unsigned int speedPercent;
+
+        /// Whether or not the recording contents were successfully loaded.
+        bool isValid;
+      };
+    } // namespace Recording
+  }   // namespace Controller
+} // namespace Xidi
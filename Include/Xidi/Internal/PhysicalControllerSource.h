@@ -0,0 +1,159 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file PhysicalControllerSource.h
+ *   Declaration of sources from which physical controller state is obtained and to which physical
+ *   force feedback actuator values are sent.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Clock.h"
+#include "ControllerTypes.h"
+#include "ForceFeedbackTypes.h"
+#include "PhysicalControllerRecording.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Interface for objects that supply physical controller state and accept physical force
+    /// feedback actuator values. The physical controller polling and force feedback actuation
+    /// threads communicate exclusively through one such object, so the rest of the input pipeline
+    /// does not depend on where physical controller state actually comes from. Implementations
+    /// must be concurrency-safe, as each physical controller has its own threads.
+    class IPhysicalControllerSource
+    {
+    public:
+
+      virtual ~IPhysicalControllerSource(void) = default;
+
+      /// Determines whether or not this source communicates with real hardware. Hardware-related
+      /// optimizations, such as backing off while a controller is disconnected and listening for
+      /// device arrival notifications, are only worthwhile for sources that do.
+      /// @return `true` if this source is backed by hardware, `false` otherwise.
+      virtual bool IsBackedByHardware(void) const = 0;
+
+      /// Reads the current state of the specified physical controller.
+      /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+      /// @return Physical state of the identified controller.
+      virtual SPhysicalState ReadState(TControllerIdentifier controllerIdentifier) = 0;
+
+      /// Writes physical force feedback actuator values to the specified physical controller.
+      /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+      /// @param [in] vibration Physical actuator vibration vector.
+      /// @return `true` if successful, `false` otherwise.
+      virtual bool WriteVibration(
+          TControllerIdentifier controllerIdentifier,
+          ForceFeedback::SPhysicalActuatorComponents vibration) = 0;
+    };
+
+    /// Communicates with physical controllers using the XInput API.
+    class XInputPhysicalControllerSource : public IPhysicalControllerSource
+    {
+    public:
+
+      // IPhysicalControllerSource
+      bool IsBackedByHardware(void) const override;
+      SPhysicalState ReadState(TControllerIdentifier controllerIdentifier) override;
+      bool WriteVibration(
+          TControllerIdentifier controllerIdentifier,
+          ForceFeedback::SPhysicalActuatorComponents vibration) override;
+    };
+
+    /// Holds the parameters that control how synthetic physical controller state is generated.
+    struct SSyntheticSourceParameters
+    {
+      /// Number of milliseconds for analog sticks and triggers to complete one full sweep of their
+      /// range of motion. Must be non-zero.
+      unsigned int sweepPeriodMilliseconds = 2000;
+
+      /// Number of times per second that the set of pressed buttons changes. A value of 0 means
+      /// buttons are never pressed.
+      unsigned int buttonMashRatePerSecond = 10;
+
+      /// Seed for the pseudo-random sequence of pressed buttons.
+      uint32_t seed = 0;
+    };
+
+    /// Generates synthetic physical controller state, without any hardware involvement. All
+    /// physical controllers are reported as connected. Analog sticks sweep around the edge of their
+    /// range of motion following sine waves, triggers sweep back and forth across their range of
+    /// motion, and buttons are mashed pseudo-randomly at a fixed rate. Each controller is offset in
+    /// phase from the others. Generated state is a pure function of elapsed time, so it is fully
+    /// reproducible. Force feedback actuator values are accepted and discarded.
+    class SyntheticPhysicalControllerSource : public IPhysicalControllerSource
+    {
+    public:
+
+      SyntheticPhysicalControllerSource(const SSyntheticSourceParameters& parameters);
+
+      /// Computes the state that the specified physical controller has at the specified time.
+      /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+      /// @param [in] elapsedMilliseconds Time since generation started, in milliseconds.
+      /// @return Physical controller state at the specified time.
+      SPhysicalState GetStateAt(
+          TControllerIdentifier controllerIdentifier, uint64_t elapsedMilliseconds) const;
+
+      // IPhysicalControllerSource
+      bool IsBackedByHardware(void) const override;
+      SPhysicalState ReadState(TControllerIdentifier controllerIdentifier) override;
+      bool WriteVibration(
+          TControllerIdentifier controllerIdentifier,
+          ForceFeedback::SPhysicalActuatorComponents vibration) override;
+
+    private:
+
+      /// Parameters that control state generation.
+      SSyntheticSourceParameters parameters;
+
+      /// Time at which generation started.
+      Clock::TTimestamp startTime;
+    };
+
+    /// Replays physical controller state changes from a recording. Force feedback actuator values
+    /// are accepted and discarded.
+    class ReplayPhysicalControllerSource : public IPhysicalControllerSource
+    {
+    public:
+
+      /// Initialization constructor.
+      /// @param [in] player Player that supplies the recording to be replayed.
+      /// @param [in] stepped Whether or not to step through the recording instead of following
+      /// wall-clock time. If so, each read of a physical controller's state produces that
+      /// controller's next recorded state, so the sequence of states read is the same every time
+      /// the recording is replayed no matter how quickly they are read.
+      ReplayPhysicalControllerSource(
+          std::unique_ptr<Recording::Player>&& player, bool stepped = false);
+
+      // IPhysicalControllerSource
+      bool IsBackedByHardware(void) const override;
+      SPhysicalState ReadState(TControllerIdentifier controllerIdentifier) override;
+      bool WriteVibration(
+          TControllerIdentifier controllerIdentifier,
+          ForceFeedback::SPhysicalActuatorComponents vibration) override;
+
+    private:
+
+      /// Player that supplies the replayed physical controller states.
+      std::unique_ptr<Recording::Player> player;
+
+      /// Whether or not replay steps through the recording instead of following wall-clock time.
+      bool stepped;
+
+      /// Position of the next state to be read for each physical controller, when stepping. Each
+      /// physical controller's state is only ever read by one thread at a time.
+      std::array<std::atomic<size_t>, kPhysicalControllerCount> nextPosition;
+    };
+  } // namespace Controller
+} // namespace Xidi
@@ -0,0 +1,185 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ReadCopyUpdate.h
+ *   Utility template for publishing read-only objects that can be replaced while they are being
+ *   read, without readers ever waiting on a lock.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Xidi
+{
+  /// Publishes a read-only object that can be replaced at any time by a new version of itself,
+  /// following the read-copy-update pattern. Readers never wait on a lock: they announce
+  /// themselves by incrementing a counter associated with the current generation, then read the
+  /// object published for that generation. Writers publish a new object under a new generation,
+  /// wait for all readers of the previous generation to finish, and only then hand the previous
+  /// object back to the caller, at which point it can safely be destroyed. Writers may therefore
+  /// wait for readers, but readers never wait for writers, and the only way a reader can be
+  /// delayed is by retrying its announcement if a writer publishes at the exact same time.
+  /// @tparam ObjectType Type of object being published.
+  template <typename ObjectType> class ReadCopyUpdate
+  {
+  public:
+
+    /// Provides read access to a published object for as long as it exists. The object is
+    /// guaranteed not to be destroyed during that time, even if it is replaced by a newer object.
+    /// Read guards should be short-lived because writers wait for them to be destroyed.
+    class ReadGuard
+    {
+    public:
+
+      ReadGuard(const ReadGuard& other) = delete;
+
+      ~ReadGuard(void)
+      {
+        readerCount->fetch_sub(1, std::memory_order_release);
+      }
+
+      /// Retrieves the published object.
+      /// @return Read-only pointer to the published object.
+      inline const ObjectType* Get(void) const
+      {
+        return object;
+      }
+
+      /// Retrieves the generation under which the published object was published. Generations
+      /// start at 0 and increase by 1 with every new object that is published, so two reads that
+      /// obtained the same generation were given the same object.
+      /// @return Generation of the published object.
+      inline uint64_t GetGeneration(void) const
+      {
+        return generation;
+      }
+
+      /// Provides member access to the published object.
+      /// @return Read-only pointer to the published object.
+      inline const ObjectType* operator->(void) const
+      {
+        return object;
+      }
+
+      /// Dereferences the published object.
+      /// @return Read-only reference to the published object.
+      inline const ObjectType& operator*(void) const
+      {
+        return *object;
+      }
+
+    private:
+
+      /// Initialization constructor. Objects can only be created by #ReadCopyUpdate::Read, which
+      /// has already announced the reader using the specified counter.
+      /// @param [in] readerCount Counter that was incremented to announce the reader.
+      /// @param [in] object Published object being read.
+      /// @param [in] generation Generation of the published object.
+      inline ReadGuard(
+          std::atomic<unsigned int>* readerCount, const ObjectType* object, uint64_t generation)
+          : readerCount(readerCount), object(object), generation(generation)
+      {}
+
+      friend class ReadCopyUpdate;
+
+      /// Counter to decrement when the reader is finished.
+      std::atomic<unsigned int>* readerCount;
+
+      /// Published object being read.
+      const ObjectType* object;
+
+      /// Generation of the published object.
+      uint64_t generation;
+    };
+
+    /// Initialization constructor. Publishes the specified object as generation 0.
+    /// @param [in] initialObject Object to publish, which becomes owned by this object.
+    explicit ReadCopyUpdate(std::unique_ptr<const ObjectType> initialObject)
+        : generation(0), readerCount(), publishedObject()
+    {
+      publishedObject[0].store(initialObject.release(), std::memory_order_relaxed);
+    }
+
+    ReadCopyUpdate(const ReadCopyUpdate& other) = delete;
+
+    ~ReadCopyUpdate(void)
+    {
+      delete publishedObject[generation.load(std::memory_order_relaxed) & 1].load(
+          std::memory_order_relaxed);
+    }
+
+    /// Publishes a new object, replacing the currently-published object. Readers that obtain
+    /// access after this method returns see the new object. Waits for all readers of the
+    /// previous object to finish before returning it. Concurrent writers are serialized, but
+    /// none of this affects readers.
+    /// @param [in] newObject Object to publish, which becomes owned by this object.
+    /// @return Previously-published object, which is no longer in use by any reader and is now
+    /// owned by the caller.
+    std::unique_ptr<const ObjectType> Publish(std::unique_ptr<const ObjectType> newObject)
+    {
+      std::scoped_lock lock(writerMutex);
+
+      // Readers only ever use the slot that matches the parity of the current generation, so the
+      // other slot can be written freely. Any reader that announced itself under the other
+      // parity will notice that the generation has since changed and retry.
+      const uint64_t oldGeneration = generation.load(std::memory_order_relaxed);
+      const uint64_t newGeneration = 1 + oldGeneration;
+
+      std::unique_ptr<const ObjectType> oldObject(
+          publishedObject[oldGeneration & 1].load(std::memory_order_relaxed));
+      publishedObject[newGeneration & 1].store(newObject.release(), std::memory_order_relaxed);
+      generation.store(newGeneration, std::memory_order_seq_cst);
+
+      while (0 != readerCount[oldGeneration & 1].load(std::memory_order_seq_cst))
+        std::this_thread::yield();
+
+      return oldObject;
+    }
+
+    /// Obtains read access to the currently-published object. Never waits on a lock.
+    /// @return Read guard through which the published object can be accessed.
+    ReadGuard Read(void) const
+    {
+      while (true)
+      {
+        const uint64_t readGeneration = generation.load(std::memory_order_seq_cst);
+        std::atomic<unsigned int>& announcement = readerCount[readGeneration & 1];
+
+        // Announcing before checking the generation again guarantees that either the writer sees
+        // the announcement and waits for it, or this reader sees the new generation and retries.
+        announcement.fetch_add(1, std::memory_order_seq_cst);
+        if (readGeneration == generation.load(std::memory_order_seq_cst))
+          return ReadGuard(
+              &announcement,
+              publishedObject[readGeneration & 1].load(std::memory_order_relaxed),
+              readGeneration);
+
+        announcement.fetch_sub(1, std::memory_order_release);
+      }
+    }
+
+  private:
+
+    /// Generation of the currently-published object.
+    std::atomic<uint64_t> generation;
+
+    /// Number of readers that announced themselves under each generation parity.
+    mutable std::atomic<unsigned int> readerCount[2];
+
+    /// Published object for each generation parity. Only the slot that matches the parity of the
+    /// current generation is valid.
+    std::atomic<const ObjectType*> publishedObject[2];
+
+    /// Serializes writers.
+    std::mutex writerMutex;
+  };
+} // namespace Xidi
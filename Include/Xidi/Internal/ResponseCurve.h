@@ -0,0 +1,158 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ResponseCurve.h
+ *   Declaration of response curves that reshape analog values before they are contributed to
+ *   virtual controller axes.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <limits>
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Non-linear response curve applied to analog stick and trigger values by axis mappers. A curve
+    /// maps the displacement of a value from neutral to a new displacement, preserving its sign, and
+    /// always maps neutral to neutral and extreme to extreme. Each curve is compiled once into
+    /// lookup tables that hold the result for every possible input value, so applying a curve is a
+    /// single indexed load regardless of its shape. Because raw deadzone and saturation are applied
+    /// to physical controller values before any element mapper sees them, curves compose with those
+    /// transformations simply by being applied afterwards. Objects are built on first request and
+    /// shared by all users of the same curve for the lifetime of the process.
+    class ResponseCurve
+    {
+    public:
+
+      /// Enumerates the supported shapes of response curves.
+      enum class EType : uint8_t
+      {
+        /// Output displacement is the input displacement raised to a power, specified as a
+        /// percentage. Exponents above 100 reduce sensitivity near neutral, and exponents below
+        /// 100 increase it.
+        Exponential,
+
+        /// Output displacement follows a smooth S-shaped curve, which reduces sensitivity both
+        /// near neutral and near the extremes. Strength is specified as a percentage, with 100
+        /// being a full smoothstep curve and smaller values blending it with a linear response.
+        SCurve,
+
+        /// Output displacement is linearly interpolated between user-supplied control points,
+        /// each of which is expressed as a pair of input and output percentages.
+        Piecewise
+      };
+
+      /// Minimum exponent percentage allowed for exponential curves.
+      static constexpr unsigned int kExponentPercentMin = 10;
+
+      /// Maximum exponent percentage allowed for exponential curves.
+      static constexpr unsigned int kExponentPercentMax = 1000;
+
+      /// Minimum strength percentage allowed for S-curves.
+      static constexpr unsigned int kStrengthPercentMin = 1;
+
+      /// Maximum strength percentage allowed for S-curves.
+      static constexpr unsigned int kStrengthPercentMax = 100;
+
+      /// Maximum number of control points allowed for piecewise curves, not including the implied
+      /// control points at neutral and at the extreme.
+      static constexpr unsigned int kPiecewisePointCountMax = 8;
+
+      /// Single control point of a piecewise curve.
+      struct SPoint
+      {
+        /// Input displacement from neutral, as a percentage of the full displacement.
+        uint8_t inputPercent;
+
+        /// Output displacement from neutral, as a percentage of the full displacement.
+        uint8_t outputPercent;
+
+        constexpr auto operator<=>(const SPoint& other) const = default;
+      };
+
+      /// Complete description of a response curve. Two curves with equal descriptions produce
+      /// identical results and are therefore represented by the same object.
+      struct SSpec
+      {
+        /// Shape of the curve.
+        EType type;
+
+        /// Shape-specific parameter. Exponent percentage for exponential curves, strength
+        /// percentage for S-curves, and unused for piecewise curves.
+        unsigned int parameter;
+
+        /// Number of valid control points, for piecewise curves.
+        unsigned int pointCount;
+
+        /// Control points, for piecewise curves, in strictly increasing order of input.
+        std::array<SPoint, kPiecewisePointCountMax> points;
+
+        constexpr auto operator<=>(const SSpec& other) const = default;
+      };
+
+      /// Retrieves the compiled form of the specified curve, building it if this is the first
+      /// request for that curve. Concurrency-safe. The curve description must already have been
+      /// validated, typically by the mapper parser.
+      /// @param [in] spec Description of the desired curve.
+      /// @return Read-only reference to the compiled curve, which remains valid indefinitely.
+      static const ResponseCurve& Get(const SSpec& spec);
+
+      /// Evaluates the specified curve directly, without using any lookup table. This is the
+      /// reference against which compiled curves are built and is far too slow for use on the hot
+      /// path.
+      /// @param [in] spec Description of the curve.
+      /// @param [in] displacement Input displacement from neutral, normalized to the range 0 to 1.
+      /// @return Output displacement from neutral, normalized to the range 0 to 1.
+      static double EvaluateNormalized(const SSpec& spec, double displacement);
+
+      /// Applies this curve to an analog value.
+      /// @param [in] analogValue Analog value to transform.
+      /// @return Transformed analog value.
+      inline int16_t ApplyToAnalog(int16_t analogValue) const
+      {
+        return analogValues[(uint16_t)analogValue];
+      }
+
+      /// Applies this curve to a trigger value.
+      /// @param [in] triggerValue Trigger value to transform.
+      /// @return Transformed trigger value.
+      inline uint8_t ApplyToTrigger(uint8_t triggerValue) const
+      {
+        return triggerValues[triggerValue];
+      }
+
+      /// Retrieves the description of this curve.
+      /// @return Read-only reference to the curve description.
+      inline const SSpec& GetSpec(void) const
+      {
+        return spec;
+      }
+
+    private:
+
+      /// Fills the lookup tables by evaluating the curve for every possible analog and trigger
+      /// value. Objects are only created by #Get.
+      /// @param [in] spec Description of the curve.
+      ResponseCurve(const SSpec& spec);
+
+      /// Description of this curve.
+      SSpec spec;
+
+      /// Transformed analog values, indexed by the bit pattern of the input analog value
+      /// reinterpreted as unsigned.
+      std::array<int16_t, 1 + std::numeric_limits<uint16_t>::max()> analogValues;
+
+      /// Transformed trigger values, indexed by the input trigger value.
+      std::array<uint8_t, 1 + std::numeric_limits<uint8_t>::max()> triggerValues;
+    };
+  } // namespace Controller
+} // namespace Xidi
@@ -0,0 +1,102 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file SeqLock.h
+ *   Utility template for publishing small values that can be read concurrently with being
+ *   written, without readers ever waiting on a lock.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Xidi
+{
+  /// Holds a copy of a small value that supports one writer at a time and any number of concurrent
+  /// readers, following the sequence lock pattern. The value is protected by a sequence counter
+  /// that is odd while a write is in progress, and readers simply retry if they observe a write in
+  /// progress or if the counter changes while they are copying the value. Readers therefore never
+  /// wait on a lock and never modify any shared data, which makes reads very cheap when writes are
+  /// infrequent relative to reads. Writers must be serialized externally.
+  /// @tparam ValueType Type of value being published, which must be trivially copyable.
+  template <typename ValueType> class SeqLock
+  {
+  public:
+
+    static_assert(
+        std::is_trivially_copyable_v<ValueType>, "Sequence-locked values must be trivially copyable.");
+
+    /// Initialization constructor. Publishes the specified value.
+    /// @param [in] initialValue Value to publish.
+    explicit SeqLock(const ValueType& initialValue = ValueType()) : sequence(0), valueWords()
+    {
+      Store(initialValue);
+    }
+
+    SeqLock(const SeqLock& other) = delete;
+
+    /// Retrieves a consistent copy of the published value. Never waits on a lock.
+    /// @return Copy of the published value.
+    ValueType Load(void) const
+    {
+      uint64_t words[kValueWordCount];
+
+      while (true)
+      {
+        const uint32_t sequenceBefore = sequence.load(std::memory_order_acquire);
+        if (0 != (sequenceBefore & 1)) continue;
+
+        for (size_t i = 0; i < kValueWordCount; ++i)
+          words[i] = valueWords[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequenceBefore == sequence.load(std::memory_order_relaxed)) break;
+      }
+
+      ValueType value;
+      std::memcpy(&value, words, sizeof(value));
+      return value;
+    }
+
+    /// Publishes a new value, replacing the currently-published value. Only one thread at a time
+    /// is allowed to store.
+    /// @param [in] newValue Value to publish.
+    void Store(const ValueType& newValue)
+    {
+      uint64_t words[kValueWordCount] = {};
+      std::memcpy(words, &newValue, sizeof(newValue));
+
+      const uint32_t sequenceBefore = sequence.load(std::memory_order_relaxed);
+      sequence.store(sequenceBefore + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+
+      for (size_t i = 0; i < kValueWordCount; ++i)
+        valueWords[i].store(words[i], std::memory_order_relaxed);
+
+      sequence.store(sequenceBefore + 2, std::memory_order_release);
+    }
+
+  private:
+
+    /// Number of 64-bit words needed to hold the value.
+    static constexpr size_t kValueWordCount =
+        (sizeof(ValueType) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    /// Incremented before and after each write, so it is odd while a write is in progress.
+    std::atomic<uint32_t> sequence;
+
+    /// Contents of the published value. Stored as atomic words so that a reader racing with the
+    /// writer observes a torn value, which the sequence counter detects, rather than undefined
+    /// behavior.
+    std::array<std::atomic<uint64_t>, kValueWordCount> valueWords;
+  };
+} // namespace Xidi
@@ -0,0 +1,54 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file StateChangeDispatcher.h
+ *   Declaration of the mechanism by which raw virtual controller state changes are delivered to
+ *   all of the virtual controller objects associated with each physical controller.
+ **************************************************************************************************/
+
+#pragma once
+
+#include "ControllerTypes.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    class VirtualControllerCore;
+
+    namespace StateChangeDispatcher
+    {
+      /// Delivers a raw virtual controller state to the virtual controller core registered with
+      /// the specified physical controller, if there is one, in the calling thread. The core in
+      /// turn updates all of the virtual controller objects attached to it. Intended to be invoked
+      /// by whichever thread produces raw virtual controller states for the physical controller,
+      /// once per change. Concurrency-safe.
+      /// @param [in] controllerIdentifier Identifier of the physical controller whose state
+      /// changed.
+      /// @param [in] rawVirtualState New raw virtual controller state.
+      void Dispatch(TControllerIdentifier controllerIdentifier, const SState& rawVirtualState);
+
+      /// Registers a virtual controller core to receive state changes from the specified physical
+      /// controller, replacing any core that is already registered. The core is immediately
+      /// updated using the current raw virtual controller state, while holding the same lock that
+      /// serializes dispatches, so that no state change can be missed between when the core is
+      /// created and when it is registered. Constant time and concurrency-safe.
+      /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+      /// @param [in] core Virtual controller core to register. Must remain valid until it is
+      /// unregistered.
+      void Register(TControllerIdentifier controllerIdentifier, VirtualControllerCore& core);
+
+      /// Unregisters a virtual controller core so that it no longer receives state changes from
+      /// the specified physical controller. Once this function returns, no dispatch to the core is
+      /// in progress and none will be started, so the core can safely be destroyed. Constant time
+      /// and concurrency-safe. Does nothing if the core is not the one registered.
+      /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+      /// @param [in] core Virtual controller core previously passed to #Register.
+      void Unregister(TControllerIdentifier controllerIdentifier, VirtualControllerCore& core);
+    } // namespace StateChangeDispatcher
+  } // namespace Controller
+} // namespace Xidi
@@ -11,10 +11,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 
-#include <boost/circular_buffer.hpp>
-
+#include "Clock.h"
 #include "ControllerTypes.h"
 
 namespace Xidi
@@ -22,10 +29,20 @@ namespace Xidi
   namespace Controller
   {
     /// Implements a state change event buffer for a virtual controller. Used for providing buffered
-    /// event functionality. Methods are not concurrency-safe, so some form of external concurrency
-    /// control is required. Behavior is modelled after DirectInput buffered event documentation.
+    /// event functionality. Behavior is modelled after DirectInput buffered event documentation.
     /// For example, number of events stored is artificially limited to one less than declared
-    /// capacity.
+    /// capacity. Events are held in a ring that supports one producer, which appends events, and
+    /// any number of consumers, which read and remove them, without either side ever waiting for
+    /// the other. Consumers copy events optimistically and retry if the producer discarded any of
+    /// them while they were being copied. Optionally, axis events can be coalesced: an axis event
+    /// whose element already has an unread event, with no button or POV event appended after it,
+    /// updates that event in place instead of being appended. This bounds the number of buffered
+    /// events by the number of controller elements, rather than by the rate at which the physical
+    /// controller produces input, so that high-rate axis movement cannot push button and POV
+    /// events out of the buffer. Consumers briefly retry while the producer is updating an event
+    /// in place, but the producer still never waits for consumers. Changing the capacity is the
+    /// only operation that needs exclusive access: consumers are excluded internally, but the
+    /// caller must make sure that no events are appended concurrently.
     class StateChangeEventBuffer
     {
     public:
@@ -79,8 +96,9 @@ namespace Xidi
         /// Event data, including virtual controller element and updated value.
         SEventData data;
 
-        /// System time in milliseconds when the event was generated.
-        uint32_t timestamp;
+        /// Clock timestamp when the event was generated. Converted to the millisecond timestamps
+        /// that applications expect only when events are presented to them.
+        Clock::TTimestamp timestamp;
 
         /// Chronological sequence number of this event. Supposed to be globally monotonic with
         /// respect to all other input events, but in practice it is locally monotonic with respect
@@ -88,7 +106,17 @@ namespace Xidi
         uint32_t sequence;
       };
 
-      static_assert(sizeof(SEvent) <= 16, "Data structure size constraint violation.");
+      static_assert(sizeof(SEvent) <= 24, "Data structure size constraint violation.");
+
+      /// Result of reading events from the event buffer.
+      struct SReadResult
+      {
+        /// Number of events read.
+        uint32_t numEvents;
+
+        /// Whether or not an overflow condition was present when the events were read.
+        bool overflowed;
+      };
 
       /// Maximum allowed event buffer capacity, measured in number of events. Computed to allow a
       /// maximum of 1MB for event storage.
@@ -96,34 +124,63 @@ namespace Xidi
 
       /// Constructs an empty event buffer with capacity of 0, which means this event buffer is
       /// disabled until it is enabled by request.
-      inline StateChangeEventBuffer(void) : eventBuffer(), eventBufferOverflowed() {}
+      /// @param [in] coalesceAxisEvents Whether or not axis events should be coalesced.
+      inline StateChangeEventBuffer(bool coalesceAxisEvents = false)
+          : kCoalesceAxisEvents(coalesceAxisEvents),
+            capacityMutex(),
+            slots(),
+            capacity(0),
+            readState(0),
+            writeIndex(0),
+            coalescableAxisEventIndex()
+      {
+        coalescableAxisEventIndex.fill(kNoCoalescableEvent);
+      }
 
       /// Allows read-only access to events by index, without performing any bounds-checking. Event
-      /// with index 0 is the oldest, and higher indices indicate more recent events.
+      /// with index 0 is the oldest, and higher indices indicate more recent events. Events
+      /// obtained this way are not guaranteed to be consistent with one another if events are being
+      /// appended concurrently, so consumers should generally use #ReadOldestEvents instead.
       /// @param [in] index Index of the desired event.
-      /// @return Read-only reference to the event at the desired index.
-      inline const SEvent& operator[](uint32_t index) const
+      /// @return Copy of the event at the desired index.
+      inline SEvent operator[](uint32_t index) const
       {
-        return eventBuffer[index];
+        std::shared_lock lock(capacityMutex);
+        return LoadEvent(ReadIndex(readState.load(std::memory_order_acquire)) + index);
       }
 
-      /// Appends a single event to the event buffer, given its data.
+      /// Appends a single event to the event buffer, given its data. Only one thread at a time is
+      /// allowed to append, and it never waits for consumers. If axis events are being coalesced
+      /// and the event can be merged into an unread event for the same axis, that event receives
+      /// the new value and timestamp but keeps its position and sequence number, so events remain
+      /// in sequence order.
       /// @param [in] eventData Event data to append.
       /// @param [in] timestamp Timestamp to apply to the appended event.
-      void AppendEvent(SEventData eventData, uint32_t timestamp);
+      void AppendEvent(SEventData eventData, Clock::TTimestamp timestamp);
 
       /// Retrieves and returns the capacity of this event buffer.
       /// @return Event buffer capacity.
       inline uint32_t GetCapacity(void) const
       {
-        return (uint32_t)eventBuffer.capacity();
+        return capacity.load(std::memory_order_relaxed);
+      }
+
+      /// Checks if this event buffer coalesces axis events.
+      /// @return `true` if axis events are coalesced, `false` if every event is appended.
+      inline bool IsCoalescingAxisEvents(void) const
+      {
+        return kCoalesceAxisEvents;
       }
 
       /// Retrieves and returns the number of events currently present in this event buffer.
       /// @return Event count in this event buffer.
       inline uint32_t GetCount(void) const
       {
-        return (uint32_t)eventBuffer.size();
+        std::shared_lock lock(capacityMutex);
+
+        // The read index is loaded first because it never passes the write index.
+        const uint64_t readIndex = ReadIndex(readState.load(std::memory_order_acquire));
+        return (uint32_t)(writeIndex.load(std::memory_order_acquire) - readIndex);
       }
 
       /// Checks if this event buffer is enabled.
@@ -137,7 +194,7 @@ namespace Xidi
       /// @return `true` if an overflow condition is present, `false` otherwise.
       inline bool IsOverflowed(void) const
       {
-        return eventBufferOverflowed;
+        return (0 != (readState.load(std::memory_order_acquire) & kOverflowFlag));
       }
 
       /// Removes and discards the oldest events from the buffer and clears any present overflow
@@ -146,6 +203,83 @@ namespace Xidi
       /// @param [in] numEventsToPop Maximum number of events to remove.
       void PopOldestEvents(uint32_t numEventsToPop);
 
+      /// Reads a consistent snapshot of up to the specified number of the oldest events, optionally
+      /// removing them from the buffer in the same step. Removing a non-zero number of events
+      /// clears any present overflow condition, exactly as #PopOldestEvents does, whereas peeking
+      /// at the events leaves the buffer completely untouched. Never waits for the producer. The
+      /// visitor is invoked once per event, oldest first, with the index of the event relative to
+      /// the oldest event and a copy of the event. If the producer discards events while they are
+      /// being read then the entire read is retried, in which case the visitor is invoked again
+      /// starting from index 0, so it should simply overwrite any output it already produced. The
+      /// same happens if the producer coalesces into an event while events are being read.
+      /// @tparam EventVisitor Callable type that accepts an index and a read-only event reference.
+      /// @param [in] numEventsMax Maximum number of events to read.
+      /// @param [in] removeEvents Whether or not the events that are read should also be removed.
+      /// @param [in] visitor Callable object to be invoked for each event that is read.
+      /// @return Number of events read and whether or not an overflow condition was present.
+      template <typename EventVisitor> SReadResult ReadOldestEvents(
+          uint32_t numEventsMax, bool removeEvents, EventVisitor visitor)
+      {
+        std::shared_lock lock(capacityMutex);
+
+        while (true)
+        {
+          const uint64_t readStateSnapshot = readState.load(std::memory_order_acquire);
+
+          // The producer is in the middle of coalescing into an event, which takes only a moment.
+          if (0 != (readStateSnapshot & kCoalescingFlag))
+          {
+            std::this_thread::yield();
+            continue;
+          }
+
+          const uint64_t readIndex = ReadIndex(readStateSnapshot);
+          const uint32_t numEvents = (uint32_t)std::min(
+              (uint64_t)numEventsMax, writeIndex.load(std::memory_order_acquire) - readIndex);
+
+          // Events are copied in chunks and each chunk is validated before it is visited, so the
+          // visitor never observes an event that the producer was in the middle of overwriting.
+          bool snapshotIsConsistent = true;
+          for (uint32_t chunkBase = 0; chunkBase < numEvents; chunkBase += kReadChunkSize)
+          {
+            std::array<SEvent, kReadChunkSize> chunk;
+            const uint32_t chunkSize = std::min(numEvents - chunkBase, kReadChunkSize);
+
+            for (uint32_t i = 0; i < chunkSize; ++i)
+              chunk[i] = LoadEvent(readIndex + chunkBase + i);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (readState.load(std::memory_order_relaxed) != readStateSnapshot)
+            {
+              snapshotIsConsistent = false;
+              break;
+            }
+
+            for (uint32_t i = 0; i < chunkSize; ++i)
+              visitor(chunkBase + i, chunk[i]);
+          }
+
+          if (false == snapshotIsConsistent) continue;
+
+          if ((true == removeEvents) && (numEvents > 0))
+          {
+            // Fails if the producer discarded or coalesced into an event or another consumer
+            // removed events since the snapshot was taken, in which case the events that were
+            // visited are stale.
+            uint64_t expectedReadState = readStateSnapshot;
+            if (false ==
+                readState.compare_exchange_strong(
+                    expectedReadState,
+                    WithReadIndex(readStateSnapshot & ~kOverflowFlag, readIndex + numEvents),
+                    std::memory_order_acq_rel))
+              continue;
+          }
+
+          return {
+              .numEvents = numEvents, .overflowed = (0 != (readStateSnapshot & kOverflowFlag))};
+        }
+      }
+
       /// Sets the capacity of this event buffer.
       /// Disables this event buffer if the specified capacity is equal to 0.
       /// Sets the capacity to #kEventBufferCapacityMax if the specified capacity is greater than
@@ -153,19 +287,138 @@ namespace Xidi
       /// event buffer, an overflow condition is triggered and the oldest excess events are
       /// discarded. Buffer always maintains one free space, so the actual number of events stored
       /// is one less than capacity. This is to be consistent with documentation for
-      /// IDirectInputDevice8::GetDeviceData.
-      /// @param [in] capacity Desired event buffer capacity.
-      void SetCapacity(uint32_t capacity);
+      /// IDirectInputDevice8::GetDeviceData. Must not be invoked concurrently with #AppendEvent.
+      /// @param [in] newCapacity Desired event buffer capacity.
+      void SetCapacity(uint32_t newCapacity);
 
     private:
 
-      /// Underlying event buffer object. Holds all individual event elements.
-      boost::circular_buffer<SEvent> eventBuffer;
+      /// Number of 64-bit words needed to hold one event.
+      static constexpr size_t kEventWordCount =
+          (sizeof(SEvent) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+      /// Number of events that consumers copy and validate at a time.
+      static constexpr uint32_t kReadChunkSize = 32;
+
+      /// Bit within the read state that holds the overflow flag.
+      static constexpr uint64_t kOverflowFlag = (1ull << 63);
+
+      /// Bit within the read state that is set while the producer is coalescing into an event.
+      /// Consumers do not read or remove events while it is set.
+      static constexpr uint64_t kCoalescingFlag = (1ull << 62);
+
+      /// Bits within the read state that hold the modification count, which the producer
+      /// increments whenever it coalesces into an event, so that consumers holding an older copy
+      /// of that event cannot remove it.
+      static constexpr uint64_t kModificationCountMask = (0x3fffull << 48);
+
+      /// Amount by which the read state changes when the modification count is incremented.
+      static constexpr uint64_t kModificationCountIncrement = (1ull << 48);
+
+      /// Bits within the read state that hold the read index.
+      static constexpr uint64_t kReadIndexMask = ((1ull << 48) - 1);
+
+      /// Placeholder position indicating that no event can be coalesced into.
+      static constexpr uint64_t kNoCoalescableEvent = UINT64_MAX;
+
+      /// Single slot in the ring. Consumers copy events out of slots without synchronizing with the
+      /// producer and only afterwards check the read state to find out whether the copy is usable,
+      /// which is why the contents are held as atomic words.
+      struct SSlot
+      {
+        std::array<std::atomic<uint64_t>, kEventWordCount> eventWords;
+      };
+
+      /// Extracts the read index from a read state value.
+      /// @param [in] readStateValue Read state value.
+      /// @return Read index, which is the position of the oldest event in the sequence of all
+      /// events ever appended since the capacity was last set.
+      static constexpr uint64_t ReadIndex(uint64_t readStateValue)
+      {
+        return (readStateValue & kReadIndexMask);
+      }
+
+      /// Replaces the read index in a read state value, leaving the other fields unchanged.
+      /// @param [in] readStateValue Read state value.
+      /// @param [in] newReadIndex New read index.
+      /// @return Updated read state value.
+      static constexpr uint64_t WithReadIndex(uint64_t readStateValue, uint64_t newReadIndex)
+      {
+        return ((readStateValue & ~kReadIndexMask) | (newReadIndex & kReadIndexMask));
+      }
+
+      /// Increments the modification count in a read state value, wrapping around if needed and
+      /// leaving the other fields unchanged.
+      /// @param [in] readStateValue Read state value.
+      /// @return Updated read state value.
+      static constexpr uint64_t WithNextModificationCount(uint64_t readStateValue)
+      {
+        return ((readStateValue & ~kModificationCountMask) |
+                ((readStateValue + kModificationCountIncrement) & kModificationCountMask));
+      }
+
+      /// Attempts to coalesce an axis event into an existing unread event, which keeps its position
+      /// and sequence number. Only invoked by the producer.
+      /// @param [in] index Position of the existing event.
+      /// @param [in] eventData New event data, which must refer to the same axis.
+      /// @param [in] timestamp New timestamp.
+      /// @return `true` if the event was coalesced, `false` if the existing event was already
+      /// removed and so the new event needs to be appended instead.
+      bool CoalesceEvent(uint64_t index, SEventData eventData, Clock::TTimestamp timestamp);
+
+      /// Copies the event at the specified position out of its slot, without any validation.
+      /// @param [in] index Position of the event in the sequence of all events ever appended.
+      /// @return Copy of the event.
+      inline SEvent LoadEvent(uint64_t index) const
+      {
+        const SSlot& slot = slots[index % capacity.load(std::memory_order_relaxed)];
+
+        uint64_t eventWords[kEventWordCount];
+        for (size_t i = 0; i < kEventWordCount; ++i)
+          eventWords[i] = slot.eventWords[i].load(std::memory_order_relaxed);
+
+        SEvent event;
+        std::memcpy(&event, eventWords, sizeof(event));
+        return event;
+      }
 
-      /// Overflow flag for the event buffer. Set whenever an operation causes the event buffer to
-      /// hit capacity and discard some previously-stored events. Cleared whenever events are
-      /// retrieved such that the event buffer goes below capacity.
-      bool eventBufferOverflowed;
+      /// Writes an event into the slot for the specified position, ordered after any preceding
+      /// read state update so that a consumer copying the slot concurrently can detect that its
+      /// copy is stale. Only invoked by the producer.
+      /// @param [in] index Position of the event in the sequence of all events ever appended.
+      /// @param [in] event Event to write.
+      void StoreEvent(uint64_t index, const SEvent& event);
+
+      /// Whether or not axis events are coalesced.
+      const bool kCoalesceAxisEvents;
+
+      /// Held shared by consumers and exclusively while the capacity is being changed, which is
+      /// the only time the ring storage itself is replaced.
+      mutable std::shared_mutex capacityMutex;
+
+      /// Ring storage, holding a number of slots equal to the capacity. The event at position `i`
+      /// is held in slot `i % capacity`. Because one slot is always kept free, the producer never
+      /// writes to a slot that holds an event that has not already been discarded or removed.
+      std::unique_ptr<SSlot[]> slots;
+
+      /// Capacity of the event buffer, in number of events.
+      std::atomic<uint32_t> capacity;
+
+      /// Read index, which is advanced by consumers when they remove events and by the producer
+      /// when it discards the oldest event due to overflow, combined with the overflow flag, the
+      /// coalescing flag, and the modification count. All are held in the same atomic value so
+      /// that removing events and clearing the overflow condition happen together and cannot race
+      /// with the producer setting it again or coalescing into one of the events being removed.
+      std::atomic<uint64_t> readState;
+
+      /// Write index, which is the position at which the producer will append the next event.
+      /// Only ever modified by the producer.
+      std::atomic<uint64_t> writeIndex;
+
+      /// Position of the most recent event for each axis that was appended after the most recent
+      /// button or POV event, or #kNoCoalescableEvent if there is none. Only used when coalescing
+      /// axis events, and only accessed by the producer.
+      std::array<uint64_t, (int)EAxis::Count> coalescableAxisEventIndex;
     };
   } // namespace Controller
 } // namespace Xidi
@@ -0,0 +1,106 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file StateHistory.h
+ *   Declaration of a lock-free history of recent timestamped virtual controller states.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include "Clock.h"
+#include "ControllerTypes.h"
+#include "SeqLock.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Holds a fixed number of the most recent virtual controller states, each tagged with the time
+    /// at which it took effect, in a ring buffer. Supports one writer and any number of concurrent
+    /// readers. Neither reading nor writing ever blocks: each slot in the ring is protected by a
+    /// sequence counter, and readers simply retry if they observe a slot while it is being written.
+    class StateHistory
+    {
+    public:
+
+      /// Type used for timestamps, which are clock timestamps.
+      using TTimestamp = Clock::TTimestamp;
+
+      /// Number of states retained in the history. Must be a power of two.
+      static constexpr unsigned int kCapacity = 32;
+
+      static_assert(0 == (kCapacity & (kCapacity - 1)), "Capacity must be a power of two.");
+
+      /// Single entry in the history.
+      struct SEntry
+      {
+        /// Position of this entry in the sequence of all entries ever appended, starting at 0.
+        uint64_t index;
+
+        /// Time at which the state took effect.
+        TTimestamp timestamp;
+
+        /// Virtual controller state.
+        SState state;
+      };
+
+      static_assert(
+          std::is_trivially_copyable_v<SEntry>, "History entries must be trivially copyable.");
+
+      /// Retrieves the current time, suitable for use as a timestamp in the history.
+      /// @return Current clock timestamp.
+      static TTimestamp CurrentTimestamp(void);
+
+      /// Converts a number of milliseconds to the equivalent number of timestamp ticks.
+      /// @param [in] milliseconds Number of milliseconds to convert.
+      /// @return Equivalent number of timestamp ticks.
+      static TTimestamp TimestampTicksFromMilliseconds(unsigned int milliseconds);
+
+      /// Appends a new state to the history, replacing the oldest state if the history is full.
+      /// Only one thread at a time is allowed to append.
+      /// @param [in] timestamp Time at which the state took effect. Must not be earlier than the
+      /// timestamp of any state already in the history.
+      /// @param [in] state State to append.
+      void Append(TTimestamp timestamp, const SState& state);
+
+      /// Retrieves the total number of states ever appended to the history.
+      /// @return Number of appended states.
+      inline uint64_t GetAppendCount(void) const
+      {
+        return appendCount.load(std::memory_order_acquire);
+      }
+
+      /// Retrieves a consistent copy of the entry at the specified position in the sequence of all
+      /// entries ever appended.
+      /// @param [in] index Position of the desired entry.
+      /// @return Copy of the entry, if it is still retained in the history.
+      std::optional<SEntry> GetEntry(uint64_t index) const;
+
+      /// Determines what the state was as of the specified time, which is the most recent state
+      /// whose timestamp is not later than the specified time. If the history does not reach back
+      /// far enough, the oldest retained state is the best available approximation and is used.
+      /// @param [in] timestamp Time of interest.
+      /// @return State as of the specified time, or nothing if no state is available. This happens
+      /// if the history is empty and, very rarely, if it changes too quickly while being searched.
+      std::optional<SState> GetStateAsOf(TTimestamp timestamp) const;
+
+    private:
+
+      /// Ring buffer of slots. The entry with index `i` is held in slot `i % kCapacity`.
+      std::array<SeqLock<SEntry>, kCapacity> slots;
+
+      /// Total number of entries ever appended.
+      std::atomic<uint64_t> appendCount = 0;
+    };
+  } // namespace Controller
+} // namespace Xidi
@@ -47,6 +47,9 @@
 // literals. All exist as wide-character strings only.
 #define XIDI_CONFIG_PROPERTIES_PREFIX_DEADZONE_PERCENT   L"DeadzonePercent"
 #define XIDI_CONFIG_PROPERTIES_PREFIX_SATURATION_PERCENT L"SaturationPercent"
+#define XIDI_CONFIG_PROPERTIES_PREFIX_ANTI_DEADZONE_PERCENT L"AntiDeadzonePercent"
+#define XIDI_CONFIG_PROPERTIES_PREFIX_RADIAL             L"Radial"
+#define XIDI_CONFIG_PROPERTIES_PREFIX_CIRCLE_TO_SQUARE   L"CircleToSquare"
 #define XIDI_CONFIG_PROPERTIES_SUFFIX_STICK_LEFT         L"StickLeft"
 #define XIDI_CONFIG_PROPERTIES_SUFFIX_STICK_RIGHT        L"StickRight"
 #define XIDI_CONFIG_PROPERTIES_SUFFIX_TRIGGER_LT         L"TriggerLT"
@@ -94,12 +97,20 @@ namespace Xidi
     /// Configuration file setting for specifying the logging verbosity level.
     inline constexpr std::wstring_view kStrConfigurationSettingLogLevel = L"Level";
 
+    /// Configuration file setting for specifying if input latency tracing is enabled, in which case
+    /// a summary of latency percentiles is periodically output to the log.
+    inline constexpr std::wstring_view kStrConfigurationSettingLogLatencyTrace = L"LatencyTrace";
+
     /// Configuration file section name for mapper-related settings.
     inline constexpr std::wstring_view kStrConfigurationSectionMapper = L"Mapper";
 
     /// Configuration file setting for specifying the mapper type.
     inline constexpr std::wstring_view kStrConfigurationSettingMapperType = L"Type";
 
+    /// Configuration file setting for enabling or disabling reloading of mappers and raw analog
+    /// transformations whenever the configuration file changes.
+    inline constexpr std::wstring_view kStrConfigurationSettingMapperHotReload = L"HotReload";
+
     /// Prefix for configuration file sections that define custom mappers.
     inline constexpr std::wstring_view kStrConfigurationSectionCustomMapperPrefix = L"CustomMapper";
 
@@ -175,6 +186,117 @@ namespace Xidi
             XIDI_CONFIG_PROPERTIES_PREFIX_SATURATION_PERCENT
                 XIDI_CONFIG_PROPERTIES_SUFFIX_TRIGGER_RT;
 
+    /// Configuration file setting for processing the two axes of the left analog stick together as
+    /// a single two-dimensional vector, so that its deadzone and saturation are circular.
+    inline constexpr std::wstring_view kStrConfigurationSettingsPropertiesRadialStickLeft =
+        XIDI_CONFIG_PROPERTIES_PREFIX_RADIAL XIDI_CONFIG_PROPERTIES_SUFFIX_STICK_LEFT;
+
+    /// Configuration file setting for processing the two axes of the right analog stick together
+    /// as a single two-dimensional vector, so that its deadzone and saturation are circular.
+    inline constexpr std::wstring_view kStrConfigurationSettingsPropertiesRadialStickRight =
+        XIDI_CONFIG_PROPERTIES_PREFIX_RADIAL XIDI_CONFIG_PROPERTIES_SUFFIX_STICK_RIGHT;
+
+    /// Configuration file setting for the smallest displacement the left analog stick reports once
+    /// it leaves its radial deadzone, expressed as a percentage of the analog range.
+    inline constexpr std::wstring_view
+        kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickLeft =
+            XIDI_CONFIG_PROPERTIES_PREFIX_ANTI_DEADZONE_PERCENT
+                XIDI_CONFIG_PROPERTIES_SUFFIX_STICK_LEFT;
+
+    /// Configuration file setting for the smallest displacement the right analog stick reports
+    /// once it leaves its radial deadzone, expressed as a percentage of the analog range.
+    inline constexpr std::wstring_view
+        kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickRight =
+            XIDI_CONFIG_PROPERTIES_PREFIX_ANTI_DEADZONE_PERCENT
+                XIDI_CONFIG_PROPERTIES_SUFFIX_STICK_RIGHT;
+
+    /// Configuration file setting for stretching the circular range of the left analog stick so
+    /// that it covers the full square range of the virtual controller's axes.
+    inline constexpr std::wstring_view kStrConfigurationSettingsPropertiesCircleToSquareStickLeft =
+        XIDI_CONFIG_PROPERTIES_PREFIX_CIRCLE_TO_SQUARE XIDI_CONFIG_PROPERTIES_SUFFIX_STICK_LEFT;
+
+    /// Configuration file setting for stretching the circular range of the right analog stick so
+    /// that it covers the full square range of the virtual controller's axes.
+    inline constexpr std::wstring_view
+        kStrConfigurationSettingsPropertiesCircleToSquareStickRight =
+            XIDI_CONFIG_PROPERTIES_PREFIX_CIRCLE_TO_SQUARE
+                XIDI_CONFIG_PROPERTIES_SUFFIX_STICK_RIGHT;
+
+    /// Configuration file setting for presenting virtual controller state to applications as of a
+    /// fixed amount of time in the past, expressed in milliseconds.
+    inline constexpr std::wstring_view
+        kStrConfigurationSettingPropertiesStateSamplingDelayMilliseconds =
+            L"StateSamplingDelayMilliseconds";
+
+    /// Configuration file setting for coalescing buffered axis events, so that an axis event that
+    /// has not yet been read by the application is updated rather than followed by another.
+    inline constexpr std::wstring_view kStrConfigurationSettingPropertiesCoalesceAxisEvents =
+        L"CoalesceAxisEvents";
+
+    /// Configuration file section name for specifying how Xidi communicates with physical
+    /// controllers.
+    inline constexpr std::wstring_view kStrConfigurationSectionPhysicalController =
+        L"PhysicalController";
+
+    /// Configuration file setting for specifying the maximum period between polling attempts for a
+    /// physical controller that is not connected.
+    inline constexpr std::wstring_view
+        kStrConfigurationSettingPhysicalControllerDisconnectedBackoffMaxMilliseconds =
+            L"DisconnectedBackoffMaxMilliseconds";
+
+    /// Configuration file setting for enabling or disabling system device arrival notifications,
+    /// which allow newly-connected physical controllers to be detected without waiting for the
+    /// next polling attempt.
+    inline constexpr std::wstring_view
+        kStrConfigurationSettingPhysicalControllerDeviceArrivalNotification =
+            L"DeviceArrivalNotification";
+
+    /// Configuration file setting for specifying the source of physical controller state.
+    inline constexpr std::wstring_view kStrConfigurationSettingPhysicalControllerSource = L"Source";
+
+    /// Configuration file value for the physical controller source setting that selects XInput,
+    /// which is the default.
+    inline constexpr std::wstring_view kStrConfigurationValuePhysicalControllerSourceXInput =
+        L"XInput";
+
+    /// Configuration file value for the physical controller source setting that selects synthetic
+    /// input generated without any hardware involvement.
+    inline constexpr std::wstring_view kStrConfigurationValuePhysicalControllerSourceSynthetic =
+        L"Synthetic";
+
+    /// Configuration file setting for specifying the number of milliseconds synthetic analog sticks
+    /// and triggers take to sweep their full range of motion.
+    inline constexpr std::wstring_view
+        kStrConfigurationSettingPhysicalControllerSyntheticSweepPeriodMilliseconds =
+            L"SyntheticSweepPeriodMilliseconds";
+
+    /// Configuration file setting for specifying the number of times per second the set of pressed
+    /// synthetic buttons changes.
+    inline constexpr std::wstring_view
+        kStrConfigurationSettingPhysicalControllerSyntheticButtonMashRate =
+            L"SyntheticButtonMashRate";
+
+    /// Configuration file section name for recording and replaying physical controller input.
+    inline constexpr std::wstring_view kStrConfigurationSectionRecording = L"Recording";
+
+    /// Configuration file setting for specifying a file to which all physical controller state
+    /// changes are recorded.
+    inline constexpr std::wstring_view kStrConfigurationSettingRecordingRecordFile = L"RecordFile";
+
+    /// Configuration file setting for specifying a previously-recorded file to be replayed in place
+    /// of input from physical controllers.
+    inline constexpr std::wstring_view kStrConfigurationSettingRecordingReplayFile = L"ReplayFile";
+
+    /// Configuration file setting for specifying the replay speed, expressed as a percentage of the
+    /// speed at which the input was originally recorded.
+    inline constexpr std::wstring_view kStrConfigurationSettingRecordingReplaySpeedPercent =
+        L"ReplaySpeedPercent";
+
+    /// Configuration file setting for specifying that replay should step through the recorded
+    /// state changes one at a time rather than following their timestamps.
+    inline constexpr std::wstring_view kStrConfigurationSettingRecordingReplayStepped =
+        L"ReplayStepped";
+
     /// Configuration file section name for specifying behavioral tweaks to work around bugs in
     /// games.
     inline constexpr std::wstring_view kStrConfigurationSectionWorkarounds = L"Workarounds";
@@ -276,6 +398,19 @@ namespace Xidi
     /// @return Resulting string representation for the specified GUID.
     TemporaryString GuidToString(const GUID& guid);
 
+    /// Retrieves a string used to represent the per-controller form of a configuration setting,
+    /// which is the setting name followed by a separator and a 1-based controller number. These
+    /// are initialized on first invocation for each setting name and returned subsequently as
+    /// read-only views. An empty view is returned if an invalid controller identifier is
+    /// specified.
+    /// @param [in] settingName Controller-independent name of the configuration setting, which
+    /// must refer to a string with static storage duration.
+    /// @param [in] controllerIdentifier Controller identifier for which a string is desired.
+    /// @return Corresponding configuration setting string, or an empty view if the controller
+    /// identifier is out of range.
+    std::wstring_view PerControllerConfigurationNameString(
+        std::wstring_view settingName, Controller::TControllerIdentifier controllerIdentifier);
+
     /// Retrieves a string used to represent a per-controller mapper type configuration setting.
     /// These are initialized on first invocation and returned subsequently as read-only views.
     /// An empty view is returned if an invalid controller identifier is specified.
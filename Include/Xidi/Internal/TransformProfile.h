@@ -0,0 +1,230 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file TransformProfile.h
+ *   Declaration of per-controller profiles of raw transformations applied to analog values read
+ *   from physical controllers.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "Configuration.h"
+#include "ControllerMath.h"
+#include "ControllerTypes.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Holds the raw deadzone and saturation transformations that are applied to the analog sticks
+    /// and triggers of one physical controller before its state is mapped. Profiles are resolved
+    /// from the configuration file per controller, and again if it is reloaded, and are read-only
+    /// once resolved, so the mapping hot path never needs to consult the configuration. Per-axis
+    /// transformations are backed by shared lookup tables, which hold the precomputed result of
+    /// the cutoff and scaling math for every possible input value, and which each profile keeps
+    /// alive for as long as it exists. Each analog stick can instead be configured for radial
+    /// processing, in which case both of its axes are transformed together as a single vector.
+    class TransformProfile
+    {
+    public:
+
+      /// Deadzone and saturation percentages that together define one raw transformation.
+      struct SParameters
+      {
+        /// Percentage of the analog range, measured from neutral, within which readings are
+        /// reported as neutral.
+        unsigned int deadzonePercent;
+
+        /// Percentage of the analog range, measured from neutral, beyond which readings are
+        /// reported as extreme.
+        unsigned int saturationPercent;
+
+        /// Simple check for equality. Primarily useful during testing.
+        /// @param [in] other Object with which to compare.
+        /// @return `true` if this object is equal to the other object, `false` otherwise.
+        constexpr bool operator==(const SParameters& other) const = default;
+      };
+
+      /// Transformation parameters that leave analog values completely unchanged.
+      static constexpr SParameters kIdentityParameters = {
+          .deadzonePercent = 0, .saturationPercent = 100};
+
+      /// Type for holding transformation parameters for all analog stick axes, indexed by
+      /// #EPhysicalStick.
+      using TStickParameters = std::array<SParameters, (int)EPhysicalStick::Count>;
+
+      /// Type for holding transformation parameters for all triggers, indexed by
+      /// #EPhysicalTrigger.
+      using TTriggerParameters = std::array<SParameters, (int)EPhysicalTrigger::Count>;
+
+      /// Number of physical analog sticks, each of which consists of a horizontal and a vertical
+      /// axis that are adjacent in #EPhysicalStick. Sticks are identified by index, 0 for left
+      /// and 1 for right.
+      static constexpr unsigned int kStickCount = (unsigned int)EPhysicalStick::Count / 2;
+
+      /// Parameters that control whether and how both axes of one analog stick are transformed
+      /// together. Deadzone and saturation percentages are taken from the per-axis parameters of
+      /// the stick, but when radial processing is enabled they are measured as the length of the
+      /// stick's displacement vector rather than along each axis independently.
+      struct SRadialParameters
+      {
+        /// Whether or not radial processing is enabled. If not, the other members are ignored.
+        bool isEnabled;
+
+        /// Percentage of the analog range, measured from neutral, that is reported as soon as the
+        /// stick leaves its deadzone.
+        unsigned int antiDeadzonePercent;
+
+        /// Whether or not the circular range of the stick is stretched to cover the square range
+        /// of the virtual controller's axes.
+        bool circleToSquare;
+
+        /// Simple check for equality. Primarily useful during testing.
+        /// @param [in] other Object with which to compare.
+        /// @return `true` if this object is equal to the other object, `false` otherwise.
+        constexpr bool operator==(const SRadialParameters& other) const = default;
+      };
+
+      /// Radial parameters that leave each axis of an analog stick to be transformed independently.
+      static constexpr SRadialParameters kAxialParameters = {
+          .isEnabled = false, .antiDeadzonePercent = 0, .circleToSquare = false};
+
+      /// Type for holding radial parameters for both analog sticks, indexed by stick.
+      using TRadialParameters = std::array<SRadialParameters, kStickCount>;
+
+      /// Default constructor. Creates a profile that leaves all analog values unchanged.
+      TransformProfile(void);
+
+      /// Initialization constructor. Creates a profile from explicit transformation parameters.
+      /// If radial processing is enabled for an analog stick, both of its axes should have the
+      /// same deadzone and saturation, and those of its horizontal axis are used.
+      /// @param [in] stickParameters Transformation parameters for each analog stick axis.
+      /// @param [in] triggerParameters Transformation parameters for each trigger.
+      /// @param [in] radialParameters Radial processing parameters for each analog stick.
+      TransformProfile(
+          const TStickParameters& stickParameters,
+          const TTriggerParameters& triggerParameters,
+          const TRadialParameters& radialParameters = {kAxialParameters, kAxialParameters});
+
+      /// Resolves the profile for the specified controller from the specified configuration data.
+      /// Each setting may be specified per-controller by appending a separator and a 1-based
+      /// controller number to its name, and any such setting takes precedence over the
+      /// controller-independent setting of the same name.
+      /// @param [in] configData Configuration data from which to read.
+      /// @param [in] controllerIdentifier Identifier of the controller whose profile is desired.
+      /// @return Resolved profile.
+      static TransformProfile FromConfigurationData(
+          const Configuration::ConfigurationData& configData,
+          TControllerIdentifier controllerIdentifier);
+
+      /// Retrieves the profile that was resolved from the configuration file for the specified
+      /// controller. All profiles are resolved together on first invocation.
+      /// @param [in] controllerIdentifier Identifier of the controller whose profile is desired.
+      /// @return Read-only reference to the profile, or to the identity profile if the controller
+      /// identifier is out of range.
+      static const TransformProfile& GetConfigured(TControllerIdentifier controllerIdentifier);
+
+      /// Retrieves a profile that leaves all analog values unchanged.
+      /// @return Read-only reference to the identity profile.
+      static const TransformProfile& GetIdentity(void);
+
+      /// Applies the per-axis transformation for the specified analog stick axis. Radial
+      /// processing is not applied, even if enabled, because it requires both axes of the stick.
+      /// @param [in] stick Analog stick axis from which the value was read.
+      /// @param [in] analogValue Analog value to transform.
+      /// @return Transformed analog value.
+      inline int16_t ApplyToStick(EPhysicalStick stick, int16_t analogValue) const
+      {
+        return stickTransform[(int)stick]->Apply(analogValue);
+      }
+
+      /// Applies the transformations for all analog stick axes in place. Sticks for which radial
+      /// processing is enabled are transformed as vectors, and all others are transformed one
+      /// axis at a time.
+      /// @param [in, out] stickValues Analog values to transform, indexed by #EPhysicalStick.
+      inline void ApplyToSticks(std::array<int16_t, (int)EPhysicalStick::Count>& stickValues) const
+      {
+        for (unsigned int stickIdx = 0; stickIdx < kStickCount; ++stickIdx)
+        {
+          const unsigned int axisIdxX = (2 * stickIdx);
+          const unsigned int axisIdxY = (2 * stickIdx) + 1;
+
+          if (true == radialParameters[stickIdx].isEnabled)
+          {
+            radialTransform[stickIdx].Apply(stickValues[axisIdxX], stickValues[axisIdxY]);
+          }
+          else
+          {
+            stickValues[axisIdxX] = stickTransform[axisIdxX]->Apply(stickValues[axisIdxX]);
+            stickValues[axisIdxY] = stickTransform[axisIdxY]->Apply(stickValues[axisIdxY]);
+          }
+        }
+      }
+
+      /// Applies the transformation for the specified trigger.
+      /// @param [in] trigger Trigger from which the value was read.
+      /// @param [in] triggerValue Trigger value to transform.
+      /// @return Transformed trigger value.
+      inline uint8_t ApplyToTrigger(EPhysicalTrigger trigger, uint8_t triggerValue) const
+      {
+        return triggerTransform[(int)trigger]->Apply(triggerValue);
+      }
+
+      /// Retrieves the transformation parameters for the specified analog stick axis.
+      /// @param [in] stick Analog stick axis of interest.
+      /// @return Transformation parameters.
+      inline SParameters GetStickParameters(EPhysicalStick stick) const
+      {
+        return stickParameters[(int)stick];
+      }
+
+      /// Retrieves the radial processing parameters for the specified analog stick.
+      /// @param [in] stickIndex Index of the analog stick of interest, 0 for left and 1 for right.
+      /// @return Radial processing parameters.
+      inline SRadialParameters GetRadialParameters(unsigned int stickIndex) const
+      {
+        return radialParameters[stickIndex];
+      }
+
+      /// Retrieves the transformation parameters for the specified trigger.
+      /// @param [in] trigger Trigger of interest.
+      /// @return Transformation parameters.
+      inline SParameters GetTriggerParameters(EPhysicalTrigger trigger) const
+      {
+        return triggerParameters[(int)trigger];
+      }
+
+    private:
+
+      /// Transformation parameters for each analog stick axis.
+      TStickParameters stickParameters;
+
+      /// Transformation parameters for each trigger.
+      TTriggerParameters triggerParameters;
+
+      /// Radial processing parameters for each analog stick.
+      TRadialParameters radialParameters;
+
+      /// Transformation lookup table for each analog stick axis, indexed by #EPhysicalStick.
+      std::array<std::shared_ptr<const Math::RawAnalogTransformTable>, (int)EPhysicalStick::Count>
+          stickTransform;
+
+      /// Transformation lookup table for each trigger, indexed by #EPhysicalTrigger.
+      std::array<
+          std::shared_ptr<const Math::RawTriggerTransformTable>,
+          (int)EPhysicalTrigger::Count>
+          triggerTransform;
+
+      /// Radial transformation for each analog stick, used only if radial processing is enabled.
+      std::array<Math::RadialStickTransform, kStickCount> radialTransform;
+    };
+  } // namespace Controller
+} // namespace Xidi
@@ -12,19 +12,23 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <stop_token>
-#include <thread>
 #include <utility>
 
 #include "ControllerTypes.h"
 #include "ForceFeedbackDevice.h"
 #include "ForceFeedbackTypes.h"
+#include "LatencyTrace.h"
 #include "Mapper.h"
+#include "SeqLock.h"
 #include "StateChangeEventBuffer.h"
+#include "StateHistory.h"
+#include "VirtualControllerCore.h"
 
 namespace Xidi
 {
@@ -137,6 +141,15 @@ namespace Xidi
           return filter.test(ElementToIndex(element));
         }
 
+        /// Retrieves the entire filter as a mask, one bit per virtual controller element, using
+        /// the base indices defined in this class to determine bit positions. Allows membership of
+        /// many elements to be tested at once.
+        /// @return Mask with bits set for all of the elements contained in the filter.
+        inline uint64_t GetMask(void) const
+        {
+          return (uint64_t)filter.to_ullong();
+        }
+
         /// Remove the specified virtual controller element from the filter so that events are not
         /// generated for it.
         /// @param [in] element Desired virtual controller element.
@@ -312,8 +325,7 @@ namespace Xidi
 
       VirtualController(const VirtualController& other) = delete;
 
-      /// Cleans up and terminates the background monitoring thread, and unregisters this controller
-      /// for force feedback.
+      /// Detaches this controller from its shared core and unregisters it for force feedback.
       ~VirtualController(void);
 
       /// Modifies the contents of the specified controller state object by applying this virtual
@@ -393,7 +405,7 @@ namespace Xidi
       /// @return Deadzone value associated with the target axis.
       inline uint32_t GetAxisDeadzone(EAxis axis) const
       {
-        return properties[axis].deadzone;
+        return publishedProperties.Load()[axis].deadzone;
       }
 
       /// Retrieves and returns the range property of the specified axis.
@@ -402,7 +414,8 @@ namespace Xidi
       /// second is the maximum.
       inline std::pair<int32_t, int32_t> GetAxisRange(EAxis axis) const
       {
-        return std::make_pair(properties[axis].rangeMin, properties[axis].rangeMax);
+        const SAxisProperties axisProperties = publishedProperties.Load()[axis];
+        return std::make_pair(axisProperties.rangeMin, axisProperties.rangeMax);
       }
 
       /// Retrieves and returns the saturation property of the specified axis.
@@ -410,7 +423,7 @@ namespace Xidi
       /// @return Saturation value associated with the target axis.
       inline uint32_t GetAxisSaturation(EAxis axis) const
       {
-        return properties[axis].saturation;
+        return publishedProperties.Load()[axis].saturation;
       }
 
       /// Retrieves and returns whether or not values read from the physical controller for the
@@ -419,7 +432,7 @@ namespace Xidi
       /// @return Whether or not transformationso are enabled for the target axis.
       inline bool GetAxisTransformationsEnabled(EAxis axis) const
       {
-        return properties[axis].transformationsEnabled;
+        return publishedProperties.Load()[axis].transformationsEnabled;
       }
 
       /// Retrieves and returns the capacity of the event buffer in number of events.
@@ -436,13 +449,14 @@ namespace Xidi
         return eventBuffer.GetCount();
       }
 
-      /// Retrieves a read-only reference to a buffered event at the specified index, without
-      /// performing any bounds-checking. Event with index 0 is the oldest, and higher indices
-      /// indicate more recent events. To prevent the event buffer from being modified while
-      /// accessing multiple events, the caller should first obtain this virtual controller's lock.
+      /// Retrieves a copy of a buffered event at the specified index, without performing any
+      /// bounds-checking. Event with index 0 is the oldest, and higher indices indicate more recent
+      /// events. Events retrieved this way are not guaranteed to be consistent with one another
+      /// while the state is being refreshed, so applications should be served using
+      /// #ReadEventBufferEvents instead.
       /// @param [in] index Index of the desired event.
-      /// @return Read-only reference to the event at the desired index.
-      inline const StateChangeEventBuffer::SEvent& GetEventBufferEvent(uint32_t index) const
+      /// @return Copy of the event at the desired index.
+      inline StateChangeEventBuffer::SEvent GetEventBufferEvent(uint32_t index) const
       {
         return eventBuffer[index];
       }
@@ -451,7 +465,7 @@ namespace Xidi
       /// @return Force feedback gain property value.
       inline uint32_t GetForceFeedbackGain(void) const
       {
-        return (uint32_t)properties.device.ffGain;
+        return (uint32_t)publishedProperties.Load().device.ffGain;
       }
 
       /// Retrieves and returns this controller's identifier.
@@ -461,10 +475,24 @@ namespace Xidi
         return kControllerIdentifier;
       }
 
-      /// Retrieves and returns the latest view of the state of this virtual controller.
+      /// Retrieves and returns the latest view of the state of this virtual controller. If a state
+      /// sampling delay is configured, the view is instead the state as of that amount of time in
+      /// the past, which keeps the latency between physical input and application reads consistent
+      /// no matter how the application's reads line up with physical controller polling. Never
+      /// obtains this virtual controller's lock, so it does not contend with state refreshes or with
+      /// other readers.
       /// @return Current state of this virtual controller.
       SState GetState(void);
 
+      /// Retrieves a read-only reference to the history of this virtual controller's recent
+      /// processed states. The history can be read concurrently without obtaining this virtual
+      /// controller's lock, which makes it suitable for diagnostic and instrumentation purposes.
+      /// @return Read-only reference to the state history.
+      inline const StateHistory& GetStateHistory(void) const
+      {
+        return stateHistory;
+      }
+
       /// Checks if this virtual controller has a state change event handle which would be signalled
       /// on virtual controller state change.
       /// @return `true` if so, `false` otherwise.
@@ -489,11 +517,13 @@ namespace Xidi
 
       /// Locks this virtual controller for ensuring proper concurrency control.
       /// The returned lock object is scoped and, as a result, will automatically unlock this
-      /// virtual controller upon its destruction. Used internally for this purpose, and can be used
-      /// externally for locking ahead of bulk events or direct event buffer access.
+      /// virtual controller upon its destruction. Used internally to serialize state refreshes and
+      /// property changes, and can be used externally ahead of bulk modifications such as changes
+      /// to the event filter. Readers of state and properties do not need it. The lock is not
+      /// recursive, so it must not be held while invoking methods that obtain it.
       /// @return Scoped lock object that has acquired this virtual controller's concurrency control
       /// mutex.
-      inline std::unique_lock<std::recursive_mutex> Lock(void)
+      inline std::unique_lock<std::mutex> Lock(void)
       {
         return std::unique_lock(controllerMutex);
       }
@@ -503,20 +533,44 @@ namespace Xidi
       /// @param [in] numEventsToPop Maximum number of events to remove.
       void PopEventBufferOldestEvents(uint32_t numEventsToPop);
 
+      /// Reads a consistent snapshot of up to the specified number of the oldest buffered events,
+      /// optionally removing them in the same step, without obtaining this virtual controller's
+      /// lock. State refreshes therefore never wait for applications reading buffered events, and
+      /// vice versa. See #StateChangeEventBuffer::ReadOldestEvents for details on how the visitor
+      /// is invoked.
+      /// @tparam EventVisitor Callable type that accepts an index and a read-only event reference.
+      /// @param [in] numEventsMax Maximum number of events to read.
+      /// @param [in] removeEvents Whether or not the events that are read should also be removed.
+      /// @param [in] visitor Callable object to be invoked for each event that is read.
+      /// @return Number of events read and whether or not an overflow condition was present.
+      template <typename EventVisitor> inline StateChangeEventBuffer::SReadResult
+          ReadEventBufferEvents(uint32_t numEventsMax, bool removeEvents, EventVisitor visitor)
+      {
+        return eventBuffer.ReadOldestEvents(numEventsMax, removeEvents, visitor);
+      }
+
       /// Generates this virtual controller's processed state view by applying this virtual
       /// controller's properties to its raw state view. Not concurrency-safe, and primarily
       /// intended for internal use.
       void ReapplyProperties(void);
 
       /// Refreshes the virtual controller's state using the supplied new state data.
-      /// Primarily intended to be called by a background thread, but exposed externally for
-      /// testing.
+      /// Primarily intended for testing, because state changes are normally delivered by the
+      /// shared core as part of an update pass.
       /// @param [in] newRawVirtualStateData Raw virtual controller state data to apply to this
       /// virtual controller's internal state view.
       /// @return `true` if the state of the controller changed as a result of applying the new
       /// state data, `false` otherwise.
       bool RefreshState(SState newRawVirtualStateData);
 
+      /// Refreshes the virtual controller's state as part of an update pass driven by the shared
+      /// core, using information that the core computes only once for all of the virtual
+      /// controllers attached to it.
+      /// @param [in] update Update information supplied by the shared core.
+      /// @return `true` if the state of the controller changed as a result of applying the new
+      /// state data, `false` otherwise.
+      bool RefreshState(const VirtualControllerCore::SUpdate& update);
+
       /// Sets the deadzone property for a single axis.
       /// @param [in] axis Target axis.
       /// @param [in] deadzone Desired deadzone value.
@@ -591,45 +645,86 @@ namespace Xidi
       /// Intended to be invoked internally.
       void SignalStateChangeEvent(void);
 
+      /// Notifies this virtual controller that the application has read its state or its buffered
+      /// events, for the purpose of input latency tracing. Only the first read after each state
+      /// change is traced. Does nothing if latency tracing is disabled.
+      void TraceApplicationRead(void);
+
     private:
 
+      /// Modifies the contents of the specified controller state object by applying this virtual
+      /// controller's properties, using capabilities that the caller has already obtained.
+      /// @param [in,out] controllerState Controller state object to transform.
+      /// @param [in] capabilities Capabilities of this virtual controller.
+      void ApplyProperties(SState& controllerState, const SCapabilities& capabilities) const;
+
       /// Controller identifier to be used when communicating with the underlying real controller.
       const TControllerIdentifier kControllerIdentifier;
 
-      /// Provides concurrency control to the data structures in this virtual controller.
-      std::recursive_mutex controllerMutex;
+      /// Amount of time in the past, in timestamp ticks, as of which state is presented to
+      /// applications. A value of 0 means the latest state is always presented.
+      const StateHistory::TTimestamp kStateSamplingDelay;
+
+      /// Serializes state refreshes and property changes. Readers instead use the published copies
+      /// of state and properties, which never require this lock.
+      std::mutex controllerMutex;
 
-      /// Buffer for holding controller state change events.
+      /// Buffer for holding controller state change events. Events are appended while holding
+      /// this virtual controller's lock, which also guards capacity changes, but they are read and
+      /// removed without it.
       StateChangeEventBuffer eventBuffer;
 
       /// Filter to be used for deciding which controller elements are allowed to generate buffered
       /// events. Default state is all controller elements are included in the filter.
       EventFilter eventFilter;
 
-      /// All properties associated with this virtual controller.
+      /// All properties associated with this virtual controller. Only accessed while holding this
+      /// virtual controller's lock.
       SProperties properties;
 
+      /// Copy of all properties associated with this virtual controller, published for readers
+      /// whenever properties change.
+      SeqLock<SProperties> publishedProperties;
+
       /// State of the virtual controller as of the last refresh.
       /// Raw values, with no properties or other processing applied.
       SState stateRaw;
 
       /// State of the virtual controller as of the last refresh.
-      /// Fully processed, all properties have been applied.
+      /// Fully processed, all properties have been applied. Only accessed while holding this
+      /// virtual controller's lock.
       SState stateProcessed;
 
+      /// Copy of the fully-processed state of the virtual controller, published for readers
+      /// whenever it changes.
+      SeqLock<SState> publishedStateProcessed;
+
+      /// Recent fully-processed states of the virtual controller, each with the time at which it
+      /// took effect.
+      StateHistory stateHistory;
+
+      /// Time at which this virtual controller's properties were most recently applied to its
+      /// state, which invalidates the processed states already in the history.
+      std::atomic<StateHistory::TTimestamp> propertiesChangeTimestamp;
+
       /// State change event notification handle, optionally provided by applications.
       /// The underlying event object is owned by the application, not by this object.
       HANDLE stateChangeEventHandle;
 
-      /// Background thread that monitors the associated physical controller for updates.
-      std::thread physicalControllerMonitor;
+      /// Part of the virtual controller that is shared with all other virtual controller objects
+      /// associated with the same physical controller. Delivers raw state changes to this object.
+      std::shared_ptr<VirtualControllerCore> core;
 
-      /// Used to indicate that the physical controller monitor thread should stop running.
-      std::stop_source physicalControllerMonitorStop;
+      /// Links this virtual controller into the list of objects attached to the shared core.
+      VirtualControllerCore::SAttachment coreAttachment;
 
       /// Pointer to the physical device force feedback buffer. Valid only if this virtual
       /// controller object is registered for force feedback, `nullptr` all other times.
       ForceFeedback::Device* physicalControllerForceFeedbackBuffer;
+
+      /// Timestamp of the physical controller read that led to the most recent state change, used
+      /// for input latency tracing. Cleared once the application reads the new state.
+      std::atomic<LatencyTrace::TTimestamp> latencyTraceOrigin;
     };
   } // namespace Controller
 } // namespace Xidi
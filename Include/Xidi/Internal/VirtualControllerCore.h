@@ -0,0 +1,154 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file VirtualControllerCore.h
+ *   Declaration of the part of a virtual controller that is shared among all virtual controller
+ *   objects associated with the same physical controller.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "Clock.h"
+#include "ControllerTypes.h"
+#include "LatencyTrace.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    class VirtualController;
+
+    /// Holds the part of a virtual controller that does not depend on any application-specified
+    /// configuration and can therefore be shared among all virtual controller objects associated
+    /// with the same physical controller, such as when an application creates several device
+    /// objects for one controller. Receives raw virtual controller state changes from the state
+    /// change dispatcher, keeps the most recent one, and drives every attached virtual controller
+    /// object through a single update pass in which all of the work that does not depend on
+    /// per-object properties, event filters, and event buffers is done only once. Objects are
+    /// reference-counted, created on first request, and destroyed when the last virtual controller
+    /// object using them is destroyed. All methods are concurrency-safe.
+    class VirtualControllerCore
+    {
+    public:
+
+      /// Record that links a virtual controller object into the list of objects attached to a
+      /// core. Owned and embedded by the virtual controller object itself, so that attaching and
+      /// detaching neither allocates memory nor searches the list. Only accessed by the core while
+      /// holding its lock.
+      struct SAttachment
+      {
+        /// Virtual controller object that is attached.
+        VirtualController* controller = nullptr;
+
+        /// Previous attachment in the list, or `nullptr` if this is the first.
+        SAttachment* previous = nullptr;
+
+        /// Next attachment in the list, or `nullptr` if this is the last.
+        SAttachment* next = nullptr;
+      };
+
+      /// Information computed once per update pass and supplied to every attached virtual
+      /// controller object.
+      struct SUpdate
+      {
+        /// New raw virtual controller state.
+        SState stateRaw;
+
+        /// Capabilities of the virtual controller, as of the update.
+        SCapabilities capabilities;
+
+        /// Timestamp to use for any buffered events generated by the update.
+        Clock::TTimestamp eventTimestamp;
+
+        /// Origin of the update for input latency tracing, or 0 if not traced.
+        LatencyTrace::TTimestamp latencyTraceOrigin;
+      };
+
+      VirtualControllerCore(const VirtualControllerCore& other) = delete;
+
+      /// Unregisters from the state change dispatcher.
+      ~VirtualControllerCore(void);
+
+      /// Retrieves the core associated with the specified physical controller, creating it if no
+      /// virtual controller object currently uses it.
+      /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+      /// @return Shared reference to the core.
+      static std::shared_ptr<VirtualControllerCore> GetForController(
+          TControllerIdentifier controllerIdentifier);
+
+      /// Computes the information for an update pass. Normally invoked only by cores, once per
+      /// update pass, but also available for refreshing a single virtual controller object
+      /// directly.
+      /// @param [in] controllerIdentifier Identifier of the associated physical controller.
+      /// @param [in] stateRaw New raw virtual controller state.
+      /// @return Update information for the specified raw virtual controller state.
+      static SUpdate PrepareUpdate(
+          TControllerIdentifier controllerIdentifier, const SState& stateRaw);
+
+      /// Attaches a virtual controller object so that it participates in future update passes. The
+      /// virtual controller object is immediately refreshed using the most recent raw state, while
+      /// holding the lock that serializes update passes, so that it cannot miss a state change.
+      /// Constant time.
+      /// @param [in,out] attachment Attachment record, whose controller field must already be
+      /// filled in. Must remain valid until it is detached.
+      void Attach(SAttachment& attachment);
+
+      /// Detaches a virtual controller object so that it no longer participates in update passes.
+      /// Once this method returns, no update pass involving the virtual controller object is in
+      /// progress. Constant time. Does nothing if the attachment record is not attached.
+      /// @param [in,out] attachment Attachment record previously passed to #Attach.
+      void Detach(SAttachment& attachment);
+
+      /// Retrieves the number of virtual controller objects currently attached.
+      /// @return Number of attached virtual controller objects.
+      unsigned int GetAttachedCount(void);
+
+      /// Retrieves the identifier of the physical controller with which this core is associated.
+      /// @return Physical controller identifier.
+      inline TControllerIdentifier GetIdentifier(void) const
+      {
+        return kControllerIdentifier;
+      }
+
+      /// Retrieves the most recent raw virtual controller state.
+      /// @return Raw virtual controller state.
+      SState GetStateRaw(void);
+
+      /// Performs an update pass using a new raw virtual controller state. Each attached virtual
+      /// controller object refreshes its own state and, if its state changed as a result, signals
+      /// its state change event. Invoked by the state change dispatcher.
+      /// @param [in] newStateRaw New raw virtual controller state.
+      void Update(const SState& newStateRaw);
+
+    private:
+
+      /// Creates a core and registers it with the state change dispatcher. Objects are only
+      /// created by #GetForController.
+      /// @param [in] controllerIdentifier Identifier of the associated physical controller.
+      VirtualControllerCore(TControllerIdentifier controllerIdentifier);
+
+      /// Identifier of the associated physical controller.
+      const TControllerIdentifier kControllerIdentifier;
+
+      /// Serializes update passes, attachment, and detachment.
+      std::mutex coreMutex;
+
+      /// Most recent raw virtual controller state.
+      SState stateRaw;
+
+      /// First attachment in the list, or `nullptr` if no virtual controller objects are attached.
+      SAttachment* attachmentListHead;
+
+      /// Number of attachments in the list.
+      unsigned int attachmentCount;
+    };
+  } // namespace Controller
+} // namespace Xidi
@@ -45,8 +45,10 @@ namespace XidiTest
 
     ~MockPhysicalController(void);
 
-    /// Advances to the next physical state.
-    /// Intended to be invoked internally only.
+    /// Advances to the next physical state and dispatches the resulting raw virtual state to all
+    /// virtual controllers associated with this mock physical controller, in the calling thread,
+    /// much as the physical controller polling thread does. Test will fail due to a test
+    /// implementation issue if attempting to advance past the end of the physical state array.
     void AdvancePhysicalState(void);
 
     /// Unregisters a virtual controller for force feedback.
@@ -101,19 +103,6 @@ namespace XidiTest
       return kControllerIdentifier;
     }
 
-    /// Retrieves and returns whether or not an advancement to the next physical state has been
-    /// requested.
-    /// @return `true` if so, `false` if not.
-    inline bool IsAdvanceStateRequested(void) const
-    {
-      return advanceRequested;
-    }
-
-    /// Requests an advancement to the next physical state.
-    /// Test will fail due to a test implementation issue if attempting to advance past the end of
-    /// the physical state array.
-    void RequestAdvancePhysicalState(void);
-
   private:
 
     /// Physical controller identifier for which this object is asserting control.
@@ -130,11 +119,6 @@ namespace XidiTest
     /// Begins at 0 and increases whenever a test case advances to the next physical state.
     size_t currentPhysicalStateIndex;
 
-    /// Flag which specifies whether or not the next wait-for-state-change operation should
-    /// result in an advancement of the reported physical state to the next element in the
-    /// physical state array.
-    bool advanceRequested;
-
     /// Force feedback device associated with the physical controller.
     /// Initialized to use a base timestamp of 0.
     ForceFeedback::Device forceFeedbackDevice;
@@ -13,8 +13,23 @@
 
 #include <sal.h>
 
+#include <cstdint>
+
+#include "ControllerTypes.h"
+
 namespace XidiTest
 {
+  /// Creates a physical controller state object that is different for each distinct seed value.
+  /// @param [in] seed Value that determines the contents of the physical state object.
+  /// @return Physical controller state object.
+  ::Xidi::Controller::SPhysicalState CreatePhysicalState(unsigned int seed);
+
+  /// Creates a virtual controller state object that is different for each distinct seed value and
+  /// whose axis values are all equal to the seed value.
+  /// @param [in] seed Value that determines the contents of the virtual state object.
+  /// @return Virtual controller state object.
+  ::Xidi::Controller::SState CreateState(int32_t seed);
+
   /// Prints the specified message and appends a newline.
   /// @param [in] str Message string.
   void Print(const wchar_t* const str);
@@ -0,0 +1,69 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file BenchmarkCase.cpp
+ *   Implementation of benchmark case functionality.
+ **************************************************************************************************/
+
+#include "BenchmarkCase.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+
+#include "BenchmarkHarness.h"
+
+namespace XidiBenchmark
+{
+  /// Destination for values that are consumed to prevent them from being optimized away.
+  static std::atomic<const void*> consumedValue;
+
+  /// Number of heap allocations made by the benchmark program so far. Constant-initialized, so it
+  /// is usable by allocations that happen during static initialization.
+  static std::atomic<uint64_t> allocationCount = 0;
+
+  IBenchmarkCase::IBenchmarkCase(std::wstring_view name)
+  {
+    BenchmarkHarness::RegisterBenchmarkCase(this, name);
+  }
+
+  void ConsumeValue(const void* value)
+  {
+    consumedValue.store(value, std::memory_order_relaxed);
+  }
+
+  uint64_t GetAllocationCount(void)
+  {
+    return allocationCount.load(std::memory_order_relaxed);
+  }
+} // namespace XidiBenchmark
+
+// Replacements for the global allocation functions, which count allocations and otherwise behave
+// like the defaults. Array and non-throwing forms are implemented in terms of these by the standard
+// library, so they are counted as well.
+
+void* operator new(size_t size)
+{
+  XidiBenchmark::allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+  void* const allocatedMemory = std::malloc((0 == size) ? 1 : size);
+  if (nullptr == allocatedMemory) throw std::bad_alloc();
+
+  return allocatedMemory;
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept
+{
+  std::free(ptr);
+}
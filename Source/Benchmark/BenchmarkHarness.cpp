@@ -0,0 +1,81 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file BenchmarkHarness.cpp
+ *   Implementation of the benchmark harness, including program entry point.
+ **************************************************************************************************/
+
+#include "BenchmarkHarness.h"
+
+#include <map>
+#include <string_view>
+
+#include "BenchmarkCase.h"
+#include "Utilities.h"
+
+namespace XidiBenchmark
+{
+  using ::XidiTest::Print;
+  using ::XidiTest::PrintFormatted;
+
+  BenchmarkHarness& BenchmarkHarness::GetInstance(void)
+  {
+    static BenchmarkHarness benchmarkHarness;
+    return benchmarkHarness;
+  }
+
+  void BenchmarkHarness::RegisterBenchmarkCaseInternal(
+      const IBenchmarkCase* const benchmarkCase, std::wstring_view name)
+  {
+    if ((false == name.empty()) && (false == benchmarkCases.contains(name)))
+      benchmarkCases[name] = benchmarkCase;
+  }
+
+  int BenchmarkHarness::RunBenchmarksWithMatchingPrefixInternal(std::wstring_view prefixToMatch)
+  {
+    int numExecutedBenchmarks = 0;
+
+    // Output is intended to be consumed by tools that track results between releases, so a header
+    // line is followed by exactly one line per measurement and nothing else.
+    Print(L"benchmark,measurement,operations,ns_per_op,allocs_per_op");
+
+    for (const auto& benchmarkCaseRecord : benchmarkCases)
+    {
+      const auto& name = benchmarkCaseRecord.first;
+      const IBenchmarkCase* const benchmarkCase = benchmarkCaseRecord.second;
+
+      if (false == name.starts_with(prefixToMatch)) continue;
+
+      BenchmarkContext context;
+      benchmarkCase->Run(context);
+      numExecutedBenchmarks += 1;
+
+      for (const auto& measurement : context.GetMeasurements())
+        PrintFormatted(
+            L"%s,%s,%llu,%.3f,%.3f",
+            name.data(),
+            measurement.label.c_str(),
+            (unsigned long long)measurement.numOperations,
+            measurement.nanosecondsPerOperation,
+            measurement.allocationsPerOperation);
+    }
+
+    return numExecutedBenchmarks;
+  }
+} // namespace XidiBenchmark
+
+/// Runs all benchmark cases, or only those whose names begin with the prefix supplied as the first
+/// command-line argument.
+/// @return 0 if at least one benchmark was run, 1 otherwise.
+int wmain(int argc, const wchar_t* argv[])
+{
+  return (
+      (XidiBenchmark::BenchmarkHarness::RunBenchmarksWithMatchingPrefix(
+           ((argc > 1) ? argv[1] : L"")) > 0)
+          ? 0
+          : 1);
+}
@@ -0,0 +1,739 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file MapperBenchmark.cpp
+ *   Microbenchmarks for entire controller layout mapper objects.
+ **************************************************************************************************/
+
+#include "BenchmarkCase.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ControllerTypes.h"
+#include "ElementMapper.h"
+#include "ElementMapperArena.h"
+#include "ForceFeedbackTypes.h"
+#include "Mapper.h"
+#include "MapperBuilder.h"
+#include "MapperDefinitions.h"
+#include "ResponseCurve.h"
+#include "TransformProfile.h"
+
+namespace XidiBenchmark
+{
+  using namespace ::Xidi::Controller;
+
+  /// Number of distinct sets of physical controller states that benchmarks cycle through. Must be
+  /// a power of two.
+  static constexpr unsigned int kNumPhysicalStateSets = 256;
+
+  /// Number of operations timed by each measurement in this file.
+  static constexpr uint64_t kNumOperations = 200000;
+
+  /// Type for holding one physical state per controller.
+  using TPhysicalStateSet = std::array<SPhysicalState, kPhysicalControllerCount>;
+
+  /// Generates a deterministic pseudorandom collection of physical controller state sets, so that
+  /// the work done by each benchmark is repeatable and the generation itself is not measured.
+  /// @return Generated physical controller state sets.
+  static std::vector<TPhysicalStateSet> GeneratePhysicalStateSets(void)
+  {
+    std::vector<TPhysicalStateSet> physicalStateSets(kNumPhysicalStateSets);
+
+    uint32_t randomState = 13579;
+    auto nextRandom = [&randomState]() -> uint32_t
+    {
+      randomState = (randomState * 1664525u) + 1013904223u;
+      return (randomState >> 8);
+    };
+
+    for (auto& physicalStateSet : physicalStateSets)
+    {
+      for (auto& physicalState : physicalStateSet)
+      {
+        physicalState = {.deviceStatus = EPhysicalDeviceStatus::Ok};
+
+        for (auto& stickValue : physicalState.stick)
+          stickValue = (int16_t)(nextRandom() & 0xffff);
+        for (auto& triggerValue : physicalState.trigger)
+          triggerValue = (uint8_t)(nextRandom() & 0xff);
+        physicalState.button = (uint16_t)(nextRandom() & 0xffff);
+      }
+    }
+
+    return physicalStateSets;
+  }
+
+  /// Enumerates the synthetic physical controller input streams used to measure mapping
+  /// throughput. Each stream exercises a different part of the mapping work.
+  enum class EInputStream
+  {
+    /// Controller at rest: sticks report small amounts of sensor noise around neutral, triggers
+    /// are released, and no buttons are pressed.
+    Idle,
+
+    /// Both sticks move continuously around the full circle, and both triggers ramp from released
+    /// to fully pressed, while no buttons are pressed.
+    StickSweep,
+
+    /// Sticks are at rest while buttons and triggers are pressed and released rapidly in a
+    /// pseudorandom pattern.
+    ButtonMash,
+
+    /// Not used as a value. Identifies the number of enumerators present in this enumeration.
+    Count
+  };
+
+  /// Retrieves a string that names the specified input stream, for use in measurement labels.
+  /// @param [in] inputStream Input stream to name.
+  /// @return Name of the input stream.
+  static std::wstring_view InputStreamName(EInputStream inputStream)
+  {
+    switch (inputStream)
+    {
+      case EInputStream::Idle:
+        return L"Idle";
+      case EInputStream::StickSweep:
+        return L"StickSweep";
+      case EInputStream::ButtonMash:
+        return L"ButtonMash";
+      default:
+        return L"Unknown";
+    }
+  }
+
+  /// Generates a deterministic synthetic stream of physical controller states. Generation is done
+  /// up front so that it is not measured.
+  /// @param [in] inputStream Type of input stream to generate.
+  /// @return Physical controller states that make up the stream, of which there are always
+  /// #kNumPhysicalStateSets.
+  static std::vector<SPhysicalState> GenerateInputStream(EInputStream inputStream)
+  {
+    constexpr double kTwoPi = 6.283185307179586;
+    constexpr int kIdleNoiseAmplitude = 64;
+
+    std::vector<SPhysicalState> physicalStates(kNumPhysicalStateSets);
+
+    uint32_t randomState = 24680;
+    auto nextRandom = [&randomState]() -> uint32_t
+    {
+      randomState = (randomState * 1664525u) + 1013904223u;
+      return (randomState >> 8);
+    };
+
+    for (unsigned int i = 0; i < kNumPhysicalStateSets; ++i)
+    {
+      SPhysicalState& physicalState = physicalStates[i];
+      physicalState = {.deviceStatus = EPhysicalDeviceStatus::Ok};
+
+      switch (inputStream)
+      {
+        case EInputStream::Idle:
+        case EInputStream::ButtonMash:
+          for (auto& stickValue : physicalState.stick)
+            stickValue = (int16_t)((int)(nextRandom() % (2 * kIdleNoiseAmplitude + 1)) -
+                                   kIdleNoiseAmplitude);
+          break;
+
+        case EInputStream::StickSweep:
+        {
+          const double angle = (kTwoPi * (double)i) / (double)kNumPhysicalStateSets;
+          const int16_t sweepX = (int16_t)(std::cos(angle) * (double)kAnalogValueMax);
+          const int16_t sweepY = (int16_t)(std::sin(angle) * (double)kAnalogValueMax);
+
+          physicalState.stick[(int)EPhysicalStick::LeftX] = sweepX;
+          physicalState.stick[(int)EPhysicalStick::LeftY] = sweepY;
+          physicalState.stick[(int)EPhysicalStick::RightX] = sweepY;
+          physicalState.stick[(int)EPhysicalStick::RightY] = sweepX;
+
+          for (auto& triggerValue : physicalState.trigger)
+            triggerValue = (uint8_t)i;
+          break;
+        }
+
+        default:
+          break;
+      }
+
+      if (EInputStream::ButtonMash == inputStream)
+      {
+        for (auto& triggerValue : physicalState.trigger)
+          triggerValue = ((0 == (nextRandom() & 1)) ? 0 : 255);
+        physicalState.button = (uint16_t)(nextRandom() & 0xffff);
+      }
+    }
+
+    return physicalStates;
+  }
+
+  /// Creates mappers that are representative of custom mappers typically defined in configuration
+  /// files, for measuring mapping throughput alongside the built-in mappers. Keyboard and mouse
+  /// element mappers are not used because their contributions are submitted to shared global
+  /// state rather than to the virtual controller state being measured.
+  /// @return Newly-created unregistered mappers.
+  static std::vector<std::unique_ptr<const Mapper>> CreateRepresentativeCustomMappers(void)
+  {
+    const ResponseCurve& exponentialCurve = ResponseCurve::Get(
+        {.type = ResponseCurve::EType::Exponential, .parameter = 200, .pointCount = 0});
+
+    std::vector<std::unique_ptr<const Mapper>> customMappers;
+
+    // Built-in StandardGamepad layout, but with response curves on all stick axes.
+    customMappers.push_back(Mapper::CreateUnregistered(
+        L"CustomResponseCurves",
+        {.stickLeftX =
+             std::make_unique<AxisMapper>(EAxis::X, EAxisDirection::Both, &exponentialCurve),
+         .stickLeftY =
+             std::make_unique<AxisMapper>(EAxis::Y, EAxisDirection::Both, &exponentialCurve),
+         .stickRightX =
+             std::make_unique<AxisMapper>(EAxis::Z, EAxisDirection::Both, &exponentialCurve),
+         .stickRightY =
+             std::make_unique<AxisMapper>(EAxis::RotZ, EAxisDirection::Both, &exponentialCurve),
+         .dpadUp = std::make_unique<PovMapper>(EPovDirection::Up),
+         .dpadDown = std::make_unique<PovMapper>(EPovDirection::Down),
+         .dpadLeft = std::make_unique<PovMapper>(EPovDirection::Left),
+         .dpadRight = std::make_unique<PovMapper>(EPovDirection::Right),
+         .triggerLT = std::make_unique<ButtonMapper>(EButton::B7),
+         .triggerRT = std::make_unique<ButtonMapper>(EButton::B8),
+         .buttonA = std::make_unique<ButtonMapper>(EButton::B1),
+         .buttonB = std::make_unique<ButtonMapper>(EButton::B2),
+         .buttonX = std::make_unique<ButtonMapper>(EButton::B3),
+         .buttonY = std::make_unique<ButtonMapper>(EButton::B4),
+         .buttonLB = std::make_unique<ButtonMapper>(EButton::B5),
+         .buttonRB = std::make_unique<ButtonMapper>(EButton::B6),
+         .buttonBack = std::make_unique<ButtonMapper>(EButton::B9),
+         .buttonStart = std::make_unique<ButtonMapper>(EButton::B10),
+         .buttonLS = std::make_unique<ButtonMapper>(EButton::B11),
+         .buttonRS = std::make_unique<ButtonMapper>(EButton::B12)}));
+
+    // Nested element mappers of every kind that forms a tree, with force feedback sent to single
+    // axes rather than projected onto two.
+    CompoundMapper::TElementMappers buttonACompound = {
+        std::make_unique<ButtonMapper>(EButton::B1),
+        std::make_unique<DigitalAxisMapper>(EAxis::RotX, EAxisDirection::Positive)};
+    CompoundMapper::TElementMappers buttonBCompound = {
+        std::make_unique<ButtonMapper>(EButton::B2),
+        std::make_unique<InvertMapper>(std::make_unique<ButtonMapper>(EButton::B6))};
+
+    customMappers.push_back(Mapper::CreateUnregistered(
+        L"CustomNestedTrees",
+        {.stickLeftX = std::make_unique<AxisMapper>(EAxis::X),
+         .stickLeftY = std::make_unique<InvertMapper>(std::make_unique<AxisMapper>(EAxis::Y)),
+         .stickRightX = std::make_unique<SplitMapper>(
+             std::make_unique<AxisMapper>(EAxis::Z, EAxisDirection::Positive),
+             std::make_unique<ButtonMapper>(EButton::B9)),
+         .stickRightY = std::make_unique<SplitMapper>(
+             std::make_unique<PovMapper>(EPovDirection::Down),
+             std::make_unique<PovMapper>(EPovDirection::Up)),
+         .dpadUp = std::make_unique<DigitalAxisMapper>(EAxis::Y, EAxisDirection::Negative),
+         .dpadDown = std::make_unique<DigitalAxisMapper>(EAxis::Y, EAxisDirection::Positive),
+         .dpadLeft = std::make_unique<DigitalAxisMapper>(EAxis::X, EAxisDirection::Negative),
+         .dpadRight = std::make_unique<DigitalAxisMapper>(EAxis::X, EAxisDirection::Positive),
+         .triggerLT = std::make_unique<AxisMapper>(EAxis::RotZ, EAxisDirection::Negative),
+         .triggerRT = std::make_unique<AxisMapper>(EAxis::RotZ, EAxisDirection::Positive),
+         .buttonA = std::make_unique<CompoundMapper>(std::move(buttonACompound)),
+         .buttonB = std::make_unique<CompoundMapper>(std::move(buttonBCompound)),
+         .buttonX = std::make_unique<ButtonMapper>(EButton::B3),
+         .buttonY = std::make_unique<ButtonMapper>(EButton::B4),
+         .buttonLB = std::make_unique<ButtonMapper>(EButton::B5),
+         .buttonStart = std::make_unique<ButtonMapper>(EButton::B10)},
+        {.leftMotor =
+             {.isPresent = true,
+              .mode = ForceFeedback::EActuatorMode::SingleAxis,
+              .singleAxis = {.axis = EAxis::X, .direction = EAxisDirection::Both}},
+         .rightMotor = {
+             .isPresent = true,
+             .mode = ForceFeedback::EActuatorMode::SingleAxis,
+             .singleAxis = {.axis = EAxis::Y, .direction = EAxisDirection::Positive}}}));
+
+    return customMappers;
+  }
+
+  /// Collects every built-in mapper, in definition order, followed by the specified custom
+  /// mappers. These are the mappers whose throughput is measured.
+  /// @param [in] customMappers Custom mappers to include.
+  /// @return Mappers whose throughput is to be measured.
+  static std::vector<const Mapper*> CollectThroughputMappers(
+      const std::vector<std::unique_ptr<const Mapper>>& customMappers)
+  {
+    std::vector<const Mapper*> throughputMappers;
+
+    for (unsigned int i = 0; i < MapperDefinitions::GetCount(); ++i)
+      throughputMappers.push_back(MapperDefinitions::GetMapper(i));
+    for (const auto& customMapper : customMappers)
+      throughputMappers.push_back(customMapper.get());
+
+    return throughputMappers;
+  }
+
+  /// Element mapper that forwards everything to an underlying element mapper tree. Element mapper
+  /// compilation does not recognize this type, so a mapper whose element mappers are all wrapped in
+  /// objects of this type evaluates its element mapper trees by walking them, in the same way that
+  /// mappers did before element maps were compiled.
+  class OpaqueElementMapper : public IElementMapper
+  {
+  public:
+
+    inline OpaqueElementMapper(std::unique_ptr<const IElementMapper>&& elementMapper)
+        : elementMapper(std::move(elementMapper))
+    {}
+
+    // IElementMapper
+    std::unique_ptr<IElementMapper> Clone(void) const override
+    {
+      return std::make_unique<OpaqueElementMapper>(elementMapper->Clone());
+    }
+
+    void ContributeFromAnalogValue(
+        SState& controllerState, int16_t analogValue, uint32_t sourceIdentifier) const override
+    {
+      elementMapper->ContributeFromAnalogValue(controllerState, analogValue, sourceIdentifier);
+    }
+
+    void ContributeFromButtonValue(
+        SState& controllerState, bool buttonPressed, uint32_t sourceIdentifier) const override
+    {
+      elementMapper->ContributeFromButtonValue(controllerState, buttonPressed, sourceIdentifier);
+    }
+
+    void ContributeFromTriggerValue(
+        SState& controllerState, uint8_t triggerValue, uint32_t sourceIdentifier) const override
+    {
+      elementMapper->ContributeFromTriggerValue(controllerState, triggerValue, sourceIdentifier);
+    }
+
+    void ContributeNeutral(SState& controllerState, uint32_t sourceIdentifier) const override
+    {
+      elementMapper->ContributeNeutral(controllerState, sourceIdentifier);
+    }
+
+    int GetTargetElementCount(void) const override
+    {
+      return elementMapper->GetTargetElementCount();
+    }
+
+    std::optional<SElementIdentifier> GetTargetElementAt(int index) const override
+    {
+      return elementMapper->GetTargetElementAt(index);
+    }
+
+  private:
+
+    /// Underlying element mapper tree.
+    const std::unique_ptr<const IElementMapper> elementMapper;
+  };
+
+  // Compares, for each built-in mapper, mapping physical controller states by walking the element
+  // mapper trees against mapping them by evaluating the compiled element map. Each operation maps
+  // one physical controller state.
+  BENCHMARK_CASE(Mapper_MapStatePhysicalToVirtual_TreeVersusProgram)
+  {
+    constexpr std::wstring_view kBuiltinMapperNames[] = {
+        L"StandardGamepad",
+        L"DigitalGamepad",
+        L"ExtendedGamepad",
+        L"XInputNative",
+        L"XInputSharedTriggers"};
+
+    const std::vector<TPhysicalStateSet> physicalStateSets = GeneratePhysicalStateSets();
+
+    for (const auto& mapperName : kBuiltinMapperNames)
+    {
+      const Mapper* const programMapper = Mapper::GetByName(mapperName);
+
+      Mapper::UElementMap treeElements = programMapper->CloneElementMap();
+      for (auto& elementMapper : treeElements.all)
+      {
+        if (nullptr != elementMapper)
+          elementMapper = std::make_unique<OpaqueElementMapper>(std::move(elementMapper));
+      }
+
+      const Mapper treeMapper(
+          std::move(treeElements.named), programMapper->GetForceFeedbackActuatorMap().named);
+
+      for (const Mapper* mapper : {&treeMapper, programMapper})
+      {
+        context.Measure(
+            std::wstring(mapperName) + ((mapper == programMapper) ? L"/Program" : L"/Tree"),
+            kNumOperations,
+            [&](uint64_t iteration) -> void
+            {
+              const SState virtualState = mapper->MapStatePhysicalToVirtual(
+                  physicalStateSets[iteration & (kNumPhysicalStateSets - 1)][0], 0);
+              DoNotOptimize(virtualState);
+            });
+      }
+    }
+  }
+
+  // Compares the existing per-axis analog stick transformations against radial processing, with
+  // and without anti-deadzone and circle-to-square mapping. Each transformation is measured both
+  // in isolation, where each operation transforms all analog stick axes of one physical controller,
+  // and as part of mapping, where each operation maps one physical controller state.
+  BENCHMARK_CASE(Mapper_MapStatePhysicalToVirtual_AxialVersusRadial)
+  {
+    constexpr TransformProfile::TStickParameters kBenchmarkStickParameters = {
+        {{10, 90}, {10, 90}, {10, 90}, {10, 90}}};
+    constexpr TransformProfile::TTriggerParameters kBenchmarkTriggerParameters = {
+        {{10, 90}, {10, 90}}};
+    constexpr TransformProfile::SRadialParameters kBenchmarkRadialParameters = {
+        .isEnabled = true, .antiDeadzonePercent = 0, .circleToSquare = false};
+    constexpr TransformProfile::SRadialParameters kBenchmarkRadialSquareParameters = {
+        .isEnabled = true, .antiDeadzonePercent = 20, .circleToSquare = true};
+
+    const struct
+    {
+      std::wstring_view name;
+      TransformProfile transformProfile;
+    } kBenchmarkTransformProfiles[] = {
+        {L"Axial",
+         TransformProfile(
+             kBenchmarkStickParameters,
+             kBenchmarkTriggerParameters,
+             {TransformProfile::kAxialParameters, TransformProfile::kAxialParameters})},
+        {L"Radial",
+         TransformProfile(
+             kBenchmarkStickParameters,
+             kBenchmarkTriggerParameters,
+             {kBenchmarkRadialParameters, kBenchmarkRadialParameters})},
+        {L"RadialAntiDeadzoneSquare",
+         TransformProfile(
+             kBenchmarkStickParameters,
+             kBenchmarkTriggerParameters,
+             {kBenchmarkRadialSquareParameters, kBenchmarkRadialSquareParameters})}};
+
+    const Mapper* const mapper = Mapper::GetByName(L"StandardGamepad");
+    const std::vector<TPhysicalStateSet> physicalStateSets = GeneratePhysicalStateSets();
+
+    for (const auto& benchmarkTransformProfile : kBenchmarkTransformProfiles)
+    {
+      context.Measure(
+          std::wstring(benchmarkTransformProfile.name) + L"/ApplyToSticks",
+          kNumOperations,
+          [&](uint64_t iteration) -> void
+          {
+            std::array<int16_t, (int)EPhysicalStick::Count> stickValues =
+                physicalStateSets[iteration & (kNumPhysicalStateSets - 1)][0].stick;
+            benchmarkTransformProfile.transformProfile.ApplyToSticks(stickValues);
+            DoNotOptimize(stickValues);
+          });
+
+      context.Measure(
+          std::wstring(benchmarkTransformProfile.name) + L"/Map",
+          kNumOperations,
+          [&](uint64_t iteration) -> void
+          {
+            const SState virtualState = mapper->MapStatePhysicalToVirtual(
+                physicalStateSets[iteration & (kNumPhysicalStateSets - 1)][0],
+                0,
+                benchmarkTransformProfile.transformProfile);
+            DoNotOptimize(virtualState);
+          });
+    }
+  }
+
+  // Compares building every custom mapper defined in a configuration file up front against
+  // building on demand only the custom mappers that are actually requested, which in this case is
+  // two out of many. Each operation creates a full set of blueprints, builds the required custom
+  // mappers, and destroys them.
+  BENCHMARK_CASE(Mapper_BuildCustomMappers_EagerVersusDeferred)
+  {
+    // Each blueprint permanently stores its mapper and template names, so the number of operations
+    // is kept low to limit memory growth.
+    constexpr uint64_t kNumBuildOperations = 1000;
+    constexpr unsigned int kNumBlueprints = 32;
+    constexpr unsigned int kNumRequestedMappers = 2;
+    constexpr std::wstring_view kTemplateMapperName = L"StandardGamepad";
+
+    std::vector<std::wstring> mapperNames;
+    for (unsigned int i = 0; i < kNumBlueprints; ++i)
+      mapperNames.push_back(L"BenchmarkCustomMapper" + std::to_wstring(i));
+
+    auto createBlueprints = [&mapperNames, kTemplateMapperName](MapperBuilder& builder) -> void
+    {
+      for (unsigned int i = 0; i < kNumBlueprints; ++i)
+      {
+        builder.CreateBlueprint(mapperNames[i]);
+        builder.SetBlueprintTemplate(mapperNames[i], kTemplateMapperName);
+        builder.SetBlueprintElementMapper(
+            mapperNames[i],
+            ELEMENT_MAP_INDEX_OF(buttonA),
+            std::make_unique<ButtonMapper>((EButton)(i % (unsigned int)EButton::Count)));
+      }
+    };
+
+    context.Measure(
+        L"Eager",
+        kNumBuildOperations,
+        [&](uint64_t iteration) -> void
+        {
+          MapperBuilder builder;
+          createBlueprints(builder);
+          builder.Build();
+
+          for (const auto& mapperName : mapperNames)
+            delete Mapper::GetByNameIfBuilt(mapperName);
+        });
+
+    context.Measure(
+        L"Deferred",
+        kNumBuildOperations,
+        [&](uint64_t iteration) -> void
+        {
+          MapperBuilder builder;
+          createBlueprints(builder);
+          Mapper::SetDeferredBuilder(&builder);
+
+          const Mapper* requestedMappers[kNumRequestedMappers];
+          for (unsigned int i = 0; i < kNumRequestedMappers; ++i)
+            requestedMappers[i] = Mapper::GetByName(mapperNames[i]);
+          DoNotOptimize(requestedMappers);
+
+          Mapper::SetDeferredBuilder(nullptr);
+          for (const Mapper* requestedMapper : requestedMappers)
+            delete requestedMapper;
+        });
+  }
+
+  // Compares, for each built-in mapper, element mapper trees allocated individually from the heap
+  // against element mapper trees allocated contiguously from an arena, which is how mappers hold
+  // them. Cloning is measured with each operation copying one complete element map, and the
+  // number of allocations per copy is included in each label. Walking is measured with each
+  // operation asking every element mapper in one element map for a contribution. The heap-allocated
+  // trees that are walked are interleaved with other allocations, as they would be after parsing a
+  // configuration file, so the difference in walking time approximates the cost of the extra cache
+  // misses caused by scattering element mappers across the heap.
+  BENCHMARK_CASE(Mapper_ElementMap_HeapVersusArena)
+  {
+    constexpr std::wstring_view kBuiltinMapperNames[] = {
+        L"StandardGamepad",
+        L"DigitalGamepad",
+        L"ExtendedGamepad",
+        L"XInputNative",
+        L"XInputSharedTriggers"};
+    constexpr size_t kInterleavedAllocationSize = 96;
+
+    for (const auto& mapperName : kBuiltinMapperNames)
+    {
+      const Mapper* const mapper = Mapper::GetByName(mapperName);
+      const Mapper::UElementMap& elements = mapper->ElementMap();
+      const std::wstring numHeapAllocations =
+          std::to_wstring(mapper->GetElementMapperArena().GetAllocationCount());
+      const std::wstring numArenaAllocations =
+          std::to_wstring(mapper->GetElementMapperArena().GetBlockCount());
+
+      context.Measure(
+          std::wstring(mapperName) + L"/Clone/Heap/" + numHeapAllocations + L"Allocations",
+          kNumOperations,
+          [&](uint64_t iteration) -> void
+          {
+            const Mapper::UElementMap clonedElements = mapper->CloneElementMap();
+            DoNotOptimize(clonedElements);
+          });
+
+      context.Measure(
+          std::wstring(mapperName) + L"/Clone/Arena/" + numArenaAllocations + L"Allocations",
+          kNumOperations,
+          [&](uint64_t iteration) -> void
+          {
+            ElementMapperArena arena;
+            ElementMapperArena::ScopedUse arenaScope(arena);
+            const Mapper::UElementMap clonedElements = mapper->CloneElementMap();
+            DoNotOptimize(clonedElements);
+          });
+
+      std::vector<std::unique_ptr<uint8_t[]>> interleavedAllocations;
+      Mapper::UElementMap scatteredElements;
+      for (int i = 0; i < _countof(elements.all); ++i)
+      {
+        interleavedAllocations.emplace_back(new uint8_t[kInterleavedAllocationSize]);
+        if (nullptr != elements.all[i]) scatteredElements.all[i] = elements.all[i]->Clone();
+      }
+
+      for (const Mapper::UElementMap* walkedElements : {&scatteredElements, &elements})
+      {
+        context.Measure(
+            std::wstring(mapperName) +
+                ((walkedElements == &elements) ? L"/Walk/Arena" : L"/Walk/Heap"),
+            kNumOperations,
+            [&](uint64_t iteration) -> void
+            {
+              SState virtualState = {};
+              for (const auto& elementMapper : walkedElements->all)
+              {
+                if (nullptr != elementMapper)
+                  elementMapper->ContributeFromAnalogValue(
+                      virtualState, (int16_t)(iteration * 257), 0);
+              }
+              DoNotOptimize(virtualState);
+            });
+      }
+    }
+  }
+
+  // Compares creating every built-in mapper object, which used to happen during static
+  // initialization, against creating only the one built-in mapper that is typically used, which is
+  // what happens now that built-in mappers are created on first use. Also compares locating
+  // built-in mappers by name using the compile-time perfect hash table against using an ordered
+  // map keyed by name, which is how the registry locates all other mappers.
+  BENCHMARK_CASE(Mapper_BuiltInMappers_EagerVersusLazy)
+  {
+    constexpr uint64_t kNumCreateOperations = 1000;
+
+    const unsigned int numBuiltInMappers = MapperDefinitions::GetCount();
+
+    context.Measure(
+        L"Create/Eager/" + std::to_wstring(numBuiltInMappers) + L"Mappers",
+        kNumCreateOperations,
+        [numBuiltInMappers](uint64_t iteration) -> void
+        {
+          for (unsigned int i = 0; i < numBuiltInMappers; ++i)
+            DoNotOptimize(MapperDefinitions::CreateMapper(i));
+        });
+
+    context.Measure(
+        L"Create/Lazy/1Mapper",
+        kNumCreateOperations,
+        [](uint64_t iteration) -> void
+        {
+          DoNotOptimize(MapperDefinitions::CreateMapper(0));
+        });
+
+    std::vector<std::wstring_view> lookupNames;
+    std::map<std::wstring_view, unsigned int> orderedMapLookup;
+    for (unsigned int i = 0; i < numBuiltInMappers; ++i)
+    {
+      lookupNames.push_back(MapperDefinitions::GetDescription(i).name);
+      orderedMapLookup[MapperDefinitions::GetDescription(i).name] = i;
+    }
+    lookupNames.push_back(L"UnknownMapper");
+
+    context.Measure(
+        L"Lookup/PerfectHash",
+        kNumOperations,
+        [&lookupNames](uint64_t iteration) -> void
+        {
+          DoNotOptimize(MapperDefinitions::FindByName(lookupNames[iteration % lookupNames.size()]));
+        });
+
+    context.Measure(
+        L"Lookup/OrderedMap",
+        kNumOperations,
+        [&lookupNames, &orderedMapLookup](uint64_t iteration) -> void
+        {
+          DoNotOptimize(orderedMapLookup.find(lookupNames[iteration % lookupNames.size()]));
+        });
+  }
+
+  // Measures, for every built-in mapper and a set of representative custom mappers, the throughput
+  // of mapping each synthetic physical controller input stream. Each operation maps one physical
+  // controller state. Intended to be tracked between releases to catch regressions.
+  BENCHMARK_CASE(Mapper_Throughput_MapStatePhysicalToVirtual)
+  {
+    const std::vector<std::unique_ptr<const Mapper>> customMappers =
+        CreateRepresentativeCustomMappers();
+
+    for (int streamIndex = 0; streamIndex < (int)EInputStream::Count; ++streamIndex)
+    {
+      const EInputStream inputStream = (EInputStream)streamIndex;
+      const std::vector<SPhysicalState> physicalStates = GenerateInputStream(inputStream);
+
+      for (const Mapper* mapper : CollectThroughputMappers(customMappers))
+      {
+        context.Measure(
+            std::wstring(mapper->GetName()) + L"/" + std::wstring(InputStreamName(inputStream)),
+            kNumOperations,
+            [&](uint64_t iteration) -> void
+            {
+              const SState virtualState = mapper->MapStatePhysicalToVirtual(
+                  physicalStates[iteration & (kNumPhysicalStateSets - 1)], 0);
+              DoNotOptimize(virtualState);
+            });
+      }
+    }
+  }
+
+  // Measures, for every built-in mapper and a set of representative custom mappers, the throughput
+  // of producing the virtual controller state that corresponds to a neutral or disconnected
+  // physical controller. Each operation produces one virtual controller state.
+  BENCHMARK_CASE(Mapper_Throughput_MapNeutralPhysicalToVirtual)
+  {
+    const std::vector<std::unique_ptr<const Mapper>> customMappers =
+        CreateRepresentativeCustomMappers();
+
+    for (const Mapper* mapper : CollectThroughputMappers(customMappers))
+    {
+      context.Measure(
+          mapper->GetName(),
+          kNumOperations,
+          [&](uint64_t iteration) -> void
+          {
+            const SState virtualState = mapper->MapNeutralPhysicalToVirtual(
+                (uint32_t)(iteration % kPhysicalControllerCount));
+            DoNotOptimize(virtualState);
+          });
+    }
+  }
+
+  // Measures, for every built-in mapper and a set of representative custom mappers, the throughput
+  // of mapping virtual force feedback vectors to physical actuator values. The idle stream holds
+  // no force at all, and the sweep stream rotates a full-strength force around the X-Y plane while
+  // also varying the other axes. Each operation maps one force feedback vector.
+  BENCHMARK_CASE(Mapper_Throughput_MapForceFeedbackVirtualToPhysical)
+  {
+    constexpr double kTwoPi = 6.283185307179586;
+
+    const std::vector<std::unique_ptr<const Mapper>> customMappers =
+        CreateRepresentativeCustomMappers();
+
+    std::vector<ForceFeedback::TOrderedMagnitudeComponents> sweepComponents(
+        kNumPhysicalStateSets);
+    for (unsigned int i = 0; i < kNumPhysicalStateSets; ++i)
+    {
+      const double angle = (kTwoPi * (double)i) / (double)kNumPhysicalStateSets;
+
+      for (int axis = 0; axis < (int)EAxis::Count; ++axis)
+        sweepComponents[i][axis] = (ForceFeedback::TEffectValue)(
+            std::sin(angle + ((double)axis * kTwoPi / 4.0)) *
+            (double)ForceFeedback::kEffectModifierMaximum);
+    }
+
+    const std::vector<ForceFeedback::TOrderedMagnitudeComponents> idleComponents(
+        kNumPhysicalStateSets, ForceFeedback::TOrderedMagnitudeComponents{});
+
+    const struct
+    {
+      std::wstring_view name;
+      const std::vector<ForceFeedback::TOrderedMagnitudeComponents>& components;
+    } kForceFeedbackStreams[] = {{L"Idle", idleComponents}, {L"Sweep", sweepComponents}};
+
+    for (const auto& forceFeedbackStream : kForceFeedbackStreams)
+    {
+      for (const Mapper* mapper : CollectThroughputMappers(customMappers))
+      {
+        context.Measure(
+            std::wstring(mapper->GetName()) + L"/" + std::wstring(forceFeedbackStream.name),
+            kNumOperations,
+            [&](uint64_t iteration) -> void
+            {
+              const ForceFeedback::SPhysicalActuatorComponents physicalActuatorComponents =
+                  mapper->MapForceFeedbackVirtualToPhysical(
+                      forceFeedbackStream.components[iteration & (kNumPhysicalStateSets - 1)]);
+              DoNotOptimize(physicalActuatorComponents);
+            });
+      }
+    }
+  }
+} // namespace XidiBenchmark
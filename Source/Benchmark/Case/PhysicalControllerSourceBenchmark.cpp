@@ -0,0 +1,140 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file PhysicalControllerSourceBenchmark.cpp
+ *   Benchmarks that drive the physical controller input pipeline using synthetic input.
+ **************************************************************************************************/
+
+#include "BenchmarkCase.h"
+
+#include <array>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "ConcurrencyWrapper.h"
+#include "ControllerTypes.h"
+#include "Mapper.h"
+#include "PhysicalControllerSource.h"
+#include "SeqLock.h"
+
+namespace XidiBenchmark
+{
+  using namespace ::Xidi;
+  using namespace ::Xidi::Controller;
+
+  /// Number of operations timed by each measurement in this file.
+  static constexpr uint64_t kNumOperations = 200000;
+
+  /// Mirrors the work the physical controller polling threads do on each polling pass, for all
+  /// physical controllers at once: read from a source, publish the physical state, and if it
+  /// changed then map it and publish the resulting raw virtual state.
+  class SyntheticPipeline
+  {
+  public:
+
+    SyntheticPipeline(void)
+        : source({.sweepPeriodMilliseconds = 1000, .buttonMashRatePerSecond = 50}),
+          mappers(
+              {Mapper::GetByName(L"StandardGamepad"),
+               Mapper::GetByName(L"ExtendedGamepad"),
+               Mapper::GetByName(L"XInputNative"),
+               Mapper::GetByName(L"XInputSharedTriggers")}),
+          mappingCaches(),
+          physicalState(),
+          rawVirtualState()
+    {}
+
+    /// Runs one polling pass for all physical controllers.
+    /// @param [in] elapsedMilliseconds Simulated time since polling started.
+    void Poll(uint64_t elapsedMilliseconds)
+    {
+      for (TControllerIdentifier controllerIdentifier = 0;
+           controllerIdentifier < kPhysicalControllerCount;
+           ++controllerIdentifier)
+      {
+        const SPhysicalState newPhysicalState =
+            source.GetStateAt(controllerIdentifier, elapsedMilliseconds);
+
+        if (false == physicalState[controllerIdentifier].Update(newPhysicalState)) continue;
+
+        const SState newRawVirtualState = mappers[controllerIdentifier]->MapStatePhysicalToVirtual(
+            newPhysicalState, controllerIdentifier, mappingCaches[controllerIdentifier]);
+        if (newRawVirtualState != rawVirtualState[controllerIdentifier].Load())
+          rawVirtualState[controllerIdentifier].Store(newRawVirtualState);
+      }
+    }
+
+    /// Retrieves the published raw virtual state object for the specified physical controller.
+    /// @param [in] controllerIdentifier Identifier of the physical controller of interest.
+    /// @return Read-only reference to the published state object.
+    inline const SeqLock<SState>& RawVirtualState(TControllerIdentifier controllerIdentifier) const
+    {
+      return rawVirtualState[controllerIdentifier];
+    }
+
+  private:
+
+    /// Source of synthetic physical controller state.
+    SyntheticPhysicalControllerSource source;
+
+    /// Mappers, one per physical controller.
+    std::array<const Mapper*, kPhysicalControllerCount> mappers;
+
+    /// Incremental mapping caches, one per physical controller.
+    std::array<Mapper::SIncrementalMappingCache, kPhysicalControllerCount> mappingCaches;
+
+    /// Published physical states, one per physical controller.
+    std::array<ConcurrencyWrapper<SPhysicalState>, kPhysicalControllerCount> physicalState;
+
+    /// Published raw virtual states, one per physical controller.
+    std::array<SeqLock<SState>, kPhysicalControllerCount> rawVirtualState;
+  };
+
+  // Measures the cost of one polling pass over all physical controllers using synthetic input, both
+  // without any readers and with one reader thread per physical controller continuously reading
+  // the published raw virtual state.
+  BENCHMARK_CASE(PhysicalControllerSource_SyntheticPipeline)
+  {
+    SyntheticPipeline pipelineNoConsumers;
+
+    context.Measure(
+        L"NoConsumers",
+        kNumOperations,
+        [&](uint64_t iteration) -> void
+        {
+          pipelineNoConsumers.Poll(iteration);
+        });
+
+    SyntheticPipeline pipelineWithConsumers;
+    std::vector<std::jthread> consumerThreads;
+
+    for (TControllerIdentifier controllerIdentifier = 0;
+         controllerIdentifier < kPhysicalControllerCount;
+         ++controllerIdentifier)
+    {
+      consumerThreads.emplace_back(
+          [&pipelineWithConsumers, controllerIdentifier](std::stop_token stopToken) -> void
+          {
+            while (false == stopToken.stop_requested())
+              DoNotOptimize(pipelineWithConsumers.RawVirtualState(controllerIdentifier).Load());
+          });
+    }
+
+    context.Measure(
+        L"WithConsumers",
+        kNumOperations,
+        [&](uint64_t iteration) -> void
+        {
+          pipelineWithConsumers.Poll(iteration);
+        });
+
+    for (auto& consumerThread : consumerThreads)
+      consumerThread.request_stop();
+  }
+} // namespace XidiBenchmark
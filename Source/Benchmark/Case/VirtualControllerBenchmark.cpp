@@ -0,0 +1,146 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file VirtualControllerBenchmark.cpp
+ *   Benchmarks for creating virtual controller objects and reading their state.
+ **************************************************************************************************/
+
+#include "BenchmarkCase.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stop_token>
+#include <thread>
+
+#include "ControllerTypes.h"
+#include "Mapper.h"
+#include "MockPhysicalController.h"
+#include "VirtualController.h"
+
+namespace XidiBenchmark
+{
+  using namespace ::Xidi::Controller;
+  using ::XidiTest::MockPhysicalController;
+
+  /// Number of operations timed by each measurement in this file.
+  static constexpr uint64_t kNumOperations = 200000;
+
+  /// Number of distinct raw virtual controller states that are cycled through when refreshing
+  /// virtual controller state.
+  static constexpr unsigned int kNumRawStates = 64;
+
+  /// Generates a sequence of raw virtual controller states that all differ from one another, so
+  /// that every refresh changes the processed state and publishes it to readers.
+  /// @return Array of raw virtual controller states.
+  static std::array<SState, kNumRawStates> GenerateRawStates(void)
+  {
+    std::array<SState, kNumRawStates> rawStates = {};
+
+    for (unsigned int i = 0; i < kNumRawStates; ++i)
+    {
+      for (unsigned int axis = 0; axis < rawStates[i].axis.size(); ++axis)
+        rawStates[i].axis[axis] = (int32_t)(((i * 509) + (axis * 131)) % kAnalogValueMax);
+
+      rawStates[i].button = (unsigned long)(i * 0x1111);
+      rawStates[i].povDirection.components[i % (int)EPovDirection::Count] = true;
+    }
+
+    return rawStates;
+  }
+
+  // Measures the cost of reading virtual controller state the way an application does. First the
+  // reading thread runs alone. Then a second thread refreshes the state as quickly as it can, which
+  // is a far higher rate than any physical controller produces and therefore a worst case for
+  // contention. Finally a third thread also reads the state as quickly as it can, which mirrors a
+  // game whose render thread and input thread both poll the same device.
+  BENCHMARK_CASE(VirtualController_GetState_ConcurrentPolling)
+  {
+    constexpr TControllerIdentifier kControllerIdentifier = 0;
+    static const std::array<SState, kNumRawStates> kRawStates = GenerateRawStates();
+
+    MockPhysicalController physicalController(
+        kControllerIdentifier, *Mapper::GetByName(L"StandardGamepad"));
+    VirtualController controller(kControllerIdentifier);
+
+    context.Measure(
+        L"ReaderOnly",
+        kNumOperations,
+        [&controller](uint64_t iteration) -> void
+        {
+          DoNotOptimize(controller.GetState());
+        });
+
+    std::jthread refreshThread(
+        [&controller](std::stop_token stopToken) -> void
+        {
+          for (uint64_t i = 0; false == stopToken.stop_requested(); ++i)
+            controller.RefreshState(kRawStates[i % kNumRawStates]);
+        });
+
+    context.Measure(
+        L"WithRefreshThread",
+        kNumOperations,
+        [&controller](uint64_t iteration) -> void
+        {
+          DoNotOptimize(controller.GetState());
+        });
+
+    std::jthread secondReaderThread(
+        [&controller](std::stop_token stopToken) -> void
+        {
+          while (false == stopToken.stop_requested())
+            DoNotOptimize(controller.GetState());
+        });
+
+    context.Measure(
+        L"WithRefreshThreadAndSecondReader",
+        kNumOperations,
+        [&controller](uint64_t iteration) -> void
+        {
+          DoNotOptimize(controller.GetState());
+        });
+
+    secondReaderThread.request_stop();
+    refreshThread.request_stop();
+  }
+
+  // Measures the cost of creating and destroying a virtual controller object, which some
+  // applications do repeatedly, both when it is the only one associated with its physical
+  // controller and when several others already exist.
+  BENCHMARK_CASE(VirtualController_CreateDestroy)
+  {
+    constexpr TControllerIdentifier kControllerIdentifier = 0;
+    constexpr unsigned int kNumOtherControllers = 3;
+    constexpr uint64_t kNumCreateDestroyOperations = 20000;
+
+    MockPhysicalController physicalController(
+        kControllerIdentifier, *Mapper::GetByName(L"StandardGamepad"));
+
+    context.Measure(
+        L"Alone",
+        kNumCreateDestroyOperations,
+        [](uint64_t iteration) -> void
+        {
+          VirtualController controller(kControllerIdentifier);
+          DoNotOptimize(controller);
+        });
+
+    std::array<std::unique_ptr<VirtualController>, kNumOtherControllers> otherControllers;
+    for (auto& otherController : otherControllers)
+      otherController = std::make_unique<VirtualController>(kControllerIdentifier);
+
+    context.Measure(
+        L"WithOthers",
+        kNumCreateDestroyOperations,
+        [](uint64_t iteration) -> void
+        {
+          VirtualController controller(kControllerIdentifier);
+          DoNotOptimize(controller);
+        });
+  }
+} // namespace XidiBenchmark
@@ -0,0 +1,77 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file Clock.cpp
+ *   Implementation of the monotonic high-resolution clock used for all internal timekeeping.
+ **************************************************************************************************/
+
+#include "Clock.h"
+
+#include <cstdint>
+
+#include "ApiWindows.h"
+
+namespace Xidi
+{
+  namespace Clock
+  {
+    /// Converts a number of clock ticks to another unit, avoiding overflow for any tick count that
+    /// the clock can realistically reach.
+    /// @param [in] ticks Number of clock ticks to convert.
+    /// @param [in] unitsPerSecond Number of the desired units in one second.
+    /// @return Equivalent number of the desired units, rounded down.
+    static inline uint64_t TicksToUnits(TTimestamp ticks, uint64_t unitsPerSecond)
+    {
+      const uint64_t frequency = GetFrequency();
+      return ((ticks / frequency) * unitsPerSecond) +
+          (((ticks % frequency) * unitsPerSecond) / frequency);
+    }
+
+    uint64_t GetFrequency(void)
+    {
+      // Windows guarantees that the performance counter is available and that its frequency is
+      // non-zero and never changes while the system is running.
+      static const uint64_t frequency = []() -> uint64_t
+      {
+        LARGE_INTEGER performanceFrequency;
+        QueryPerformanceFrequency(&performanceFrequency);
+        return (uint64_t)performanceFrequency.QuadPart;
+      }();
+
+      return frequency;
+    }
+
+    TTimestamp Now(void)
+    {
+      LARGE_INTEGER performanceCount;
+      QueryPerformanceCounter(&performanceCount);
+      return (TTimestamp)performanceCount.QuadPart;
+    }
+
+    TTimestamp TicksFromMilliseconds(uint64_t milliseconds)
+    {
+      const uint64_t frequency = GetFrequency();
+      return ((milliseconds / 1000) * frequency) +
+          ((((milliseconds % 1000) * frequency) + 999) / 1000);
+    }
+
+    uint64_t TicksToMilliseconds(TTimestamp ticks)
+    {
+      return TicksToUnits(ticks, 1000ull);
+    }
+
+    uint64_t TicksToMicroseconds(TTimestamp ticks)
+    {
+      return TicksToUnits(ticks, 1000000ull);
+    }
+
+    uint64_t TicksToNanoseconds(TTimestamp ticks)
+    {
+      return TicksToUnits(ticks, 1000000000ull);
+    }
+  } // namespace Clock
+} // namespace Xidi
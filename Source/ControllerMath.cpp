@@ -13,6 +13,12 @@
 #include "ControllerMath.h"
 
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
 
 #include "ControllerTypes.h"
 
@@ -65,6 +71,88 @@ namespace Xidi
 
         return kTriggerValueMin + (uint8_t)(transformedTriggerBase * transformationScaleFactor);
       }
+
+      RawAnalogTransformTable::RawAnalogTransformTable(
+          unsigned int deadzonePercent, unsigned int saturationPercent)
+          : transformedValues()
+      {
+        for (int32_t analogValue = std::numeric_limits<int16_t>::min();
+             analogValue <= std::numeric_limits<int16_t>::max();
+             ++analogValue)
+          transformedValues[(uint16_t)analogValue] =
+              ApplyRawAnalogTransform((int16_t)analogValue, deadzonePercent, saturationPercent);
+      }
+
+      std::shared_ptr<const RawAnalogTransformTable> RawAnalogTransformTable::Get(
+          unsigned int deadzonePercent, unsigned int saturationPercent)
+      {
+        static std::mutex tablesGuard;
+        static std::map<
+            std::pair<unsigned int, unsigned int>,
+            std::weak_ptr<const RawAnalogTransformTable>>
+            tables;
+
+        std::scoped_lock lock(tablesGuard);
+
+        std::shared_ptr<const RawAnalogTransformTable> table =
+            tables[{deadzonePercent, saturationPercent}].lock();
+        if (nullptr == table)
+        {
+          // Entries for tables that are no longer in use are pruned whenever a table is built, so
+          // the number of entries is bounded by the number of tables in use plus one.
+          std::erase_if(
+              tables,
+              [](const auto& entry) -> bool
+              {
+                return entry.second.expired();
+              });
+          table.reset(new RawAnalogTransformTable(deadzonePercent, saturationPercent));
+          tables[{deadzonePercent, saturationPercent}] = table;
+        }
+
+        return table;
+      }
+
+      RawTriggerTransformTable::RawTriggerTransformTable(
+          unsigned int deadzonePercent, unsigned int saturationPercent)
+          : transformedValues()
+      {
+        for (int32_t triggerValue = std::numeric_limits<uint8_t>::min();
+             triggerValue <= std::numeric_limits<uint8_t>::max();
+             ++triggerValue)
+          transformedValues[triggerValue] =
+              ApplyRawTriggerTransform((uint8_t)triggerValue, deadzonePercent, saturationPercent);
+      }
+
+      std::shared_ptr<const RawTriggerTransformTable> RawTriggerTransformTable::Get(
+          unsigned int deadzonePercent, unsigned int saturationPercent)
+      {
+        static std::mutex tablesGuard;
+        static std::map<
+            std::pair<unsigned int, unsigned int>,
+            std::weak_ptr<const RawTriggerTransformTable>>
+            tables;
+
+        std::scoped_lock lock(tablesGuard);
+
+        std::shared_ptr<const RawTriggerTransformTable> table =
+            tables[{deadzonePercent, saturationPercent}].lock();
+        if (nullptr == table)
+        {
+          // Entries for tables that are no longer in use are pruned whenever a table is built, so
+          // the number of entries is bounded by the number of tables in use plus one.
+          std::erase_if(
+              tables,
+              [](const auto& entry) -> bool
+              {
+                return entry.second.expired();
+              });
+          table.reset(new RawTriggerTransformTable(deadzonePercent, saturationPercent));
+          tables[{deadzonePercent, saturationPercent}] = table;
+        }
+
+        return table;
+      }
     } // namespace Math
   }   // namespace Controller
 } // namespace Xidi
@@ -27,6 +27,26 @@ namespace Xidi
 {
   namespace Controller
   {
+    /// Deadzone percentage applied to analog and trigger values that are contributed to mouse
+    /// axes, if built-in properties are enabled.
+    static constexpr unsigned int kMouseAxisDeadzonePercent = 8;
+
+    /// Saturation percentage applied to analog and trigger values that are contributed to mouse
+    /// axes, if built-in properties are enabled.
+    static constexpr unsigned int kMouseAxisSaturationPercent = 92;
+
+    /// Determines if built-in deadzone and saturation properties should be applied to analog and
+    /// trigger values that are contributed to mouse axes, as specified in the configuration file.
+    /// @return `true` if so, `false` if the values should be contributed unmodified.
+    static bool IsMouseAxisPropertiesEnabled(void)
+    {
+      return Globals::GetConfigurationData()
+          .GetFirstBooleanValue(
+              Strings::kStrConfigurationSectionProperties,
+              Strings::kStrConfigurationSettingsPropertiesUseBuiltinProperties)
+          .value_or(true);
+    }
+
     std::unique_ptr<IElementMapper> AxisMapper::Clone(void) const
     {
       return std::make_unique<AxisMapper>(*this);
@@ -35,79 +55,23 @@ namespace Xidi
     void AxisMapper::ContributeFromAnalogValue(
         SState& controllerState, int16_t analogValue, uint32_t sourceIdentifier) const
     {
-      int32_t axisValueToContribute = (int32_t)analogValue;
-
-      switch (direction)
-      {
-        case EAxisDirection::Both:
-          break;
-
-        case EAxisDirection::Positive:
-          axisValueToContribute = (axisValueToContribute - kAnalogValueMin) >> 1;
-          break;
-
-        case EAxisDirection::Negative:
-          axisValueToContribute = (axisValueToContribute - kAnalogValueMax) >> 1;
-          break;
-      }
-
-      controllerState[axis] += axisValueToContribute;
+      const int16_t analogValueForContribution =
+          ((nullptr == responseCurve) ? analogValue : responseCurve->ApplyToAnalog(analogValue));
+      controllerState[axis] += AxisValueFromAnalogValue(direction, analogValueForContribution);
     }
 
     void AxisMapper::ContributeFromButtonValue(
         SState& controllerState, bool buttonPressed, uint32_t sourceIdentifier) const
     {
-      int32_t axisValueToContribute = 0;
-
-      switch (direction)
-      {
-        case EAxisDirection::Both:
-          axisValueToContribute = (buttonPressed ? kAnalogValueMax : kAnalogValueMin);
-          break;
-
-        case EAxisDirection::Positive:
-          axisValueToContribute = (buttonPressed ? kAnalogValueMax : kAnalogValueNeutral);
-          break;
-
-        case EAxisDirection::Negative:
-          axisValueToContribute = (buttonPressed ? kAnalogValueMin : kAnalogValueNeutral);
-          break;
-      }
-
-      controllerState[axis] += axisValueToContribute;
+      controllerState[axis] += AxisValueFromButtonValue(direction, buttonPressed);
     }
 
     void AxisMapper::ContributeFromTriggerValue(
         SState& controllerState, uint8_t triggerValue, uint32_t sourceIdentifier) const
     {
-      constexpr double kBidirectionalStepSize = (double)(kAnalogValueMax - kAnalogValueMin) /
-          (double)(kTriggerValueMax - kTriggerValueMin);
-      constexpr double kPositiveStepSize =
-          (double)kAnalogValueMax / (double)(kTriggerValueMax - kTriggerValueMin);
-      constexpr double kNegativeStepSize =
-          (double)kAnalogValueMin / (double)(kTriggerValueMax - kTriggerValueMin);
-
-      int32_t axisValueToContribute = 0;
-
-      switch (direction)
-      {
-        case EAxisDirection::Both:
-          axisValueToContribute =
-              (int32_t)((double)triggerValue * kBidirectionalStepSize) + kAnalogValueMin;
-          break;
-
-        case EAxisDirection::Positive:
-          axisValueToContribute =
-              (int32_t)((double)triggerValue * kPositiveStepSize) + kAnalogValueNeutral;
-          break;
-
-        case EAxisDirection::Negative:
-          axisValueToContribute =
-              (int32_t)((double)triggerValue * kNegativeStepSize) - kAnalogValueNeutral;
-          break;
-      }
-
-      controllerState[axis] += axisValueToContribute;
+      const uint8_t triggerValueForContribution =
+          ((nullptr == responseCurve) ? triggerValue : responseCurve->ApplyToTrigger(triggerValue));
+      controllerState[axis] += AxisValueFromTriggerValue(direction, triggerValueForContribution);
     }
 
     int AxisMapper::GetTargetElementCount(void) const
@@ -243,27 +207,8 @@ namespace Xidi
     void DigitalAxisMapper::ContributeFromAnalogValue(
         SState& controllerState, int16_t analogValue, uint32_t sourceIdentifier) const
     {
-      int32_t axisValueToContribute = 0;
-
-      switch (GetAxisDirection())
-      {
-        case EAxisDirection::Both:
-          if (Math::IsAnalogPressedNegative(analogValue))
-            axisValueToContribute = kAnalogValueMin;
-          else if (Math::IsAnalogPressedPositive(analogValue))
-            axisValueToContribute = kAnalogValueMax;
-          break;
-
-        case EAxisDirection::Positive:
-          if (Math::IsAnalogPressedPositive(analogValue)) axisValueToContribute = kAnalogValueMax;
-          break;
-
-        case EAxisDirection::Negative:
-          if (Math::IsAnalogPressedNegative(analogValue)) axisValueToContribute = kAnalogValueMin;
-          break;
-      }
-
-      controllerState[GetAxis()] += axisValueToContribute;
+      controllerState[GetAxis()] +=
+          DigitalAxisValueFromAnalogValue(GetAxisDirection(), analogValue);
     }
 
     void DigitalAxisMapper::ContributeFromTriggerValue(
@@ -388,24 +333,16 @@ namespace Xidi
     void MouseAxisMapper::ContributeFromAnalogValue(
         SState& controllerState, int16_t analogValue, uint32_t sourceIdentifier) const
     {
-      static const bool kEnableMouseAxisProperites =
-          Globals::GetConfigurationData()
-              .GetFirstBooleanValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesUseBuiltinProperties)
-              .value_or(true);
-
       constexpr double kAnalogToMouseScalingFactor =
           (double)(Mouse::kMouseMovementUnitsMax - Mouse::kMouseMovementUnitsMin) /
           (double)(kAnalogValueMax - kAnalogValueMin);
 
-      constexpr unsigned int kAnalogMouseDeadzonePercent = 8;
-      constexpr unsigned int kAnalogMouseSaturationPercent = 92;
-      const int16_t analogValueForContribution =
-          (kEnableMouseAxisProperites
-               ? Math::ApplyRawAnalogTransform(
-                     analogValue, kAnalogMouseDeadzonePercent, kAnalogMouseSaturationPercent)
-               : analogValue);
+      static const std::shared_ptr<const Math::RawAnalogTransformTable> kAnalogMouseTransform =
+          (IsMouseAxisPropertiesEnabled()
+               ? Math::RawAnalogTransformTable::Get(
+                     kMouseAxisDeadzonePercent, kMouseAxisSaturationPercent)
+               : Math::RawAnalogTransformTable::Get(0, 100));
+      const int16_t analogValueForContribution = kAnalogMouseTransform->Apply(analogValue);
 
       const double mouseAxisValueRaw =
           ((double)(analogValueForContribution - kAnalogValueNeutral) *
@@ -464,13 +401,6 @@ namespace Xidi
     void MouseAxisMapper::ContributeFromTriggerValue(
         SState& controllerState, uint8_t triggerValue, uint32_t sourceIdentifier) const
     {
-      static const bool kEnableMouseAxisProperites =
-          Globals::GetConfigurationData()
-              .GetFirstBooleanValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesUseBuiltinProperties)
-              .value_or(true);
-
       constexpr double kBidirectionalStepSize =
           (double)(Mouse::kMouseMovementUnitsMax - Mouse::kMouseMovementUnitsMin) /
           (double)(kTriggerValueMax - kTriggerValueMin);
@@ -479,13 +409,12 @@ namespace Xidi
       constexpr double kNegativeStepSize =
           (double)Mouse::kMouseMovementUnitsMin / (double)(kTriggerValueMax - kTriggerValueMin);
 
-      constexpr unsigned int kTriggerMouseDeadzonePercent = 8;
-      constexpr unsigned int kTriggerMouseSaturationPercent = 92;
-      const uint8_t triggerValueForContribution =
-          (kEnableMouseAxisProperites
-               ? Math::ApplyRawTriggerTransform(
-                     triggerValue, kTriggerMouseDeadzonePercent, kTriggerMouseSaturationPercent)
-               : triggerValue);
+      static const std::shared_ptr<const Math::RawTriggerTransformTable> kTriggerMouseTransform =
+          (IsMouseAxisPropertiesEnabled()
+               ? Math::RawTriggerTransformTable::Get(
+                     kMouseAxisDeadzonePercent, kMouseAxisSaturationPercent)
+               : Math::RawTriggerTransformTable::Get(0, 100));
+      const uint8_t triggerValueForContribution = kTriggerMouseTransform->Apply(triggerValue);
 
       int mouseAxisValueToContribute = 0;
 
@@ -0,0 +1,112 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ElementMapperArena.cpp
+ *   Implementation of arena allocation for element mapper objects.
+ **************************************************************************************************/
+
+#include "ElementMapperArena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Precedes every element mapper object in memory, whether it was allocated from the heap or
+    /// from an arena, so that releasing an object can determine where its memory came from. Its
+    /// alignment keeps the objects that follow it suitably aligned.
+    struct alignas(std::max_align_t) SAllocationHeader
+    {
+      /// Arena from which the object was allocated, or `nullptr` if it came from the heap.
+      ElementMapperArena* arena;
+    };
+
+    /// Arena in use on the current thread, if any.
+    static thread_local ElementMapperArena* currentArena = nullptr;
+
+    /// Rounds the specified object size up so that objects allocated one after another remain
+    /// suitably aligned.
+    /// @param [in] size Object size, in bytes.
+    /// @return Rounded object size, in bytes.
+    static constexpr size_t AlignedSize(size_t size)
+    {
+      return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    }
+
+    ElementMapperArena::ScopedUse::ScopedUse(ElementMapperArena& arena)
+        : previousArena(currentArena)
+    {
+      currentArena = &arena;
+    }
+
+    ElementMapperArena::ScopedUse::~ScopedUse(void)
+    {
+      currentArena = previousArena;
+    }
+
+    void* ElementMapperArena::AllocateElementMapper(size_t size)
+    {
+      const size_t allocationSize = sizeof(SAllocationHeader) + AlignedSize(size);
+
+      SAllocationHeader* const header =
+          ((nullptr == currentArena)
+               ? static_cast<SAllocationHeader*>(::operator new(allocationSize))
+               : static_cast<SAllocationHeader*>(currentArena->Allocate(allocationSize)));
+      header->arena = currentArena;
+
+      return &header[1];
+    }
+
+    void ElementMapperArena::ReleaseElementMapper(void* ptr)
+    {
+      if (nullptr == ptr) return;
+
+      SAllocationHeader* const header = &(static_cast<SAllocationHeader*>(ptr)[-1]);
+      if (nullptr == header->arena) ::operator delete(header);
+    }
+
+    bool ElementMapperArena::Contains(const void* ptr) const
+    {
+      const uint8_t* const bytePtr = static_cast<const uint8_t*>(ptr);
+
+      for (const auto& block : blocks)
+      {
+        if ((bytePtr >= block.memory.get()) && (bytePtr < (block.memory.get() + block.used)))
+          return true;
+      }
+
+      return false;
+    }
+
+    void* ElementMapperArena::Allocate(size_t size)
+    {
+      if ((true == blocks.empty()) || ((blocks.back().size - blocks.back().used) < size))
+      {
+        const size_t blockSize = ((size > kDefaultBlockSize) ? size : kDefaultBlockSize);
+
+        // Plain `new` of a byte array only guarantees fundamental alignment, which is all that
+        // element mappers require.
+        blocks.push_back(
+            {.memory = std::unique_ptr<uint8_t[]>(new uint8_t[blockSize]),
+             .size = blockSize,
+             .used = 0});
+      }
+
+      SBlock& block = blocks.back();
+      void* const allocatedMemory = &block.memory[block.used];
+
+      block.used += size;
+      allocationCount += 1;
+      bytesUsed += size;
+
+      return allocatedMemory;
+    }
+  } // namespace Controller
+} // namespace Xidi
@@ -0,0 +1,528 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ElementProgram.cpp
+ *   Implementation of the compiled form of element mappers, which is a flat array of operations
+ *   that can be evaluated without walking a tree of element mapper objects.
+ **************************************************************************************************/
+
+#include "ElementProgram.h"
+
+#include <cstdint>
+#include <typeinfo>
+#include <vector>
+
+#include "ControllerMath.h"
+#include "ControllerTypes.h"
+#include "ElementMapper.h"
+#include "ResponseCurve.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Operation flag indicating that analog and trigger input values are inverted before use, in
+    /// the same way as #InvertMapper does it.
+    static constexpr uint8_t kOperationFlagInvertValue = 1 << 0;
+
+    /// Operation flag indicating that button input values are inverted before use. Tracked
+    /// separately from analog and trigger values because split mappers replace button values.
+    static constexpr uint8_t kOperationFlagInvertButtonValue = 1 << 1;
+
+    /// Operation flag indicating that the button input value is replaced by a pressed button before
+    /// any inversion is applied, which is what split mappers pass to whichever branch they select.
+    static constexpr uint8_t kOperationFlagReplaceButtonValue = 1 << 2;
+
+    /// Operation flag indicating that a side effect operation makes a neutral contribution instead
+    /// of using the input value at all, which is what split mappers do to the unselected branch.
+    static constexpr uint8_t kOperationFlagNeutral = 1 << 3;
+
+    /// Determines if the element mapper object is exactly of the specified type. Subclasses do not
+    /// match because they might override behavior that the compiled operations would bypass.
+    /// @tparam ElementMapperType Element mapper type to check.
+    /// @param [in] elementMapper Element mapper object to check.
+    /// @return `true` if the object is of the specified type, `false` otherwise.
+    template <typename ElementMapperType> static inline bool IsElementMapperOfType(
+        const IElementMapper& elementMapper)
+    {
+      return (typeid(elementMapper) == typeid(ElementMapperType));
+    }
+
+    /// Appends operations that reproduce the neutral contribution of an element mapper tree. Only
+    /// element mappers with side effects make neutral contributions, so all other element mappers
+    /// compile to nothing.
+    /// @param [in] elementMapper Element mapper tree to compile, or `nullptr` for nothing.
+    /// @param [in,out] operations Operation array to which to append.
+    static void CompileNeutral(
+        const IElementMapper* elementMapper, std::vector<ElementProgram::SOperation>& operations)
+    {
+      if (nullptr == elementMapper) return;
+
+      if (true == IsElementMapperOfType<CompoundMapper>(*elementMapper))
+      {
+        for (const auto& underlyingElementMapper :
+             static_cast<const CompoundMapper*>(elementMapper)->GetElementMappers())
+          CompileNeutral(underlyingElementMapper.get(), operations);
+      }
+      else if (true == IsElementMapperOfType<InvertMapper>(*elementMapper))
+      {
+        CompileNeutral(
+            static_cast<const InvertMapper*>(elementMapper)->GetElementMapper(), operations);
+      }
+      else if (true == IsElementMapperOfType<SplitMapper>(*elementMapper))
+      {
+        CompileNeutral(
+            static_cast<const SplitMapper*>(elementMapper)->GetPositiveMapper(), operations);
+        CompileNeutral(
+            static_cast<const SplitMapper*>(elementMapper)->GetNegativeMapper(), operations);
+      }
+      else if (
+          (false == IsElementMapperOfType<AxisMapper>(*elementMapper)) &&
+          (false == IsElementMapperOfType<DigitalAxisMapper>(*elementMapper)) &&
+          (false == IsElementMapperOfType<ButtonMapper>(*elementMapper)) &&
+          (false == IsElementMapperOfType<PovMapper>(*elementMapper)))
+      {
+        operations.push_back(
+            {.opcode = ElementProgram::EOpcode::SideEffect,
+             .flags = kOperationFlagNeutral,
+             .elementMapper = elementMapper});
+      }
+    }
+
+    /// Appends operations that reproduce the contributions of an element mapper tree.
+    /// @param [in] elementMapper Element mapper tree to compile, or `nullptr` for nothing.
+    /// @param [in] flags Operation flags in effect at the root of the tree, which accumulate the
+    /// effects of any inversions and splits above it.
+    /// @param [in,out] operations Operation array to which to append.
+    static void Compile(
+        const IElementMapper* elementMapper,
+        uint8_t flags,
+        std::vector<ElementProgram::SOperation>& operations)
+    {
+      using EOpcode = ElementProgram::EOpcode;
+
+      if (nullptr == elementMapper) return;
+
+      if (true == IsElementMapperOfType<AxisMapper>(*elementMapper))
+      {
+        const AxisMapper* const axisMapper = static_cast<const AxisMapper*>(elementMapper);
+        if (nullptr == axisMapper->GetResponseCurve())
+          operations.push_back(
+              {.opcode = EOpcode::AxisWrite,
+               .flags = flags,
+               .target = (uint8_t)axisMapper->GetAxis(),
+               .direction = axisMapper->GetAxisDirection()});
+        else
+          operations.push_back(
+              {.opcode = EOpcode::CurvedAxisWrite,
+               .flags = flags,
+               .target = (uint8_t)axisMapper->GetAxis(),
+               .direction = axisMapper->GetAxisDirection(),
+               .elementMapper = axisMapper});
+      }
+      else if (true == IsElementMapperOfType<DigitalAxisMapper>(*elementMapper))
+      {
+        const DigitalAxisMapper* const digitalAxisMapper =
+            static_cast<const DigitalAxisMapper*>(elementMapper);
+        operations.push_back(
+            {.opcode = EOpcode::DigitalAxisWrite,
+             .flags = flags,
+             .target = (uint8_t)digitalAxisMapper->GetAxis(),
+             .direction = digitalAxisMapper->GetAxisDirection()});
+      }
+      else if (true == IsElementMapperOfType<ButtonMapper>(*elementMapper))
+      {
+        const SElementIdentifier targetElement = *elementMapper->GetTargetElementAt(0);
+        operations.push_back(
+            {.opcode = EOpcode::ButtonWrite,
+             .flags = flags,
+             .target = (uint8_t)targetElement.button});
+      }
+      else if (true == IsElementMapperOfType<PovMapper>(*elementMapper))
+      {
+        operations.push_back(
+            {.opcode = EOpcode::PovWrite,
+             .flags = flags,
+             .target = (uint8_t)static_cast<const PovMapper*>(elementMapper)->GetDirection()});
+      }
+      else if (true == IsElementMapperOfType<CompoundMapper>(*elementMapper))
+      {
+        for (const auto& underlyingElementMapper :
+             static_cast<const CompoundMapper*>(elementMapper)->GetElementMappers())
+          Compile(underlyingElementMapper.get(), flags, operations);
+      }
+      else if (true == IsElementMapperOfType<InvertMapper>(*elementMapper))
+      {
+        Compile(
+            static_cast<const InvertMapper*>(elementMapper)->GetElementMapper(),
+            flags ^ (kOperationFlagInvertValue | kOperationFlagInvertButtonValue),
+            operations);
+      }
+      else if (true == IsElementMapperOfType<SplitMapper>(*elementMapper))
+      {
+        // Layout is the split operation, the positive branch followed by the neutral contribution
+        // of the negative branch, a jump past the rest, and finally the negative branch followed
+        // by the neutral contribution of the positive branch. This preserves the order in which
+        // split mappers invoke their branches.
+        const SplitMapper* const splitMapper = static_cast<const SplitMapper*>(elementMapper);
+        const uint8_t branchFlags = (flags & kOperationFlagInvertValue) |
+            kOperationFlagReplaceButtonValue;
+
+        const size_t splitPosition = operations.size();
+        operations.push_back({.opcode = EOpcode::Split, .flags = flags});
+
+        Compile(splitMapper->GetPositiveMapper(), branchFlags, operations);
+        CompileNeutral(splitMapper->GetNegativeMapper(), operations);
+
+        const size_t jumpPosition = operations.size();
+        operations.push_back({.opcode = EOpcode::Jump});
+        operations[splitPosition].jumpDistance = (uint16_t)(operations.size() - splitPosition);
+
+        Compile(splitMapper->GetNegativeMapper(), branchFlags, operations);
+        CompileNeutral(splitMapper->GetPositiveMapper(), operations);
+        operations[jumpPosition].jumpDistance = (uint16_t)(operations.size() - jumpPosition);
+      }
+      else
+      {
+        operations.push_back(
+            {.opcode = EOpcode::SideEffect, .flags = flags, .elementMapper = elementMapper});
+      }
+    }
+
+    /// Computes the analog value that an operation uses as its input.
+    /// @param [in] operation Operation of interest.
+    /// @param [in] analogValue Analog value supplied to the element as a whole.
+    /// @return Analog value to be used by the operation.
+    static inline int16_t OperationInputValue(
+        const ElementProgram::SOperation& operation, int16_t analogValue)
+    {
+      if (0 == (operation.flags & kOperationFlagInvertValue)) return analogValue;
+      return (int16_t)((kAnalogValueMax + kAnalogValueMin) - (int32_t)analogValue);
+    }
+
+    /// Computes the button value that an operation uses as its input.
+    /// @param [in] operation Operation of interest.
+    /// @param [in] buttonPressed Button value supplied to the element as a whole.
+    /// @return Button value to be used by the operation.
+    static inline bool OperationInputValue(
+        const ElementProgram::SOperation& operation, bool buttonPressed)
+    {
+      const bool buttonValue =
+          ((0 != (operation.flags & kOperationFlagReplaceButtonValue)) ? true : buttonPressed);
+      return (buttonValue != (0 != (operation.flags & kOperationFlagInvertButtonValue)));
+    }
+
+    /// Computes the trigger value that an operation uses as its input.
+    /// @param [in] operation Operation of interest.
+    /// @param [in] triggerValue Trigger value supplied to the element as a whole.
+    /// @return Trigger value to be used by the operation.
+    static inline uint8_t OperationInputValue(
+        const ElementProgram::SOperation& operation, uint8_t triggerValue)
+    {
+      if (0 == (operation.flags & kOperationFlagInvertValue)) return triggerValue;
+      return (uint8_t)((kTriggerValueMax + kTriggerValueMin) - (int32_t)triggerValue);
+    }
+
+    /// Computes the contribution of an axis write operation from an analog value.
+    /// @param [in] direction Target axis direction.
+    /// @param [in] analogValue Input value.
+    /// @return Value to add to the target axis.
+    static inline int32_t AxisValue(EAxisDirection direction, int16_t analogValue)
+    {
+      return AxisMapper::AxisValueFromAnalogValue(direction, analogValue);
+    }
+
+    /// Computes the contribution of an axis write operation from a button value.
+    /// @param [in] direction Target axis direction.
+    /// @param [in] buttonPressed Input value.
+    /// @return Value to add to the target axis.
+    static inline int32_t AxisValue(EAxisDirection direction, bool buttonPressed)
+    {
+      return AxisMapper::AxisValueFromButtonValue(direction, buttonPressed);
+    }
+
+    /// Computes the contribution of an axis write operation from a trigger value.
+    /// @param [in] direction Target axis direction.
+    /// @param [in] triggerValue Input value.
+    /// @return Value to add to the target axis.
+    static inline int32_t AxisValue(EAxisDirection direction, uint8_t triggerValue)
+    {
+      return AxisMapper::AxisValueFromTriggerValue(direction, triggerValue);
+    }
+
+    /// Applies a response curve to an analog value, for curved axis write operations.
+    /// @param [in] responseCurve Response curve to apply.
+    /// @param [in] analogValue Input value.
+    /// @return Transformed input value.
+    static inline int16_t CurvedValue(const ResponseCurve& responseCurve, int16_t analogValue)
+    {
+      return responseCurve.ApplyToAnalog(analogValue);
+    }
+
+    /// Applies a response curve to a button value, for curved axis write operations. Button values
+    /// are unaffected by response curves.
+    /// @param [in] responseCurve Response curve to apply.
+    /// @param [in] buttonPressed Input value.
+    /// @return Transformed input value.
+    static inline bool CurvedValue(const ResponseCurve& responseCurve, bool buttonPressed)
+    {
+      return buttonPressed;
+    }
+
+    /// Applies a response curve to a trigger value, for curved axis write operations.
+    /// @param [in] responseCurve Response curve to apply.
+    /// @param [in] triggerValue Input value.
+    /// @return Transformed input value.
+    static inline uint8_t CurvedValue(const ResponseCurve& responseCurve, uint8_t triggerValue)
+    {
+      return responseCurve.ApplyToTrigger(triggerValue);
+    }
+
+    /// Computes the contribution of a digital axis write operation from an analog value.
+    /// @param [in] direction Target axis direction.
+    /// @param [in] analogValue Input value.
+    /// @return Value to add to the target axis.
+    static inline int32_t DigitalAxisValue(EAxisDirection direction, int16_t analogValue)
+    {
+      return DigitalAxisMapper::DigitalAxisValueFromAnalogValue(direction, analogValue);
+    }
+
+    /// Computes the contribution of a digital axis write operation from a button value.
+    /// @param [in] direction Target axis direction.
+    /// @param [in] buttonPressed Input value.
+    /// @return Value to add to the target axis.
+    static inline int32_t DigitalAxisValue(EAxisDirection direction, bool buttonPressed)
+    {
+      return AxisMapper::AxisValueFromButtonValue(direction, buttonPressed);
+    }
+
+    /// Computes the contribution of a digital axis write operation from a trigger value.
+    /// @param [in] direction Target axis direction.
+    /// @param [in] triggerValue Input value.
+    /// @return Value to add to the target axis.
+    static inline int32_t DigitalAxisValue(EAxisDirection direction, uint8_t triggerValue)
+    {
+      return AxisMapper::AxisValueFromButtonValue(direction, Math::IsTriggerPressed(triggerValue));
+    }
+
+    /// Determines if an analog value is considered pressed by button and POV write operations.
+    /// @param [in] analogValue Input value.
+    /// @return `true` if pressed, `false` otherwise.
+    static inline bool IsPressed(int16_t analogValue)
+    {
+      return Math::IsAnalogPressed(analogValue);
+    }
+
+    /// Determines if a button value is considered pressed by button and POV write operations.
+    /// @param [in] buttonPressed Input value.
+    /// @return `true` if pressed, `false` otherwise.
+    static inline bool IsPressed(bool buttonPressed)
+    {
+      return buttonPressed;
+    }
+
+    /// Determines if a trigger value is considered pressed by button and POV write operations.
+    /// @param [in] triggerValue Input value.
+    /// @return `true` if pressed, `false` otherwise.
+    static inline bool IsPressed(uint8_t triggerValue)
+    {
+      return Math::IsTriggerPressed(triggerValue);
+    }
+
+    /// Determines if an analog value selects the positive branch of a split operation.
+    /// @param [in] analogValue Input value.
+    /// @return `true` for the positive branch, `false` for the negative branch.
+    static inline bool SelectsPositiveBranch(int16_t analogValue)
+    {
+      return ((int32_t)analogValue >= kAnalogValueNeutral);
+    }
+
+    /// Determines if a button value selects the positive branch of a split operation.
+    /// @param [in] buttonPressed Input value.
+    /// @return `true` for the positive branch, `false` for the negative branch.
+    static inline bool SelectsPositiveBranch(bool buttonPressed)
+    {
+      return buttonPressed;
+    }
+
+    /// Determines if a trigger value selects the positive branch of a split operation.
+    /// @param [in] triggerValue Input value.
+    /// @return `true` for the positive branch, `false` for the negative branch.
+    static inline bool SelectsPositiveBranch(uint8_t triggerValue)
+    {
+      return ((int32_t)triggerValue >= kTriggerValueMid);
+    }
+
+    /// Invokes an element mapper object with an analog value.
+    /// @param [in] elementMapper Element mapper to invoke.
+    /// @param [in,out] controllerState Controller state data structure to be updated.
+    /// @param [in] analogValue Input value.
+    /// @param [in] sourceIdentifier Opaque source identifier to pass along.
+    static inline void ContributeFromValue(
+        const IElementMapper& elementMapper,
+        SState& controllerState,
+        int16_t analogValue,
+        uint32_t sourceIdentifier)
+    {
+      elementMapper.ContributeFromAnalogValue(controllerState, analogValue, sourceIdentifier);
+    }
+
+    /// Invokes an element mapper object with a button value.
+    /// @param [in] elementMapper Element mapper to invoke.
+    /// @param [in,out] controllerState Controller state data structure to be updated.
+    /// @param [in] buttonPressed Input value.
+    /// @param [in] sourceIdentifier Opaque source identifier to pass along.
+    static inline void ContributeFromValue(
+        const IElementMapper& elementMapper,
+        SState& controllerState,
+        bool buttonPressed,
+        uint32_t sourceIdentifier)
+    {
+      elementMapper.ContributeFromButtonValue(controllerState, buttonPressed, sourceIdentifier);
+    }
+
+    /// Invokes an element mapper object with a trigger value.
+    /// @param [in] elementMapper Element mapper to invoke.
+    /// @param [in,out] controllerState Controller state data structure to be updated.
+    /// @param [in] triggerValue Input value.
+    /// @param [in] sourceIdentifier Opaque source identifier to pass along.
+    static inline void ContributeFromValue(
+        const IElementMapper& elementMapper,
+        SState& controllerState,
+        uint8_t triggerValue,
+        uint32_t sourceIdentifier)
+    {
+      elementMapper.ContributeFromTriggerValue(controllerState, triggerValue, sourceIdentifier);
+    }
+
+    /// Evaluates a range of compiled operations for a single input value.
+    /// @tparam ValueType Type of input value, which determines how it is interpreted.
+    /// @param [in] operation First operation to evaluate.
+    /// @param [in] end One past the last operation to evaluate.
+    /// @param [in,out] controllerState Controller state data structure to be updated.
+    /// @param [in] value Input value supplied to the element as a whole.
+    /// @param [in] sourceIdentifier Opaque source identifier to pass to side effect operations.
+    template <typename ValueType> static inline void Evaluate(
+        const ElementProgram::SOperation* operation,
+        const ElementProgram::SOperation* const end,
+        SState& controllerState,
+        ValueType value,
+        uint32_t sourceIdentifier)
+    {
+      using EOpcode = ElementProgram::EOpcode;
+
+      while (operation < end)
+      {
+        const ValueType operationValue = OperationInputValue(*operation, value);
+
+        switch (operation->opcode)
+        {
+          case EOpcode::AxisWrite:
+            controllerState[(EAxis)operation->target] +=
+                AxisValue(operation->direction, operationValue);
+            break;
+
+          case EOpcode::CurvedAxisWrite:
+            controllerState[(EAxis)operation->target] += AxisValue(
+                operation->direction,
+                CurvedValue(
+                    *static_cast<const AxisMapper*>(operation->elementMapper)->GetResponseCurve(),
+                    operationValue));
+            break;
+
+          case EOpcode::DigitalAxisWrite:
+            controllerState[(EAxis)operation->target] +=
+                DigitalAxisValue(operation->direction, operationValue);
+            break;
+
+          case EOpcode::ButtonWrite:
+            if (true == IsPressed(operationValue))
+              controllerState[(EButton)operation->target] = true;
+            break;
+
+          case EOpcode::PovWrite:
+            if (true == IsPressed(operationValue))
+              controllerState[(EPovDirection)operation->target] = true;
+            break;
+
+          case EOpcode::Split:
+            if (false == SelectsPositiveBranch(operationValue))
+            {
+              operation += operation->jumpDistance;
+              continue;
+            }
+            break;
+
+          case EOpcode::Jump:
+            operation += operation->jumpDistance;
+            continue;
+
+          case EOpcode::SideEffect:
+            if (0 != (operation->flags & kOperationFlagNeutral))
+              operation->elementMapper->ContributeNeutral(controllerState, sourceIdentifier);
+            else
+              ContributeFromValue(
+                  *operation->elementMapper, controllerState, operationValue, sourceIdentifier);
+            break;
+
+          default:
+            break;
+        }
+
+        operation += 1;
+      }
+    }
+
+    void ElementProgram::AppendElement(const IElementMapper* elementMapper)
+    {
+      Compile(elementMapper, 0, operations);
+      elementBoundaries.push_back((uint32_t)operations.size());
+    }
+
+    void ElementProgram::ContributeFromAnalogValue(
+        unsigned int elementIndex,
+        SState& controllerState,
+        int16_t analogValue,
+        uint32_t sourceIdentifier) const
+    {
+      Evaluate(
+          &operations.data()[elementBoundaries[elementIndex]],
+          &operations.data()[elementBoundaries[elementIndex + 1]],
+          controllerState,
+          analogValue,
+          sourceIdentifier);
+    }
+
+    void ElementProgram::ContributeFromButtonValue(
+        unsigned int elementIndex,
+        SState& controllerState,
+        bool buttonPressed,
+        uint32_t sourceIdentifier) const
+    {
+      Evaluate(
+          &operations.data()[elementBoundaries[elementIndex]],
+          &operations.data()[elementBoundaries[elementIndex + 1]],
+          controllerState,
+          buttonPressed,
+          sourceIdentifier);
+    }
+
+    void ElementProgram::ContributeFromTriggerValue(
+        unsigned int elementIndex,
+        SState& controllerState,
+        uint8_t triggerValue,
+        uint32_t sourceIdentifier) const
+    {
+      Evaluate(
+          &operations.data()[elementBoundaries[elementIndex]],
+          &operations.data()[elementBoundaries[elementIndex + 1]],
+          controllerState,
+          triggerValue,
+          sourceIdentifier);
+    }
+  } // namespace Controller
+} // namespace Xidi
@@ -15,9 +15,9 @@
 #include <memory>
 #include <mutex>
 
+#include "Clock.h"
 #include "ForceFeedbackEffect.h"
 #include "ForceFeedbackTypes.h"
-#include "ImportApiWinMM.h"
 
 namespace Xidi
 {
@@ -25,21 +25,29 @@ namespace Xidi
   {
     namespace ForceFeedback
     {
+      /// Retrieves the current time in milliseconds from the high-resolution clock, which unlike
+      /// system time does not depend on the system timer resolution. Wraps around in the same way
+      /// as system time, which relative timestamp computation tolerates.
+      /// @return Current time, in milliseconds.
+      static inline TEffectTimeMs CurrentTimestamp(void)
+      {
+        return (TEffectTimeMs)Clock::TicksToMilliseconds(Clock::Now());
+      }
+
       /// Computes the relative timestamp that corresponds to a given base and optional provided
       /// timestamp value.
       /// @param [in] timestampBase Fixed baseline timestamp.
       /// @param [in] timestamp Optional absolute timestamp value, which if absent results in the
-      /// current system time being used.
+      /// current time being used.
       /// @return Corresponding relative timestamp.
       static inline TEffectTimeMs RelativeTimestamp(
           TEffectTimeMs timestampBase, std::optional<TEffectTimeMs> timestamp)
       {
-        return ((true == timestamp.has_value()) ? timestamp.value()
-                                                : ImportApiWinMM::timeGetTime()) -
+        return ((true == timestamp.has_value()) ? timestamp.value() : CurrentTimestamp()) -
             timestampBase;
       }
 
-      Device::Device(void) : Device(ImportApiWinMM::timeGetTime()) {}
+      Device::Device(void) : Device(CurrentTimestamp()) {}
 
       Device::Device(TEffectTimeMs timestampBase)
           : mutex(),
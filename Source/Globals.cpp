@@ -81,27 +81,24 @@ namespace Xidi
 
 #ifndef XIDI_SKIP_MAPPERS
     /// Holds custom mapper blueprints produced while reading from a configuration file.
-    static Controller::MapperBuilder customMapperBuilder;
+    /// Heap-allocated and never destroyed because custom mappers are built on demand from these
+    /// blueprints, which can happen at any time.
+    static Controller::MapperBuilder* const customMapperBuilder = new Controller::MapperBuilder();
 #endif
 
 #ifndef XIDI_SKIP_MAPPERS
-    /// Attempts to build all custom mappers held by the custom mapper builder object.
-    /// Upon completion, regardless of outcome, clears out all of the stored blueprint objects.
-    static inline void BuildCustomMappers(void)
+    /// Arranges for the custom mapper builder object to build each custom mapper the first time it
+    /// is requested, rather than building all of them up front. Configuration files can define
+    /// many custom mappers, and typically only a few are actually used.
+    static inline void DeferCustomMappers(void)
     {
-      if ((false == customMapperBuilder.Build()) && (false == GetConfigurationData().HasErrors()))
-      {
-        if (true == Message::IsLogFileEnabled())
-          Message::Output(
-              Message::ESeverity::ForcedInteractiveWarning,
-              L"Errors were encountered during custom mapper construction. See log file for more information.");
-        else
-          Message::Output(
-              Message::ESeverity::ForcedInteractiveWarning,
-              L"Errors were encountered during custom mapper construction. Enable logging and see log file for more information.");
-      }
+      Controller::Mapper::SetDeferredBuilder(customMapperBuilder);
 
-      customMapperBuilder.Clear();
+      if (0 != customMapperBuilder->GetBlueprintCount())
+        Message::OutputFormatted(
+            Message::ESeverity::Info,
+            L"Deferred building of %u custom mapper(s) until they are first requested.",
+            (unsigned int)customMapperBuilder->GetBlueprintCount());
     }
 #endif
 
@@ -164,7 +161,7 @@ namespace Xidi
             XidiConfigReader configReader;
 
 #ifndef XIDI_SKIP_MAPPERS
-            configReader.SetMapperBuilder(&customMapperBuilder);
+            configReader.SetMapperBuilder(customMapperBuilder);
 #endif
 
             configData = configReader.ReadConfigurationFile(Strings::kStrConfigurationFilename);
@@ -226,7 +223,7 @@ namespace Xidi
       EnableLogIfConfigured();
 
 #ifndef XIDI_SKIP_MAPPERS
-      BuildCustomMappers();
+      DeferCustomMappers();
       Controller::Mapper::DumpRegisteredMappers();
 #endif
     }
@@ -0,0 +1,218 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file LatencyTrace.cpp
+ *   Implementation of optional end-to-end input latency tracing, from physical controller read to
+ *   application read.
+ **************************************************************************************************/
+
+#include "LatencyTrace.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "ApiWindows.h"
+#include "Clock.h"
+#include "ControllerTypes.h"
+#include "Globals.h"
+#include "Message.h"
+#include "Strings.h"
+
+namespace Xidi
+{
+  namespace LatencyTrace
+  {
+    /// Number of milliseconds between periodic summaries output to the log.
+    static constexpr unsigned int kSummaryPeriodMilliseconds = 10000;
+
+    /// Human-readable names for each stage, for use in summary output.
+    static constexpr const wchar_t* kStageNames[] = {
+        L"PhysicalRead",
+        L"RawVirtualStateUpdate",
+        L"VirtualControllerRefresh",
+        L"StateChangeEventSignal",
+        L"ApplicationRead",
+    };
+    static_assert(_countof(kStageNames) == (size_t)EStage::Count, "Stage name count mismatch.");
+
+    /// Whether or not tracing is enabled. Set at most once during initialization.
+    static std::atomic<bool> isTracingEnabled = false;
+
+    /// Latency histograms, one per stage.
+    static std::array<Histogram, (size_t)EStage::Count> stageHistograms;
+
+    /// Timestamps of the physical controller reads that produced the most recently published raw
+    /// virtual controller states, one per physical controller.
+    static std::array<std::atomic<TTimestamp>, Controller::kPhysicalControllerCount>
+        publishedOrigins;
+
+    /// Periodically outputs a summary of the latency histograms. Intended to be a thread entry
+    /// point.
+    static void PeriodicallyOutputSummary(void)
+    {
+      while (true)
+      {
+        Sleep(kSummaryPeriodMilliseconds);
+        OutputSummary();
+      }
+    }
+
+    unsigned int Histogram::BucketIndexForValue(uint64_t value)
+    {
+      if (value < kNumLinearBuckets) return (unsigned int)value;
+
+      const unsigned int exponent = (unsigned int)std::bit_width(value) - 1;
+      if (exponent > kMaxTrackedExponent) return (kNumBuckets - 1);
+
+      const unsigned int subBucket =
+          (unsigned int)(value >> (exponent - 5)) & (kNumSubBucketsPerPowerOfTwo - 1);
+      return kNumLinearBuckets + ((exponent - 6) * kNumSubBucketsPerPowerOfTwo) + subBucket;
+    }
+
+    uint64_t Histogram::LowerBoundForBucketIndex(unsigned int bucketIndex)
+    {
+      if (bucketIndex < kNumLinearBuckets) return (uint64_t)bucketIndex;
+
+      const unsigned int exponent =
+          6 + ((bucketIndex - kNumLinearBuckets) / kNumSubBucketsPerPowerOfTwo);
+      const unsigned int subBucket = (bucketIndex - kNumLinearBuckets) % kNumSubBucketsPerPowerOfTwo;
+      return ((uint64_t)(kNumSubBucketsPerPowerOfTwo + subBucket) << (exponent - 5));
+    }
+
+    uint64_t Histogram::GetCount(void) const
+    {
+      uint64_t count = 0;
+
+      for (const auto& bucketCount : bucketCounts)
+        count += bucketCount.load(std::memory_order_relaxed);
+
+      return count;
+    }
+
+    uint64_t Histogram::GetPercentile(double percentile) const
+    {
+      std::array<uint32_t, kNumBuckets> bucketCountsSnapshot;
+      uint64_t count = 0;
+
+      for (unsigned int i = 0; i < kNumBuckets; ++i)
+      {
+        bucketCountsSnapshot[i] = bucketCounts[i].load(std::memory_order_relaxed);
+        count += bucketCountsSnapshot[i];
+      }
+
+      if (0 == count) return 0;
+
+      uint64_t rank = (uint64_t)std::ceil((percentile / 100.0) * (double)count);
+      if (rank < 1) rank = 1;
+      if (rank > count) rank = count;
+
+      uint64_t cumulativeCount = 0;
+      for (unsigned int i = 0; i < kNumBuckets; ++i)
+      {
+        cumulativeCount += bucketCountsSnapshot[i];
+        if (cumulativeCount >= rank) return LowerBoundForBucketIndex(i);
+      }
+
+      return LowerBoundForBucketIndex(kNumBuckets - 1);
+    }
+
+    void Histogram::Record(uint64_t value)
+    {
+      bucketCounts[BucketIndexForValue(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const Histogram& GetStageHistogram(EStage stage)
+    {
+      return stageHistograms[(size_t)stage];
+    }
+
+    TTimestamp GetPublishedOrigin(Controller::TControllerIdentifier controllerIdentifier)
+    {
+      if ((false == IsEnabled()) || (controllerIdentifier >= Controller::kPhysicalControllerCount))
+        return 0;
+
+      return publishedOrigins[controllerIdentifier].load(std::memory_order_acquire);
+    }
+
+    void InitializeIfConfigured(void)
+    {
+      static std::once_flag initFlag;
+      std::call_once(
+          initFlag,
+          []() -> void
+          {
+            const bool latencyTraceEnabled =
+                Globals::GetConfigurationData()
+                    .GetFirstBooleanValue(
+                        Strings::kStrConfigurationSectionLog,
+                        Strings::kStrConfigurationSettingLogLatencyTrace)
+                    .value_or(false);
+            if (false == latencyTraceEnabled) return;
+
+            isTracingEnabled.store(true, std::memory_order_release);
+
+            std::thread(PeriodicallyOutputSummary).detach();
+            Message::OutputFormatted(
+                Message::ESeverity::Info,
+                L"Enabled input latency tracing. A summary will be output every %u seconds.",
+                kSummaryPeriodMilliseconds / 1000);
+          });
+    }
+
+    bool IsEnabled(void)
+    {
+      return isTracingEnabled.load(std::memory_order_relaxed);
+    }
+
+    void OutputSummary(void)
+    {
+      if (false == IsEnabled()) return;
+
+      for (unsigned int i = 0; i < (unsigned int)EStage::Count; ++i)
+      {
+        const Histogram& histogram = stageHistograms[i];
+
+        Message::OutputFormatted(
+            Message::ESeverity::Info,
+            L"Input latency trace: %-24s samples = %-10llu p50 = %10.1f us, p99 = %10.1f us",
+            kStageNames[i],
+            (unsigned long long)histogram.GetCount(),
+            ((double)histogram.GetPercentile(50.0) / 1000.0),
+            ((double)histogram.GetPercentile(99.0) / 1000.0));
+      }
+    }
+
+    void PublishOrigin(Controller::TControllerIdentifier controllerIdentifier, TTimestamp origin)
+    {
+      if ((false == IsEnabled()) || (controllerIdentifier >= Controller::kPhysicalControllerCount))
+        return;
+
+      publishedOrigins[controllerIdentifier].store(origin, std::memory_order_release);
+    }
+
+    void RecordStage(EStage stage, TTimestamp origin)
+    {
+      if ((false == IsEnabled()) || (0 == origin)) return;
+
+      const TTimestamp now = TraceTimestamp();
+      if (now < origin) return;
+
+      stageHistograms[(size_t)stage].Record(Clock::TicksToNanoseconds(now - origin));
+    }
+
+    TTimestamp TraceTimestamp(void)
+    {
+      if (false == IsEnabled()) return 0;
+      return Clock::Now();
+    }
+  } // namespace LatencyTrace
+} // namespace Xidi
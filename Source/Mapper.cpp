@@ -12,22 +12,31 @@
 
 #include "Mapper.h"
 
+#include <array>
+#include <functional>
 #include <limits>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <string_view>
 
 #include "ApiBitSet.h"
 #include "ApiWindows.h"
+#include "Clock.h"
 #include "Configuration.h"
-#include "ControllerMath.h"
 #include "ControllerTypes.h"
 #include "ElementMapper.h"
+#include "ElementMapperArena.h"
+#include "ElementProgram.h"
 #include "ForceFeedbackTypes.h"
 #include "Globals.h"
+#include "MapperBuilder.h"
+#include "MapperDefinitions.h"
 #include "Message.h"
+#include "Mouse.h"
 #include "Strings.h"
+#include "TransformProfile.h"
 
 namespace Xidi
 {
@@ -47,43 +56,27 @@ namespace Xidi
         return mapperRegistry;
       }
 
-      /// Dumps all mappers in this registry.
+      /// Dumps all mappers in this registry. Built-in mappers are dumped using their
+      /// compile-time capabilities, so dumping them does not cause them to be created.
       void DumpRegisteredMappers(void)
       {
         constexpr Message::ESeverity kDumpSeverity = Message::ESeverity::Info;
 
         if (Message::WillOutputMessageOfSeverity(kDumpSeverity))
         {
-          Message::Output(kDumpSeverity, L"Begin dump of all known mappers.");
-
-          for (const auto& knownMapper : knownMappers)
-          {
-            const std::wstring_view knownMapperName = knownMapper.first;
-            const SCapabilities knownMapperCapabilities = knownMapper.second->GetCapabilities();
+          std::scoped_lock lock(registryGuard);
 
-            Message::OutputFormatted(kDumpSeverity, L"  %s:", knownMapperName.data());
-
-            Message::OutputFormatted(
-                kDumpSeverity, L"    numAxes = %u", (unsigned int)knownMapperCapabilities.numAxes);
-            for (unsigned int i = 0; i < knownMapperCapabilities.numAxes; ++i)
-              Message::OutputFormatted(
-                  kDumpSeverity,
-                  L"      axisCapabilities[%u] = { type = %s, supportsForceFeedback = %s }",
-                  i,
-                  Strings::AxisTypeString(knownMapperCapabilities.axisCapabilities[i].type),
-                  ((true == knownMapperCapabilities.axisCapabilities[i].supportsForceFeedback)
-                       ? L"true"
-                       : L"false"));
+          Message::Output(kDumpSeverity, L"Begin dump of all known mappers.");
 
-            Message::OutputFormatted(
-                kDumpSeverity,
-                L"    numButtons = %u",
-                (unsigned int)knownMapperCapabilities.numButtons);
-            Message::OutputFormatted(
+          for (unsigned int i = 0; i < MapperDefinitions::GetCount(); ++i)
+            DumpMapperCapabilities(
                 kDumpSeverity,
-                L"    hasPov = %s",
-                ((true == knownMapperCapabilities.hasPov) ? L"true" : L"false"));
-          }
+                MapperDefinitions::GetDescription(i).name,
+                MapperDefinitions::GetDescription(i).capabilities);
+
+          for (const auto& knownMapper : knownMappers)
+            DumpMapperCapabilities(
+                kDumpSeverity, knownMapper.first, knownMapper.second->GetCapabilities());
 
           Message::Output(kDumpSeverity, L"End dump of all known mappers.");
         }
@@ -102,9 +95,9 @@ namespace Xidi
           return;
         }
 
-        knownMappers[name] = object;
+        std::scoped_lock lock(registryGuard);
 
-        if (true == defaultMapper.empty()) defaultMapper = name;
+        knownMappers[name] = object;
       }
 
       /// Unregisters a mapper object from this registry, if the registration details provided match
@@ -121,6 +114,8 @@ namespace Xidi
           return;
         }
 
+        std::scoped_lock lock(registryGuard);
+
         if (false == knownMappers.contains(name))
         {
           Message::OutputFormatted(
@@ -140,37 +135,155 @@ namespace Xidi
         }
 
         knownMappers.erase(name);
-
-        if (defaultMapper == name) defaultMapper = std::wstring_view();
       }
 
       /// Retrieves a pointer to the mapper object that corresponds to the specified name, if it
-      /// exists.
+      /// exists. Built-in mappers are located first, without taking the registry lock, and are
+      /// created the first time they are requested. An empty name requests the default mapper,
+      /// which is the first built-in mapper.
       /// @param [in] mapperName Desired mapper name.
+      /// @param [in] buildIfDeferred Whether or not to build the mapper using the deferred builder
+      /// if it does not yet exist in the registry but a blueprint for it has not yet been built.
       /// @return Pointer to the corresponding mapper object, or `nullptr` if it does not exist in
       /// the registry.
-      const Mapper* GetMapper(std::wstring_view mapperName)
+      const Mapper* GetMapper(std::wstring_view mapperName, bool buildIfDeferred)
       {
-        if (true == mapperName.empty()) mapperName = defaultMapper;
+        if (true == mapperName.empty()) return MapperDefinitions::GetMapper(0);
+
+        const std::optional<unsigned int> maybeBuiltInIndex =
+            MapperDefinitions::FindByName(mapperName);
+        if (true == maybeBuiltInIndex.has_value())
+          return MapperDefinitions::GetMapper(maybeBuiltInIndex.value());
+
+        std::scoped_lock lock(registryGuard);
 
         const auto mapperRecord = knownMappers.find(mapperName);
         if (knownMappers.cend() != mapperRecord) return mapperRecord->second;
 
+        if ((true == buildIfDeferred) && (nullptr != deferredBuilder) &&
+            (true == deferredBuilder->IsBlueprintBuildPending(mapperName)))
+          return BuildDeferred(mapperName);
+
         return nullptr;
       }
 
+      /// Determines if the deferred builder, if there is one, holds a blueprint for the specified
+      /// mapper. Never builds anything.
+      /// @param [in] mapperName Name of the mapper to check.
+      /// @param [in] pendingOnly Whether or not to disregard blueprints on which a build attempt
+      /// has already been made.
+      /// @return `true` if a matching blueprint exists, `false` otherwise.
+      bool HasDeferredBlueprint(std::wstring_view mapperName, bool pendingOnly)
+      {
+        std::scoped_lock lock(registryGuard);
+
+        if (nullptr == deferredBuilder) return false;
+
+        if (true == pendingOnly) return deferredBuilder->IsBlueprintBuildPending(mapperName);
+
+        return deferredBuilder->DoesBlueprintNameExist(mapperName);
+      }
+
+      /// Sets the mapper builder whose blueprints are built on demand.
+      /// @param [in] mapperBuilder Mapper builder to use, or `nullptr` to stop building on demand.
+      void SetDeferredBuilder(MapperBuilder* mapperBuilder)
+      {
+        std::scoped_lock lock(registryGuard);
+        deferredBuilder = mapperBuilder;
+      }
+
     private:
 
       MapperRegistry(void) = default;
 
+      /// Dumps the name and capabilities of a single mapper.
+      /// @param [in] severity Severity at which to output the dump.
+      /// @param [in] name Name of the mapper.
+      /// @param [in] capabilities Capabilities of the mapper.
+      static void DumpMapperCapabilities(
+          Message::ESeverity severity, std::wstring_view name, const SCapabilities& capabilities)
+      {
+        Message::OutputFormatted(severity, L"  %s:", name.data());
+
+        Message::OutputFormatted(severity, L"    numAxes = %u", (unsigned int)capabilities.numAxes);
+        for (unsigned int i = 0; i < capabilities.numAxes; ++i)
+          Message::OutputFormatted(
+              severity,
+              L"      axisCapabilities[%u] = { type = %s, supportsForceFeedback = %s }",
+              i,
+              Strings::AxisTypeString(capabilities.axisCapabilities[i].type),
+              ((true == capabilities.axisCapabilities[i].supportsForceFeedback) ? L"true"
+                                                                                 : L"false"));
+
+        Message::OutputFormatted(
+            severity, L"    numButtons = %u", (unsigned int)capabilities.numButtons);
+        Message::OutputFormatted(
+            severity, L"    hasPov = %s", ((true == capabilities.hasPov) ? L"true" : L"false"));
+      }
+
+      /// Builds a mapper using the deferred builder and reports the time and memory spent doing
+      /// so. Registry lock must already be held. Building registers the new mapper, and any
+      /// templates it depends on, from this thread, which is why the registry lock is recursive.
+      /// @param [in] mapperName Name of the mapper to build.
+      /// @return Pointer to the new mapper object, or `nullptr` if it could not be built.
+      const Mapper* BuildDeferred(std::wstring_view mapperName)
+      {
+        const Clock::TTimestamp buildStartTime = Clock::Now();
+        const Mapper* const builtMapper = deferredBuilder->Build(mapperName);
+        const Clock::TTimestamp buildEndTime = Clock::Now();
+
+        if (nullptr == builtMapper)
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Warning,
+              L"Mapper %s was requested but could not be built. See earlier messages for more information.",
+              mapperName.data());
+          return nullptr;
+        }
+
+        unsigned int numElementMappers = 0;
+        for (const auto& elementMapper : builtMapper->ElementMap().all)
+        {
+          if (nullptr != elementMapper) numElementMappers += 1;
+        }
+
+        Message::OutputFormatted(
+            Message::ESeverity::Info,
+            L"Built mapper %s on first request in %u microseconds. It has %u element mappers, and its compiled element map uses %u bytes.",
+            builtMapper->GetName().data(),
+            (unsigned int)Clock::TicksToMicroseconds(buildEndTime - buildStartTime),
+            numElementMappers,
+            (unsigned int)builtMapper->CompiledElementMap().GetMemoryFootprint());
+
+        return builtMapper;
+      }
+
       /// Implements the registry of known mappers.
       std::map<std::wstring_view, const Mapper*> knownMappers;
 
-      /// Holds the map key that corresponds to the default mapper.
-      /// The first type of mapper that is registered becomes the default.
-      std::wstring_view defaultMapper;
+      /// Mapper builder whose blueprints are built on demand, if any.
+      MapperBuilder* deferredBuilder = nullptr;
+
+      /// Guards all registry contents. Mappers are built on demand, potentially by any thread that
+      /// looks them up, so registration is no longer limited to startup.
+      std::recursive_mutex registryGuard;
     };
 
+    /// Moves the specified element mappers into the specified arena by cloning them into it and
+    /// then destroying the originals. Clones are allocated parent first, so each element mapper
+    /// tree ends up laid out contiguously in traversal order.
+    /// @param [in] arena Arena that is to hold the element mappers.
+    /// @param [in] elements Element mappers to move into the arena.
+    /// @return Element map whose element mappers are all allocated from the arena.
+    static Mapper::UElementMap PlaceElementMapInArena(
+        ElementMapperArena& arena, Mapper::SElementMap&& elements)
+    {
+      const Mapper::UElementMap originalElements(std::move(elements));
+
+      ElementMapperArena::ScopedUse arenaScope(arena);
+      return Mapper::UElementMap(originalElements);
+    }
+
     /// Derives the capabilities of the controller that is described by the specified element
     /// mappers in aggregate. Number of axes is determined as the total number of unique axes on the
     /// virtual controller to which element mappers contribute. Number of buttons is determined by
@@ -364,7 +477,62 @@ namespace Xidi
       return (ForceFeedback::TPhysicalActuatorValue)physicalActuatorStrength;
     }
 
-    /// Computes the opaque source identifier that is to be passed to an element mapper.
+    /// Enumerates the types of physical controller elements that can supply input to an element
+    /// mapper.
+    enum class EPhysicalElementType : uint8_t
+    {
+      Stick,
+      Trigger,
+      Button
+    };
+
+    /// Identifies the physical controller element that supplies input to an element mapper.
+    struct SPhysicalElementSource
+    {
+      /// Type of physical controller element.
+      EPhysicalElementType type;
+
+      /// Index of the physical controller element, interpreted according to its type as an
+      /// enumerator of #EPhysicalStick, #EPhysicalTrigger, or #EPhysicalButton.
+      uint8_t index;
+    };
+
+    /// Physical controller element that supplies input to each element mapper, indexed by position
+    /// within the element map. Order must match the order of fields in #Mapper::SElementMap.
+    static constexpr SPhysicalElementSource kPhysicalElementSources[] = {
+        {.type = EPhysicalElementType::Stick, .index = (uint8_t)EPhysicalStick::LeftX},
+        {.type = EPhysicalElementType::Stick, .index = (uint8_t)EPhysicalStick::LeftY},
+        {.type = EPhysicalElementType::Stick, .index = (uint8_t)EPhysicalStick::RightX},
+        {.type = EPhysicalElementType::Stick, .index = (uint8_t)EPhysicalStick::RightY},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::DpadUp},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::DpadDown},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::DpadLeft},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::DpadRight},
+        {.type = EPhysicalElementType::Trigger, .index = (uint8_t)EPhysicalTrigger::LT},
+        {.type = EPhysicalElementType::Trigger, .index = (uint8_t)EPhysicalTrigger::RT},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::A},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::B},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::X},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::Y},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::LB},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::RB},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::Back},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::Start},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::LS},
+        {.type = EPhysicalElementType::Button, .index = (uint8_t)EPhysicalButton::RS},
+    };
+
+    static_assert(
+        _countof(kPhysicalElementSources) == Mapper::kElementMapCount,
+        "Physical element source table does not match the element map.");
+
+    static_assert(
+        (kPhysicalControllerCount * Mapper::kElementMapCount) <= Mouse::kMouseMovementSourceCount,
+        "Not enough mouse movement contribution slots for all element mappers.");
+
+    /// Computes the opaque source identifier that is to be passed to an element mapper. Source
+    /// identifiers are dense, one per element map position per physical controller, so that they
+    /// can directly index fixed arrays of contribution slots such as those used for mouse movement.
     /// @param [in] sourceControllerIdentifier Opaque identifier of the physical controller
     /// associated with the state being mapped.
     /// @param [in] elementMapIndex Positional index of the element mapper within the overall
@@ -373,7 +541,161 @@ namespace Xidi
     inline uint32_t SourceIdentifierForElementMapper(
         uint32_t sourceControllerIdentifier, uint32_t elementMapIndex)
     {
-      return (sourceControllerIdentifier << 8) + elementMapIndex;
+      return (sourceControllerIdentifier * Mapper::kElementMapCount) + elementMapIndex;
+    }
+
+    /// Determines whether or not the physical controller element that supplies input to the
+    /// element mapper at the specified position in the element map differs between two physical
+    /// controller states.
+    /// @param [in] oldPhysicalState Previous physical controller state.
+    /// @param [in] newPhysicalState Current physical controller state.
+    /// @param [in] elementMapIndex Positional index of the element mapper within the overall
+    /// element map.
+    /// @return `true` if the input to the element mapper has changed, `false` otherwise.
+    static inline bool HasPhysicalElementChanged(
+        const SPhysicalState& oldPhysicalState,
+        const SPhysicalState& newPhysicalState,
+        unsigned int elementMapIndex)
+    {
+      const SPhysicalElementSource source = kPhysicalElementSources[elementMapIndex];
+
+      switch (source.type)
+      {
+        case EPhysicalElementType::Stick:
+          return (oldPhysicalState.stick[source.index] != newPhysicalState.stick[source.index]);
+
+        case EPhysicalElementType::Trigger:
+          return (
+              oldPhysicalState.trigger[source.index] != newPhysicalState.trigger[source.index]);
+
+        case EPhysicalElementType::Button:
+          return (
+              oldPhysicalState.button[source.index] != newPhysicalState.button[source.index]);
+
+        default:
+          return true;
+      }
+    }
+
+    /// Filters, and if needed inverts, an analog stick value read from a physical controller so
+    /// that it is suitable for presentation to element mappers. Left and right stick values need to
+    /// be saturated at the virtual controller range due to a very slight difference between XInput
+    /// range and virtual controller range. This difference (-32768 extreme negative for XInput vs
+    /// -32767 extreme negative for Xidi) does not affect functionality when filtered by saturation.
+    /// Vertical analog axes additionally need to be inverted because XInput presents up as positive
+    /// and down as negative whereas Xidi needs to do the opposite.
+    /// @param [in] stick Physical analog stick axis from which the value was read.
+    /// @param [in] analogValue Raw analog value.
+    /// @return Filtered and possibly inverted analog value.
+    static inline int16_t FilterPhysicalStickValue(EPhysicalStick stick, int16_t analogValue)
+    {
+      return (
+          ((EPhysicalStick::LeftY == stick) || (EPhysicalStick::RightY == stick))
+              ? FilterAndInvertAnalogStickValue(analogValue)
+              : FilterAnalogStickValue(analogValue));
+    }
+
+    /// Filters all analog stick values in a physical controller state and then applies raw
+    /// transformations to its analog sticks and triggers, so that it is suitable for presentation
+    /// to element mappers. The entire state is transformed at once, rather than one element at a
+    /// time, because radial processing of an analog stick needs both of its axes together.
+    /// @param [in, out] physicalState Physical controller state to transform in place.
+    /// @param [in] transformProfile Raw analog transformations to apply.
+    static inline void TransformPhysicalState(
+        SPhysicalState& physicalState, const TransformProfile& transformProfile)
+    {
+      for (int stickIdx = 0; stickIdx < (int)EPhysicalStick::Count; ++stickIdx)
+        physicalState.stick[stickIdx] =
+            FilterPhysicalStickValue((EPhysicalStick)stickIdx, physicalState.stick[stickIdx]);
+
+      transformProfile.ApplyToSticks(physicalState.stick);
+
+      for (int triggerIdx = 0; triggerIdx < (int)EPhysicalTrigger::Count; ++triggerIdx)
+        physicalState.trigger[triggerIdx] = transformProfile.ApplyToTrigger(
+            (EPhysicalTrigger)triggerIdx, physicalState.trigger[triggerIdx]);
+    }
+
+    /// Reads the physical controller element that supplies input to the element mapper at the
+    /// specified position in the element map and passes it to the compiled form of the element
+    /// mapper for it to contribute to the virtual controller state.
+    /// @param [in] program Compiled element map that contains the element mapper.
+    /// @param [in, out] controllerState Virtual controller state to which to contribute.
+    /// @param [in] physicalState Physical controller state from which to read, which must already
+    /// have been transformed using #TransformPhysicalState.
+    /// @param [in] elementMapIndex Positional index of the element mapper within the overall
+    /// element map.
+    /// @param [in] sourceControllerIdentifier Opaque identifier of the physical controller
+    /// associated with the state being mapped.
+    static inline void ContributeFromPhysicalElement(
+        const ElementProgram& program,
+        SState& controllerState,
+        const SPhysicalState& physicalState,
+        unsigned int elementMapIndex,
+        uint32_t sourceControllerIdentifier)
+    {
+      const SPhysicalElementSource source = kPhysicalElementSources[elementMapIndex];
+      const uint32_t sourceIdentifier =
+          SourceIdentifierForElementMapper(sourceControllerIdentifier, elementMapIndex);
+
+      switch (source.type)
+      {
+        case EPhysicalElementType::Stick:
+          program.ContributeFromAnalogValue(
+              elementMapIndex,
+              controllerState,
+              physicalState.stick[source.index],
+              sourceIdentifier);
+          break;
+
+        case EPhysicalElementType::Trigger:
+          program.ContributeFromTriggerValue(
+              elementMapIndex,
+              controllerState,
+              physicalState.trigger[source.index],
+              sourceIdentifier);
+          break;
+
+        case EPhysicalElementType::Button:
+          program.ContributeFromButtonValue(
+              elementMapIndex,
+              controllerState,
+              physicalState.button[source.index],
+              sourceIdentifier);
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    /// Compiles all of the element mappers in an element map, in element map order.
+    /// @param [in] elements Element map to compile.
+    /// @return Compiled element map.
+    static ElementProgram CompileElementMap(const Mapper::UElementMap& elements)
+    {
+      ElementProgram program;
+
+      for (const auto& elementMapper : elements.all)
+        program.AppendElement(elementMapper.get());
+
+      return program;
+    }
+
+    /// Saturates all axis values in a virtual controller state at the extreme ends of the allowed
+    /// range. Doing this only once all contributions have been committed means that intermediate
+    /// contributions are computed with much more range than the controller is allowed to report,
+    /// which can increase accuracy when there are multiple interfering mappers contributing to
+    /// axes.
+    /// @param [in, out] controllerState Virtual controller state whose axes should be saturated.
+    static inline void SaturateAxisValues(SState& controllerState)
+    {
+      for (auto& axisValue : controllerState.axis)
+      {
+        if (axisValue > kAnalogValueMax)
+          axisValue = kAnalogValueMax;
+        else if (axisValue < kAnalogValueMin)
+          axisValue = kAnalogValueMin;
+      }
     }
 
     Mapper::UElementMap::UElementMap(const UElementMap& other) : named()
@@ -387,22 +709,33 @@ namespace Xidi
     Mapper::Mapper(
         const std::wstring_view name,
         SElementMap&& elements,
-        SForceFeedbackActuatorMap forceFeedbackActuators)
-        : elements(std::move(elements)),
+        SForceFeedbackActuatorMap forceFeedbackActuators,
+        bool registerName)
+        : elementMapperArena(),
+          elements(PlaceElementMapInArena(elementMapperArena, std::move(elements))),
+          program(CompileElementMap(this->elements)),
           forceFeedbackActuators(forceFeedbackActuators),
           capabilities(DeriveCapabilitiesFromElementMap(this->elements, forceFeedbackActuators)),
-          name(name)
+          name(name),
+          isRegistered(registerName && (false == name.empty()))
     {
-      if (false == name.empty()) MapperRegistry::GetInstance().RegisterMapper(name, this);
+      if (true == isRegistered) MapperRegistry::GetInstance().RegisterMapper(name, this);
     }
 
+    Mapper::Mapper(
+        const std::wstring_view name,
+        SElementMap&& elements,
+        SForceFeedbackActuatorMap forceFeedbackActuators)
+        : Mapper(name, std::move(elements), forceFeedbackActuators, true)
+    {}
+
     Mapper::Mapper(SElementMap&& elements, SForceFeedbackActuatorMap forceFeedbackActuators)
         : Mapper(L"", std::move(elements), forceFeedbackActuators)
     {}
 
     Mapper::~Mapper(void)
     {
-      if (false == name.empty()) MapperRegistry::GetInstance().UnregisterMapper(name, this);
+      if (true == isRegistered) MapperRegistry::GetInstance().UnregisterMapper(name, this);
     }
 
     Mapper::UElementMap& Mapper::UElementMap::operator=(const UElementMap& other)
@@ -426,6 +759,15 @@ namespace Xidi
       return *this;
     }
 
+    std::unique_ptr<const Mapper> Mapper::CreateUnregistered(
+        const std::wstring_view name,
+        SElementMap&& elements,
+        SForceFeedbackActuatorMap forceFeedbackActuators)
+    {
+      return std::unique_ptr<const Mapper>(
+          new Mapper(name, std::move(elements), forceFeedbackActuators, false));
+    }
+
     void Mapper::DumpRegisteredMappers(void)
     {
       MapperRegistry::GetInstance().DumpRegisteredMappers();
@@ -433,102 +775,55 @@ namespace Xidi
 
     const Mapper* Mapper::GetByName(std::wstring_view mapperName)
     {
-      return MapperRegistry::GetInstance().GetMapper(mapperName);
+      return MapperRegistry::GetInstance().GetMapper(mapperName, true);
+    }
+
+    const Mapper* Mapper::GetByNameIfBuilt(std::wstring_view mapperName)
+    {
+      return MapperRegistry::GetInstance().GetMapper(mapperName, false);
     }
 
     const Mapper* Mapper::GetConfigured(TControllerIdentifier controllerIdentifier)
     {
-      static const Mapper* configuredMapper[kPhysicalControllerCount];
+      static std::array<const Mapper*, kPhysicalControllerCount> configuredMapper;
       static std::once_flag configuredMapperFlag;
 
       std::call_once(
           configuredMapperFlag,
           []() -> void
           {
-            const Configuration::ConfigurationData& configData = Globals::GetConfigurationData();
+            // Custom mappers are built on demand, so this is where errors in the definition of a
+            // custom mapper that is actually used come to light.
+            bool customMapperBuildFailed = false;
 
-            if (true == configData.SectionExists(Strings::kStrConfigurationSectionMapper))
-            {
-              // Mapper section exists in the configuration file.
-              // If the controller-independent type setting exists, it will be used as the fallback
-              // default, otherwise the default mapper will be used for this purpose. If any
-              // per-controller type settings exist, they take precedence.
-              const auto& mapperConfigData = configData[Strings::kStrConfigurationSectionMapper];
-
-              const Mapper* fallbackMapper = nullptr;
-              if (true == mapperConfigData.NameExists(Strings::kStrConfigurationSettingMapperType))
-              {
-                std::wstring_view fallbackMapperName =
-                    mapperConfigData[Strings::kStrConfigurationSettingMapperType]
-                        .FirstValue()
-                        .GetStringValue();
-                fallbackMapper = GetByName(fallbackMapperName);
-
-                if (nullptr == fallbackMapper)
-                  Message::OutputFormatted(
-                      Message::ESeverity::Warning,
-                      L"Could not locate mapper \"%s\" specified in the configuration file as the default.",
-                      fallbackMapperName.data());
-              }
-
-              if (nullptr == fallbackMapper)
-              {
-                fallbackMapper = GetDefault();
-
-                if (nullptr == fallbackMapper)
+            configuredMapper = ResolveConfigured(
+                Globals::GetConfigurationData(),
+                [&customMapperBuildFailed](std::wstring_view mapperName) -> const Mapper*
                 {
-                  Message::Output(
-                      Message::ESeverity::Error,
-                      L"Internal error: Unable to locate the default mapper.");
-                  fallbackMapper = GetNull();
-                }
-              }
+                  const Mapper* const mapper = GetByName(mapperName);
+                  if ((nullptr == mapper) &&
+                      (true ==
+                       MapperRegistry::GetInstance().HasDeferredBlueprint(mapperName, false)))
+                    customMapperBuildFailed = true;
 
-              for (TControllerIdentifier i = 0; i < _countof(configuredMapper); ++i)
-              {
-                if (true ==
-                    mapperConfigData.NameExists(Strings::MapperTypeConfigurationNameString(i)))
-                {
-                  std::wstring_view configuredMapperName =
-                      mapperConfigData[Strings::MapperTypeConfigurationNameString(i)]
-                          .FirstValue()
-                          .GetStringValue();
-                  configuredMapper[i] = GetByName(configuredMapperName.data());
-
-                  if (nullptr == configuredMapper[i])
-                  {
-                    Message::OutputFormatted(
-                        Message::ESeverity::Warning,
-                        L"Could not locate mapper \"%s\" specified in the configuration file for controller %u.",
-                        configuredMapperName.data(),
-                        (unsigned int)(1 + i));
-                    configuredMapper[i] = fallbackMapper;
-                  }
-                }
-                else
-                {
-                  configuredMapper[i] = fallbackMapper;
-                }
-              }
-            }
-            else
+                  return mapper;
+                });
+
+            if ((true == customMapperBuildFailed) &&
+                (false == Globals::GetConfigurationData().HasErrors()))
             {
-              // Mapper section does not exist in the configuration file.
-              const Mapper* defaultMapper = GetDefault();
-              if (nullptr == defaultMapper)
-              {
+              if (true == Message::IsLogFileEnabled())
                 Message::Output(
-                    Message::ESeverity::Error,
-                    L"Internal error: Unable to locate the default mapper. Virtual controllers will not function.");
-                defaultMapper = GetNull();
-              }
-
-              for (TControllerIdentifier i = 0; i < _countof(configuredMapper); ++i)
-                configuredMapper[i] = defaultMapper;
+                    Message::ESeverity::ForcedInteractiveWarning,
+                    L"Errors were encountered during custom mapper construction. See log file for more information.");
+              else
+                Message::Output(
+                    Message::ESeverity::ForcedInteractiveWarning,
+                    L"Errors were encountered during custom mapper construction. Enable logging and see log file for more information.");
             }
 
             Message::Output(Message::ESeverity::Info, L"Mappers assigned to controllers...");
-            for (TControllerIdentifier i = 0; i < _countof(configuredMapper); ++i)
+            for (TControllerIdentifier i = 0; i < configuredMapper.size(); ++i)
               Message::OutputFormatted(
                   Message::ESeverity::Info,
                   L"    [%u]: %s",
@@ -536,7 +831,7 @@ namespace Xidi
                   configuredMapper[i]->GetName().data());
           });
 
-      if (controllerIdentifier >= _countof(configuredMapper))
+      if (controllerIdentifier >= configuredMapper.size())
       {
         Message::OutputFormatted(
             Message::ESeverity::Error,
@@ -554,6 +849,104 @@ namespace Xidi
       return &kNullMapper;
     }
 
+    std::array<const Mapper*, kPhysicalControllerCount> Mapper::ResolveConfigured(
+        const Configuration::ConfigurationData& configData,
+        const std::function<const Mapper*(std::wstring_view)>& lookupByName)
+    {
+      std::array<const Mapper*, kPhysicalControllerCount> resolvedMapper;
+
+      if (true == configData.SectionExists(Strings::kStrConfigurationSectionMapper))
+      {
+        // Mapper section exists in the configuration file.
+        // If the controller-independent type setting exists, it will be used as the fallback
+        // default, otherwise the default mapper will be used for this purpose. If any
+        // per-controller type settings exist, they take precedence.
+        const auto& mapperConfigData = configData[Strings::kStrConfigurationSectionMapper];
+
+        const Mapper* fallbackMapper = nullptr;
+        if (true == mapperConfigData.NameExists(Strings::kStrConfigurationSettingMapperType))
+        {
+          std::wstring_view fallbackMapperName =
+              mapperConfigData[Strings::kStrConfigurationSettingMapperType]
+                  .FirstValue()
+                  .GetStringValue();
+          fallbackMapper = lookupByName(fallbackMapperName);
+
+          if (nullptr == fallbackMapper)
+            Message::OutputFormatted(
+                Message::ESeverity::Warning,
+                L"Could not locate mapper \"%s\" specified in the configuration file as the default.",
+                fallbackMapperName.data());
+        }
+
+        if (nullptr == fallbackMapper)
+        {
+          fallbackMapper = lookupByName(L"");
+
+          if (nullptr == fallbackMapper)
+          {
+            Message::Output(
+                Message::ESeverity::Error, L"Internal error: Unable to locate the default mapper.");
+            fallbackMapper = GetNull();
+          }
+        }
+
+        for (TControllerIdentifier i = 0; i < resolvedMapper.size(); ++i)
+        {
+          if (true == mapperConfigData.NameExists(Strings::MapperTypeConfigurationNameString(i)))
+          {
+            std::wstring_view configuredMapperName =
+                mapperConfigData[Strings::MapperTypeConfigurationNameString(i)]
+                    .FirstValue()
+                    .GetStringValue();
+            resolvedMapper[i] = lookupByName(configuredMapperName.data());
+
+            if (nullptr == resolvedMapper[i])
+            {
+              Message::OutputFormatted(
+                  Message::ESeverity::Warning,
+                  L"Could not locate mapper \"%s\" specified in the configuration file for controller %u.",
+                  configuredMapperName.data(),
+                  (unsigned int)(1 + i));
+              resolvedMapper[i] = fallbackMapper;
+            }
+          }
+          else
+          {
+            resolvedMapper[i] = fallbackMapper;
+          }
+        }
+      }
+      else
+      {
+        // Mapper section does not exist in the configuration file.
+        const Mapper* defaultMapper = lookupByName(L"");
+        if (nullptr == defaultMapper)
+        {
+          Message::Output(
+              Message::ESeverity::Error,
+              L"Internal error: Unable to locate the default mapper. Virtual controllers will not function.");
+          defaultMapper = GetNull();
+        }
+
+        resolvedMapper.fill(defaultMapper);
+      }
+
+      return resolvedMapper;
+    }
+
+    bool Mapper::IsMapperNameKnown(std::wstring_view mapperName)
+    {
+      return (
+          (nullptr != GetByNameIfBuilt(mapperName)) ||
+          (true == MapperRegistry::GetInstance().HasDeferredBlueprint(mapperName, true)));
+    }
+
+    void Mapper::SetDeferredBuilder(MapperBuilder* mapperBuilder)
+    {
+      MapperRegistry::GetInstance().SetDeferredBuilder(mapperBuilder);
+    }
+
     ForceFeedback::SPhysicalActuatorComponents Mapper::MapForceFeedbackVirtualToPhysical(
         ForceFeedback::TOrderedMagnitudeComponents virtualEffectComponents,
         ForceFeedback::TEffectValue gain) const
@@ -570,230 +963,95 @@ namespace Xidi
     }
 
     SState Mapper::MapStatePhysicalToVirtual(
-        SPhysicalState physicalState, uint32_t sourceControllerIdentifier) const
-    {
-      // These properties are read from the configuration file and can be used to apply extra
-      // transformations to raw analog values read from physical controllers. By default, deadzone
-      // percentage is set to 0 and saturation percentage is set to 100 to avoid any reduction in
-      // full analog range of motion, since most often applications will themselves apply a deadzone
-      // and saturation via virtual controller properties. However not all applications do this, and
-      // some interfaces like WinMM do not even support application-supplied properties.
-      static const unsigned int kDeadzonePercentStickLeft =
-          (unsigned int)Globals::GetConfigurationData()
-              .GetFirstIntegerValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesDeadzonePercentStickLeft)
-              .value_or(0);
-      static const unsigned int kDeadzonePercentStickRight =
-          (unsigned int)Globals::GetConfigurationData()
-              .GetFirstIntegerValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesDeadzonePercentStickRight)
-              .value_or(0);
-      static const unsigned int kDeadzonePercentTriggerLT =
-          (unsigned int)Globals::GetConfigurationData()
-              .GetFirstIntegerValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesDeadzonePercentTriggerLT)
-              .value_or(0);
-      static const unsigned int kDeadzonePercentTriggerRT =
-          (unsigned int)Globals::GetConfigurationData()
-              .GetFirstIntegerValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesDeadzonePercentTriggerRT)
-              .value_or(0);
-      static const unsigned int kSaturationPercentStickLeft =
-          (unsigned int)Globals::GetConfigurationData()
-              .GetFirstIntegerValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesSaturationPercentStickLeft)
-              .value_or(100);
-      static const unsigned int kSaturationPercentStickRight =
-          (unsigned int)Globals::GetConfigurationData()
-              .GetFirstIntegerValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesSaturationPercentStickRight)
-              .value_or(100);
-      static const unsigned int kSaturationPercentTriggerLT =
-          (unsigned int)Globals::GetConfigurationData()
-              .GetFirstIntegerValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesSaturationPercentTriggerLT)
-              .value_or(100);
-      static const unsigned int kSaturationPercentTriggerRT =
-          (unsigned int)Globals::GetConfigurationData()
-              .GetFirstIntegerValue(
-                  Strings::kStrConfigurationSectionProperties,
-                  Strings::kStrConfigurationSettingsPropertiesSaturationPercentTriggerRT)
-              .value_or(100);
+        SPhysicalState physicalState,
+        uint32_t sourceControllerIdentifier,
+        const TransformProfile& transformProfile) const
+    {
+      TransformPhysicalState(physicalState, transformProfile);
 
       SState controllerState = {};
 
-      // Left and right stick values need to be saturated at the virtual controller range due to a
-      // very slight difference between XInput range and virtual controller range. This difference
-      // (-32768 extreme negative for XInput vs -32767 extreme negative for Xidi) does not affect
-      // functionality when filtered by saturation. Vertical analog axes additionally need to be
-      // inverted because XInput presents up as positive and down as negative whereas Xidi needs to
-      // do the opposite.
-
-      if (nullptr != elements.named.stickLeftX)
-        elements.named.stickLeftX->ContributeFromAnalogValue(
-            controllerState,
-            Math::ApplyRawAnalogTransform(
-                FilterAnalogStickValue(physicalState[EPhysicalStick::LeftX]),
-                kDeadzonePercentStickLeft,
-                kSaturationPercentStickLeft),
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(stickLeftX)));
-      if (nullptr != elements.named.stickLeftY)
-        elements.named.stickLeftY->ContributeFromAnalogValue(
-            controllerState,
-            Math::ApplyRawAnalogTransform(
-                FilterAndInvertAnalogStickValue(physicalState[EPhysicalStick::LeftY]),
-                kDeadzonePercentStickLeft,
-                kSaturationPercentStickLeft),
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(stickLeftY)));
-
-      if (nullptr != elements.named.stickRightX)
-        elements.named.stickRightX->ContributeFromAnalogValue(
-            controllerState,
-            Math::ApplyRawAnalogTransform(
-                FilterAnalogStickValue(physicalState[EPhysicalStick::RightX]),
-                kDeadzonePercentStickRight,
-                kSaturationPercentStickRight),
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(stickRightX)));
-      if (nullptr != elements.named.stickRightY)
-        elements.named.stickRightY->ContributeFromAnalogValue(
-            controllerState,
-            Math::ApplyRawAnalogTransform(
-                FilterAndInvertAnalogStickValue(physicalState[EPhysicalStick::RightY]),
-                kDeadzonePercentStickRight,
-                kSaturationPercentStickRight),
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(stickRightY)));
-
-      if (nullptr != elements.named.dpadUp)
-        elements.named.dpadUp->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::DpadUp],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(dpadUp)));
-      if (nullptr != elements.named.dpadDown)
-        elements.named.dpadDown->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::DpadDown],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(dpadDown)));
-      if (nullptr != elements.named.dpadLeft)
-        elements.named.dpadLeft->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::DpadLeft],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(dpadLeft)));
-      if (nullptr != elements.named.dpadRight)
-        elements.named.dpadRight->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::DpadRight],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(dpadRight)));
-
-      if (nullptr != elements.named.triggerLT)
-        elements.named.triggerLT->ContributeFromTriggerValue(
-            controllerState,
-            Math::ApplyRawTriggerTransform(
-                physicalState[EPhysicalTrigger::LT],
-                kDeadzonePercentTriggerLT,
-                kSaturationPercentTriggerLT),
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(triggerLT)));
-      if (nullptr != elements.named.triggerRT)
-        elements.named.triggerRT->ContributeFromTriggerValue(
-            controllerState,
-            Math::ApplyRawTriggerTransform(
-                physicalState[EPhysicalTrigger::RT],
-                kDeadzonePercentTriggerRT,
-                kSaturationPercentTriggerRT),
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(triggerRT)));
-
-      if (nullptr != elements.named.buttonA)
-        elements.named.buttonA->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::A],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonA)));
-      if (nullptr != elements.named.buttonB)
-        elements.named.buttonB->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::B],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonB)));
-      if (nullptr != elements.named.buttonX)
-        elements.named.buttonX->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::X],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonX)));
-      if (nullptr != elements.named.buttonY)
-        elements.named.buttonY->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::Y],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonY)));
-
-      if (nullptr != elements.named.buttonLB)
-        elements.named.buttonLB->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::LB],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonLB)));
-      if (nullptr != elements.named.buttonRB)
-        elements.named.buttonRB->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::RB],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonRB)));
-
-      if (nullptr != elements.named.buttonBack)
-        elements.named.buttonBack->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::Back],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonBack)));
-      if (nullptr != elements.named.buttonStart)
-        elements.named.buttonStart->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::Start],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonStart)));
-
-      if (nullptr != elements.named.buttonLS)
-        elements.named.buttonLS->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::LS],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonLS)));
-      if (nullptr != elements.named.buttonRS)
-        elements.named.buttonRS->ContributeFromButtonValue(
-            controllerState,
-            physicalState[EPhysicalButton::RS],
-            SourceIdentifierForElementMapper(
-                sourceControllerIdentifier, ELEMENT_MAP_INDEX_OF(buttonRS)));
-
-      // Once all contributions have been committed, saturate all axis values at the extreme ends of
-      // the allowed range. Doing this at the end means that intermediate contributions are computed
-      // with much more range than the controller is allowed to report, which can increase accuracy
-      // when there are multiple interfering mappers contributing to axes.
-      for (auto& axisValue : controllerState.axis)
+      for (unsigned int elementMapIdx = 0; elementMapIdx < _countof(elements.all); ++elementMapIdx)
       {
-        if (axisValue > kAnalogValueMax)
-          axisValue = kAnalogValueMax;
-        else if (axisValue < kAnalogValueMin)
-          axisValue = kAnalogValueMin;
+        if (nullptr != elements.all[elementMapIdx])
+          ContributeFromPhysicalElement(
+              program, controllerState, physicalState, elementMapIdx, sourceControllerIdentifier);
+      }
+
+      SaturateAxisValues(controllerState);
+      return controllerState;
+    }
+
+    SState Mapper::MapStatePhysicalToVirtual(
+        SPhysicalState physicalState,
+        uint32_t sourceControllerIdentifier,
+        SIncrementalMappingCache& cache,
+        const TransformProfile& transformProfile) const
+    {
+      // Transformed values are compared, rather than raw values, because radial processing makes
+      // each axis of an analog stick depend on the other.
+      TransformPhysicalState(physicalState, transformProfile);
+
+      const bool isFullRemapRequired =
+          ((false == cache.isValid) || (this != cache.mapper) ||
+           (sourceControllerIdentifier != cache.sourceControllerIdentifier) ||
+           (&transformProfile != cache.transformProfile));
+      if (true == isFullRemapRequired)
+      {
+        cache.elementContributions = {};
+        cache.combinedContributions = {};
       }
 
+      // Axis contributions are additive, so the combined value can be updated by swapping out the
+      // old contribution for the new one. Button and POV contributions are combined by inclusive
+      // OR, which cannot be undone, so if any of them change the combination is rebuilt.
+      bool combinedButtonsOrPovNeedRebuild = false;
+
+      for (unsigned int elementMapIdx = 0; elementMapIdx < _countof(elements.all); ++elementMapIdx)
+      {
+        if (nullptr == elements.all[elementMapIdx]) continue;
+
+        if ((false == isFullRemapRequired) &&
+            (false ==
+             HasPhysicalElementChanged(cache.physicalState, physicalState, elementMapIdx)))
+          continue;
+
+        SState newContribution = {};
+        ContributeFromPhysicalElement(
+            program, newContribution, physicalState, elementMapIdx, sourceControllerIdentifier);
+
+        const SState& oldContribution = cache.elementContributions[elementMapIdx];
+        for (int axisIdx = 0; axisIdx < (int)EAxis::Count; ++axisIdx)
+          cache.combinedContributions.axis[axisIdx] +=
+              (newContribution.axis[axisIdx] - oldContribution.axis[axisIdx]);
+
+        if ((newContribution.button != oldContribution.button) ||
+            (newContribution.povDirection != oldContribution.povDirection))
+          combinedButtonsOrPovNeedRebuild = true;
+
+        cache.elementContributions[elementMapIdx] = newContribution;
+      }
+
+      if (true == combinedButtonsOrPovNeedRebuild)
+      {
+        cache.combinedContributions.button.reset();
+        cache.combinedContributions.povDirection.all = 0;
+
+        for (const auto& elementContribution : cache.elementContributions)
+        {
+          cache.combinedContributions.button |= elementContribution.button;
+          cache.combinedContributions.povDirection.all |= elementContribution.povDirection.all;
+        }
+      }
+
+      cache.isValid = true;
+      cache.mapper = this;
+      cache.sourceControllerIdentifier = sourceControllerIdentifier;
+      cache.transformProfile = &transformProfile;
+      cache.physicalState = physicalState;
+
+      SState controllerState = cache.combinedContributions;
+      SaturateAxisValues(controllerState);
       return controllerState;
     }
 
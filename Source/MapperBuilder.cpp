@@ -16,6 +16,7 @@
 #include <memory>
 
 #include "Mapper.h"
+#include "MapperDefinitions.h"
 #include "MapperParser.h"
 #include "Message.h"
 
@@ -37,6 +38,10 @@ namespace Xidi
       return mapperNames->emplace_back(mapperName);
     }
 
+    MapperBuilder::MapperBuilder(bool isDetached)
+        : blueprints(), isDetached(isDetached), detachedMappers()
+    {}
+
     bool MapperBuilder::Build(void)
     {
       for (const auto& blueprintItem : blueprints)
@@ -62,7 +67,7 @@ namespace Xidi
         return nullptr;
       }
 
-      if (true == Mapper::IsMapperNameKnown(mapperName))
+      if (nullptr != GetMapper(mapperName))
       {
         Message::OutputFormatted(
             Message::ESeverity::Error,
@@ -104,7 +109,7 @@ namespace Xidi
         // If a template is specified, then the mapper element starting point comes from an existing
         // mapper object. If the mapper object named in the template does not exist, try to build
         // it. It is an error if that dependent build operation fails.
-        if (false == Mapper::IsMapperNameKnown(blueprint.templateName))
+        if (nullptr == GetMapper(blueprint.templateName))
         {
           // The purpose of this check is to make error messages easier to understand by making it
           // immediately obvious why a template build operation failed. Without it, the user would
@@ -137,7 +142,7 @@ namespace Xidi
             return nullptr;
           }
 
-          if (false == Mapper::IsMapperNameKnown(blueprint.templateName))
+          if (nullptr == GetMapper(blueprint.templateName))
           {
             Message::OutputFormatted(
                 Message::ESeverity::Error,
@@ -150,7 +155,7 @@ namespace Xidi
 
         // Since the template name is known, the registered mapper object should be obtainable.
         // It is an internal error if this fails.
-        const Mapper* const kTemplateMapper = Mapper::GetByName(blueprint.templateName);
+        const Mapper* const kTemplateMapper = GetMapper(blueprint.templateName);
         if (nullptr == kTemplateMapper)
         {
           Message::OutputFormatted(
@@ -161,9 +166,8 @@ namespace Xidi
           return nullptr;
         }
 
-        mapperElements = Mapper::GetByName(blueprint.templateName)->CloneElementMap();
-        mapperForceFeedbackActuators =
-            Mapper::GetByName(blueprint.templateName)->GetForceFeedbackActuatorMap();
+        mapperElements = kTemplateMapper->CloneElementMap();
+        mapperForceFeedbackActuators = kTemplateMapper->GetForceFeedbackActuatorMap();
       }
 
       // Loop through all the changes that the blueprint describes and apply them to the starting
@@ -189,8 +193,23 @@ namespace Xidi
 
       Message::OutputFormatted(
           Message::ESeverity::Info, L"Successfully built mapper %s.", mapperName.data());
+
+      // Blueprint map keys are safe string views, so the built mapper can refer to its name
+      // indefinitely.
+      const std::wstring_view safeMapperName = blueprints.find(mapperName)->first;
+
+      if (true == isDetached)
+      {
+        std::shared_ptr<const Mapper> detachedMapper = Mapper::CreateUnregistered(
+            safeMapperName,
+            std::move(mapperElements.named),
+            mapperForceFeedbackActuators.named);
+        return detachedMappers.emplace(safeMapperName, std::move(detachedMapper))
+            .first->second.get();
+      }
+
       return new Mapper(
-          mapperName, std::move(mapperElements.named), mapperForceFeedbackActuators.named);
+          safeMapperName, std::move(mapperElements.named), mapperForceFeedbackActuators.named);
     }
 
     bool MapperBuilder::ClearBlueprintElementMapper(
@@ -246,7 +265,7 @@ namespace Xidi
 
     bool MapperBuilder::CreateBlueprint(std::wstring_view mapperName)
     {
-      if (true == Mapper::IsMapperNameKnown(mapperName)) return false;
+      if (nullptr != GetMapper(mapperName)) return false;
 
       return blueprints.emplace(std::make_pair(SafeMapperNameString(mapperName), SBlueprint()))
           .second;
@@ -284,6 +303,31 @@ namespace Xidi
       return blueprintIter->second.templateName;
     }
 
+    const Mapper* MapperBuilder::GetMapper(std::wstring_view mapperName) const
+    {
+      if (false == isDetached) return Mapper::GetByNameIfBuilt(mapperName);
+
+      const auto detachedMapperIter = detachedMappers.find(mapperName);
+      if (detachedMappers.cend() != detachedMapperIter) return detachedMapperIter->second.get();
+
+      // Every registered mapper that is not built-in is a custom mapper built by some other
+      // builder, and custom mappers held as blueprints by the deferred builder are not registered
+      // until they are built, so only built-in mappers need to be looked up.
+      if ((false == mapperName.empty()) &&
+          (false == MapperDefinitions::FindByName(mapperName).has_value()))
+        return nullptr;
+
+      return Mapper::GetByNameIfBuilt(mapperName);
+    }
+
+    bool MapperBuilder::IsBlueprintBuildPending(std::wstring_view mapperName) const
+    {
+      const auto blueprintIter = blueprints.find(mapperName);
+      if (blueprints.cend() == blueprintIter) return false;
+
+      return (false == blueprintIter->second.buildAttempted);
+    }
+
     bool MapperBuilder::InvalidateBlueprint(std::wstring_view mapperName)
     {
       auto blueprintIter = blueprints.find(mapperName);
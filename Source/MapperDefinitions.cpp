@@ -9,129 +9,336 @@
  *   Definitions of all known mapper types.
  **************************************************************************************************/
 
+#include "MapperDefinitions.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
 #include "ControllerTypes.h"
 #include "ElementMapper.h"
 #include "Mapper.h"
+#include "Message.h"
 
 namespace Xidi
 {
   namespace Controller
   {
-    /// Defines all known mapper types, one element per type. The first element is the default
-    /// mapper. Any field that corresponds to an XInput controller element can be omitted or
-    /// assigned `nullptr` and the mapper will simply ignore input from that XInput controller
-    /// element.
-    static const Mapper kMappers[] = {
-        Mapper(
-            L"StandardGamepad",
-            {.stickLeftX = std::make_unique<AxisMapper>(EAxis::X),
-             .stickLeftY = std::make_unique<AxisMapper>(EAxis::Y),
-             .stickRightX = std::make_unique<AxisMapper>(EAxis::Z),
-             .stickRightY = std::make_unique<AxisMapper>(EAxis::RotZ),
-             .dpadUp = std::make_unique<PovMapper>(EPovDirection::Up),
-             .dpadDown = std::make_unique<PovMapper>(EPovDirection::Down),
-             .dpadLeft = std::make_unique<PovMapper>(EPovDirection::Left),
-             .dpadRight = std::make_unique<PovMapper>(EPovDirection::Right),
-             .triggerLT = std::make_unique<ButtonMapper>(EButton::B7),
-             .triggerRT = std::make_unique<ButtonMapper>(EButton::B8),
-             .buttonA = std::make_unique<ButtonMapper>(EButton::B1),
-             .buttonB = std::make_unique<ButtonMapper>(EButton::B2),
-             .buttonX = std::make_unique<ButtonMapper>(EButton::B3),
-             .buttonY = std::make_unique<ButtonMapper>(EButton::B4),
-             .buttonLB = std::make_unique<ButtonMapper>(EButton::B5),
-             .buttonRB = std::make_unique<ButtonMapper>(EButton::B6),
-             .buttonBack = std::make_unique<ButtonMapper>(EButton::B9),
-             .buttonStart = std::make_unique<ButtonMapper>(EButton::B10),
-             .buttonLS = std::make_unique<ButtonMapper>(EButton::B11),
-             .buttonRS = std::make_unique<ButtonMapper>(EButton::B12)}),
-        Mapper(
-            L"DigitalGamepad",
-            {.stickLeftX = std::make_unique<DigitalAxisMapper>(EAxis::X),
-             .stickLeftY = std::make_unique<DigitalAxisMapper>(EAxis::Y),
-             .stickRightX = std::make_unique<DigitalAxisMapper>(EAxis::Z),
-             .stickRightY = std::make_unique<DigitalAxisMapper>(EAxis::RotZ),
-             .dpadUp = std::make_unique<DigitalAxisMapper>(EAxis::Y, EAxisDirection::Negative),
-             .dpadDown = std::make_unique<DigitalAxisMapper>(EAxis::Y, EAxisDirection::Positive),
-             .dpadLeft = std::make_unique<DigitalAxisMapper>(EAxis::X, EAxisDirection::Negative),
-             .dpadRight = std::make_unique<DigitalAxisMapper>(EAxis::X, EAxisDirection::Positive),
-             .triggerLT = std::make_unique<ButtonMapper>(EButton::B7),
-             .triggerRT = std::make_unique<ButtonMapper>(EButton::B8),
-             .buttonA = std::make_unique<ButtonMapper>(EButton::B1),
-             .buttonB = std::make_unique<ButtonMapper>(EButton::B2),
-             .buttonX = std::make_unique<ButtonMapper>(EButton::B3),
-             .buttonY = std::make_unique<ButtonMapper>(EButton::B4),
-             .buttonLB = std::make_unique<ButtonMapper>(EButton::B5),
-             .buttonRB = std::make_unique<ButtonMapper>(EButton::B6),
-             .buttonBack = std::make_unique<ButtonMapper>(EButton::B9),
-             .buttonStart = std::make_unique<ButtonMapper>(EButton::B10),
-             .buttonLS = std::make_unique<ButtonMapper>(EButton::B11),
-             .buttonRS = std::make_unique<ButtonMapper>(EButton::B12)}),
-        Mapper(
-            L"ExtendedGamepad",
-            {.stickLeftX = std::make_unique<AxisMapper>(EAxis::X),
-             .stickLeftY = std::make_unique<AxisMapper>(EAxis::Y),
-             .stickRightX = std::make_unique<AxisMapper>(EAxis::Z),
-             .stickRightY = std::make_unique<AxisMapper>(EAxis::RotZ),
-             .dpadUp = std::make_unique<PovMapper>(EPovDirection::Up),
-             .dpadDown = std::make_unique<PovMapper>(EPovDirection::Down),
-             .dpadLeft = std::make_unique<PovMapper>(EPovDirection::Left),
-             .dpadRight = std::make_unique<PovMapper>(EPovDirection::Right),
-             .triggerLT = std::make_unique<AxisMapper>(EAxis::RotX),
-             .triggerRT = std::make_unique<AxisMapper>(EAxis::RotY),
-             .buttonA = std::make_unique<ButtonMapper>(EButton::B1),
-             .buttonB = std::make_unique<ButtonMapper>(EButton::B2),
-             .buttonX = std::make_unique<ButtonMapper>(EButton::B3),
-             .buttonY = std::make_unique<ButtonMapper>(EButton::B4),
-             .buttonLB = std::make_unique<ButtonMapper>(EButton::B5),
-             .buttonRB = std::make_unique<ButtonMapper>(EButton::B6),
-             .buttonBack = std::make_unique<ButtonMapper>(EButton::B7),
-             .buttonStart = std::make_unique<ButtonMapper>(EButton::B8),
-             .buttonLS = std::make_unique<ButtonMapper>(EButton::B9),
-             .buttonRS = std::make_unique<ButtonMapper>(EButton::B10)}),
-
-        Mapper(
-            L"XInputNative",
-            {.stickLeftX = std::make_unique<AxisMapper>(EAxis::X),
-             .stickLeftY = std::make_unique<AxisMapper>(EAxis::Y),
-             .stickRightX = std::make_unique<AxisMapper>(EAxis::RotX),
-             .stickRightY = std::make_unique<AxisMapper>(EAxis::RotY),
-             .dpadUp = std::make_unique<PovMapper>(EPovDirection::Up),
-             .dpadDown = std::make_unique<PovMapper>(EPovDirection::Down),
-             .dpadLeft = std::make_unique<PovMapper>(EPovDirection::Left),
-             .dpadRight = std::make_unique<PovMapper>(EPovDirection::Right),
-             .triggerLT = std::make_unique<AxisMapper>(EAxis::Z),
-             .triggerRT = std::make_unique<AxisMapper>(EAxis::RotZ),
-             .buttonA = std::make_unique<ButtonMapper>(EButton::B1),
-             .buttonB = std::make_unique<ButtonMapper>(EButton::B2),
-             .buttonX = std::make_unique<ButtonMapper>(EButton::B3),
-             .buttonY = std::make_unique<ButtonMapper>(EButton::B4),
-             .buttonLB = std::make_unique<ButtonMapper>(EButton::B5),
-             .buttonRB = std::make_unique<ButtonMapper>(EButton::B6),
-             .buttonBack = std::make_unique<ButtonMapper>(EButton::B7),
-             .buttonStart = std::make_unique<ButtonMapper>(EButton::B8),
-             .buttonLS = std::make_unique<ButtonMapper>(EButton::B9),
-             .buttonRS = std::make_unique<ButtonMapper>(EButton::B10)}),
-        Mapper(
-            L"XInputSharedTriggers",
-            {.stickLeftX = std::make_unique<AxisMapper>(EAxis::X),
-             .stickLeftY = std::make_unique<AxisMapper>(EAxis::Y),
-             .stickRightX = std::make_unique<AxisMapper>(EAxis::RotX),
-             .stickRightY = std::make_unique<AxisMapper>(EAxis::RotY),
-             .dpadUp = std::make_unique<PovMapper>(EPovDirection::Up),
-             .dpadDown = std::make_unique<PovMapper>(EPovDirection::Down),
-             .dpadLeft = std::make_unique<PovMapper>(EPovDirection::Left),
-             .dpadRight = std::make_unique<PovMapper>(EPovDirection::Right),
-             .triggerLT = std::make_unique<AxisMapper>(EAxis::Z, EAxisDirection::Positive),
-             .triggerRT = std::make_unique<AxisMapper>(EAxis::Z, EAxisDirection::Negative),
-             .buttonA = std::make_unique<ButtonMapper>(EButton::B1),
-             .buttonB = std::make_unique<ButtonMapper>(EButton::B2),
-             .buttonX = std::make_unique<ButtonMapper>(EButton::B3),
-             .buttonY = std::make_unique<ButtonMapper>(EButton::B4),
-             .buttonLB = std::make_unique<ButtonMapper>(EButton::B5),
-             .buttonRB = std::make_unique<ButtonMapper>(EButton::B6),
-             .buttonBack = std::make_unique<ButtonMapper>(EButton::B7),
-             .buttonStart = std::make_unique<ButtonMapper>(EButton::B8),
-             .buttonLS = std::make_unique<ButtonMapper>(EButton::B9),
-             .buttonRS = std::make_unique<ButtonMapper>(EButton::B10)})};
+    namespace MapperDefinitions
+    {
+      /// Describes all known mapper types, one element per type. The first element is the default
+      /// mapper. Any field that corresponds to an XInput controller element can be omitted and the
+      /// mapper will simply ignore input from that XInput controller element. Capabilities are
+      /// derived by the compiler, so no mapper objects need to exist in order to query them.
+      static constexpr SMapperDescription kMappers[] = {
+          Describe(
+              L"StandardGamepad",
+              {.stickLeftX = Axis(EAxis::X),
+               .stickLeftY = Axis(EAxis::Y),
+               .stickRightX = Axis(EAxis::Z),
+               .stickRightY = Axis(EAxis::RotZ),
+               .dpadUp = Pov(EPovDirection::Up),
+               .dpadDown = Pov(EPovDirection::Down),
+               .dpadLeft = Pov(EPovDirection::Left),
+               .dpadRight = Pov(EPovDirection::Right),
+               .triggerLT = Button(EButton::B7),
+               .triggerRT = Button(EButton::B8),
+               .buttonA = Button(EButton::B1),
+               .buttonB = Button(EButton::B2),
+               .buttonX = Button(EButton::B3),
+               .buttonY = Button(EButton::B4),
+               .buttonLB = Button(EButton::B5),
+               .buttonRB = Button(EButton::B6),
+               .buttonBack = Button(EButton::B9),
+               .buttonStart = Button(EButton::B10),
+               .buttonLS = Button(EButton::B11),
+               .buttonRS = Button(EButton::B12)}),
+          Describe(
+              L"DigitalGamepad",
+              {.stickLeftX = DigitalAxis(EAxis::X),
+               .stickLeftY = DigitalAxis(EAxis::Y),
+               .stickRightX = DigitalAxis(EAxis::Z),
+               .stickRightY = DigitalAxis(EAxis::RotZ),
+               .dpadUp = DigitalAxis(EAxis::Y, EAxisDirection::Negative),
+               .dpadDown = DigitalAxis(EAxis::Y, EAxisDirection::Positive),
+               .dpadLeft = DigitalAxis(EAxis::X, EAxisDirection::Negative),
+               .dpadRight = DigitalAxis(EAxis::X, EAxisDirection::Positive),
+               .triggerLT = Button(EButton::B7),
+               .triggerRT = Button(EButton::B8),
+               .buttonA = Button(EButton::B1),
+               .buttonB = Button(EButton::B2),
+               .buttonX = Button(EButton::B3),
+               .buttonY = Button(EButton::B4),
+               .buttonLB = Button(EButton::B5),
+               .buttonRB = Button(EButton::B6),
+               .buttonBack = Button(EButton::B9),
+               .buttonStart = Button(EButton::B10),
+               .buttonLS = Button(EButton::B11),
+               .buttonRS = Button(EButton::B12)}),
+          Describe(
+              L"ExtendedGamepad",
+              {.stickLeftX = Axis(EAxis::X),
+               .stickLeftY = Axis(EAxis::Y),
+               .stickRightX = Axis(EAxis::Z),
+               .stickRightY = Axis(EAxis::RotZ),
+               .dpadUp = Pov(EPovDirection::Up),
+               .dpadDown = Pov(EPovDirection::Down),
+               .dpadLeft = Pov(EPovDirection::Left),
+               .dpadRight = Pov(EPovDirection::Right),
+               .triggerLT = Axis(EAxis::RotX),
+               .triggerRT = Axis(EAxis::RotY),
+               .buttonA = Button(EButton::B1),
+               .buttonB = Button(EButton::B2),
+               .buttonX = Button(EButton::B3),
+               .buttonY = Button(EButton::B4),
+               .buttonLB = Button(EButton::B5),
+               .buttonRB = Button(EButton::B6),
+               .buttonBack = Button(EButton::B7),
+               .buttonStart = Button(EButton::B8),
+               .buttonLS = Button(EButton::B9),
+               .buttonRS = Button(EButton::B10)}),
+          Describe(
+              L"XInputNative",
+              {.stickLeftX = Axis(EAxis::X),
+               .stickLeftY = Axis(EAxis::Y),
+               .stickRightX = Axis(EAxis::RotX),
+               .stickRightY = Axis(EAxis::RotY),
+               .dpadUp = Pov(EPovDirection::Up),
+               .dpadDown = Pov(EPovDirection::Down),
+               .dpadLeft = Pov(EPovDirection::Left),
+               .dpadRight = Pov(EPovDirection::Right),
+               .triggerLT = Axis(EAxis::Z),
+               .triggerRT = Axis(EAxis::RotZ),
+               .buttonA = Button(EButton::B1),
+               .buttonB = Button(EButton::B2),
+               .buttonX = Button(EButton::B3),
+               .buttonY = Button(EButton::B4),
+               .buttonLB = Button(EButton::B5),
+               .buttonRB = Button(EButton::B6),
+               .buttonBack = Button(EButton::B7),
+               .buttonStart = Button(EButton::B8),
+               .buttonLS = Button(EButton::B9),
+               .buttonRS = Button(EButton::B10)}),
+          Describe(
+              L"XInputSharedTriggers",
+              {.stickLeftX = Axis(EAxis::X),
+               .stickLeftY = Axis(EAxis::Y),
+               .stickRightX = Axis(EAxis::RotX),
+               .stickRightY = Axis(EAxis::RotY),
+               .dpadUp = Pov(EPovDirection::Up),
+               .dpadDown = Pov(EPovDirection::Down),
+               .dpadLeft = Pov(EPovDirection::Left),
+               .dpadRight = Pov(EPovDirection::Right),
+               .triggerLT = Axis(EAxis::Z, EAxisDirection::Positive),
+               .triggerRT = Axis(EAxis::Z, EAxisDirection::Negative),
+               .buttonA = Button(EButton::B1),
+               .buttonB = Button(EButton::B2),
+               .buttonX = Button(EButton::B3),
+               .buttonY = Button(EButton::B4),
+               .buttonLB = Button(EButton::B5),
+               .buttonRB = Button(EButton::B6),
+               .buttonBack = Button(EButton::B7),
+               .buttonStart = Button(EButton::B8),
+               .buttonLS = Button(EButton::B9),
+               .buttonRS = Button(EButton::B10)})};
+
+      /// Number of built-in mappers.
+      static constexpr unsigned int kMapperCount = _countof(kMappers);
+
+      static_assert(kMapperCount > 0, "At least one built-in mapper is required as the default.");
+
+      // Documented capabilities of the built-in mappers, checked by the compiler.
+      static_assert(
+          (4 == kMappers[0].capabilities.numAxes) && (12 == kMappers[0].capabilities.numButtons) &&
+              (true == kMappers[0].capabilities.hasPov),
+          "StandardGamepad capabilities mismatch.");
+      static_assert(
+          (4 == kMappers[1].capabilities.numAxes) && (12 == kMappers[1].capabilities.numButtons) &&
+              (false == kMappers[1].capabilities.hasPov),
+          "DigitalGamepad capabilities mismatch.");
+      static_assert(
+          (6 == kMappers[2].capabilities.numAxes) && (10 == kMappers[2].capabilities.numButtons) &&
+              (true == kMappers[2].capabilities.hasPov),
+          "ExtendedGamepad capabilities mismatch.");
+      static_assert(
+          (6 == kMappers[3].capabilities.numAxes) && (10 == kMappers[3].capabilities.numButtons) &&
+              (true == kMappers[3].capabilities.hasPov),
+          "XInputNative capabilities mismatch.");
+      static_assert(
+          (5 == kMappers[4].capabilities.numAxes) && (10 == kMappers[4].capabilities.numButtons) &&
+              (true == kMappers[4].capabilities.hasPov),
+          "XInputSharedTriggers capabilities mismatch.");
+
+      /// Number of slots in the perfect hash table used to look up built-in mappers by name. Must
+      /// be a power of two at least as large as the number of built-in mappers.
+      static constexpr unsigned int kHashTableSize = 8;
+
+      static_assert(
+          (kHashTableSize >= kMapperCount) && (0 == (kHashTableSize & (kHashTableSize - 1))),
+          "Perfect hash table size is invalid.");
+
+      /// Hashes a mapper name using the FNV-1a algorithm, perturbed by a seed value.
+      /// @param [in] name Mapper name to hash.
+      /// @param [in] seed Seed value, which selects one of a family of hash functions.
+      /// @return Hash table slot for the mapper name.
+      static constexpr unsigned int HashName(std::wstring_view name, uint32_t seed)
+      {
+        uint32_t hash = 2166136261u ^ seed;
+
+        for (const wchar_t nameChar : name)
+        {
+          hash ^= (uint32_t)nameChar;
+          hash *= 16777619u;
+        }
+
+        // Multiplication only propagates entropy upwards, so the upper bits are folded into the
+        // lower bits that select the slot.
+        return (unsigned int)((hash ^ (hash >> 16)) & (kHashTableSize - 1));
+      }
+
+      /// Searches for a seed value that causes every built-in mapper name to hash to a different
+      /// slot. Intended to be evaluated by the compiler.
+      /// @return Seed value for a perfect hash function.
+      static constexpr uint32_t FindPerfectHashSeed(void)
+      {
+        for (uint32_t seed = 0; true; ++seed)
+        {
+          bool slotUsed[kHashTableSize] = {};
+          bool collisionFound = false;
+
+          for (const auto& mapper : kMappers)
+          {
+            const unsigned int slot = HashName(mapper.name, seed);
+
+            if (true == slotUsed[slot])
+            {
+              collisionFound = true;
+              break;
+            }
+
+            slotUsed[slot] = true;
+          }
+
+          if (false == collisionFound) return seed;
+        }
+      }
+
+      /// Seed value for the perfect hash function that maps built-in mapper names to slots.
+      static constexpr uint32_t kHashSeed = FindPerfectHashSeed();
+
+      /// Perfect hash table that maps built-in mapper names to indices. Each slot holds one more
+      /// than the index of the built-in mapper whose name hashes to it, or 0 if it is empty.
+      static constexpr std::array<uint8_t, kHashTableSize> kHashTable = []() -> auto
+      {
+        std::array<uint8_t, kHashTableSize> hashTable = {};
+
+        for (unsigned int i = 0; i < kMapperCount; ++i)
+          hashTable[HashName(kMappers[i].name, kHashSeed)] = (uint8_t)(1 + i);
+
+        return hashTable;
+      }();
+
+      /// Creates an element mapper object from its description.
+      /// @param [in] description Element mapper description.
+      /// @return Newly-created element mapper object, or `nullptr` if the element is not mapped.
+      static std::unique_ptr<const IElementMapper> CreateElementMapper(
+          const SElementMapperDescription& description)
+      {
+        switch (description.type)
+        {
+          case EElementMapperType::Axis:
+            return std::make_unique<AxisMapper>(description.axis, description.axisDirection);
+
+          case EElementMapperType::Button:
+            return std::make_unique<ButtonMapper>(description.button);
+
+          case EElementMapperType::DigitalAxis:
+            return std::make_unique<DigitalAxisMapper>(
+                description.axis, description.axisDirection);
+
+          case EElementMapperType::Pov:
+            return std::make_unique<PovMapper>(description.povDirection);
+
+          default:
+            return nullptr;
+        }
+      }
+
+      std::unique_ptr<const Mapper> CreateMapper(unsigned int index)
+      {
+        const SMapperDescription& description = kMappers[index];
+
+        return Mapper::CreateUnregistered(
+            description.name,
+            {.stickLeftX = CreateElementMapper(description.elements.stickLeftX),
+             .stickLeftY = CreateElementMapper(description.elements.stickLeftY),
+             .stickRightX = CreateElementMapper(description.elements.stickRightX),
+             .stickRightY = CreateElementMapper(description.elements.stickRightY),
+             .dpadUp = CreateElementMapper(description.elements.dpadUp),
+             .dpadDown = CreateElementMapper(description.elements.dpadDown),
+             .dpadLeft = CreateElementMapper(description.elements.dpadLeft),
+             .dpadRight = CreateElementMapper(description.elements.dpadRight),
+             .triggerLT = CreateElementMapper(description.elements.triggerLT),
+             .triggerRT = CreateElementMapper(description.elements.triggerRT),
+             .buttonA = CreateElementMapper(description.elements.buttonA),
+             .buttonB = CreateElementMapper(description.elements.buttonB),
+             .buttonX = CreateElementMapper(description.elements.buttonX),
+             .buttonY = CreateElementMapper(description.elements.buttonY),
+             .buttonLB = CreateElementMapper(description.elements.buttonLB),
+             .buttonRB = CreateElementMapper(description.elements.buttonRB),
+             .buttonBack = CreateElementMapper(description.elements.buttonBack),
+             .buttonStart = CreateElementMapper(description.elements.buttonStart),
+             .buttonLS = CreateElementMapper(description.elements.buttonLS),
+             .buttonRS = CreateElementMapper(description.elements.buttonRS)});
+      }
+
+      std::optional<unsigned int> FindByName(std::wstring_view name)
+      {
+        const unsigned int hashTableEntry = kHashTable[HashName(name, kHashSeed)];
+        if (0 == hashTableEntry) return std::nullopt;
+
+        const unsigned int index = hashTableEntry - 1;
+        if (name != kMappers[index].name) return std::nullopt;
+
+        return index;
+      }
+
+      unsigned int GetCount(void)
+      {
+        return kMapperCount;
+      }
+
+      const SMapperDescription& GetDescription(unsigned int index)
+      {
+        return kMappers[index];
+      }
+
+      const Mapper* GetMapper(unsigned int index)
+      {
+        static const Mapper* materializedMappers[kMapperCount];
+        static std::once_flag materializedMapperFlags[kMapperCount];
+
+        if (index >= kMapperCount)
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Error,
+              L"Internal error: Requesting out-of-bounds built-in mapper %u.",
+              index);
+          return nullptr;
+        }
+
+        std::call_once(
+            materializedMapperFlags[index],
+            [index]() -> void
+            {
+              materializedMappers[index] = CreateMapper(index).release();
+            });
+
+        return materializedMappers[index];
+      }
+    } // namespace MapperDefinitions
   } // namespace Controller
 } // namespace Xidi
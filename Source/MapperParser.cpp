@@ -27,6 +27,7 @@
 #include "Keyboard.h"
 #include "Mapper.h"
 #include "Mouse.h"
+#include "ResponseCurve.h"
 #include "Strings.h"
 #include "ValueOrError.h"
 
@@ -38,8 +39,8 @@ namespace Xidi
     {
       /// Maximum recursion depth allowed for an element mapper string.
       /// Should be at least one more than the total number of element mapper types that accept
-      /// underlying element mappers.
-      static constexpr unsigned int kElementMapperMaxRecursionDepth = 4;
+      /// underlying element mappers, plus one more for response curves nested inside axis mappers.
+      static constexpr unsigned int kElementMapperMaxRecursionDepth = 5;
 
       /// Character used inside an element mapper string to indicate the beginning of a parameter
       /// list.
@@ -52,6 +53,10 @@ namespace Xidi
       /// parameters.
       static constexpr wchar_t kCharElementMapperParamSeparator = L',';
 
+      /// Character used inside a piecewise response curve control point to separate the input
+      /// percentage from the output percentage.
+      static constexpr wchar_t kCharResponseCurvePointSeparator = L':';
+
       /// Set of characters that are considered whitespace for the purpose of parsing element mapper
       /// strings.
       static constexpr wchar_t kCharSetWhitespace[] = L" \t";
@@ -84,6 +89,7 @@ namespace Xidi
       {
         AxisEnumType axis;
         EAxisDirection direction;
+        const ResponseCurve* responseCurve = nullptr;
       };
 
       /// Type alias for enabling axis parameter parsing to indicate a semantically-rich error on
@@ -291,10 +297,12 @@ namespace Xidi
       /// string.
       /// @tparam AxisEnumType Axis enumeration type that identifies the target axis.
       /// @param [in] params Parameter string.
+      /// @param [in] allowResponseCurve Whether or not a response curve may follow the axis
+      /// direction, or take its place if no axis direction is supplied.
       /// @return Structure containing the parsed parameters if parsing was successful, error
       /// message otherwise.
       template <typename AxisEnumType> static AxisParamsOrError<AxisEnumType> ParseAxisParams(
-          std::wstring_view params)
+          std::wstring_view params, bool allowResponseCurve = false)
       {
         SParamStringParts paramParts =
             ExtractParameterListStringParts(params).value_or(SParamStringParts());
@@ -314,20 +322,49 @@ namespace Xidi
         // Second parameter is optional. It is a string that specifies the axis direction, with the
         // default being both.
         EAxisDirection axisDirection = EAxisDirection::Both;
+        bool axisDirectionPresent = false;
 
         paramParts =
             ExtractParameterListStringParts(paramParts.remaining).value_or(SParamStringParts());
         if (false == paramParts.first.empty())
         {
-          // It is an error for a second parameter to be present but invalid.
+          // It is an error for a second parameter to be present but invalid, unless it could
+          // instead be a response curve.
           const std::optional<EAxisDirection> maybeAxisDirection =
               AxisDirectionFromString(paramParts.first);
-          if (false == maybeAxisDirection.has_value())
+          if (true == maybeAxisDirection.has_value())
+          {
+            axisDirection = maybeAxisDirection.value();
+            axisDirectionPresent = true;
+          }
+          else if (
+              (false == allowResponseCurve) ||
+              (std::wstring_view::npos == paramParts.first.find(kCharElementMapperBeginParams)))
+          {
             return Strings::FormatString(
                        L"%s: Unrecognized axis direction", std::wstring(paramParts.first).c_str())
                 .Data();
+          }
+        }
+
+        // Third parameter is optional and only allowed in some cases. It is a string that
+        // specifies a response curve, with the default being a linear response. If the axis
+        // direction is omitted then the response curve can take its place.
+        const ResponseCurve* responseCurve = nullptr;
+
+        if (true == allowResponseCurve)
+        {
+          if (true == axisDirectionPresent)
+            paramParts =
+                ExtractParameterListStringParts(paramParts.remaining).value_or(SParamStringParts());
 
-          axisDirection = maybeAxisDirection.value();
+          if (false == paramParts.first.empty())
+          {
+            const ResponseCurveOrError maybeResponseCurve = ParseResponseCurve(paramParts.first);
+            if (true == maybeResponseCurve.HasError()) return maybeResponseCurve.Error();
+
+            responseCurve = maybeResponseCurve.Value();
+          }
         }
 
         // No further parameters allowed.
@@ -336,7 +373,8 @@ namespace Xidi
                      L"\"%s\" is extraneous", std::wstring(paramParts.remaining).c_str())
               .Data();
 
-        return SAxisParams<AxisEnumType>({.axis = axis, .direction = axisDirection});
+        return SAxisParams<AxisEnumType>(
+            {.axis = axis, .direction = axisDirection, .responseCurve = responseCurve});
       }
 
       /// Parses a relatively small unsigned integer value from the supplied input string.
@@ -949,12 +987,14 @@ namespace Xidi
 
       ElementMapperOrError MakeAxisMapper(std::wstring_view params)
       {
-        const AxisParamsOrError<EAxis> maybeAxisMapperParams = ParseAxisParams<EAxis>(params);
+        const AxisParamsOrError<EAxis> maybeAxisMapperParams = ParseAxisParams<EAxis>(params, true);
         if (true == maybeAxisMapperParams.HasError())
           return Strings::FormatString(L"Axis: %s", maybeAxisMapperParams.Error().c_str()).Data();
 
         return std::make_unique<AxisMapper>(
-            maybeAxisMapperParams.Value().axis, maybeAxisMapperParams.Value().direction);
+            maybeAxisMapperParams.Value().axis,
+            maybeAxisMapperParams.Value().direction,
+            maybeAxisMapperParams.Value().responseCurve);
       }
 
       ElementMapperOrError MakeButtonMapper(std::wstring_view params)
@@ -1394,6 +1434,141 @@ namespace Xidi
 
         return makeForceFeedbackActuatorIter->second(kForceFeedbackActuatorStringParts.params);
       }
+
+      ResponseCurveOrError ParseResponseCurve(std::wstring_view responseCurveString)
+      {
+        // Map of strings representing response curve types.
+        static const std::map<std::wstring_view, ResponseCurve::EType> kResponseCurveTypeStrings = {
+            {L"exp", ResponseCurve::EType::Exponential},
+            {L"Exp", ResponseCurve::EType::Exponential},
+            {L"exponential", ResponseCurve::EType::Exponential},
+            {L"Exponential", ResponseCurve::EType::Exponential},
+
+            {L"scurve", ResponseCurve::EType::SCurve},
+            {L"Scurve", ResponseCurve::EType::SCurve},
+            {L"SCurve", ResponseCurve::EType::SCurve},
+
+            {L"piecewise", ResponseCurve::EType::Piecewise},
+            {L"Piecewise", ResponseCurve::EType::Piecewise}};
+
+        const std::optional<SStringParts> maybeResponseCurveStringParts =
+            ExtractElementMapperStringParts(responseCurveString);
+        if ((false == maybeResponseCurveStringParts.has_value()) ||
+            (false == maybeResponseCurveStringParts.value().remaining.empty()))
+          return Strings::FormatString(
+                     L"\"%s\" contains a syntax error", std::wstring(responseCurveString).c_str())
+              .Data();
+
+        const SStringParts& responseCurveStringParts = maybeResponseCurveStringParts.value();
+
+        const auto responseCurveTypeIter =
+            kResponseCurveTypeStrings.find(responseCurveStringParts.type);
+        if (kResponseCurveTypeStrings.cend() == responseCurveTypeIter)
+          return Strings::FormatString(
+                     L"%s: Unrecognized response curve",
+                     std::wstring(responseCurveStringParts.type).c_str())
+              .Data();
+
+        ResponseCurve::SSpec responseCurveSpec = {.type = responseCurveTypeIter->second};
+
+        switch (responseCurveSpec.type)
+        {
+          case ResponseCurve::EType::Exponential:
+          {
+            const std::optional<unsigned int> maybeExponentPercent =
+                ParseUnsignedInteger(responseCurveStringParts.params, 10);
+            if ((false == maybeExponentPercent.has_value()) ||
+                (maybeExponentPercent.value() < ResponseCurve::kExponentPercentMin) ||
+                (maybeExponentPercent.value() > ResponseCurve::kExponentPercentMax))
+              return Strings::FormatString(
+                         L"Exponential: Parameter \"%s\" must be a percentage between %u and %u",
+                         std::wstring(responseCurveStringParts.params).c_str(),
+                         ResponseCurve::kExponentPercentMin,
+                         ResponseCurve::kExponentPercentMax)
+                  .Data();
+
+            responseCurveSpec.parameter = maybeExponentPercent.value();
+            break;
+          }
+
+          case ResponseCurve::EType::SCurve:
+          {
+            const std::optional<unsigned int> maybeStrengthPercent =
+                ParseUnsignedInteger(responseCurveStringParts.params, 10);
+            if ((false == maybeStrengthPercent.has_value()) ||
+                (maybeStrengthPercent.value() < ResponseCurve::kStrengthPercentMin) ||
+                (maybeStrengthPercent.value() > ResponseCurve::kStrengthPercentMax))
+              return Strings::FormatString(
+                         L"SCurve: Parameter \"%s\" must be a percentage between %u and %u",
+                         std::wstring(responseCurveStringParts.params).c_str(),
+                         ResponseCurve::kStrengthPercentMin,
+                         ResponseCurve::kStrengthPercentMax)
+                  .Data();
+
+            responseCurveSpec.parameter = maybeStrengthPercent.value();
+            break;
+          }
+
+          case ResponseCurve::EType::Piecewise:
+          {
+            // Each parameter is a control point of the form "input:output", with both parts being
+            // percentages. Inputs must be strictly increasing and lie strictly between neutral and
+            // extreme, which are implied control points.
+            SParamStringParts paramParts = {.remaining = responseCurveStringParts.params};
+            unsigned int minInputPercent = 1;
+
+            while (false == paramParts.remaining.empty())
+            {
+              const std::optional<SParamStringParts> maybeParamParts =
+                  ExtractParameterListStringParts(paramParts.remaining);
+              if (false == maybeParamParts.has_value())
+                return Strings::FormatString(
+                           L"Piecewise: \"%s\" contains a syntax error",
+                           std::wstring(paramParts.remaining).c_str())
+                    .Data();
+
+              paramParts = maybeParamParts.value();
+
+              if (responseCurveSpec.pointCount >= ResponseCurve::kPiecewisePointCountMax)
+                return Strings::FormatString(
+                           L"Piecewise: Too many control points, maximum is %u",
+                           ResponseCurve::kPiecewisePointCountMax)
+                    .Data();
+
+              const size_t separatorPosition =
+                  paramParts.first.find(kCharResponseCurvePointSeparator);
+              const std::optional<unsigned int> maybeInputPercent =
+                  ((std::wstring_view::npos == separatorPosition)
+                       ? std::nullopt
+                       : ParseUnsignedInteger(
+                             TrimWhitespace(paramParts.first.substr(0, separatorPosition)), 10));
+              const std::optional<unsigned int> maybeOutputPercent =
+                  ((std::wstring_view::npos == separatorPosition)
+                       ? std::nullopt
+                       : ParseUnsignedInteger(
+                             TrimWhitespace(paramParts.first.substr(1 + separatorPosition)), 10));
+
+              if ((false == maybeInputPercent.has_value()) ||
+                  (false == maybeOutputPercent.has_value()) ||
+                  (maybeInputPercent.value() < minInputPercent) ||
+                  (maybeInputPercent.value() > 99) || (maybeOutputPercent.value() > 100))
+                return Strings::FormatString(
+                           L"Piecewise: Control point \"%s\" must be of the form input:output, with input strictly increasing between 1 and 99 and output between 0 and 100",
+                           std::wstring(paramParts.first).c_str())
+                    .Data();
+
+              responseCurveSpec.points[responseCurveSpec.pointCount] = {
+                  .inputPercent = (uint8_t)maybeInputPercent.value(),
+                  .outputPercent = (uint8_t)maybeOutputPercent.value()};
+              responseCurveSpec.pointCount += 1;
+              minInputPercent = 1 + maybeInputPercent.value();
+            }
+            break;
+          }
+        }
+
+        return &ResponseCurve::Get(responseCurveSpec);
+      }
     } // namespace MapperParser
   }   // namespace Controller
 } // namespace Xidi
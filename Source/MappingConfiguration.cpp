@@ -0,0 +1,280 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file MappingConfiguration.cpp
+ *   Implementation of the per-controller mapping configuration, which can be reloaded from the
+ *   configuration file while running.
+ **************************************************************************************************/
+
+#include "MappingConfiguration.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include "ApiWindows.h"
+#include "Configuration.h"
+#include "ControllerTypes.h"
+#include "Globals.h"
+#include "Mapper.h"
+#include "MapperBuilder.h"
+#include "Message.h"
+#include "ReadCopyUpdate.h"
+#include "Strings.h"
+#include "TransformProfile.h"
+#include "XidiConfigReader.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    namespace MappingConfiguration
+    {
+      /// Time to wait after the configuration file is first seen to change before reading it.
+      /// Editors often save files in several steps, and reading too early would see a partial
+      /// file.
+      static constexpr unsigned int kChangeSettleMilliseconds = 250;
+
+      /// Retrieves the published mapping configuration of each controller. Objects are allocated
+      /// on first use and never destroyed, because the threads that read them are detached and may
+      /// still be running while static objects are being destroyed.
+      /// @return Array of pointers to published mapping configurations, indexed by controller.
+      static const std::array<ReadCopyUpdate<SMappingConfiguration>*, kPhysicalControllerCount>&
+          PublishedConfigurations(void)
+      {
+        static std::array<ReadCopyUpdate<SMappingConfiguration>*, kPhysicalControllerCount>
+            publishedConfigurations;
+        static std::once_flag initFlag;
+
+        std::call_once(
+            initFlag,
+            []() -> void
+            {
+              for (TControllerIdentifier i = 0; i < publishedConfigurations.size(); ++i)
+                publishedConfigurations[i] = new ReadCopyUpdate<SMappingConfiguration>(
+                    std::unique_ptr<const SMappingConfiguration>(new SMappingConfiguration{
+                        .mapper = Mapper::GetConfigured(i),
+                        .transformProfile = TransformProfile::GetConfigured(i),
+                        .mapperOwner = nullptr}));
+            });
+
+        return publishedConfigurations;
+      }
+
+      /// Retrieves the last-write time of the configuration file.
+      /// @return Last-write time, or 0 if it could not be determined.
+      static uint64_t ConfigurationFileLastWriteTime(void)
+      {
+        WIN32_FILE_ATTRIBUTE_DATA fileAttributes;
+        if (FALSE ==
+            GetFileAttributesEx(
+                Strings::kStrConfigurationFilename.data(), GetFileExInfoStandard, &fileAttributes))
+          return 0;
+
+        return ((uint64_t)fileAttributes.ftLastWriteTime.dwHighDateTime << 32) |
+            (uint64_t)fileAttributes.ftLastWriteTime.dwLowDateTime;
+      }
+
+      /// Waits for changes to the directory that contains the configuration file and reloads the
+      /// configuration file whenever its last-write time changes. Intended to be a thread entry
+      /// point.
+      /// @param [in] changeNotification Change notification handle for the directory that
+      /// contains the configuration file.
+      static void ReloadOnChange(HANDLE changeNotification)
+      {
+        uint64_t lastWriteTime = ConfigurationFileLastWriteTime();
+
+        while (WAIT_OBJECT_0 == WaitForSingleObject(changeNotification, INFINITE))
+        {
+          Sleep(kChangeSettleMilliseconds);
+
+          // Notifications cover the whole directory, which usually contains other files that
+          // change, such as the log file.
+          const uint64_t newLastWriteTime = ConfigurationFileLastWriteTime();
+          if ((0 != newLastWriteTime) && (lastWriteTime != newLastWriteTime))
+          {
+            lastWriteTime = newLastWriteTime;
+
+            Message::OutputFormatted(
+                Message::ESeverity::Info,
+                L"Detected a change to configuration file %s. Reloading it.",
+                Strings::kStrConfigurationFilename.data());
+            Reload();
+          }
+
+          if (FALSE == FindNextChangeNotification(changeNotification)) break;
+        }
+
+        Message::OutputFormatted(
+            Message::ESeverity::Warning,
+            L"Stopped watching for configuration file changes due to Windows error %u.",
+            (unsigned int)GetLastError());
+        FindCloseChangeNotification(changeNotification);
+      }
+
+      TReadGuard Read(TControllerIdentifier controllerIdentifier)
+      {
+        return PublishedConfigurations()[controllerIdentifier]->Read();
+      }
+
+      SMappingConfiguration ResolveReplacement(
+          const SMappingConfiguration& currentConfiguration,
+          const Mapper* newMapper,
+          const TransformProfile& newTransformProfile,
+          const MapperBuilder& customMapperBuilder)
+      {
+        if (newMapper->GetCapabilities() != currentConfiguration.mapper->GetCapabilities())
+          return SMappingConfiguration{
+              .mapper = currentConfiguration.mapper,
+              .transformProfile = newTransformProfile,
+              .mapperOwner = currentConfiguration.mapperOwner};
+
+        std::shared_ptr<const Mapper> newMapperOwner = nullptr;
+
+        const auto detachedMapperIter =
+            customMapperBuilder.GetDetachedMappers().find(newMapper->GetName());
+        if ((customMapperBuilder.GetDetachedMappers().cend() != detachedMapperIter) &&
+            (newMapper == detachedMapperIter->second.get()))
+          newMapperOwner = detachedMapperIter->second;
+
+        return SMappingConfiguration{
+            .mapper = newMapper,
+            .transformProfile = newTransformProfile,
+            .mapperOwner = std::move(newMapperOwner)};
+      }
+
+      void Publish(
+          const Configuration::ConfigurationData& configData,
+          const MapperBuilder& customMapperBuilder)
+      {
+        static std::mutex publishGuard;
+        std::scoped_lock lock(publishGuard);
+
+        const std::array<const Mapper*, kPhysicalControllerCount> resolvedMappers =
+            Mapper::ResolveConfigured(
+                configData,
+                [&customMapperBuilder](std::wstring_view mapperName) -> const Mapper*
+                {
+                  return customMapperBuilder.GetMapper(mapperName);
+                });
+
+        Message::Output(Message::ESeverity::Info, L"Mappers reloaded for controllers...");
+        for (TControllerIdentifier i = 0; i < resolvedMappers.size(); ++i)
+        {
+          std::unique_ptr<const SMappingConfiguration> newConfiguration = nullptr;
+
+          {
+            // The read guard must be released before publishing, which waits for all readers.
+            const TReadGuard currentConfiguration = Read(i);
+            newConfiguration = std::make_unique<const SMappingConfiguration>(ResolveReplacement(
+                *currentConfiguration,
+                resolvedMappers[i],
+                TransformProfile::FromConfigurationData(configData, i),
+                customMapperBuilder));
+          }
+
+          if (newConfiguration->mapper != resolvedMappers[i])
+          {
+            Message::OutputFormatted(
+                Message::ESeverity::Warning,
+                L"    [%u]: Keeping mapper %s because mapper %s has different capabilities. Restart the application to use it.",
+                (unsigned int)(1 + i),
+                newConfiguration->mapper->GetName().data(),
+                resolvedMappers[i]->GetName().data());
+          }
+          else
+          {
+            Message::OutputFormatted(
+                Message::ESeverity::Info,
+                L"    [%u]: %s",
+                (unsigned int)(1 + i),
+                newConfiguration->mapper->GetName().data());
+          }
+
+          // The returned configuration is no longer in use by any reader, so it is destroyed
+          // immediately. Doing so releases the last reference to a previously-reloaded mapper that
+          // is not part of the new configuration.
+          PublishedConfigurations()[i]->Publish(std::move(newConfiguration));
+        }
+      }
+
+      bool Reload(void)
+      {
+        XidiConfigReader configReader;
+        MapperBuilder customMapperBuilder(true);
+        configReader.SetMapperBuilder(&customMapperBuilder);
+
+        const Configuration::ConfigurationData configData =
+            configReader.ReadConfigurationFile(Strings::kStrConfigurationFilename);
+
+        if ((true == configReader.HasReadErrors()) || (true == configData.HasErrors()))
+        {
+          Message::Output(
+              Message::ESeverity::Warning,
+              L"Configuration file was not reloaded because errors were encountered while reading it.");
+          for (const auto& readError : configReader.GetReadErrors())
+            Message::OutputFormatted(Message::ESeverity::Warning, L"    %s", readError.c_str());
+
+          return false;
+        }
+
+        if (false == customMapperBuilder.Build())
+        {
+          Message::Output(
+              Message::ESeverity::Warning,
+              L"Configuration file was not reloaded because errors were encountered during custom mapper construction.");
+          return false;
+        }
+
+        Publish(configData, customMapperBuilder);
+        return true;
+      }
+
+      void WatchForChangesIfConfigured(void)
+      {
+        static std::once_flag watchFlag;
+        std::call_once(
+            watchFlag,
+            []() -> void
+            {
+              const bool hotReloadEnabled =
+                  Globals::GetConfigurationData()
+                      .GetFirstBooleanValue(
+                          Strings::kStrConfigurationSectionMapper,
+                          Strings::kStrConfigurationSettingMapperHotReload)
+                      .value_or(false);
+              if (false == hotReloadEnabled) return;
+
+              // Make sure the startup configuration is published before anything can replace it.
+              PublishedConfigurations();
+
+              const HANDLE changeNotification = FindFirstChangeNotification(
+                  Strings::kStrXidiDirectoryName.data(),
+                  FALSE,
+                  FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+              if (INVALID_HANDLE_VALUE == changeNotification)
+              {
+                Message::OutputFormatted(
+                    Message::ESeverity::Warning,
+                    L"Unable to watch for configuration file changes due to Windows error %u.",
+                    (unsigned int)GetLastError());
+                return;
+              }
+
+              std::thread(ReloadOnChange, changeNotification).detach();
+              Message::OutputFormatted(
+                  Message::ESeverity::Info,
+                  L"Watching configuration file %s for changes. Mappers and raw analog transformations will be reloaded whenever it changes.",
+                  Strings::kStrConfigurationFilename.data());
+            });
+      }
+    } // namespace MappingConfiguration
+  } // namespace Controller
+} // namespace Xidi
@@ -12,9 +12,8 @@
 
 #include "Mouse.h"
 
-#include <concurrent_unordered_map.h>
-
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <cstdint>
 #include <mutex>
@@ -25,6 +24,7 @@
 #include "ApiBitSet.h"
 #include "ApiWindows.h"
 #include "ControllerTypes.h"
+#include "DebugAssert.h"
 #include "Globals.h"
 #include "Message.h"
 #include "Strings.h"
@@ -36,9 +36,31 @@ namespace Xidi
     /// Type used to represent the state of a virtual mouse's buttons.
     using TButtonState = BitSetEnum<EMouseButton>;
 
-    /// Type used to represent the individually-sourced mouse movement contributions.
-    /// Operations allowed are read, append, and update.
-    using TMouseMovementContributions = concurrency::concurrent_unordered_map<uint32_t, int>;
+    /// Holds the individually-sourced mouse movement contributions along a single mouse axis. Each
+    /// source identifier directly indexes its own slot, so submitting a contribution never
+    /// allocates memory and summing all contributions is a walk over a contiguous array. Only the
+    /// slots below the high-water mark have ever been written.
+    struct SMouseMovementContributions
+    {
+      /// Contribution from each source, indexed by source identifier.
+      std::array<std::atomic<int>, kMouseMovementSourceCount> slots = {};
+
+      /// One more than the highest source identifier that has ever submitted a contribution.
+      std::atomic<unsigned int> numSlotsInUse = 0;
+
+      /// Computes the sum of all contributions.
+      /// @return Sum of all contributions, in internal mouse movement units.
+      inline int Sum(void) const
+      {
+        const unsigned int numSlotsToSum = numSlotsInUse.load(std::memory_order_relaxed);
+        int sum = 0;
+
+        for (unsigned int i = 0; i < numSlotsToSum; ++i)
+          sum += slots[i].load(std::memory_order_relaxed);
+
+        return sum;
+      }
+    };
 
     /// Tracks mouse state contributions and generates mouse state snapshots.
     class StateContributionTracker
@@ -99,7 +121,7 @@ namespace Xidi
 
       /// Retrieves a read-only reference to all mouse movement contributions on all axes.
       /// @return Read-only reference to the mouse movement contribution tracking data structure.
-      inline const std::array<TMouseMovementContributions, (unsigned int)EMouseAxis::Count>&
+      inline const std::array<SMouseMovementContributions, (unsigned int)EMouseAxis::Count>&
           MovementContributions(void)
       {
         return mouseMovementContributions;
@@ -139,14 +161,13 @@ namespace Xidi
       {
         for (auto& axisMovementContributions : mouseMovementContributions)
         {
-          for (auto& contribution : axisMovementContributions)
-            contribution.second = 0;
+          for (auto& contribution : axisMovementContributions.slots)
+            contribution.store(0, std::memory_order_relaxed);
         }
       }
 
-      /// Submits a mouse movement.
-      /// Either inserts a contribution from a new source or updates the contribution from an
-      /// existing source.
+      /// Submits a mouse movement by replacing the contribution from the specified source.
+      /// Lock-free and does not allocate memory.
       /// @param [in] axis Mouse axis that is affected.
       /// @param [in] mouseMovementUnits Number of internal mouse movement units along the target
       /// mouse axis.
@@ -154,7 +175,25 @@ namespace Xidi
       inline void SubmitMouseMovement(
           EMouseAxis axis, int mouseMovementUnits, uint32_t sourceIdentifier)
       {
-        mouseMovementContributions[(unsigned int)axis][sourceIdentifier] = mouseMovementUnits;
+        DebugAssert(
+            sourceIdentifier < kMouseMovementSourceCount,
+            "Mouse movement source identifier is out of bounds.");
+        if (sourceIdentifier >= kMouseMovementSourceCount) return;
+
+        SMouseMovementContributions& axisMovementContributions =
+            mouseMovementContributions[(unsigned int)axis];
+        axisMovementContributions.slots[sourceIdentifier].store(
+            mouseMovementUnits, std::memory_order_relaxed);
+
+        unsigned int numSlotsInUse =
+            axisMovementContributions.numSlotsInUse.load(std::memory_order_relaxed);
+        while (numSlotsInUse <= sourceIdentifier)
+        {
+          if (true ==
+              axisMovementContributions.numSlotsInUse.compare_exchange_weak(
+                  numSlotsInUse, sourceIdentifier + 1, std::memory_order_relaxed))
+            break;
+        }
       }
 
     private:
@@ -173,7 +212,7 @@ namespace Xidi
       /// Individually-sourced mouse movement contributions.
       /// Since mouse movements are always relative, only one state data structure is needed, one
       /// per mouse axis.
-      std::array<TMouseMovementContributions, (unsigned int)EMouseAxis::Count>
+      std::array<SMouseMovementContributions, (unsigned int)EMouseAxis::Count>
           mouseMovementContributions;
     };
 
@@ -374,17 +413,12 @@ namespace Xidi
           // Mouse movement
           if ((true == haveInputFocus) && (false == terminationRequested))
           {
-            const std::array<TMouseMovementContributions, (unsigned int)EMouseAxis::Count>&
+            const std::array<SMouseMovementContributions, (unsigned int)EMouseAxis::Count>&
                 mouseMovementContributions = mouseTracker->MovementContributions();
 
             for (size_t axisIndex = 0; axisIndex < mouseMovementContributions.size(); ++axisIndex)
             {
-              const TMouseMovementContributions& axisMovementContributions =
-                  mouseMovementContributions[axisIndex];
-              int axisMovementUnits = 0;
-
-              for (const auto& contribution : axisMovementContributions)
-                axisMovementUnits += contribution.second;
+              int axisMovementUnits = mouseMovementContributions[axisIndex].Sum();
 
               if (kMouseMovementUnitsNeutral != axisMovementUnits)
               {
@@ -11,10 +11,13 @@
 
 #include "PhysicalController.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <stop_token>
+#include <string_view>
 #include <thread>
 
 #include "ApiWindows.h"
@@ -23,9 +26,16 @@
 #include "ForceFeedbackDevice.h"
 #include "Globals.h"
 #include "ImportApiWinMM.h"
-#include "ImportApiXInput.h"
+#include "LatencyTrace.h"
 #include "Mapper.h"
+#include "MappingConfiguration.h"
 #include "Message.h"
+#include "PhysicalControllerRecording.h"
+#include "PhysicalControllerSource.h"
+#include "SeqLock.h"
+#include "StateChangeDispatcher.h"
+#include "Strings.h"
+#include "TransformProfile.h"
 #include "VirtualController.h"
 
 namespace Xidi
@@ -36,8 +46,9 @@ namespace Xidi
     static ConcurrencyWrapper<SPhysicalState> physicalControllerState[kPhysicalControllerCount];
 
     /// State data for each of the possible physical controllers after it is passed through a mapper
-    /// but without any further processing.
-    static ConcurrencyWrapper<SState> rawVirtualControllerState[kPhysicalControllerCount];
+    /// but without any further processing. Virtual controllers receive changes from the polling
+    /// threads directly, so nothing ever waits on these values.
+    static SeqLock<SState> rawVirtualControllerState[kPhysicalControllerCount];
 
     /// Per-controller force feedback device buffer objects.
     /// These objects are not safe for dynamic initialization, so they are initialized later by
@@ -53,6 +64,37 @@ namespace Xidi
     /// feedback registration data.
     static std::mutex physicalControllerForceFeedbackMutex[kPhysicalControllerCount];
 
+    /// Records physical controller state changes, if recording is enabled in the configuration
+    /// file. Created during initialization and destroyed when this library is unloaded, at which
+    /// point the recording file is trimmed to fit the records it contains and closed.
+    static std::unique_ptr<Recording::Recorder> physicalControllerStateRecorder;
+
+    /// Source from which physical controller state is read and to which force feedback actuator
+    /// values are written. Selected based on the configuration file. Not safe for dynamic
+    /// initialization, so it is initialized later by pointer.
+    static IPhysicalControllerSource* physicalControllerSource = nullptr;
+
+    /// Maximum number of milliseconds to wait between polling attempts while a physical controller
+    /// is disconnected. Can be overridden in the configuration file.
+    static unsigned int physicalControllerDisconnectedBackoffMaxPeriodMilliseconds =
+        kPhysicalDisconnectedBackoffMaxPeriodMilliseconds;
+
+    /// Events, one per physical controller, that are signalled whenever the system reports the
+    /// arrival of a device that might be a newly-connected physical controller. Used to interrupt
+    /// the backoff period between polling attempts while a physical controller is disconnected.
+    /// Each is `nullptr` if device arrival notifications are disabled or unavailable.
+    static HANDLE physicalControllerDeviceArrivalEvent[kPhysicalControllerCount];
+
+    /// Device interface class that XInput controllers connected by wire or by wireless adapter
+    /// expose.
+    static constexpr GUID kDeviceInterfaceClassXUSB = {
+        0xec87f1e3, 0xc13b, 0x4100, {0xb5, 0xf7, 0x8b, 0x84, 0xd5, 0x42, 0x60, 0xcb}};
+
+    /// Device interface class for human interface devices, which includes XInput controllers
+    /// connected by Bluetooth.
+    static constexpr GUID kDeviceInterfaceClassHID = {
+        0x4d1e55b2, 0xf16f, 0x11cf, {0x88, 0xcb, 0x00, 0x11, 0x11, 0x00, 0x00, 0x30}};
+
     /// Computes an opaque source identifier from a given controller identifier.
     /// @param [in] controllerIdentifier Identifier of the physical controller for which an
     /// identifier is needed.
@@ -63,74 +105,57 @@ namespace Xidi
       return (uint32_t)controllerIdentifier;
     }
 
-    /// Reads physical controller state.
-    /// @param [in] controllerIdentifier Identifier of the controller on which to operate.
-    /// @return Physical state of the identified controller.
-    static SPhysicalState ReadPhysicalControllerState(TControllerIdentifier controllerIdentifier)
+    /// Receives device notifications from the system and signals all of the device arrival events.
+    /// Arrivals are not filtered by controller because XInput does not expose a mapping between
+    /// device interfaces and controller identifiers, so every disconnected controller simply polls
+    /// once more. Human interface device arrivals, which include keyboards and mice, are needed to
+    /// detect controllers connected by Bluetooth, so they signal the events too. Each event is
+    /// reset whenever its controller becomes disconnected, so any arrivals signalled while it was
+    /// connected do not cut short its backoff. Parameters are documented by the system, see
+    /// `PCM_NOTIFY_CALLBACK`.
+    static DWORD CALLBACK DeviceNotificationCallback(
+        HCMNOTIFICATION notification,
+        PVOID context,
+        CM_NOTIFY_ACTION action,
+        PCM_NOTIFY_EVENT_DATA eventData,
+        DWORD eventDataSize)
     {
-      constexpr uint16_t kUnusedButtonMask =
-          ~((uint16_t)((1u << (unsigned int)EPhysicalButton::UnusedGuide) |
-                       (1u << (unsigned int)EPhysicalButton::UnusedShare)));
-
-      XINPUT_STATE xinputState;
-      DWORD xinputGetStateResult =
-          ImportApiXInput::XInputGetState(controllerIdentifier, &xinputState);
-
-      switch (xinputGetStateResult)
+      if (CM_NOTIFY_ACTION_DEVICEINTERFACEARRIVAL == action)
       {
-        case ERROR_SUCCESS:
-          // Directly using wButtons assumes that the bit layout is the same between the internal
-          // bitset and the XInput data structure. The static assertions below this function verify
-          // this assumption and will cause a compiler error if it is wrong.
-          return {
-              .deviceStatus = EPhysicalDeviceStatus::Ok,
-              .stick =
-                  {xinputState.Gamepad.sThumbLX,
-                          xinputState.Gamepad.sThumbLY,
-                          xinputState.Gamepad.sThumbRX,
-                          xinputState.Gamepad.sThumbRY},
-              .trigger = {xinputState.Gamepad.bLeftTrigger, xinputState.Gamepad.bRightTrigger},
-              .button = (uint16_t)(xinputState.Gamepad.wButtons & kUnusedButtonMask)
-          };
-
-        case ERROR_DEVICE_NOT_CONNECTED:
-          return {.deviceStatus = EPhysicalDeviceStatus::NotConnected};
-
-        default:
-          return {.deviceStatus = EPhysicalDeviceStatus::Error};
+        for (HANDLE deviceArrivalEvent : physicalControllerDeviceArrivalEvent)
+          SetEvent(deviceArrivalEvent);
       }
+
+      return ERROR_SUCCESS;
     }
 
-    static_assert(1u << (unsigned int)EPhysicalButton::DpadUp == XINPUT_GAMEPAD_DPAD_UP);
-    static_assert(1u << (unsigned int)EPhysicalButton::DpadDown == XINPUT_GAMEPAD_DPAD_DOWN);
-    static_assert(1u << (unsigned int)EPhysicalButton::DpadLeft == XINPUT_GAMEPAD_DPAD_LEFT);
-    static_assert(1u << (unsigned int)EPhysicalButton::DpadRight == XINPUT_GAMEPAD_DPAD_RIGHT);
-    static_assert(1u << (unsigned int)EPhysicalButton::Start == XINPUT_GAMEPAD_START);
-    static_assert(1u << (unsigned int)EPhysicalButton::Back == XINPUT_GAMEPAD_BACK);
-    static_assert(1u << (unsigned int)EPhysicalButton::LS == XINPUT_GAMEPAD_LEFT_THUMB);
-    static_assert(1u << (unsigned int)EPhysicalButton::RS == XINPUT_GAMEPAD_RIGHT_THUMB);
-    static_assert(1u << (unsigned int)EPhysicalButton::LB == XINPUT_GAMEPAD_LEFT_SHOULDER);
-    static_assert(1u << (unsigned int)EPhysicalButton::RB == XINPUT_GAMEPAD_RIGHT_SHOULDER);
-    static_assert(1u << (unsigned int)EPhysicalButton::A == XINPUT_GAMEPAD_A);
-    static_assert(1u << (unsigned int)EPhysicalButton::B == XINPUT_GAMEPAD_B);
-    static_assert(1u << (unsigned int)EPhysicalButton::X == XINPUT_GAMEPAD_X);
-    static_assert(1u << (unsigned int)EPhysicalButton::Y == XINPUT_GAMEPAD_Y);
-
-    /// Writes a vibration command to a physical controller.
-    /// @param [in] controllerIdentifier Identifier of the controller on which to operate.
-    /// @param [in] vibration Physical actuator vibration vector.
-    /// @return `true` if successful, `false` otherwise.
-    static bool WritePhysicalControllerVibration(
-        TControllerIdentifier controllerIdentifier,
-        ForceFeedback::SPhysicalActuatorComponents vibration)
+    /// Discards any device arrivals signalled for the specified controller so far. Invoked when the
+    /// controller becomes disconnected.
+    /// @param [in] controllerIdentifier Identifier of the controller whose device arrival event
+    /// should be reset.
+    static void ResetDeviceArrival(TControllerIdentifier controllerIdentifier)
     {
-      // Impulse triggers are ignored because the XInput API does not support them.
-      XINPUT_VIBRATION xinputVibration = {
-          .wLeftMotorSpeed = (WORD)vibration.leftMotor,
-          .wRightMotorSpeed = (WORD)vibration.rightMotor};
-      return (
-          ERROR_SUCCESS ==
-          ImportApiXInput::XInputSetState((DWORD)controllerIdentifier, &xinputVibration));
+      HANDLE deviceArrivalEvent = physicalControllerDeviceArrivalEvent[controllerIdentifier];
+      if (nullptr != deviceArrivalEvent) ResetEvent(deviceArrivalEvent);
+    }
+
+    /// Waits for the specified amount of time to pass or for a device to arrive, whichever comes
+    /// first. If device arrival notifications are unavailable then this is equivalent to sleeping.
+    /// @param [in] controllerIdentifier Identifier of the controller on whose behalf to wait.
+    /// @param [in] timeoutMilliseconds Maximum amount of time to wait.
+    /// @return `true` if the wait ended because a device arrived, `false` otherwise.
+    static bool WaitForDeviceArrival(
+        TControllerIdentifier controllerIdentifier, unsigned int timeoutMilliseconds)
+    {
+      HANDLE deviceArrivalEvent = physicalControllerDeviceArrivalEvent[controllerIdentifier];
+
+      if (nullptr == deviceArrivalEvent)
+      {
+        Sleep(timeoutMilliseconds);
+        return false;
+      }
+
+      return (WAIT_OBJECT_0 == WaitForSingleObject(deviceArrivalEvent, timeoutMilliseconds));
     }
 
     /// Periodically plays force feedback effects on the physical controller actuators.
@@ -142,7 +167,6 @@ namespace Xidi
       ForceFeedback::SPhysicalActuatorComponents previousPhysicalActuatorValues;
       ForceFeedback::SPhysicalActuatorComponents currentPhysicalActuatorValues;
 
-      const Mapper* mapper = Mapper::GetConfigured(controllerIdentifier);
       bool lastActuationResult = true;
 
       while (true)
@@ -174,8 +198,9 @@ namespace Xidi
                   ((ForceFeedback::TEffectValue)virtualController->GetForceFeedbackGain() /
                    ForceFeedback::kEffectModifierMaximum);
 
-            physicalActuatorVector = mapper->MapForceFeedbackVirtualToPhysical(
-                virtualMagnitudeVector, overallEffectGain);
+            physicalActuatorVector = MappingConfiguration::Read(controllerIdentifier)
+                                         ->mapper->MapForceFeedbackVirtualToPhysical(
+                                             virtualMagnitudeVector, overallEffectGain);
           }
 
           currentPhysicalActuatorValues = physicalActuatorVector;
@@ -188,7 +213,8 @@ namespace Xidi
         if (previousPhysicalActuatorValues != currentPhysicalActuatorValues)
         {
           lastActuationResult =
-              WritePhysicalControllerVibration(controllerIdentifier, currentPhysicalActuatorValues);
+              physicalControllerSource->WriteVibration(
+                  controllerIdentifier, currentPhysicalActuatorValues);
           previousPhysicalActuatorValues = currentPhysicalActuatorValues;
         }
         else
@@ -199,36 +225,133 @@ namespace Xidi
     }
 
     /// Periodically polls for physical controller state.
-    /// On detected state change, updates the internal data structure and notifies all waiting
-    /// threads.
+    /// On detected state change, updates the internal data structure, notifies all waiting
+    /// threads, and dispatches the new raw virtual controller state to all registered virtual
+    /// controllers.
     /// @param [in] controllerIdentifier Identifier of the controller on which to operate.
     static void PollForPhysicalControllerStateChanges(TControllerIdentifier controllerIdentifier)
     {
       SPhysicalState newPhysicalState = physicalControllerState[controllerIdentifier].Get();
+      Mapper::SIncrementalMappingCache mappingCache;
+
+      // Mapper that produced the most recent mapping, along with whatever keeps it alive if it was
+      // built by a configuration reload. Keyboard keys and mouse movement are contributed outside
+      // of the virtual controller state, so they stay in effect until this same mapper releases
+      // them, even after a new configuration replaces it.
+      uint64_t mappingConfigurationGeneration;
+      const Mapper* activeMapper;
+      std::shared_ptr<const Mapper> activeMapperOwner;
+
+      {
+        const MappingConfiguration::TReadGuard mappingConfiguration =
+            MappingConfiguration::Read(controllerIdentifier);
+        mappingConfigurationGeneration = mappingConfiguration.GetGeneration();
+        activeMapper = mappingConfiguration->mapper;
+        activeMapperOwner = mappingConfiguration->mapperOwner;
+      }
+
+      unsigned int disconnectedBackoffPeriod = kPhysicalErrorBackoffPeriodMilliseconds;
 
       while (true)
       {
-        if (EPhysicalDeviceStatus::Ok == newPhysicalState.deviceStatus)
-          Sleep(kPhysicalPollingPeriodMilliseconds);
-        else
-          Sleep(kPhysicalErrorBackoffPeriodMilliseconds);
+        switch (newPhysicalState.deviceStatus)
+        {
+          case EPhysicalDeviceStatus::Ok:
+            Sleep(kPhysicalPollingPeriodMilliseconds);
+            disconnectedBackoffPeriod = kPhysicalErrorBackoffPeriodMilliseconds;
+            break;
+
+          case EPhysicalDeviceStatus::NotConnected:
+            // Disconnected controllers are polled less and less frequently the longer they stay
+            // disconnected, but a device arrival restarts the backoff from the beginning because
+            // XInput might not recognize a newly-connected controller right away.
+            if (true == WaitForDeviceArrival(controllerIdentifier, disconnectedBackoffPeriod))
+              disconnectedBackoffPeriod = kPhysicalErrorBackoffPeriodMilliseconds;
+            else
+              disconnectedBackoffPeriod = std::min(
+                  (2 * disconnectedBackoffPeriod),
+                  physicalControllerDisconnectedBackoffMaxPeriodMilliseconds);
+            break;
+
+          default:
+            Sleep(kPhysicalErrorBackoffPeriodMilliseconds);
+            disconnectedBackoffPeriod = kPhysicalErrorBackoffPeriodMilliseconds;
+            break;
+        }
 
-        newPhysicalState = ReadPhysicalControllerState(controllerIdentifier);
+        const LatencyTrace::TTimestamp readTimestamp = LatencyTrace::TraceTimestamp();
+        newPhysicalState = physicalControllerSource->ReadState(controllerIdentifier);
 
-        if (true == physicalControllerState[controllerIdentifier].Update(newPhysicalState))
+        const bool physicalStateChanged =
+            physicalControllerState[controllerIdentifier].Update(newPhysicalState);
+
+        if ((true == physicalStateChanged) &&
+            (EPhysicalDeviceStatus::NotConnected == newPhysicalState.deviceStatus))
+          ResetDeviceArrival(controllerIdentifier);
+
+        const MappingConfiguration::TReadGuard mappingConfiguration =
+            MappingConfiguration::Read(controllerIdentifier);
+
+        // A reloaded mapping configuration requires a remap even if the physical state did not
+        // change. It also invalidates the cache, which identifies the mapper and transformations
+        // by address and could otherwise be fooled by a new configuration reusing an old address.
+        // Before the remap, the outgoing mapper releases its keyboard and mouse contributions,
+        // because the new mapper might not map anything to the same keys or mouse axes.
+        if (mappingConfiguration.GetGeneration() != mappingConfigurationGeneration)
         {
-          const SState newRawVirtualState =
-              ((EPhysicalDeviceStatus::Ok == newPhysicalState.deviceStatus)
-                   ? Mapper::GetConfigured(controllerIdentifier)
-                         ->MapStatePhysicalToVirtual(
-                             newPhysicalState,
-                             OpaqueControllerSourceIdentifier(controllerIdentifier))
-                   : Mapper::GetConfigured(controllerIdentifier)
-                         ->MapNeutralPhysicalToVirtual(
-                             OpaqueControllerSourceIdentifier(controllerIdentifier)));
-
-          rawVirtualControllerState[controllerIdentifier].Update(newRawVirtualState);
+          activeMapper->MapNeutralPhysicalToVirtual(
+              OpaqueControllerSourceIdentifier(controllerIdentifier));
+
+          mappingConfigurationGeneration = mappingConfiguration.GetGeneration();
+          activeMapper = mappingConfiguration->mapper;
+          activeMapperOwner = mappingConfiguration->mapperOwner;
+          mappingCache.Invalidate();
         }
+        else if (false == physicalStateChanged)
+        {
+          continue;
+        }
+
+        if (true == physicalStateChanged)
+        {
+          LatencyTrace::RecordStage(LatencyTrace::EStage::PhysicalRead, readTimestamp);
+
+          if (nullptr != physicalControllerStateRecorder)
+            physicalControllerStateRecorder->Append(controllerIdentifier, newPhysicalState);
+        }
+
+        SState newRawVirtualState;
+
+        if (EPhysicalDeviceStatus::Ok == newPhysicalState.deviceStatus)
+        {
+          // Only the element mappers whose physical inputs changed since the last mapping
+          // operation need to be invoked again.
+          newRawVirtualState = mappingConfiguration->mapper->MapStatePhysicalToVirtual(
+              newPhysicalState,
+              OpaqueControllerSourceIdentifier(controllerIdentifier),
+              mappingCache,
+              mappingConfiguration->transformProfile);
+        }
+        else
+        {
+          // Neutral mapping bypasses the cache, so the next mapping operation must be a full
+          // remap once the physical controller is back.
+          newRawVirtualState = mappingConfiguration->mapper->MapNeutralPhysicalToVirtual(
+              OpaqueControllerSourceIdentifier(controllerIdentifier));
+          mappingCache.Invalidate();
+        }
+
+        LatencyTrace::PublishOrigin(controllerIdentifier, readTimestamp);
+        const bool rawVirtualStateChanged =
+            (newRawVirtualState != rawVirtualControllerState[controllerIdentifier].Load());
+        if (true == rawVirtualStateChanged)
+          rawVirtualControllerState[controllerIdentifier].Store(newRawVirtualState);
+        LatencyTrace::RecordStage(LatencyTrace::EStage::RawVirtualStateUpdate, readTimestamp);
+
+        // Virtual controllers are refreshed directly on this thread rather than each waiting for
+        // the change on a thread of its own.
+        if (true == rawVirtualStateChanged)
+          StateChangeDispatcher::Dispatch(controllerIdentifier, newRawVirtualState);
       }
     }
 
@@ -301,6 +424,169 @@ namespace Xidi
       }
     }
 
+    /// Creates the source of physical controller state based on the configuration file. A recording
+    /// to be replayed takes precedence over the configured source type, and if neither is present
+    /// then physical controllers are accessed using XInput.
+    static void InitializePhysicalControllerSource(void)
+    {
+      const auto& configurationData = Globals::GetConfigurationData();
+
+      const auto maybeReplayFile = configurationData.GetFirstStringValue(
+          Strings::kStrConfigurationSectionRecording,
+          Strings::kStrConfigurationSettingRecordingReplayFile);
+      if (true == maybeReplayFile.has_value())
+      {
+        const unsigned int replaySpeedPercent =
+            (unsigned int)configurationData
+                .GetFirstIntegerValue(
+                    Strings::kStrConfigurationSectionRecording,
+                    Strings::kStrConfigurationSettingRecordingReplaySpeedPercent)
+                .value_or(100);
+
+        const bool replayStepped =
+            configurationData
+                .GetFirstBooleanValue(
+                    Strings::kStrConfigurationSectionRecording,
+                    Strings::kStrConfigurationSettingRecordingReplayStepped)
+                .value_or(false);
+
+        auto player = Recording::Player::Open(maybeReplayFile.value(), replaySpeedPercent);
+        if (nullptr != player)
+        {
+          physicalControllerSource =
+              new ReplayPhysicalControllerSource(std::move(player), replayStepped);
+          return;
+        }
+      }
+
+      const std::wstring_view sourceType =
+          configurationData
+              .GetFirstStringValue(
+                  Strings::kStrConfigurationSectionPhysicalController,
+                  Strings::kStrConfigurationSettingPhysicalControllerSource)
+              .value_or(Strings::kStrConfigurationValuePhysicalControllerSourceXInput);
+
+      if (Strings::kStrConfigurationValuePhysicalControllerSourceSynthetic == sourceType)
+      {
+        const SSyntheticSourceParameters syntheticSourceParameters = {
+            .sweepPeriodMilliseconds =
+                (unsigned int)configurationData
+                    .GetFirstIntegerValue(
+                        Strings::kStrConfigurationSectionPhysicalController,
+                        Strings::kStrConfigurationSettingPhysicalControllerSyntheticSweepPeriodMilliseconds)
+                    .value_or(SSyntheticSourceParameters().sweepPeriodMilliseconds),
+            .buttonMashRatePerSecond =
+                (unsigned int)configurationData
+                    .GetFirstIntegerValue(
+                        Strings::kStrConfigurationSectionPhysicalController,
+                        Strings::kStrConfigurationSettingPhysicalControllerSyntheticButtonMashRate)
+                    .value_or(SSyntheticSourceParameters().buttonMashRatePerSecond)};
+
+        physicalControllerSource = new SyntheticPhysicalControllerSource(syntheticSourceParameters);
+        Message::OutputFormatted(
+            Message::ESeverity::Info,
+            L"Generating synthetic physical controller input in place of reading from physical controllers. Sweep period is %u ms, button mash rate is %u per second.",
+            syntheticSourceParameters.sweepPeriodMilliseconds,
+            syntheticSourceParameters.buttonMashRatePerSecond);
+        return;
+      }
+
+      physicalControllerSource = new XInputPhysicalControllerSource();
+    }
+
+    /// Creates the physical controller state recorder object, but only if it is enabled in the
+    /// configuration file.
+    static void InitializeRecording(void)
+    {
+      const auto& configurationData = Globals::GetConfigurationData();
+
+      const auto maybeRecordFile = configurationData.GetFirstStringValue(
+          Strings::kStrConfigurationSectionRecording,
+          Strings::kStrConfigurationSettingRecordingRecordFile);
+      if (true == maybeRecordFile.has_value())
+      {
+        physicalControllerStateRecorder = Recording::Recorder::Create(maybeRecordFile.value());
+
+        if (nullptr != physicalControllerStateRecorder)
+          Message::OutputFormatted(
+              Message::ESeverity::Info,
+              L"Recording physical controller state changes to %s.",
+              maybeRecordFile.value().data());
+      }
+    }
+
+    /// Reads the disconnected physical controller backoff settings from the configuration file and,
+    /// if enabled, registers for device arrival notifications. Neither is used unless the source of
+    /// physical controller state is backed by hardware, because otherwise controllers connect and
+    /// disconnect on a schedule that does not involve the system.
+    static void InitializeDisconnectedBackoff(void)
+    {
+      if (false == physicalControllerSource->IsBackedByHardware())
+      {
+        physicalControllerDisconnectedBackoffMaxPeriodMilliseconds =
+            kPhysicalErrorBackoffPeriodMilliseconds;
+        return;
+      }
+
+      const auto& configurationData = Globals::GetConfigurationData();
+
+      physicalControllerDisconnectedBackoffMaxPeriodMilliseconds =
+          (unsigned int)configurationData
+              .GetFirstIntegerValue(
+                  Strings::kStrConfigurationSectionPhysicalController,
+                  Strings::kStrConfigurationSettingPhysicalControllerDisconnectedBackoffMaxMilliseconds)
+              .value_or(kPhysicalDisconnectedBackoffMaxPeriodMilliseconds);
+
+      const bool deviceArrivalNotificationEnabled =
+          configurationData
+              .GetFirstBooleanValue(
+                  Strings::kStrConfigurationSectionPhysicalController,
+                  Strings::kStrConfigurationSettingPhysicalControllerDeviceArrivalNotification)
+              .value_or(true);
+      if (false == deviceArrivalNotificationEnabled) return;
+
+      for (auto& deviceArrivalEvent : physicalControllerDeviceArrivalEvent)
+      {
+        deviceArrivalEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+
+        if (nullptr == deviceArrivalEvent)
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Warning,
+              L"Failed with code %u to create a device arrival event.",
+              GetLastError());
+          return;
+        }
+      }
+
+      // Notification registrations last for the lifetime of the process, so their handles are
+      // never needed again after this point.
+      for (const GUID& deviceInterfaceClass : {kDeviceInterfaceClassXUSB, kDeviceInterfaceClassHID})
+      {
+        CM_NOTIFY_FILTER notificationFilter = {};
+        notificationFilter.cbSize = sizeof(notificationFilter);
+        notificationFilter.FilterType = CM_NOTIFY_FILTER_TYPE_DEVICEINTERFACE;
+        notificationFilter.u.DeviceInterface.ClassGuid = deviceInterfaceClass;
+
+        HCMNOTIFICATION notificationHandle = nullptr;
+        const CONFIGRET registerResult = CM_Register_Notification(
+            &notificationFilter, nullptr, DeviceNotificationCallback, &notificationHandle);
+
+        if (CR_SUCCESS != registerResult)
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Warning,
+              L"Failed with code %u to register for device arrival notifications.",
+              (unsigned int)registerResult);
+          return;
+        }
+      }
+
+      Message::Output(
+          Message::ESeverity::Info,
+          L"Registered for device arrival notifications to detect newly-connected physical controllers.");
+    }
+
     /// Initializes internal data structures and creates worker threads.
     /// Idempotent and concurrency-safe.
     static void Initialize(void)
@@ -310,21 +596,31 @@ namespace Xidi
           initFlag,
           []() -> void
           {
+            InitializePhysicalControllerSource();
+            InitializeRecording();
+            InitializeDisconnectedBackoff();
+            LatencyTrace::InitializeIfConfigured();
+
             // Initialize controller state data structures.
             for (auto controllerIdentifier = 0;
                  controllerIdentifier < _countof(physicalControllerState);
                  ++controllerIdentifier)
             {
               const SPhysicalState initialPhysicalState =
-                  ReadPhysicalControllerState(controllerIdentifier);
+                  physicalControllerSource->ReadState(controllerIdentifier);
+              const MappingConfiguration::TReadGuard mappingConfiguration =
+                  MappingConfiguration::Read(controllerIdentifier);
               const SState initialRawVirtualState =
-                  Mapper::GetConfigured(controllerIdentifier)
-                      ->MapStatePhysicalToVirtual(
-                          initialPhysicalState,
-                          OpaqueControllerSourceIdentifier(controllerIdentifier));
+                  mappingConfiguration->mapper->MapStatePhysicalToVirtual(
+                      initialPhysicalState,
+                      OpaqueControllerSourceIdentifier(controllerIdentifier),
+                      mappingConfiguration->transformProfile);
 
               physicalControllerState[controllerIdentifier].Set(initialPhysicalState);
-              rawVirtualControllerState[controllerIdentifier].Set(initialRawVirtualState);
+              rawVirtualControllerState[controllerIdentifier].Store(initialRawVirtualState);
+
+              if (nullptr != physicalControllerStateRecorder)
+                physicalControllerStateRecorder->Append(controllerIdentifier, initialPhysicalState);
             }
 
             // Ensure the system timer resolution is suitable for the desired polling frequency.
@@ -360,9 +656,10 @@ namespace Xidi
               std::thread(PollForPhysicalControllerStateChanges, controllerIdentifier).detach();
               Message::OutputFormatted(
                   Message::ESeverity::Info,
-                  L"Initialized the physical controller state polling thread for controller %u. Desired polling period is %u ms.",
+                  L"Initialized the physical controller state polling thread for controller %u. Desired polling period is %u ms, or up to %u ms while disconnected.",
                   (unsigned int)(1 + controllerIdentifier),
-                  kPhysicalPollingPeriodMilliseconds);
+                  kPhysicalPollingPeriodMilliseconds,
+                  physicalControllerDisconnectedBackoffMaxPeriodMilliseconds);
             }
 
             // Allocate the force feedback device buffers, then create and start the force feedback
@@ -380,6 +677,10 @@ namespace Xidi
                   kPhysicalForceFeedbackPeriodMilliseconds);
             }
 
+            // Start reloading mappers whenever the configuration file changes, but only after all of
+            // the threads that use them are running.
+            MappingConfiguration::WatchForChangesIfConfigured();
+
             // Create and start the physical controller hardware status monitoring threads, but only
             // if the messages generated by those threads will actually be delivered as output.
             if (Message::WillOutputMessageOfSeverity(Message::ESeverity::Warning))
@@ -412,7 +713,7 @@ namespace Xidi
     SState GetCurrentRawVirtualControllerState(TControllerIdentifier controllerIdentifier)
     {
       Initialize();
-      return rawVirtualControllerState[controllerIdentifier].Get();
+      return rawVirtualControllerState[controllerIdentifier].Load();
     }
 
     ForceFeedback::Device* PhysicalControllerForceFeedbackRegister(
@@ -464,15 +765,5 @@ namespace Xidi
 
       return physicalControllerState[controllerIdentifier].WaitForUpdate(state, stopToken);
     }
-
-    bool WaitForRawVirtualControllerStateChange(
-        TControllerIdentifier controllerIdentifier, SState& state, std::stop_token stopToken)
-    {
-      Initialize();
-
-      if (controllerIdentifier >= kPhysicalControllerCount) return false;
-
-      return rawVirtualControllerState[controllerIdentifier].WaitForUpdate(state, stopToken);
-    }
   } // namespace Controller
 } // namespace Xidi
\ No newline at end of file
@@ -0,0 +1,396 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file PhysicalControllerRecording.cpp
+ *   Implementation of functionality for recording and replaying physical controller state
+ *   streams.
+ **************************************************************************************************/
+
+#include "PhysicalControllerRecording.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "ApiWindows.h"
+#include "Clock.h"
+#include "ControllerTypes.h"
+#include "Message.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    namespace Recording
+    {
+      /// Computes the number of bytes needed to hold a recording file header followed by the
+      /// specified number of records.
+      /// @param [in] recordCount Number of records.
+      /// @return Total size in bytes.
+      static inline uint64_t RecordingFileSize(uint64_t recordCount)
+      {
+        return (uint64_t)sizeof(SRecordingFileHeader) + (recordCount * (uint64_t)sizeof(SRecord));
+      }
+
+      SRecord RecordFromPhysicalState(
+          uint64_t timestamp,
+          TControllerIdentifier controllerIdentifier,
+          const SPhysicalState& physicalState)
+      {
+        return {
+            .timestamp = timestamp,
+            .controllerIdentifier = (uint8_t)controllerIdentifier,
+            .deviceStatus = (uint8_t)physicalState.deviceStatus,
+            .trigger = physicalState.trigger,
+            .button = (uint16_t)physicalState.button.to_ulong(),
+            .stick = physicalState.stick,
+            .reserved = 0};
+      }
+
+      SPhysicalState PhysicalStateFromRecord(const SRecord& record)
+      {
+        if (record.deviceStatus >= (uint8_t)EPhysicalDeviceStatus::Count)
+          return {.deviceStatus = EPhysicalDeviceStatus::Error};
+
+        return {
+            .deviceStatus = (EPhysicalDeviceStatus)record.deviceStatus,
+            .stick = record.stick,
+            .trigger = record.trigger,
+            .button = record.button};
+      }
+
+      Recorder::Recorder(HANDLE fileHandle, uint64_t startTimestamp, uint64_t timestampFrequency)
+          : fileHandle(fileHandle),
+            mappingHandle(nullptr),
+            mappedHeader(nullptr),
+            recordCapacity(0),
+            startTimestamp(startTimestamp),
+            timestampFrequency(timestampFrequency),
+            recorderMutex()
+      {}
+
+      Recorder::~Recorder(void)
+      {
+        // When the process is exiting, this object is destroyed after all the polling threads have
+        // already been terminated, and one of them might have been terminated while holding the
+        // lock. Nothing else can append at that point, so the lock is only taken if available.
+        std::unique_lock lock(recorderMutex, std::try_to_lock);
+
+        const uint64_t recordCount = ((nullptr != mappedHeader) ? mappedHeader->recordCount : 0);
+        Unmap();
+
+        // The file grows in large increments, so it is trimmed to fit the records it actually
+        // contains once recording is finished.
+        LARGE_INTEGER finalFileSize = {.QuadPart = (LONGLONG)RecordingFileSize(recordCount)};
+        if (FALSE != SetFilePointerEx(fileHandle, finalFileSize, nullptr, FILE_BEGIN))
+          SetEndOfFile(fileHandle);
+
+        CloseHandle(fileHandle);
+      }
+
+      std::unique_ptr<Recorder> Recorder::Create(std::wstring_view filename)
+      {
+        const std::wstring filenameString(filename);
+        HANDLE fileHandle = CreateFileW(
+            filenameString.c_str(),
+            (GENERIC_READ | GENERIC_WRITE),
+            FILE_SHARE_READ,
+            nullptr,
+            CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (INVALID_HANDLE_VALUE == fileHandle)
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Error,
+              L"Failed with code %u to create physical controller recording file %s.",
+              GetLastError(),
+              filenameString.c_str());
+          return nullptr;
+        }
+
+        std::unique_ptr<Recorder> recorder(
+            new Recorder(fileHandle, Clock::Now(), Clock::GetFrequency()));
+
+        // The new recorder object is not yet visible to any other thread, so there is no need to
+        // hold its lock while initially mapping the file.
+        if (false == recorder->MapWithCapacity(kRecordGrowthIncrement))
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Error,
+              L"Failed with code %u to map physical controller recording file %s.",
+              GetLastError(),
+              filenameString.c_str());
+          return nullptr;
+        }
+
+        *(recorder->mappedHeader) = {
+            .signature = kRecordingFileSignature,
+            .version = kRecordingFileVersion,
+            .recordSize = (uint16_t)sizeof(SRecord),
+            .timestampFrequency = recorder->timestampFrequency,
+            .recordCount = 0};
+
+        return recorder;
+      }
+
+      bool Recorder::Append(
+          TControllerIdentifier controllerIdentifier, const SPhysicalState& physicalState)
+      {
+        std::unique_lock lock(recorderMutex);
+
+        if (nullptr == mappedHeader) return false;
+
+        // Timestamp is taken while holding the lock so that records are guaranteed to appear in
+        // timestamp order even when multiple polling threads append concurrently.
+        const uint64_t timestamp = Clock::Now() - startTimestamp;
+        const uint64_t recordCount = mappedHeader->recordCount;
+
+        if (recordCount >= recordCapacity)
+        {
+          if (false == MapWithCapacity(recordCapacity + kRecordGrowthIncrement))
+          {
+            Message::OutputFormatted(
+                Message::ESeverity::Error,
+                L"Failed with code %u to grow the physical controller recording file. Recording has stopped.",
+                GetLastError());
+            return false;
+          }
+        }
+
+        SRecord* const records = reinterpret_cast<SRecord*>(&mappedHeader[1]);
+        records[recordCount] =
+            RecordFromPhysicalState(timestamp, controllerIdentifier, physicalState);
+        mappedHeader->recordCount = recordCount + 1;
+
+        return true;
+      }
+
+      uint64_t Recorder::GetRecordCount(void) const
+      {
+        std::unique_lock lock(recorderMutex);
+        return ((nullptr != mappedHeader) ? mappedHeader->recordCount : 0);
+      }
+
+      bool Recorder::MapWithCapacity(size_t newRecordCapacity)
+      {
+        Unmap();
+
+        const uint64_t mappingSize = RecordingFileSize(newRecordCapacity);
+
+        mappingHandle = CreateFileMappingW(
+            fileHandle,
+            nullptr,
+            PAGE_READWRITE,
+            (DWORD)(mappingSize >> 32),
+            (DWORD)(mappingSize & 0xffffffffull),
+            nullptr);
+        if (nullptr == mappingHandle) return false;
+
+        mappedHeader = reinterpret_cast<SRecordingFileHeader*>(
+            MapViewOfFile(mappingHandle, FILE_MAP_WRITE, 0, 0, (SIZE_T)mappingSize));
+        if (nullptr == mappedHeader)
+        {
+          Unmap();
+          return false;
+        }
+
+        recordCapacity = newRecordCapacity;
+        return true;
+      }
+
+      void Recorder::Unmap(void)
+      {
+        if (nullptr != mappedHeader)
+        {
+          UnmapViewOfFile(mappedHeader);
+          mappedHeader = nullptr;
+        }
+
+        if (nullptr != mappingHandle)
+        {
+          CloseHandle(mappingHandle);
+          mappingHandle = nullptr;
+        }
+
+        recordCapacity = 0;
+      }
+
+      Player::Player(const void* recordingData, size_t recordingSize, unsigned int speedPercent)
+          : records(),
+            recordIndicesByController(),
+            timestampFrequency(0),
+            playbackStartTimestamp(Clock::Now()),
+            playbackTimestampFrequency(Clock::GetFrequency()),
+            speedPercent(speedPercent),
+            isValid(false)
+      {
+        if ((nullptr == recordingData) || (recordingSize < sizeof(SRecordingFileHeader))) return;
+
+        SRecordingFileHeader header;
+        std::memcpy(&header, recordingData, sizeof(header));
+
+        if ((kRecordingFileSignature != header.signature) ||
+            (kRecordingFileVersion != header.version) || (sizeof(SRecord) != header.recordSize) ||
+            (0 == header.timestampFrequency) || (0 == speedPercent))
+          return;
+
+        // A recording that was interrupted might claim more records than are actually present, so
+        // the record count is limited by the amount of data that is available.
+        const size_t recordCount = (size_t)std::min<uint64_t>(
+            header.recordCount,
+            (uint64_t)((recordingSize - sizeof(SRecordingFileHeader)) / sizeof(SRecord)));
+
+        records.resize(recordCount);
+        std::memcpy(
+            records.data(),
+            &(reinterpret_cast<const uint8_t*>(recordingData)[sizeof(SRecordingFileHeader)]),
+            recordCount * sizeof(SRecord));
+
+        for (size_t recordIndex = 0; recordIndex < records.size(); ++recordIndex)
+        {
+          const SRecord& record = records[recordIndex];
+
+          if (record.controllerIdentifier >= kPhysicalControllerCount) continue;
+          if ((recordIndex > 0) && (record.timestamp < records[recordIndex - 1].timestamp)) return;
+
+          recordIndicesByController[record.controllerIdentifier].push_back(recordIndex);
+        }
+
+        timestampFrequency = header.timestampFrequency;
+        isValid = true;
+      }
+
+      std::unique_ptr<Player> Player::Open(std::wstring_view filename, unsigned int speedPercent)
+      {
+        const std::wstring filenameString(filename);
+        HANDLE fileHandle = CreateFileW(
+            filenameString.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (INVALID_HANDLE_VALUE == fileHandle)
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Error,
+              L"Failed with code %u to open physical controller recording file %s.",
+              GetLastError(),
+              filenameString.c_str());
+          return nullptr;
+        }
+
+        LARGE_INTEGER fileSize = {};
+        HANDLE mappingHandle = nullptr;
+        const void* mappedView = nullptr;
+
+        if ((FALSE != GetFileSizeEx(fileHandle, &fileSize)) && (fileSize.QuadPart > 0))
+          mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (nullptr != mappingHandle)
+          mappedView = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+        std::unique_ptr<Player> player;
+        if (nullptr != mappedView)
+        {
+          player =
+              std::make_unique<Player>(mappedView, (size_t)fileSize.QuadPart, speedPercent);
+          UnmapViewOfFile(mappedView);
+        }
+
+        if (nullptr != mappingHandle) CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+
+        if ((nullptr == player) || (false == player->IsValid()))
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Error,
+              L"Physical controller recording file %s is invalid and cannot be replayed.",
+              filenameString.c_str());
+          return nullptr;
+        }
+
+        Message::OutputFormatted(
+            Message::ESeverity::Info,
+            L"Loaded %llu record(s) from physical controller recording file %s for replay at %u%% speed.",
+            (unsigned long long)player->GetRecordCount(),
+            filenameString.c_str(),
+            speedPercent);
+        return player;
+      }
+
+      uint64_t Player::GetDuration(void) const
+      {
+        if (true == records.empty()) return 0;
+
+        return records.back().timestamp;
+      }
+
+      size_t Player::GetRecordCountForController(TControllerIdentifier controllerIdentifier) const
+      {
+        if (controllerIdentifier >= kPhysicalControllerCount) return 0;
+
+        return recordIndicesByController[controllerIdentifier].size();
+      }
+
+      SPhysicalState Player::GetStateAtPosition(
+          TControllerIdentifier controllerIdentifier, size_t position) const
+      {
+        if (controllerIdentifier >= kPhysicalControllerCount)
+          return {.deviceStatus = EPhysicalDeviceStatus::Error};
+
+        const auto& recordIndices = recordIndicesByController[controllerIdentifier];
+        if (true == recordIndices.empty())
+          return {.deviceStatus = EPhysicalDeviceStatus::NotConnected};
+
+        return PhysicalStateFromRecord(
+            records[recordIndices[std::min(position, recordIndices.size() - 1)]]);
+      }
+
+      SPhysicalState Player::GetStateAt(
+          TControllerIdentifier controllerIdentifier, uint64_t timestamp) const
+      {
+        if (controllerIdentifier >= kPhysicalControllerCount)
+          return {.deviceStatus = EPhysicalDeviceStatus::Error};
+
+        const auto& recordIndices = recordIndicesByController[controllerIdentifier];
+
+        // Finds the first record for this controller that is strictly after the requested time.
+        // The record immediately before it, if any, holds the state as of the requested time.
+        const auto nextRecordIndexIter = std::upper_bound(
+            recordIndices.cbegin(),
+            recordIndices.cend(),
+            timestamp,
+            [this](uint64_t value, size_t recordIndex) -> bool
+            {
+              return (value < records[recordIndex].timestamp);
+            });
+
+        if (recordIndices.cbegin() == nextRecordIndexIter)
+          return {.deviceStatus = EPhysicalDeviceStatus::NotConnected};
+
+        return PhysicalStateFromRecord(records[*(nextRecordIndexIter - 1)]);
+      }
+
+      SPhysicalState Player::ReadState(TControllerIdentifier controllerIdentifier) const
+      {
+        const uint64_t elapsedPlaybackTicks = Clock::Now() - playbackStartTimestamp;
+        const uint64_t recordingTimestamp = (uint64_t)(
+            ((double)elapsedPlaybackTicks * (double)timestampFrequency * (double)speedPercent) /
+            ((double)playbackTimestampFrequency * 100.0));
+
+        return GetStateAt(controllerIdentifier, recordingTimestamp);
+      }
+    } // namespace Recording
+  }   // namespace Controller
+} // namespace Xidi
@@ -0,0 +1,219 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file PhysicalControllerSource.cpp
+ *   Implementation of sources from which physical controller state is obtained and to which
+ *   physical force feedback actuator values are sent.
+ **************************************************************************************************/
+
+#include "PhysicalControllerSource.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numbers>
+
+#include "ApiWindows.h"
+#include "Clock.h"
+#include "ControllerTypes.h"
+#include "ForceFeedbackTypes.h"
+#include "ImportApiXInput.h"
+#include "PhysicalControllerRecording.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Mask that identifies all of the physical buttons that are actually used.
+    static constexpr uint16_t kUsedButtonMask =
+        ~((uint16_t)((1u << (unsigned int)EPhysicalButton::UnusedGuide) |
+                     (1u << (unsigned int)EPhysicalButton::UnusedShare)));
+
+    /// Scrambles the bits of the input value to produce a pseudo-random output value. This is the
+    /// finalizer from the SplitMix64 generator, which is a bijection with good avalanche behavior.
+    /// @param [in] value Value to scramble.
+    /// @return Scrambled value.
+    static inline uint64_t ScrambleBits(uint64_t value)
+    {
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+      return (value ^ (value >> 31));
+    }
+
+    bool XInputPhysicalControllerSource::IsBackedByHardware(void) const
+    {
+      return true;
+    }
+
+    SPhysicalState XInputPhysicalControllerSource::ReadState(
+        TControllerIdentifier controllerIdentifier)
+    {
+      XINPUT_STATE xinputState;
+      DWORD xinputGetStateResult =
+          ImportApiXInput::XInputGetState(controllerIdentifier, &xinputState);
+
+      switch (xinputGetStateResult)
+      {
+        case ERROR_SUCCESS:
+          // Directly using wButtons assumes that the bit layout is the same between the internal
+          // bitset and the XInput data structure. The static assertions below this function verify
+          // this assumption and will cause a compiler error if it is wrong.
+          return {
+              .deviceStatus = EPhysicalDeviceStatus::Ok,
+              .stick =
+                  {xinputState.Gamepad.sThumbLX,
+                          xinputState.Gamepad.sThumbLY,
+                          xinputState.Gamepad.sThumbRX,
+                          xinputState.Gamepad.sThumbRY},
+              .trigger = {xinputState.Gamepad.bLeftTrigger, xinputState.Gamepad.bRightTrigger},
+              .button = (uint16_t)(xinputState.Gamepad.wButtons & kUsedButtonMask)
+          };
+
+        case ERROR_DEVICE_NOT_CONNECTED:
+          return {.deviceStatus = EPhysicalDeviceStatus::NotConnected};
+
+        default:
+          return {.deviceStatus = EPhysicalDeviceStatus::Error};
+      }
+    }
+
+    static_assert(1u << (unsigned int)EPhysicalButton::DpadUp == XINPUT_GAMEPAD_DPAD_UP);
+    static_assert(1u << (unsigned int)EPhysicalButton::DpadDown == XINPUT_GAMEPAD_DPAD_DOWN);
+    static_assert(1u << (unsigned int)EPhysicalButton::DpadLeft == XINPUT_GAMEPAD_DPAD_LEFT);
+    static_assert(1u << (unsigned int)EPhysicalButton::DpadRight == XINPUT_GAMEPAD_DPAD_RIGHT);
+    static_assert(1u << (unsigned int)EPhysicalButton::Start == XINPUT_GAMEPAD_START);
+    static_assert(1u << (unsigned int)EPhysicalButton::Back == XINPUT_GAMEPAD_BACK);
+    static_assert(1u << (unsigned int)EPhysicalButton::LS == XINPUT_GAMEPAD_LEFT_THUMB);
+    static_assert(1u << (unsigned int)EPhysicalButton::RS == XINPUT_GAMEPAD_RIGHT_THUMB);
+    static_assert(1u << (unsigned int)EPhysicalButton::LB == XINPUT_GAMEPAD_LEFT_SHOULDER);
+    static_assert(1u << (unsigned int)EPhysicalButton::RB == XINPUT_GAMEPAD_RIGHT_SHOULDER);
+    static_assert(1u << (unsigned int)EPhysicalButton::A == XINPUT_GAMEPAD_A);
+    static_assert(1u << (unsigned int)EPhysicalButton::B == XINPUT_GAMEPAD_B);
+    static_assert(1u << (unsigned int)EPhysicalButton::X == XINPUT_GAMEPAD_X);
+    static_assert(1u << (unsigned int)EPhysicalButton::Y == XINPUT_GAMEPAD_Y);
+
+    bool XInputPhysicalControllerSource::WriteVibration(
+        TControllerIdentifier controllerIdentifier,
+        ForceFeedback::SPhysicalActuatorComponents vibration)
+    {
+      // Impulse triggers are ignored because the XInput API does not support them.
+      XINPUT_VIBRATION xinputVibration = {
+          .wLeftMotorSpeed = (WORD)vibration.leftMotor,
+          .wRightMotorSpeed = (WORD)vibration.rightMotor};
+      return (
+          ERROR_SUCCESS ==
+          ImportApiXInput::XInputSetState((DWORD)controllerIdentifier, &xinputVibration));
+    }
+
+    SyntheticPhysicalControllerSource::SyntheticPhysicalControllerSource(
+        const SSyntheticSourceParameters& parameters)
+        : parameters(parameters), startTime(Clock::Now())
+    {
+      // A sweep period of 0 would cause division by 0, so it is treated as the shortest possible
+      // period instead.
+      if (0 == this->parameters.sweepPeriodMilliseconds)
+        this->parameters.sweepPeriodMilliseconds = 1;
+    }
+
+    SPhysicalState SyntheticPhysicalControllerSource::GetStateAt(
+        TControllerIdentifier controllerIdentifier, uint64_t elapsedMilliseconds) const
+    {
+      const uint64_t sweepPeriod = (uint64_t)parameters.sweepPeriodMilliseconds;
+
+      // Each controller is offset in phase by an equal fraction of the sweep period so that
+      // controllers do not all report identical states at the same time.
+      const uint64_t sweepOffset = (sweepPeriod * controllerIdentifier) / kPhysicalControllerCount;
+      const uint64_t sweepPosition = (elapsedMilliseconds + sweepOffset) % sweepPeriod;
+      const double sweepAngle =
+          (2.0 * std::numbers::pi * (double)sweepPosition) / (double)sweepPeriod;
+
+      const int16_t sweepSine = (int16_t)std::lround(std::sin(sweepAngle) * 32767.0);
+      const int16_t sweepCosine = (int16_t)std::lround(std::cos(sweepAngle) * 32767.0);
+
+      // Triggers follow a triangle wave, from released to fully pressed and back.
+      const uint64_t sweepHalfPeriod = ((sweepPeriod + 1) / 2);
+      const uint64_t triggerPosition =
+          ((sweepPosition < sweepHalfPeriod) ? sweepPosition : (sweepPeriod - sweepPosition));
+      const uint8_t triggerValue = (uint8_t)((triggerPosition * 255) / sweepHalfPeriod);
+
+      uint16_t buttonValue = 0;
+      if (0 != parameters.buttonMashRatePerSecond)
+      {
+        const uint64_t mashIndex =
+            (elapsedMilliseconds * parameters.buttonMashRatePerSecond) / 1000;
+        const uint64_t mashBits = ScrambleBits(
+            ((uint64_t)parameters.seed << 32) ^
+            ((mashIndex * kPhysicalControllerCount) + controllerIdentifier));
+        buttonValue = (uint16_t)mashBits & kUsedButtonMask;
+      }
+
+      return {
+          .deviceStatus = EPhysicalDeviceStatus::Ok,
+          .stick = {sweepSine, sweepCosine, sweepCosine, (int16_t)-sweepSine},
+          .trigger = {triggerValue, (uint8_t)(255 - triggerValue)},
+          .button = buttonValue
+      };
+    }
+
+    bool SyntheticPhysicalControllerSource::IsBackedByHardware(void) const
+    {
+      return false;
+    }
+
+    SPhysicalState SyntheticPhysicalControllerSource::ReadState(
+        TControllerIdentifier controllerIdentifier)
+    {
+      return GetStateAt(controllerIdentifier, Clock::TicksToMilliseconds(Clock::Now() - startTime));
+    }
+
+    bool SyntheticPhysicalControllerSource::WriteVibration(
+        TControllerIdentifier controllerIdentifier,
+        ForceFeedback::SPhysicalActuatorComponents vibration)
+    {
+      return true;
+    }
+
+    ReplayPhysicalControllerSource::ReplayPhysicalControllerSource(
+        std::unique_ptr<Recording::Player>&& player, bool stepped)
+        : player(std::move(player)), stepped(stepped), nextPosition()
+    {}
+
+    bool ReplayPhysicalControllerSource::IsBackedByHardware(void) const
+    {
+      return false;
+    }
+
+    SPhysicalState ReplayPhysicalControllerSource::ReadState(
+        TControllerIdentifier controllerIdentifier)
+    {
+      if (controllerIdentifier >= kPhysicalControllerCount)
+        return {.deviceStatus = EPhysicalDeviceStatus::Error};
+
+      if (true == stepped)
+      {
+        // Positions past the end hold the last recorded state, so the position stops advancing
+        // there rather than continuing to count reads.
+        const size_t position = nextPosition[controllerIdentifier].load();
+        if (position < player->GetRecordCountForController(controllerIdentifier))
+          nextPosition[controllerIdentifier].store(position + 1);
+
+        return player->GetStateAtPosition(controllerIdentifier, position);
+      }
+
+      return player->ReadState(controllerIdentifier);
+    }
+
+    bool ReplayPhysicalControllerSource::WriteVibration(
+        TControllerIdentifier controllerIdentifier,
+        ForceFeedback::SPhysicalActuatorComponents vibration)
+    {
+      return true;
+    }
+  } // namespace Controller
+} // namespace Xidi
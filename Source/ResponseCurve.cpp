@@ -0,0 +1,137 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ResponseCurve.cpp
+ *   Implementation of response curves that reshape analog values before they are contributed to
+ *   virtual controller axes.
+ **************************************************************************************************/
+
+#include "ResponseCurve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "ControllerTypes.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Transforms a displacement from neutral using the specified curve and rescales the result to
+    /// an integer displacement of the same maximum magnitude.
+    /// @param [in] spec Description of the curve.
+    /// @param [in] displacement Input displacement from neutral, which must not exceed the
+    /// maximum.
+    /// @param [in] maxDisplacement Largest possible displacement from neutral.
+    /// @return Output displacement from neutral.
+    static int32_t TransformDisplacement(
+        const ResponseCurve::SSpec& spec, int32_t displacement, int32_t maxDisplacement)
+    {
+      const double transformedDisplacement = ResponseCurve::EvaluateNormalized(
+          spec, (double)displacement / (double)maxDisplacement);
+      return std::clamp(
+          (int32_t)std::lround(transformedDisplacement * (double)maxDisplacement),
+          (int32_t)0,
+          maxDisplacement);
+    }
+
+    ResponseCurve::ResponseCurve(const SSpec& spec) : spec(spec), analogValues(), triggerValues()
+    {
+      constexpr int32_t kAnalogDisplacementMax = kAnalogValueMax - kAnalogValueNeutral;
+      constexpr int32_t kTriggerDisplacementMax = kTriggerValueMax - kTriggerValueMin;
+
+      for (int32_t analogValue = std::numeric_limits<int16_t>::min();
+           analogValue <= std::numeric_limits<int16_t>::max();
+           ++analogValue)
+      {
+        const int32_t displacement = analogValue - kAnalogValueNeutral;
+        const int32_t transformedDisplacement = TransformDisplacement(
+            spec, std::min(std::abs(displacement), kAnalogDisplacementMax), kAnalogDisplacementMax);
+
+        analogValues[(uint16_t)analogValue] = (int16_t)(
+            (displacement >= 0) ? (kAnalogValueNeutral + transformedDisplacement)
+                                : (kAnalogValueNeutral - transformedDisplacement));
+      }
+
+      for (int32_t triggerValue = std::numeric_limits<uint8_t>::min();
+           triggerValue <= std::numeric_limits<uint8_t>::max();
+           ++triggerValue)
+        triggerValues[triggerValue] = (uint8_t)(
+            kTriggerValueMin +
+            TransformDisplacement(spec, triggerValue - kTriggerValueMin, kTriggerDisplacementMax));
+    }
+
+    const ResponseCurve& ResponseCurve::Get(const SSpec& spec)
+    {
+      static std::mutex curvesGuard;
+      static std::map<SSpec, std::unique_ptr<ResponseCurve>> curves;
+
+      std::scoped_lock lock(curvesGuard);
+
+      auto& curve = curves[spec];
+      if (nullptr == curve) curve.reset(new ResponseCurve(spec));
+
+      return *curve;
+    }
+
+    double ResponseCurve::EvaluateNormalized(const SSpec& spec, double displacement)
+    {
+      switch (spec.type)
+      {
+        case EType::Exponential:
+          return std::pow(displacement, (double)spec.parameter / 100.0);
+
+        case EType::SCurve:
+        {
+          const double smoothstep = displacement * displacement * (3.0 - (2.0 * displacement));
+          return displacement + (((double)spec.parameter / 100.0) * (smoothstep - displacement));
+        }
+
+        case EType::Piecewise:
+        {
+          // Control points at neutral and at the extreme are implied, so the segment containing
+          // the input is bounded by the last control point whose input does not exceed it and the
+          // next control point, or the extreme if there is none.
+          const double inputPercent = displacement * 100.0;
+
+          double segmentStartInput = 0.0;
+          double segmentStartOutput = 0.0;
+          double segmentEndInput = 100.0;
+          double segmentEndOutput = 100.0;
+
+          for (unsigned int i = 0; i < spec.pointCount; ++i)
+          {
+            if ((double)spec.points[i].inputPercent <= inputPercent)
+            {
+              segmentStartInput = (double)spec.points[i].inputPercent;
+              segmentStartOutput = (double)spec.points[i].outputPercent;
+            }
+            else
+            {
+              segmentEndInput = (double)spec.points[i].inputPercent;
+              segmentEndOutput = (double)spec.points[i].outputPercent;
+              break;
+            }
+          }
+
+          const double segmentPosition =
+              (inputPercent - segmentStartInput) / (segmentEndInput - segmentStartInput);
+          return (segmentStartOutput + (segmentPosition * (segmentEndOutput - segmentStartOutput))) /
+              100.0;
+        }
+
+        default:
+          return displacement;
+      }
+    }
+  } // namespace Controller
+} // namespace Xidi
@@ -0,0 +1,74 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file StateChangeDispatcher.cpp
+ *   Implementation of the mechanism by which raw virtual controller state changes are delivered to
+ *   all of the virtual controller objects associated with each physical controller.
+ **************************************************************************************************/
+
+#include "StateChangeDispatcher.h"
+
+#include <mutex>
+
+#include "ControllerTypes.h"
+#include "Message.h"
+#include "PhysicalController.h"
+#include "VirtualControllerCore.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    namespace StateChangeDispatcher
+    {
+      /// Virtual controller core registered with each physical controller, or `nullptr` if no
+      /// virtual controller objects exist for that physical controller.
+      static VirtualControllerCore* registeredCore[kPhysicalControllerCount];
+
+      /// Mutex objects, one per physical controller, that protect the registered cores and
+      /// serialize dispatches to them.
+      static std::mutex registrationMutex[kPhysicalControllerCount];
+
+      void Dispatch(TControllerIdentifier controllerIdentifier, const SState& rawVirtualState)
+      {
+        if (controllerIdentifier >= kPhysicalControllerCount) return;
+
+        std::unique_lock lock(registrationMutex[controllerIdentifier]);
+
+        if (nullptr != registeredCore[controllerIdentifier])
+          registeredCore[controllerIdentifier]->Update(rawVirtualState);
+      }
+
+      void Register(TControllerIdentifier controllerIdentifier, VirtualControllerCore& core)
+      {
+        if (controllerIdentifier >= kPhysicalControllerCount)
+        {
+          Message::OutputFormatted(
+              Message::ESeverity::Error,
+              L"Attempted to register for state changes with a physical controller with invalid identifier %u.",
+              controllerIdentifier);
+          return;
+        }
+
+        std::unique_lock lock(registrationMutex[controllerIdentifier]);
+
+        registeredCore[controllerIdentifier] = &core;
+        core.Update(GetCurrentRawVirtualControllerState(controllerIdentifier));
+      }
+
+      void Unregister(TControllerIdentifier controllerIdentifier, VirtualControllerCore& core)
+      {
+        if (controllerIdentifier >= kPhysicalControllerCount) return;
+
+        std::unique_lock lock(registrationMutex[controllerIdentifier]);
+
+        if (&core == registeredCore[controllerIdentifier])
+          registeredCore[controllerIdentifier] = nullptr;
+      }
+    } // namespace StateChangeDispatcher
+  } // namespace Controller
+} // namespace Xidi
@@ -11,44 +11,107 @@
 
 #include "StateChangeEventBuffer.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 
-#include <boost/circular_buffer.hpp>
-
-#include "ApiWindows.h"
+#include "Clock.h"
 #include "ControllerTypes.h"
 
 namespace Xidi
 {
   namespace Controller
   {
-    /// Handles a possible buffer overflow condition.
-    /// @param [in] eventBuffer Event buffer object for which to check for overflow.
-    /// @return `true` if the event buffer overflowed, `false` otherwise.
-    static inline bool HandlePossibleOverflow(
-        boost::circular_buffer<StateChangeEventBuffer::SEvent>& eventBuffer)
+    void StateChangeEventBuffer::AppendEvent(SEventData eventData, Clock::TTimestamp timestamp)
     {
-      // Per DirectInput documentation, we always need one free space in the buffer.
-      // This is how we ensure the number of events stored is always one less than capacity.
+      // Sequence number is globally ordered with respect to all controller events, even those from
+      // other event buffers.
+      static std::atomic<uint32_t> nextSequence = 0;
+
+      const uint32_t currentCapacity = capacity.load(std::memory_order_relaxed);
+
+      // Per DirectInput documentation, we always need one free space in the buffer. A buffer with
+      // a capacity of 1 therefore cannot hold any events at all, so every event overflows it.
+      if (currentCapacity < 2)
+      {
+        if (0 != currentCapacity) readState.fetch_or(kOverflowFlag, std::memory_order_acq_rel);
+        return;
+      }
 
-      const bool eventBufferWasFull = ((0 != eventBuffer.size()) && (true == eventBuffer.full()));
+      const uint64_t index = writeIndex.load(std::memory_order_relaxed);
 
-      if (true == eventBufferWasFull) eventBuffer.pop_front();
+      if (true == kCoalesceAxisEvents)
+      {
+        if (EElementType::Axis == eventData.element.type)
+        {
+          uint64_t& coalescableIndex = coalescableAxisEventIndex[(int)eventData.element.axis];
+
+          if ((kNoCoalescableEvent != coalescableIndex) &&
+              (true == CoalesceEvent(coalescableIndex, eventData, timestamp)))
+            return;
+
+          coalescableIndex = index;
+        }
+        else
+        {
+          // Coalescing an axis event into one that precedes a button or POV event would reorder
+          // them relative to one another.
+          coalescableAxisEventIndex.fill(kNoCoalescableEvent);
+        }
+      }
 
-      return eventBufferWasFull;
+      // If the buffer is already holding as many events as it can, the oldest event is discarded
+      // to make room. A consumer might remove events concurrently, in which case there may no
+      // longer be any need to discard anything.
+      uint64_t readStateSnapshot = readState.load(std::memory_order_acquire);
+      while ((index - ReadIndex(readStateSnapshot)) >= (uint64_t)(currentCapacity - 1))
+      {
+        if (true ==
+            readState.compare_exchange_weak(
+                readStateSnapshot,
+                WithReadIndex(readStateSnapshot, ReadIndex(readStateSnapshot) + 1) | kOverflowFlag,
+                std::memory_order_acq_rel,
+                std::memory_order_acquire))
+          break;
+      }
+
+      // The slot being written is the free slot, but a slow consumer might still be copying the
+      // event that previously occupied it. The write is ordered after the read index update, which
+      // allows that consumer to detect that its copy is stale.
+      StoreEvent(
+          index, {.data = eventData, .timestamp = timestamp, .sequence = nextSequence++});
+      writeIndex.store(index + 1, std::memory_order_release);
     }
 
-    void StateChangeEventBuffer::AppendEvent(SEventData eventData, uint32_t timestamp)
+    bool StateChangeEventBuffer::CoalesceEvent(
+        uint64_t index, SEventData eventData, Clock::TTimestamp timestamp)
     {
-      // Sequence number is globally ordered with respect to all controller events, even those from
-      // other event buffers.
-      static std::atomic<uint32_t> nextSequence = 0;
+      // Consumers holding a copy of the event from before it is updated cannot remove it once the
+      // modification count changes, and no consumer reads or removes events until the update is
+      // complete. This way every consumer observes either the old value followed by the new value
+      // or just the new value.
+      uint64_t readStateSnapshot = readState.load(std::memory_order_acquire);
+      do
+      {
+        if (index < ReadIndex(readStateSnapshot)) return false;
+      } while (false ==
+               readState.compare_exchange_weak(
+                   readStateSnapshot,
+                   WithNextModificationCount(readStateSnapshot) | kCoalescingFlag,
+                   std::memory_order_acq_rel,
+                   std::memory_order_acquire));
 
-      eventBuffer.push_back(
-          {.data = eventData, .timestamp = timestamp, .sequence = nextSequence++});
+      SEvent event = LoadEvent(index);
+      event.data = eventData;
+      event.timestamp = timestamp;
+      StoreEvent(index, event);
 
-      eventBufferOverflowed = HandlePossibleOverflow(eventBuffer);
+      readState.fetch_and(~kCoalescingFlag, std::memory_order_release);
+      return true;
     }
 
     void StateChangeEventBuffer::PopOldestEvents(uint32_t numEventsToPop)
@@ -56,23 +119,75 @@ namespace Xidi
       // Popping 0 events is a no-op.
       if (numEventsToPop > 0)
       {
-        for (uint32_t i = 0; (i < numEventsToPop) && (false == eventBuffer.empty()); ++i)
-          eventBuffer.pop_front();
+        std::shared_lock lock(capacityMutex);
+
+        uint64_t readStateSnapshot = readState.load(std::memory_order_acquire);
+        while (true)
+        {
+          const uint64_t readIndex = ReadIndex(readStateSnapshot);
+          const uint64_t numEventsPresent = writeIndex.load(std::memory_order_acquire) - readIndex;
+          const uint64_t newReadIndex =
+              readIndex + std::min((uint64_t)numEventsToPop, numEventsPresent);
 
-        eventBufferOverflowed = false;
+          if (true ==
+              readState.compare_exchange_weak(
+                  readStateSnapshot,
+                  WithReadIndex(readStateSnapshot & ~kOverflowFlag, newReadIndex),
+                  std::memory_order_acq_rel,
+                  std::memory_order_acquire))
+            break;
+        }
       }
     }
 
-    void StateChangeEventBuffer::SetCapacity(uint32_t capacity)
+    void StateChangeEventBuffer::SetCapacity(uint32_t newCapacity)
     {
       // Setting the capacity to the same as the current capacity is a no-op.
-      if (GetCapacity() != capacity)
+      if (GetCapacity() == newCapacity) return;
+
+      newCapacity = std::min(newCapacity, kEventBufferCapacityMax);
+
+      std::unique_lock lock(capacityMutex);
+
+      // The newest events are retained. If they do not all fit, while still leaving one free
+      // space, an overflow condition is triggered. Otherwise any existing overflow condition is
+      // cleared.
+      const uint64_t numEventsPresent = writeIndex.load(std::memory_order_relaxed) -
+          ReadIndex(readState.load(std::memory_order_relaxed));
+      const uint64_t numEventsRetained =
+          ((0 == newCapacity) ? 0 : std::min(numEventsPresent, (uint64_t)(newCapacity - 1)));
+      const bool overflowed = ((0 != newCapacity) && (numEventsPresent >= newCapacity));
+
+      std::unique_ptr<SSlot[]> newSlots =
+          ((0 == newCapacity) ? nullptr : std::make_unique<SSlot[]>(newCapacity));
+
+      const uint64_t firstRetainedIndex = writeIndex.load(std::memory_order_relaxed) -
+          numEventsRetained;
+      for (uint64_t i = 0; i < numEventsRetained; ++i)
       {
-        const uint32_t newCapacity =
-            ((capacity > kEventBufferCapacityMax) ? kEventBufferCapacityMax : capacity);
-        eventBuffer.rset_capacity(newCapacity);
-        eventBufferOverflowed = HandlePossibleOverflow(eventBuffer);
+        const SSlot& oldSlot = slots[(firstRetainedIndex + i) % GetCapacity()];
+        for (size_t j = 0; j < kEventWordCount; ++j)
+          newSlots[i].eventWords[j].store(
+              oldSlot.eventWords[j].load(std::memory_order_relaxed), std::memory_order_relaxed);
       }
+
+      slots = std::move(newSlots);
+      coalescableAxisEventIndex.fill(kNoCoalescableEvent);
+      capacity.store(newCapacity, std::memory_order_relaxed);
+      readState.store(((true == overflowed) ? kOverflowFlag : 0), std::memory_order_release);
+      writeIndex.store(numEventsRetained, std::memory_order_release);
+    }
+
+    void StateChangeEventBuffer::StoreEvent(uint64_t index, const SEvent& event)
+    {
+      uint64_t eventWords[kEventWordCount] = {};
+      std::memcpy(eventWords, &event, sizeof(event));
+
+      std::atomic_thread_fence(std::memory_order_release);
+
+      SSlot& slot = slots[index % capacity.load(std::memory_order_relaxed)];
+      for (size_t i = 0; i < kEventWordCount; ++i)
+        slot.eventWords[i].store(eventWords[i], std::memory_order_relaxed);
     }
   } // namespace Controller
 } // namespace Xidi
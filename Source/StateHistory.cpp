@@ -0,0 +1,80 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file StateHistory.cpp
+ *   Implementation of a lock-free history of recent timestamped virtual controller states.
+ **************************************************************************************************/
+
+#include "StateHistory.h"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "Clock.h"
+#include "ControllerTypes.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    StateHistory::TTimestamp StateHistory::CurrentTimestamp(void)
+    {
+      return Clock::Now();
+    }
+
+    StateHistory::TTimestamp StateHistory::TimestampTicksFromMilliseconds(
+        unsigned int milliseconds)
+    {
+      return Clock::TicksFromMilliseconds(milliseconds);
+    }
+
+    void StateHistory::Append(TTimestamp timestamp, const SState& state)
+    {
+      const uint64_t index = appendCount.load(std::memory_order_relaxed);
+
+      slots[index % kCapacity].Store({.index = index, .timestamp = timestamp, .state = state});
+      appendCount.store(index + 1, std::memory_order_release);
+    }
+
+    std::optional<StateHistory::SEntry> StateHistory::GetEntry(uint64_t index) const
+    {
+      // Slots that have never been written hold default-constructed entries, so an entry that has
+      // not yet been appended cannot be identified by the index it holds.
+      if (index >= GetAppendCount()) return std::nullopt;
+
+      const SEntry entry = slots[index % kCapacity].Load();
+
+      // The slot might have been reused for a newer entry.
+      if (index != entry.index) return std::nullopt;
+
+      return entry;
+    }
+
+    std::optional<SState> StateHistory::GetStateAsOf(TTimestamp timestamp) const
+    {
+      const uint64_t count = GetAppendCount();
+      if (0 == count) return std::nullopt;
+
+      const uint64_t oldestIndex = ((count > kCapacity) ? (count - kCapacity) : 0);
+      std::optional<SState> oldestStateSeen;
+
+      // Entries are searched from newest to oldest. Usually the newest entry is the answer, unless
+      // the specified time is in the past.
+      for (uint64_t index = count; index > oldestIndex; --index)
+      {
+        const std::optional<SEntry> maybeEntry = GetEntry(index - 1);
+        if (false == maybeEntry.has_value()) break;
+
+        if (maybeEntry->timestamp <= timestamp) return maybeEntry->state;
+        oldestStateSeen = maybeEntry->state;
+      }
+
+      return oldestStateSeen;
+    }
+  } // namespace Controller
+} // namespace Xidi
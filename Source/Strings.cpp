@@ -14,9 +14,11 @@
 #include <intrin.h>
 #include <sal.h>
 
+#include <array>
 #include <cctype>
 #include <cstdlib>
 #include <cwctype>
+#include <map>
 #include <mutex>
 #include <string>
 #include <string_view>
@@ -521,27 +523,40 @@ namespace Xidi
     std::wstring_view MapperTypeConfigurationNameString(
         Controller::TControllerIdentifier controllerIdentifier)
     {
-      static std::wstring initStrings[Controller::kPhysicalControllerCount];
-      static std::once_flag initFlag;
-
-      std::call_once(
-          initFlag,
-          []() -> void
-          {
-            TemporaryString perControllerMapperTypeString;
+      return PerControllerConfigurationNameString(
+          kStrConfigurationSettingMapperType, controllerIdentifier);
+    }
 
-            for (Controller::TControllerIdentifier i = 0; i < _countof(initStrings); ++i)
-            {
-              perControllerMapperTypeString.Clear();
-              perControllerMapperTypeString << kStrConfigurationSettingMapperType
-                                            << kCharConfigurationSettingSeparator << (1 + i);
-              initStrings[i] = perControllerMapperTypeString;
-            }
-          });
+    std::wstring_view PerControllerConfigurationNameString(
+        std::wstring_view settingName, Controller::TControllerIdentifier controllerIdentifier)
+    {
+      static std::map<
+          std::wstring_view,
+          std::array<std::wstring, Controller::kPhysicalControllerCount>>
+          initStrings;
+      static std::mutex initStringsGuard;
 
       if (controllerIdentifier >= Controller::kPhysicalControllerCount) return std::wstring_view();
 
-      return initStrings[controllerIdentifier];
+      std::scoped_lock lock(initStringsGuard);
+
+      auto initStringsIter = initStrings.find(settingName);
+      if (initStrings.end() == initStringsIter)
+      {
+        std::array<std::wstring, Controller::kPhysicalControllerCount> perControllerStrings;
+        TemporaryString perControllerString;
+
+        for (Controller::TControllerIdentifier i = 0; i < perControllerStrings.size(); ++i)
+        {
+          perControllerString.Clear();
+          perControllerString << settingName << kCharConfigurationSettingSeparator << (1 + i);
+          perControllerStrings[i] = perControllerString;
+        }
+
+        initStringsIter = initStrings.emplace(settingName, std::move(perControllerStrings)).first;
+      }
+
+      return initStringsIter->second[controllerIdentifier];
     }
 
     TemporaryVector<std::wstring_view> SplitString(
@@ -18,6 +18,7 @@
 #include "ApiWindows.h"
 #include "ControllerTypes.h"
 #include "ElementMapper.h"
+#include "ResponseCurve.h"
 
 namespace XidiTest
 {
@@ -448,4 +449,99 @@ namespace XidiTest
 
     TEST_ASSERT(actualState == expectedState);
   }
+
+  // Verifies that an axis mapper with a response curve contributes analog values after reshaping
+  // them using the curve. Sweeps the entire range of possible analog values.
+  TEST_CASE(AxisMapper_ContributeFromAnalogValue_ResponseCurve)
+  {
+    constexpr EAxis kTargetAxis = EAxis::X;
+    const ResponseCurve& responseCurve = ResponseCurve::Get(
+        {.type = ResponseCurve::EType::Exponential, .parameter = 200});
+    const AxisMapper mapper(kTargetAxis, EAxisDirection::Both, &responseCurve);
+
+    for (int32_t analogValue = kAnalogValueMin; analogValue <= kAnalogValueMax; ++analogValue)
+    {
+      SState expectedState;
+      ZeroMemory(&expectedState, sizeof(expectedState));
+      expectedState[kTargetAxis] = responseCurve.ApplyToAnalog((int16_t)analogValue);
+
+      SState actualState;
+      ZeroMemory(&actualState, sizeof(actualState));
+      mapper.ContributeFromAnalogValue(actualState, (int16_t)analogValue);
+
+      TEST_ASSERT(actualState == expectedState);
+    }
+
+    // With an exponent of 2, half of the displacement in either direction should become a quarter.
+    SState actualState;
+    ZeroMemory(&actualState, sizeof(actualState));
+    mapper.ContributeFromAnalogValue(actualState, (int16_t)(kAnalogValueMax / 2));
+    TEST_ASSERT(kAnalogValueMax / 4 == actualState[kTargetAxis]);
+
+    ZeroMemory(&actualState, sizeof(actualState));
+    mapper.ContributeFromAnalogValue(actualState, (int16_t)(kAnalogValueMin / 2));
+    TEST_ASSERT(kAnalogValueMin / 4 == actualState[kTargetAxis]);
+  }
+
+  // Verifies that an axis mapper with a response curve contributes button values exactly as it
+  // would without a response curve.
+  TEST_CASE(AxisMapper_ContributeFromButtonValue_ResponseCurve)
+  {
+    constexpr EAxis kTargetAxis = EAxis::Y;
+    const ResponseCurve& responseCurve =
+        ResponseCurve::Get({.type = ResponseCurve::EType::SCurve, .parameter = 100});
+
+    for (EAxisDirection direction :
+         {EAxisDirection::Both, EAxisDirection::Positive, EAxisDirection::Negative})
+    {
+      const AxisMapper linearMapper(kTargetAxis, direction);
+      const AxisMapper curvedMapper(kTargetAxis, direction, &responseCurve);
+
+      for (bool buttonIsPressed : {false, true})
+      {
+        SState expectedState;
+        ZeroMemory(&expectedState, sizeof(expectedState));
+        linearMapper.ContributeFromButtonValue(expectedState, buttonIsPressed);
+
+        SState actualState;
+        ZeroMemory(&actualState, sizeof(actualState));
+        curvedMapper.ContributeFromButtonValue(actualState, buttonIsPressed);
+
+        TEST_ASSERT(actualState == expectedState);
+      }
+    }
+  }
+
+  // Verifies that an axis mapper with a response curve contributes trigger values after reshaping
+  // them using the curve. Sweeps the entire range of possible trigger values.
+  TEST_CASE(AxisMapper_ContributeFromTriggerValue_ResponseCurve)
+  {
+    constexpr EAxis kTargetAxis = EAxis::Z;
+    const ResponseCurve& responseCurve = ResponseCurve::Get(
+        {.type = ResponseCurve::EType::Piecewise,
+         .pointCount = 1,
+         .points = {{{.inputPercent = 50, .outputPercent = 10}}}});
+
+    for (EAxisDirection direction :
+         {EAxisDirection::Both, EAxisDirection::Positive, EAxisDirection::Negative})
+    {
+      const AxisMapper linearMapper(kTargetAxis, direction);
+      const AxisMapper curvedMapper(kTargetAxis, direction, &responseCurve);
+
+      for (int32_t triggerValue = kTriggerValueMin; triggerValue <= kTriggerValueMax;
+           ++triggerValue)
+      {
+        SState expectedState;
+        ZeroMemory(&expectedState, sizeof(expectedState));
+        linearMapper.ContributeFromTriggerValue(
+            expectedState, responseCurve.ApplyToTrigger((uint8_t)triggerValue));
+
+        SState actualState;
+        ZeroMemory(&actualState, sizeof(actualState));
+        curvedMapper.ContributeFromTriggerValue(actualState, (uint8_t)triggerValue);
+
+        TEST_ASSERT(actualState == expectedState);
+      }
+    }
+  }
 } // namespace XidiTest
@@ -0,0 +1,66 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ClockTest.cpp
+ *   Unit tests for the monotonic high-resolution clock.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "Clock.h"
+
+#include <cstdint>
+
+namespace XidiTest
+{
+  using namespace ::Xidi;
+
+  // Verifies that the clock has at least microsecond resolution and never goes backwards.
+  TEST_CASE(Clock_Monotonic)
+  {
+    constexpr unsigned int kNumSamples = 100000;
+
+    TEST_ASSERT(Clock::GetFrequency() >= 1000000ull);
+
+    Clock::TTimestamp lastTimestamp = Clock::Now();
+    for (unsigned int i = 0; i < kNumSamples; ++i)
+    {
+      const Clock::TTimestamp timestamp = Clock::Now();
+      TEST_ASSERT(timestamp >= lastTimestamp);
+      lastTimestamp = timestamp;
+    }
+  }
+
+  // Verifies that converting between clock ticks and other units is exact for whole numbers of
+  // seconds and consistent in both directions.
+  TEST_CASE(Clock_Conversions)
+  {
+    const uint64_t kFrequency = Clock::GetFrequency();
+
+    TEST_ASSERT(1000ull == Clock::TicksToMilliseconds(kFrequency));
+    TEST_ASSERT(1000000ull == Clock::TicksToMicroseconds(kFrequency));
+    TEST_ASSERT(1000000000ull == Clock::TicksToNanoseconds(kFrequency));
+    TEST_ASSERT(kFrequency == Clock::TicksFromMilliseconds(1000));
+
+    for (uint64_t milliseconds = 0; milliseconds < 5000; milliseconds += 7)
+      TEST_ASSERT(
+          milliseconds == Clock::TicksToMilliseconds(Clock::TicksFromMilliseconds(milliseconds)));
+  }
+
+  // Verifies that conversions do not overflow for tick counts that correspond to a system that has
+  // been running for a very long time.
+  TEST_CASE(Clock_ConversionsLongUptime)
+  {
+    constexpr uint64_t kUptimeSeconds = 10ull * 365ull * 24ull * 60ull * 60ull;
+    const Clock::TTimestamp kTicks = Clock::GetFrequency() * kUptimeSeconds;
+
+    TEST_ASSERT((kUptimeSeconds * 1000ull) == Clock::TicksToMilliseconds(kTicks));
+    TEST_ASSERT((kUptimeSeconds * 1000000ull) == Clock::TicksToMicroseconds(kTicks));
+    TEST_ASSERT((kUptimeSeconds * 1000000000ull) == Clock::TicksToNanoseconds(kTicks));
+    TEST_ASSERT(kTicks == Clock::TicksFromMilliseconds(kUptimeSeconds * 1000ull));
+  }
+} // namespace XidiTest
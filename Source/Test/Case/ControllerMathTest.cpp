@@ -0,0 +1,363 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ControllerMathTest.cpp
+ *   Unit tests for common mathematical operations for interpreting and transforming controller
+ *   data.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "ControllerMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+
+#include "ControllerTypes.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+
+  /// Deadzone and saturation percentage pairs used to exercise raw transformations.
+  /// These cover the identity case, the extremes of the allowed configuration ranges, and some
+  /// values in between.
+  static constexpr struct
+  {
+    unsigned int deadzonePercent;
+    unsigned int saturationPercent;
+  } kTestTransformParameters[] = {
+      {0, 100},
+      {0, 55},
+      {45, 100},
+      {45, 55},
+      {10, 90},
+      {7, 93},
+      {25, 75},
+      {1, 99},
+  };
+
+  // Transforms every possible analog value using lookup tables built for each of several
+  // different transformation parameters and verifies that the results are identical to applying
+  // the transformation directly.
+  TEST_CASE(ControllerMath_RawAnalogTransformTable_MatchesIndividual)
+  {
+    for (const auto& parameters : kTestTransformParameters)
+    {
+      const std::shared_ptr<const Math::RawAnalogTransformTable> table =
+          Math::RawAnalogTransformTable::Get(
+              parameters.deadzonePercent, parameters.saturationPercent);
+
+      for (int analogValue = (int)std::numeric_limits<int16_t>::min();
+           analogValue <= (int)std::numeric_limits<int16_t>::max();
+           ++analogValue)
+      {
+        const int16_t expectedValue = Math::ApplyRawAnalogTransform(
+            (int16_t)analogValue, parameters.deadzonePercent, parameters.saturationPercent);
+        const int16_t actualValue = table->Apply((int16_t)analogValue);
+
+        if (actualValue != expectedValue)
+          TEST_FAILED_BECAUSE(
+              L"Mismatch for input %d with deadzone %u%% and saturation %u%%: expected %d, got %d.",
+              analogValue,
+              parameters.deadzonePercent,
+              parameters.saturationPercent,
+              (int)expectedValue,
+              (int)actualValue);
+      }
+    }
+  }
+
+  // Transforms every possible trigger value using lookup tables built for each of several
+  // different transformation parameters and verifies that the results are identical to applying
+  // the transformation directly.
+  TEST_CASE(ControllerMath_RawTriggerTransformTable_MatchesIndividual)
+  {
+    for (const auto& parameters : kTestTransformParameters)
+    {
+      const std::shared_ptr<const Math::RawTriggerTransformTable> table =
+          Math::RawTriggerTransformTable::Get(
+              parameters.deadzonePercent, parameters.saturationPercent);
+
+      for (int triggerValue = (int)std::numeric_limits<uint8_t>::min();
+           triggerValue <= (int)std::numeric_limits<uint8_t>::max();
+           ++triggerValue)
+      {
+        const uint8_t expectedValue = Math::ApplyRawTriggerTransform(
+            (uint8_t)triggerValue, parameters.deadzonePercent, parameters.saturationPercent);
+        const uint8_t actualValue = table->Apply((uint8_t)triggerValue);
+
+        if (actualValue != expectedValue)
+          TEST_FAILED_BECAUSE(
+              L"Mismatch for input %d with deadzone %u%% and saturation %u%%: expected %d, got %d.",
+              triggerValue,
+              parameters.deadzonePercent,
+              parameters.saturationPercent,
+              (int)expectedValue,
+              (int)actualValue);
+      }
+    }
+  }
+
+  // Verifies that lookup tables are shared among all requests for the same transformation
+  // parameters and are distinct for different transformation parameters.
+  TEST_CASE(ControllerMath_RawTransformTable_Sharing)
+  {
+    TEST_ASSERT(
+        Math::RawAnalogTransformTable::Get(10, 90) == Math::RawAnalogTransformTable::Get(10, 90));
+    TEST_ASSERT(
+        Math::RawAnalogTransformTable::Get(10, 90) != Math::RawAnalogTransformTable::Get(10, 80));
+    TEST_ASSERT(
+        Math::RawTriggerTransformTable::Get(10, 90) == Math::RawTriggerTransformTable::Get(10, 90));
+    TEST_ASSERT(
+        Math::RawTriggerTransformTable::Get(10, 90) != Math::RawTriggerTransformTable::Get(20, 90));
+  }
+
+  // Verifies that lookup tables are destroyed once they are no longer in use, rather than being
+  // kept for the lifetime of the process.
+  TEST_CASE(ControllerMath_RawTransformTable_Release)
+  {
+    const std::weak_ptr<const Math::RawAnalogTransformTable> analogTable =
+        Math::RawAnalogTransformTable::Get(13, 87);
+    TEST_ASSERT(true == analogTable.expired());
+
+    const std::weak_ptr<const Math::RawTriggerTransformTable> triggerTable =
+        Math::RawTriggerTransformTable::Get(13, 87);
+    TEST_ASSERT(true == triggerTable.expired());
+  }
+
+  /// Computes the expected result of a radial stick transformation for one axis using
+  /// floating-point math, which serves as the reference for the integer implementation.
+  /// @param [in] analogValueX Horizontal axis input value.
+  /// @param [in] analogValueY Vertical axis input value.
+  /// @param [in] analogValue Input value of the axis whose output is desired.
+  /// @param [in] deadzonePercent Deadzone percentage.
+  /// @param [in] saturationPercent Saturation percentage.
+  /// @param [in] antiDeadzonePercent Anti-deadzone percentage.
+  /// @param [in] circleToSquare Whether or not circle-to-square mapping is enabled.
+  /// @return Expected output value of the axis, prior to rounding.
+  static double RadialStickTransformReference(
+      int16_t analogValueX,
+      int16_t analogValueY,
+      int16_t analogValue,
+      unsigned int deadzonePercent,
+      unsigned int saturationPercent,
+      unsigned int antiDeadzonePercent,
+      bool circleToSquare)
+  {
+    constexpr double kMagnitudeMax = (double)(kAnalogValueMax - kAnalogValueNeutral);
+
+    const double deadzoneCutoff = (double)(((int)kMagnitudeMax * (int)deadzonePercent) / 100);
+    const double saturationCutoff = (double)(((int)kMagnitudeMax * (int)saturationPercent) / 100);
+    const double antiDeadzoneMagnitude =
+        (double)(((int)kMagnitudeMax * (int)antiDeadzonePercent) / 100);
+
+    const double magnitude = std::hypot((double)analogValueX, (double)analogValueY);
+    if (magnitude <= deadzoneCutoff) return (double)kAnalogValueNeutral;
+
+    const double transformedMagnitude = ((magnitude >= saturationCutoff)
+            ? kMagnitudeMax
+            : antiDeadzoneMagnitude +
+                ((magnitude - deadzoneCutoff) * (kMagnitudeMax - antiDeadzoneMagnitude) /
+                 (saturationCutoff - deadzoneCutoff)));
+    const double referenceMagnitude = ((true == circleToSquare)
+            ? (double)std::max(std::abs((int)analogValueX), std::abs((int)analogValueY))
+            : magnitude);
+
+    return std::clamp(
+        (double)analogValue * transformedMagnitude / referenceMagnitude,
+        -kMagnitudeMax,
+        kMagnitudeMax);
+  }
+
+  // Verifies that integer square roots are exact, both for perfect squares and for the values
+  // immediately preceding them, across the entire range of possible results.
+  TEST_CASE(ControllerMath_IntegerSquareRoot)
+  {
+    TEST_ASSERT(0 == Math::IntegerSquareRoot(0));
+    TEST_ASSERT(65535 == Math::IntegerSquareRoot(std::numeric_limits<uint32_t>::max()));
+    TEST_ASSERT(
+        std::numeric_limits<uint32_t>::max() ==
+        Math::IntegerSquareRoot(std::numeric_limits<uint64_t>::max()));
+
+    for (uint64_t root = 1; root <= 65535; ++root)
+    {
+      TEST_ASSERT(root == Math::IntegerSquareRoot(root * root));
+      TEST_ASSERT((root - 1) == Math::IntegerSquareRoot((root * root) - 1));
+    }
+
+    for (uint64_t root = 65536; root <= std::numeric_limits<uint32_t>::max(); root += 65521)
+    {
+      TEST_ASSERT(root == Math::IntegerSquareRoot(root * root));
+      TEST_ASSERT((root - 1) == Math::IntegerSquareRoot((root * root) - 1));
+    }
+  }
+
+  // Verifies that a default-constructed radial transformation leaves unchanged every vector whose
+  // magnitude does not exceed the analog range.
+  TEST_CASE(ControllerMath_RadialStickTransform_Identity)
+  {
+    const Math::RadialStickTransform transform;
+
+    for (int analogValueX = kAnalogValueMin; analogValueX <= kAnalogValueMax; analogValueX += 97)
+    {
+      for (int analogValueY = kAnalogValueMin; analogValueY <= kAnalogValueMax;
+           analogValueY += 89)
+      {
+        if (((analogValueX * analogValueX) + (analogValueY * analogValueY)) >=
+            (kAnalogValueMax * kAnalogValueMax))
+          continue;
+
+        int16_t actualValueX = (int16_t)analogValueX;
+        int16_t actualValueY = (int16_t)analogValueY;
+        transform.Apply(actualValueX, actualValueY);
+
+        TEST_ASSERT(actualValueX == (int16_t)analogValueX);
+        TEST_ASSERT(actualValueY == (int16_t)analogValueY);
+      }
+    }
+  }
+
+  // Transforms a grid of vectors covering the entire analog range with several different
+  // transformation parameters and verifies that the integer implementation agrees with a
+  // floating-point reference to within a small tolerance for fixed-point rounding.
+  TEST_CASE(ControllerMath_RadialStickTransform_MatchesReference)
+  {
+    constexpr unsigned int kTestAntiDeadzonePercent[] = {0, 10, 50};
+    constexpr double kTolerance = 2.0;
+
+    for (const auto& transformParameters : kTestTransformParameters)
+    {
+      for (const auto antiDeadzonePercent : kTestAntiDeadzonePercent)
+      {
+        for (const bool circleToSquare : {false, true})
+        {
+          const Math::RadialStickTransform transform(
+              transformParameters.deadzonePercent,
+              transformParameters.saturationPercent,
+              antiDeadzonePercent,
+              circleToSquare);
+
+          for (int analogValueX = kAnalogValueMin; analogValueX <= kAnalogValueMax;
+               analogValueX += 251)
+          {
+            for (int analogValueY = kAnalogValueMin; analogValueY <= kAnalogValueMax;
+                 analogValueY += 241)
+            {
+              int16_t actualValueX = (int16_t)analogValueX;
+              int16_t actualValueY = (int16_t)analogValueY;
+              transform.Apply(actualValueX, actualValueY);
+
+              const double expectedValueX = RadialStickTransformReference(
+                  (int16_t)analogValueX,
+                  (int16_t)analogValueY,
+                  (int16_t)analogValueX,
+                  transformParameters.deadzonePercent,
+                  transformParameters.saturationPercent,
+                  antiDeadzonePercent,
+                  circleToSquare);
+              const double expectedValueY = RadialStickTransformReference(
+                  (int16_t)analogValueX,
+                  (int16_t)analogValueY,
+                  (int16_t)analogValueY,
+                  transformParameters.deadzonePercent,
+                  transformParameters.saturationPercent,
+                  antiDeadzonePercent,
+                  circleToSquare);
+
+              TEST_ASSERT(std::abs((double)actualValueX - expectedValueX) <= kTolerance);
+              TEST_ASSERT(std::abs((double)actualValueY - expectedValueY) <= kTolerance);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Verifies that the radial deadzone is circular and does not snap readings onto the axes, unlike
+  // the per-axis deadzone.
+  TEST_CASE(ControllerMath_RadialStickTransform_Deadzone)
+  {
+    const Math::RadialStickTransform transform(20, 100, 0, false);
+
+    // Magnitude is about 6325, which is within the deadzone cutoff of 6553.
+    int16_t analogValueX = 6000;
+    int16_t analogValueY = -2000;
+    transform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(kAnalogValueNeutral == analogValueX);
+    TEST_ASSERT(kAnalogValueNeutral == analogValueY);
+
+    // Each axis is within the deadzone cutoff on its own, but the magnitude of about 7071 is not.
+    analogValueX = 5000;
+    analogValueY = -5000;
+    transform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(analogValueX > kAnalogValueNeutral);
+    TEST_ASSERT(analogValueY < kAnalogValueNeutral);
+    TEST_ASSERT(analogValueX == -analogValueY);
+
+    // Vertical axis is within the deadzone cutoff on its own but still contributes direction.
+    analogValueX = 20000;
+    analogValueY = 1000;
+    transform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(analogValueY > kAnalogValueNeutral);
+    TEST_ASSERT(kAnalogValueNeutral == Math::ApplyRawAnalogTransform(1000, 20, 100));
+  }
+
+  // Verifies that anti-deadzone causes the stick to jump to the configured magnitude as soon as
+  // it leaves the deadzone.
+  TEST_CASE(ControllerMath_RadialStickTransform_AntiDeadzone)
+  {
+    const Math::RadialStickTransform transform(10, 100, 25, false);
+
+    int16_t analogValueX = 0;
+    int16_t analogValueY = 3277;
+    transform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(kAnalogValueNeutral == analogValueX);
+    TEST_ASSERT(std::abs(analogValueY - 8191) <= 2);
+
+    analogValueX = kAnalogValueMax;
+    analogValueY = 0;
+    transform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(kAnalogValueMax == analogValueX);
+    TEST_ASSERT(kAnalogValueNeutral == analogValueY);
+  }
+
+  // Verifies that circle-to-square mapping pushes full diagonal readings out to the corners of the
+  // square range while leaving readings along the axes unchanged, and that without it the same
+  // readings remain on the circle.
+  TEST_CASE(ControllerMath_RadialStickTransform_CircleToSquare)
+  {
+    const Math::RadialStickTransform circleTransform(0, 100, 0, false);
+    const Math::RadialStickTransform squareTransform(0, 100, 0, true);
+
+    int16_t analogValueX = 23170;
+    int16_t analogValueY = -23170;
+    circleTransform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(23170 == analogValueX);
+    TEST_ASSERT(-23170 == analogValueY);
+
+    squareTransform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(kAnalogValueMax - analogValueX <= 1);
+    TEST_ASSERT(kAnalogValueMin - analogValueY >= -1);
+
+    analogValueX = kAnalogValueMin;
+    analogValueY = 0;
+    squareTransform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(kAnalogValueMin == analogValueX);
+    TEST_ASSERT(kAnalogValueNeutral == analogValueY);
+
+    analogValueX = 12345;
+    analogValueY = 0;
+    squareTransform.Apply(analogValueX, analogValueY);
+    TEST_ASSERT(12345 == analogValueX);
+    TEST_ASSERT(kAnalogValueNeutral == analogValueY);
+  }
+} // namespace XidiTest
@@ -0,0 +1,138 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ElementMapperArenaTest.cpp
+ *   Unit tests for arena allocation of element mapper objects.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "ElementMapperArena.h"
+
+#include <memory>
+
+#include "ControllerTypes.h"
+#include "ElementMapper.h"
+#include "Mapper.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+
+  // Verifies that element mappers created while no arena is in use come from the heap, and that
+  // element mappers created while an arena is in use come from that arena.
+  TEST_CASE(ElementMapperArena_ScopedUse_Nominal)
+  {
+    ElementMapperArena arena;
+
+    const std::unique_ptr<IElementMapper> heapElementMapper =
+        std::make_unique<ButtonMapper>(EButton::B1);
+    TEST_ASSERT(false == arena.Contains(heapElementMapper.get()));
+    TEST_ASSERT(0 == arena.GetAllocationCount());
+
+    std::unique_ptr<IElementMapper> arenaElementMapper;
+    do
+    {
+      ElementMapperArena::ScopedUse arenaScope(arena);
+      arenaElementMapper = heapElementMapper->Clone();
+    } while (false);
+
+    TEST_ASSERT(true == arena.Contains(arenaElementMapper.get()));
+    TEST_ASSERT(1 == arena.GetAllocationCount());
+
+    const std::unique_ptr<IElementMapper> clonedElementMapper = arenaElementMapper->Clone();
+    TEST_ASSERT(false == arena.Contains(clonedElementMapper.get()));
+    TEST_ASSERT(1 == arena.GetAllocationCount());
+  }
+
+  // Verifies that nested arena scopes direct allocations to the innermost arena and restore the
+  // outer arena when they end.
+  TEST_CASE(ElementMapperArena_ScopedUse_Nested)
+  {
+    ElementMapperArena outerArena;
+    ElementMapperArena innerArena;
+
+    std::unique_ptr<IElementMapper> elementMappers[3];
+    do
+    {
+      ElementMapperArena::ScopedUse outerArenaScope(outerArena);
+      elementMappers[0] = std::make_unique<ButtonMapper>(EButton::B1);
+
+      do
+      {
+        ElementMapperArena::ScopedUse innerArenaScope(innerArena);
+        elementMappers[1] = std::make_unique<ButtonMapper>(EButton::B2);
+      } while (false);
+
+      elementMappers[2] = std::make_unique<ButtonMapper>(EButton::B3);
+    } while (false);
+
+    TEST_ASSERT(true == outerArena.Contains(elementMappers[0].get()));
+    TEST_ASSERT(true == innerArena.Contains(elementMappers[1].get()));
+    TEST_ASSERT(true == outerArena.Contains(elementMappers[2].get()));
+    TEST_ASSERT(2 == outerArena.GetAllocationCount());
+    TEST_ASSERT(1 == innerArena.GetAllocationCount());
+  }
+
+  // Verifies that cloning an element mapper tree into an arena lays it out contiguously in a
+  // single block, with each parent before its children.
+  TEST_CASE(ElementMapperArena_Clone_TraversalOrder)
+  {
+    CompoundMapper::TElementMappers underlyingElementMappers = {
+        std::make_unique<ButtonMapper>(EButton::B1),
+        std::make_unique<InvertMapper>(std::make_unique<ButtonMapper>(EButton::B2)),
+        std::make_unique<ButtonMapper>(EButton::B3)};
+    const CompoundMapper heapElementMapper(std::move(underlyingElementMappers));
+
+    ElementMapperArena arena;
+    std::unique_ptr<IElementMapper> arenaElementMapper;
+    do
+    {
+      ElementMapperArena::ScopedUse arenaScope(arena);
+      arenaElementMapper = heapElementMapper.Clone();
+    } while (false);
+
+    TEST_ASSERT(5 == arena.GetAllocationCount());
+    TEST_ASSERT(1 == arena.GetBlockCount());
+
+    const CompoundMapper& arenaCompoundMapper =
+        static_cast<const CompoundMapper&>(*arenaElementMapper);
+    const void* previousAddress = &arenaCompoundMapper;
+
+    for (int i = 0; i < 3; ++i)
+    {
+      const void* const underlyingAddress = arenaCompoundMapper.GetElementMappers()[i].get();
+      TEST_ASSERT(true == arena.Contains(underlyingAddress));
+      TEST_ASSERT(underlyingAddress > previousAddress);
+      previousAddress = underlyingAddress;
+    }
+  }
+
+  // Verifies that a mapper holds all of its element mappers in its own arena, and that copies of
+  // its element map are allocated from the heap instead.
+  TEST_CASE(ElementMapperArena_Mapper_ElementsInArena)
+  {
+    const Mapper mapper(
+        {.stickLeftX = std::make_unique<AxisMapper>(EAxis::X),
+         .dpadUp = std::make_unique<InvertMapper>(std::make_unique<AxisMapper>(EAxis::Y)),
+         .buttonA = std::make_unique<ButtonMapper>(EButton::B1)});
+
+    const ElementMapperArena& arena = mapper.GetElementMapperArena();
+    TEST_ASSERT(4 == arena.GetAllocationCount());
+    TEST_ASSERT(1 == arena.GetBlockCount());
+
+    const Mapper::UElementMap clonedElements = mapper.CloneElementMap();
+
+    for (int i = 0; i < _countof(Mapper::UElementMap::all); ++i)
+    {
+      if (nullptr == mapper.ElementMap().all[i]) continue;
+
+      TEST_ASSERT(true == arena.Contains(mapper.ElementMap().all[i].get()));
+      TEST_ASSERT(false == arena.Contains(clonedElements.all[i].get()));
+    }
+  }
+} // namespace XidiTest
@@ -0,0 +1,252 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ElementProgramTest.cpp
+ *   Unit tests for the compiled form of element mappers.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "ElementProgram.h"
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "ControllerTypes.h"
+#include "ElementMapper.h"
+#include "Mapper.h"
+#include "MockElementMapper.h"
+#include "ResponseCurve.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+
+  /// Opaque source identifier used for tests in this file.
+  static constexpr uint32_t kOpaqueSourceIdentifier = 55;
+
+  /// Verifies that the compiled form of an element mapper tree contributes exactly the same virtual
+  /// controller state as the tree itself for every possible analog, button, and trigger value.
+  /// Only works for element mappers without side effects.
+  /// @param [in] elementMapper Element mapper tree to check.
+  static void VerifyProgramMatchesTree(const IElementMapper& elementMapper)
+  {
+    ElementProgram program;
+    program.AppendElement(&elementMapper);
+
+    for (int32_t analogValue = INT16_MIN; analogValue <= INT16_MAX; ++analogValue)
+    {
+      SState expectedState = {};
+      elementMapper.ContributeFromAnalogValue(
+          expectedState, (int16_t)analogValue, kOpaqueSourceIdentifier);
+
+      SState actualState = {};
+      program.ContributeFromAnalogValue(
+          0, actualState, (int16_t)analogValue, kOpaqueSourceIdentifier);
+
+      TEST_ASSERT(actualState == expectedState);
+    }
+
+    for (int32_t triggerValue = 0; triggerValue <= UINT8_MAX; ++triggerValue)
+    {
+      SState expectedState = {};
+      elementMapper.ContributeFromTriggerValue(
+          expectedState, (uint8_t)triggerValue, kOpaqueSourceIdentifier);
+
+      SState actualState = {};
+      program.ContributeFromTriggerValue(
+          0, actualState, (uint8_t)triggerValue, kOpaqueSourceIdentifier);
+
+      TEST_ASSERT(actualState == expectedState);
+    }
+
+    for (bool buttonPressed : {false, true})
+    {
+      SState expectedState = {};
+      elementMapper.ContributeFromButtonValue(
+          expectedState, buttonPressed, kOpaqueSourceIdentifier);
+
+      SState actualState = {};
+      program.ContributeFromButtonValue(0, actualState, buttonPressed, kOpaqueSourceIdentifier);
+
+      TEST_ASSERT(actualState == expectedState);
+    }
+  }
+
+  // Verifies that unused elements compile to nothing and that elements are numbered in the order
+  // in which they are appended.
+  TEST_CASE(ElementProgram_EmptyElements)
+  {
+    const AxisMapper axisMapper(EAxis::X);
+
+    ElementProgram program;
+    program.AppendElement(nullptr);
+    program.AppendElement(&axisMapper);
+    program.AppendElement(nullptr);
+
+    TEST_ASSERT(3 == program.GetElementCount());
+    TEST_ASSERT(0 == program.GetOperationCount(0));
+    TEST_ASSERT(1 == program.GetOperationCount(1));
+    TEST_ASSERT(0 == program.GetOperationCount(2));
+
+    SState actualState = {};
+    program.ContributeFromAnalogValue(0, actualState, kAnalogValueMax, kOpaqueSourceIdentifier);
+    program.ContributeFromAnalogValue(2, actualState, kAnalogValueMax, kOpaqueSourceIdentifier);
+    TEST_ASSERT(SState() == actualState);
+
+    program.ContributeFromAnalogValue(1, actualState, kAnalogValueMax, kOpaqueSourceIdentifier);
+    TEST_ASSERT(kAnalogValueMax == actualState[EAxis::X]);
+  }
+
+  // Verifies that compound and invert mappers do not themselves produce any operations and that
+  // split mappers produce one operation for the split itself and one for skipping the negative
+  // branch.
+  TEST_CASE(ElementProgram_Flattening)
+  {
+    const CompoundMapper compoundMapper(
+        {std::make_unique<AxisMapper>(EAxis::X),
+         std::make_unique<InvertMapper>(std::make_unique<ButtonMapper>(EButton::B1)),
+         std::make_unique<PovMapper>(EPovDirection::Up)});
+
+    const SplitMapper splitMapper(
+        std::make_unique<AxisMapper>(EAxis::Y, EAxisDirection::Positive),
+        std::make_unique<InvertMapper>(std::make_unique<DigitalAxisMapper>(EAxis::Y)));
+
+    ElementProgram program;
+    program.AppendElement(&compoundMapper);
+    program.AppendElement(&splitMapper);
+
+    TEST_ASSERT(3 == program.GetOperationCount(0));
+    TEST_ASSERT(4 == program.GetOperationCount(1));
+  }
+
+  // Verifies that the compiled forms of all element mappers in all built-in mappers behave
+  // identically to the element mappers themselves.
+  TEST_CASE(ElementProgram_MatchesTree_BuiltinMappers)
+  {
+    constexpr std::wstring_view kMapperNames[] = {
+        L"StandardGamepad",
+        L"DigitalGamepad",
+        L"ExtendedGamepad",
+        L"XInputNative",
+        L"XInputSharedTriggers"};
+
+    for (const auto& mapperName : kMapperNames)
+    {
+      const Mapper* const mapper = Mapper::GetByName(mapperName);
+      TEST_ASSERT(nullptr != mapper);
+
+      for (const auto& elementMapper : mapper->ElementMap().all)
+      {
+        if (nullptr != elementMapper) VerifyProgramMatchesTree(*elementMapper);
+      }
+    }
+  }
+
+  // Verifies that the compiled forms of deeply-nested combinations of split, invert, and compound
+  // mappers behave identically to the element mappers themselves.
+  TEST_CASE(ElementProgram_MatchesTree_NestedSplitAndInvert)
+  {
+    const std::unique_ptr<const IElementMapper> kTestElementMappers[] = {
+        std::make_unique<InvertMapper>(std::make_unique<AxisMapper>(EAxis::X)),
+        std::make_unique<InvertMapper>(
+            std::make_unique<InvertMapper>(std::make_unique<AxisMapper>(EAxis::X))),
+        std::make_unique<SplitMapper>(
+            std::make_unique<ButtonMapper>(EButton::B1),
+            std::make_unique<InvertMapper>(std::make_unique<ButtonMapper>(EButton::B2))),
+        std::make_unique<InvertMapper>(std::make_unique<SplitMapper>(
+            std::make_unique<InvertMapper>(
+                std::make_unique<AxisMapper>(EAxis::X, EAxisDirection::Positive)),
+            std::make_unique<AxisMapper>(EAxis::Y, EAxisDirection::Negative))),
+        std::make_unique<CompoundMapper>(CompoundMapper::TElementMappers{
+            std::make_unique<SplitMapper>(
+                std::make_unique<PovMapper>(EPovDirection::Up),
+                std::make_unique<PovMapper>(EPovDirection::Down)),
+            std::make_unique<InvertMapper>(std::make_unique<SplitMapper>(
+                nullptr,
+                std::make_unique<SplitMapper>(
+                    std::make_unique<DigitalAxisMapper>(EAxis::Z),
+                    std::make_unique<InvertMapper>(
+                        std::make_unique<AxisMapper>(EAxis::RotZ))))),
+            std::make_unique<InvertMapper>(std::make_unique<DigitalAxisMapper>(EAxis::RotX)),
+            std::make_unique<AxisMapper>(EAxis::RotY)}),
+    };
+
+    for (const auto& elementMapper : kTestElementMappers)
+      VerifyProgramMatchesTree(*elementMapper);
+  }
+
+  // Verifies that axis mappers with response curves compile to a single operation and that their
+  // compiled forms, including when nested inside inversions and splits, behave identically to the
+  // element mappers themselves.
+  TEST_CASE(ElementProgram_MatchesTree_ResponseCurve)
+  {
+    const ResponseCurve& responseCurve = ResponseCurve::Get(
+        {.type = ResponseCurve::EType::Piecewise,
+         .pointCount = 2,
+         .points = {
+             {{.inputPercent = 20, .outputPercent = 5},
+              {.inputPercent = 80, .outputPercent = 40}}}});
+
+    const AxisMapper curvedAxisMapper(EAxis::X, EAxisDirection::Both, &responseCurve);
+
+    ElementProgram program;
+    program.AppendElement(&curvedAxisMapper);
+    TEST_ASSERT(1 == program.GetOperationCount(0));
+
+    const std::unique_ptr<const IElementMapper> kTestElementMappers[] = {
+        std::make_unique<AxisMapper>(EAxis::X, EAxisDirection::Both, &responseCurve),
+        std::make_unique<AxisMapper>(EAxis::Y, EAxisDirection::Negative, &responseCurve),
+        std::make_unique<InvertMapper>(
+            std::make_unique<AxisMapper>(EAxis::Z, EAxisDirection::Positive, &responseCurve)),
+        std::make_unique<SplitMapper>(
+            std::make_unique<AxisMapper>(EAxis::RotX, EAxisDirection::Positive, &responseCurve),
+            std::make_unique<InvertMapper>(
+                std::make_unique<AxisMapper>(EAxis::RotX, EAxisDirection::Both, &responseCurve))),
+    };
+
+    for (const auto& elementMapper : kTestElementMappers)
+      VerifyProgramMatchesTree(*elementMapper);
+  }
+
+  // Verifies that element mappers the compiler does not recognize are invoked through their
+  // interface with the correctly inverted value and source identifier, and that the unselected
+  // branch of a split mapper receives a neutral contribution.
+  TEST_CASE(ElementProgram_SideEffect)
+  {
+    constexpr int16_t kTestValue = -1000;
+
+    int numPositiveContributions = 0;
+    int numNeutralContributions = 0;
+
+    const InvertMapper invertMapper(std::make_unique<SplitMapper>(
+        std::make_unique<MockElementMapper>(
+            MockElementMapper::EExpectedSource::Analog,
+            (int16_t)-kTestValue,
+            &numPositiveContributions,
+            std::vector<SElementIdentifier>{SElementIdentifier()},
+            kOpaqueSourceIdentifier),
+        std::make_unique<MockElementMapper>(
+            MockElementMapper::EExpectedSource::Neutral,
+            false,
+            &numNeutralContributions,
+            std::vector<SElementIdentifier>{SElementIdentifier()},
+            kOpaqueSourceIdentifier)));
+
+    ElementProgram program;
+    program.AppendElement(&invertMapper);
+
+    SState unusedControllerState = {};
+    program.ContributeFromAnalogValue(
+        0, unusedControllerState, kTestValue, kOpaqueSourceIdentifier);
+
+    TEST_ASSERT(1 == numPositiveContributions);
+    TEST_ASSERT(1 == numNeutralContributions);
+  }
+} // namespace XidiTest
@@ -0,0 +1,89 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file LatencyTraceTest.cpp
+ *   Unit tests for input latency tracing data structures.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "LatencyTrace.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace XidiTest
+{
+  using ::Xidi::LatencyTrace::Histogram;
+
+  // Verifies that bucket indices increase monotonically with value, that each value lies within
+  // its bucket, and that the relative width of each bucket above the linear range is bounded.
+  TEST_CASE(LatencyTrace_Histogram_BucketBoundaries)
+  {
+    unsigned int previousBucketIndex = 0;
+
+    for (uint64_t value = 0; value < (1ull << 20); ++value)
+    {
+      const unsigned int bucketIndex = Histogram::BucketIndexForValue(value);
+      const uint64_t lowerBound = Histogram::LowerBoundForBucketIndex(bucketIndex);
+
+      TEST_ASSERT(bucketIndex >= previousBucketIndex);
+      TEST_ASSERT(bucketIndex < Histogram::kNumBuckets);
+      TEST_ASSERT(lowerBound <= value);
+      TEST_ASSERT(
+          (value - lowerBound) * Histogram::kNumSubBucketsPerPowerOfTwo <=
+          ((value < Histogram::kNumLinearBuckets) ? 0 : value));
+
+      previousBucketIndex = bucketIndex;
+    }
+
+    for (unsigned int bucketIndex = 0; bucketIndex < Histogram::kNumBuckets; ++bucketIndex)
+      TEST_ASSERT(
+          bucketIndex ==
+          Histogram::BucketIndexForValue(Histogram::LowerBoundForBucketIndex(bucketIndex)));
+  }
+
+  // Verifies that values too large to be tracked precisely are clamped into the last bucket.
+  TEST_CASE(LatencyTrace_Histogram_Clamp)
+  {
+    TEST_ASSERT((Histogram::kNumBuckets - 1) == Histogram::BucketIndexForValue(UINT64_MAX));
+    TEST_ASSERT(
+        (Histogram::kNumBuckets - 1) ==
+        Histogram::BucketIndexForValue(1ull << (Histogram::kMaxTrackedExponent + 1)));
+  }
+
+  // Verifies that an empty histogram reports zero for all percentiles.
+  TEST_CASE(LatencyTrace_Histogram_Empty)
+  {
+    const auto histogram = std::make_unique<Histogram>();
+
+    TEST_ASSERT(0 == histogram->GetCount());
+    TEST_ASSERT(0 == histogram->GetPercentile(50.0));
+    TEST_ASSERT(0 == histogram->GetPercentile(99.0));
+  }
+
+  // Verifies percentile computation using values that are each exactly representable by a bucket
+  // lower bound, so that the expected results are exact.
+  TEST_CASE(LatencyTrace_Histogram_Percentiles)
+  {
+    const auto histogram = std::make_unique<Histogram>();
+
+    // 100 samples: values 1 to 98 once each, then 4096 twice.
+    for (uint64_t value = 1; value <= 98; ++value)
+      histogram->Record(value);
+    histogram->Record(4096);
+    histogram->Record(4096);
+
+    TEST_ASSERT(100 == histogram->GetCount());
+    TEST_ASSERT(1 == histogram->GetPercentile(0.0));
+    TEST_ASSERT(
+        Histogram::LowerBoundForBucketIndex(Histogram::BucketIndexForValue(50)) ==
+        histogram->GetPercentile(50.0));
+    TEST_ASSERT(4096 == histogram->GetPercentile(99.0));
+    TEST_ASSERT(4096 == histogram->GetPercentile(100.0));
+  }
+} // namespace XidiTest
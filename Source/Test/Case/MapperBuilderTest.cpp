@@ -814,4 +814,180 @@ namespace XidiTest
         mapper->GetForceFeedbackActuatorMap();
     VerifyForceFeedbackActuatorMapsAreEquivalent(actualActuatorMap, expectedActuatorMap);
   }
+
+  // Verifies that a detached builder does not register the mapper it builds but instead holds it
+  // and makes it available by name.
+  TEST_CASE(MapperBuilder_Detached_Build_Nominal)
+  {
+    constexpr std::wstring_view kMapperName = L"DetachedTestMapper";
+    constexpr ButtonMapper kTestElementMapper(EButton::B15);
+    const std::set<int> kControllerElements = {ELEMENT_MAP_INDEX_OF(buttonA)};
+
+    MapperBuilder builder(true);
+    TEST_ASSERT(true == builder.IsDetached());
+    TEST_ASSERT(true == builder.CreateBlueprint(kMapperName));
+    TEST_ASSERT(
+        true ==
+        builder.SetBlueprintElementMapper(
+            kMapperName, ELEMENT_MAP_INDEX_OF(buttonA), kTestElementMapper.Clone()));
+
+    const Mapper* const mapper = builder.Build(kMapperName);
+    TEST_ASSERT(nullptr != mapper);
+    TEST_ASSERT(kMapperName == mapper->GetName());
+    TEST_ASSERT(false == Mapper::IsMapperNameKnown(kMapperName));
+    TEST_ASSERT(builder.GetMapper(kMapperName) == mapper);
+    TEST_ASSERT(1 == builder.GetDetachedMappers().size());
+    TEST_ASSERT(builder.GetDetachedMappers().at(kMapperName).get() == mapper);
+    VerifyElementMapMatchesSpec(kControllerElements, kTestElementMapper, mapper->ElementMap());
+  }
+
+  // Verifies that a detached builder can build a new version of a custom mapper that was built
+  // and registered previously, that it does not see the registered version either by name or as a
+  // template, and that the registered version is unaffected.
+  TEST_CASE(MapperBuilder_Detached_Build_ReplacesCustomMapper)
+  {
+    constexpr std::wstring_view kMapperName = L"DetachedReplacementTestMapper";
+    constexpr std::wstring_view kOtherMapperName = L"DetachedReplacementOtherTestMapper";
+    constexpr ButtonMapper kOriginalElementMapper(EButton::B1);
+    constexpr ButtonMapper kReplacementElementMapper(EButton::B2);
+    const std::set<int> kControllerElements = {ELEMENT_MAP_INDEX_OF(buttonX)};
+
+    MapperBuilder registeringBuilder;
+    TEST_ASSERT(true == registeringBuilder.CreateBlueprint(kMapperName));
+    TEST_ASSERT(
+        true ==
+        registeringBuilder.SetBlueprintElementMapper(
+            kMapperName, ELEMENT_MAP_INDEX_OF(buttonX), kOriginalElementMapper.Clone()));
+    std::unique_ptr<const Mapper> registeredMapper(registeringBuilder.Build(kMapperName));
+    TEST_ASSERT(nullptr != registeredMapper);
+
+    MapperBuilder detachedBuilder(true);
+    TEST_ASSERT(nullptr == detachedBuilder.GetMapper(kMapperName));
+    TEST_ASSERT(true == detachedBuilder.CreateBlueprint(kOtherMapperName));
+    TEST_ASSERT(true == detachedBuilder.SetBlueprintTemplate(kOtherMapperName, kMapperName));
+    TEST_ASSERT(nullptr == detachedBuilder.Build(kOtherMapperName));
+
+    TEST_ASSERT(true == detachedBuilder.CreateBlueprint(kMapperName));
+    TEST_ASSERT(
+        true ==
+        detachedBuilder.SetBlueprintElementMapper(
+            kMapperName, ELEMENT_MAP_INDEX_OF(buttonX), kReplacementElementMapper.Clone()));
+
+    const Mapper* const detachedMapper = detachedBuilder.Build(kMapperName);
+    TEST_ASSERT(nullptr != detachedMapper);
+    TEST_ASSERT(detachedMapper != registeredMapper.get());
+    TEST_ASSERT(Mapper::GetByName(kMapperName) == registeredMapper.get());
+    VerifyElementMapMatchesSpec(
+        kControllerElements, kReplacementElementMapper, detachedMapper->ElementMap());
+    VerifyElementMapMatchesSpec(
+        kControllerElements, kOriginalElementMapper, registeredMapper->ElementMap());
+  }
+
+  // Verifies that a detached builder still sees built-in mappers, so it can use them as templates
+  // but cannot create blueprints that reuse their names.
+  TEST_CASE(MapperBuilder_Detached_BuiltInMapper)
+  {
+    constexpr std::wstring_view kMapperName = L"DetachedTemplateTestMapper";
+    constexpr std::wstring_view kTemplateMapperName = L"StandardGamepad";
+
+    MapperBuilder builder(true);
+    TEST_ASSERT(Mapper::GetByName(kTemplateMapperName) == builder.GetMapper(kTemplateMapperName));
+    TEST_ASSERT(false == builder.CreateBlueprint(kTemplateMapperName));
+
+    TEST_ASSERT(true == builder.CreateBlueprint(kMapperName));
+    TEST_ASSERT(true == builder.SetBlueprintTemplate(kMapperName, kTemplateMapperName));
+
+    const Mapper* const mapper = builder.Build(kMapperName);
+    TEST_ASSERT(nullptr != mapper);
+    VerifyElementMapsAreEquivalent(
+        mapper->ElementMap(), Mapper::GetByName(kTemplateMapperName)->ElementMap());
+  }
+
+  // Verifies that blueprints held by the deferred builder are known but not built until they are
+  // requested by name, that requesting a mapper also builds its template, and that templates are
+  // built only once no matter how many mappers depend on them.
+  TEST_CASE(MapperBuilder_Deferred_BuildOnFirstRequest)
+  {
+    constexpr std::wstring_view kTemplateMapperName = L"DeferredTemplateTestMapper";
+    constexpr std::wstring_view kMapperNames[] = {
+        L"DeferredTestMapperA", L"DeferredTestMapperB", L"DeferredTestMapperC"};
+    constexpr ButtonMapper kTestElementMapper(EButton::B7);
+    const std::set<int> kControllerElements = {ELEMENT_MAP_INDEX_OF(buttonY)};
+
+    MapperBuilder builder;
+    TEST_ASSERT(true == builder.CreateBlueprint(kTemplateMapperName));
+    TEST_ASSERT(
+        true ==
+        builder.SetBlueprintElementMapper(
+            kTemplateMapperName, ELEMENT_MAP_INDEX_OF(buttonY), kTestElementMapper.Clone()));
+
+    for (auto kMapperName : kMapperNames)
+    {
+      TEST_ASSERT(true == builder.CreateBlueprint(kMapperName));
+      TEST_ASSERT(true == builder.SetBlueprintTemplate(kMapperName, kTemplateMapperName));
+    }
+
+    Mapper::SetDeferredBuilder(&builder);
+
+    TEST_ASSERT(nullptr == Mapper::GetByNameIfBuilt(kTemplateMapperName));
+    for (auto kMapperName : kMapperNames)
+    {
+      TEST_ASSERT(true == Mapper::IsMapperNameKnown(kMapperName));
+      TEST_ASSERT(nullptr == Mapper::GetByNameIfBuilt(kMapperName));
+      TEST_ASSERT(true == builder.IsBlueprintBuildPending(kMapperName));
+    }
+
+    const Mapper* const mapper = Mapper::GetByName(kMapperNames[0]);
+    TEST_ASSERT(nullptr != mapper);
+    TEST_ASSERT(kMapperNames[0] == mapper->GetName());
+    TEST_ASSERT(Mapper::GetByName(kMapperNames[0]) == mapper);
+    VerifyElementMapMatchesSpec(kControllerElements, kTestElementMapper, mapper->ElementMap());
+
+    const Mapper* const templateMapper = Mapper::GetByNameIfBuilt(kTemplateMapperName);
+    TEST_ASSERT(nullptr != templateMapper);
+    TEST_ASSERT(false == builder.IsBlueprintBuildPending(kTemplateMapperName));
+    TEST_ASSERT(nullptr == Mapper::GetByNameIfBuilt(kMapperNames[1]));
+    TEST_ASSERT(nullptr == Mapper::GetByNameIfBuilt(kMapperNames[2]));
+
+    const Mapper* const otherMapper = Mapper::GetByName(kMapperNames[1]);
+    TEST_ASSERT(nullptr != otherMapper);
+    TEST_ASSERT(Mapper::GetByNameIfBuilt(kTemplateMapperName) == templateMapper);
+    TEST_ASSERT(nullptr == Mapper::GetByNameIfBuilt(kMapperNames[2]));
+    TEST_ASSERT(true == builder.IsBlueprintBuildPending(kMapperNames[2]));
+
+    Mapper::SetDeferredBuilder(nullptr);
+    TEST_ASSERT(false == Mapper::IsMapperNameKnown(kMapperNames[2]));
+    TEST_ASSERT(nullptr == Mapper::GetByName(kMapperNames[2]));
+
+    delete mapper;
+    delete otherMapper;
+    delete templateMapper;
+  }
+
+  // Verifies that requesting a mapper whose blueprint cannot be built fails without affecting the
+  // other blueprints held by the deferred builder, and that names without blueprints are not
+  // built.
+  TEST_CASE(MapperBuilder_Deferred_BuildFailure)
+  {
+    constexpr std::wstring_view kInvalidMapperName = L"DeferredInvalidTestMapper";
+    constexpr std::wstring_view kValidMapperName = L"DeferredValidTestMapper";
+    constexpr std::wstring_view kUnknownMapperName = L"DeferredUnknownTestMapper";
+
+    MapperBuilder builder;
+    TEST_ASSERT(true == builder.CreateBlueprint(kInvalidMapperName));
+    TEST_ASSERT(true == builder.InvalidateBlueprint(kInvalidMapperName));
+    TEST_ASSERT(true == builder.CreateBlueprint(kValidMapperName));
+
+    Mapper::SetDeferredBuilder(&builder);
+
+    TEST_ASSERT(nullptr == Mapper::GetByName(kInvalidMapperName));
+    TEST_ASSERT(nullptr == Mapper::GetByName(kUnknownMapperName));
+    TEST_ASSERT(true == builder.IsBlueprintBuildPending(kValidMapperName));
+
+    const Mapper* const mapper = Mapper::GetByName(kValidMapperName);
+    TEST_ASSERT(nullptr != mapper);
+
+    Mapper::SetDeferredBuilder(nullptr);
+    delete mapper;
+  }
 } // namespace XidiTest
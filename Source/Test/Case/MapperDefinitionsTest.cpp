@@ -0,0 +1,157 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file MapperDefinitionsTest.cpp
+ *   Unit tests for compile-time descriptions of built-in mappers.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "MapperDefinitions.h"
+
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "ControllerTypes.h"
+#include "ElementMapper.h"
+#include "Mapper.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+
+  // Verifies that the capabilities derived by the compiler for each built-in mapper match the
+  // capabilities derived at runtime from the mapper object it describes, and that each element
+  // mapper in that object targets the same virtual controller element as its description.
+  TEST_CASE(MapperDefinitions_Capabilities_MatchMapperObject)
+  {
+    for (unsigned int i = 0; i < MapperDefinitions::GetCount(); ++i)
+    {
+      const MapperDefinitions::SMapperDescription& description =
+          MapperDefinitions::GetDescription(i);
+      const std::unique_ptr<const Mapper> mapper = MapperDefinitions::CreateMapper(i);
+
+      TEST_ASSERT(nullptr != mapper);
+      TEST_ASSERT(mapper->GetName() == description.name);
+      TEST_ASSERT(mapper->GetCapabilities() == description.capabilities);
+
+      const auto elementDescriptions = description.elements.All();
+      for (int j = 0; j < _countof(Mapper::UElementMap::all); ++j)
+      {
+        const int expectedTargetElementCount = elementDescriptions[j].GetTargetElementCount();
+
+        if (0 == expectedTargetElementCount)
+        {
+          TEST_ASSERT(nullptr == mapper->ElementMap().all[j]);
+          continue;
+        }
+
+        TEST_ASSERT(nullptr != mapper->ElementMap().all[j]);
+        TEST_ASSERT(
+            expectedTargetElementCount == mapper->ElementMap().all[j]->GetTargetElementCount());
+
+        for (int k = 0; k < expectedTargetElementCount; ++k)
+          TEST_ASSERT(
+              mapper->ElementMap().all[j]->GetTargetElementAt(k) ==
+              elementDescriptions[j].GetTargetElementAt(k));
+      }
+    }
+  }
+
+  // Verifies that the capabilities derived by the compiler account for every force feedback
+  // actuator in both modes, including the impulse triggers, in the same way as a mapper object
+  // that uses the same element mappers and force feedback actuator map.
+  TEST_CASE(MapperDefinitions_Capabilities_MatchMapperObjectWithForceFeedbackActuators)
+  {
+    constexpr Mapper::SForceFeedbackActuatorMap kTestForceFeedbackActuatorMap = {
+        .leftMotor =
+            {.isPresent = true,
+             .mode = ForceFeedback::EActuatorMode::SingleAxis,
+             .singleAxis = {.axis = EAxis::RotX, .direction = EAxisDirection::Both}},
+        .rightMotor =
+            {.isPresent = true,
+             .mode = ForceFeedback::EActuatorMode::MagnitudeProjection,
+             .magnitudeProjection = {.axisFirst = EAxis::X, .axisSecond = EAxis::RotY}},
+        .rightImpulseTrigger =
+            {.isPresent = true,
+             .mode = ForceFeedback::EActuatorMode::SingleAxis,
+             .singleAxis = {.axis = EAxis::RotZ, .direction = EAxisDirection::Positive}}};
+
+    for (unsigned int i = 0; i < MapperDefinitions::GetCount(); ++i)
+    {
+      const MapperDefinitions::SMapperDescription& description =
+          MapperDefinitions::GetDescription(i);
+      const std::unique_ptr<const Mapper> builtinMapper = MapperDefinitions::CreateMapper(i);
+      TEST_ASSERT(nullptr != builtinMapper);
+
+      Mapper::UElementMap elements = builtinMapper->CloneElementMap();
+      const Mapper mapper(std::move(elements.named), kTestForceFeedbackActuatorMap);
+
+      TEST_ASSERT(
+          mapper.GetCapabilities() ==
+          MapperDefinitions::DeriveCapabilities(
+              description.elements, kTestForceFeedbackActuatorMap));
+    }
+  }
+
+  // Verifies that every built-in mapper can be located by its name.
+  TEST_CASE(MapperDefinitions_FindByName_Nominal)
+  {
+    for (unsigned int i = 0; i < MapperDefinitions::GetCount(); ++i)
+    {
+      const std::optional<unsigned int> maybeIndex =
+          MapperDefinitions::FindByName(MapperDefinitions::GetDescription(i).name);
+      TEST_ASSERT(true == maybeIndex.has_value());
+      TEST_ASSERT(i == maybeIndex.value());
+    }
+  }
+
+  // Verifies that names which do not exactly match any built-in mapper are not located, even if
+  // they happen to hash to an occupied slot.
+  TEST_CASE(MapperDefinitions_FindByName_Unknown)
+  {
+    constexpr std::wstring_view kUnknownNames[] = {
+        L"",
+        L"standardgamepad",
+        L"StandardGamepad ",
+        L"StandardGamepa",
+        L"XInput",
+        L"XInputNativeX",
+        L"CustomMapper",
+        L"A",
+        L"B",
+        L"C",
+        L"D",
+        L"E",
+        L"F",
+        L"G",
+        L"H"};
+
+    for (const auto unknownName : kUnknownNames)
+      TEST_ASSERT(false == MapperDefinitions::FindByName(unknownName).has_value());
+  }
+
+  // Verifies that each built-in mapper object is created only once and is the same object that is
+  // located by name, and that the first built-in mapper is the default.
+  TEST_CASE(MapperDefinitions_GetMapper_Nominal)
+  {
+    for (unsigned int i = 0; i < MapperDefinitions::GetCount(); ++i)
+    {
+      const Mapper* const mapper = MapperDefinitions::GetMapper(i);
+
+      TEST_ASSERT(nullptr != mapper);
+      TEST_ASSERT(mapper == MapperDefinitions::GetMapper(i));
+      TEST_ASSERT(mapper == Mapper::GetByName(MapperDefinitions::GetDescription(i).name));
+      TEST_ASSERT(mapper == Mapper::GetByNameIfBuilt(MapperDefinitions::GetDescription(i).name));
+      TEST_ASSERT(mapper->GetName() == MapperDefinitions::GetDescription(i).name);
+    }
+
+    TEST_ASSERT(MapperDefinitions::GetMapper(0) == Mapper::GetDefault());
+    TEST_ASSERT(nullptr == MapperDefinitions::GetMapper(MapperDefinitions::GetCount()));
+  }
+} // namespace XidiTest
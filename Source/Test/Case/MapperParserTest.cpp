@@ -24,6 +24,7 @@
 #include "Keyboard.h"
 #include "Mapper.h"
 #include "Mouse.h"
+#include "ResponseCurve.h"
 
 namespace XidiTest
 {
@@ -378,7 +379,13 @@ namespace XidiTest
   TEST_CASE(MapperParser_MakeAxisMapper_Invalid)
   {
     const std::wstring_view kAxisMapperTestStrings[] = {
-        L"A", L"3", L"x, anydir", L"rotz, +, morestuff"};
+        L"A",
+        L"3",
+        L"x, anydir",
+        L"rotz, +, morestuff",
+        L"x, +, Exponential(200), morestuff",
+        L"x, Exponential(5)",
+        L"x, Unknown(50)"};
 
     for (auto& axisMapperTestString : kAxisMapperTestStrings)
     {
@@ -387,6 +394,50 @@ namespace XidiTest
     }
   }
 
+  // Verifies correct construction of axis mapper objects with response curves, both with and
+  // without an axis direction preceding the response curve.
+  TEST_CASE(MapperParser_MakeAxisMapper_ResponseCurve)
+  {
+    const ResponseCurve::SSpec kExponentialSpec = {
+        .type = ResponseCurve::EType::Exponential, .parameter = 200};
+    const ResponseCurve::SSpec kSCurveSpec = {.type = ResponseCurve::EType::SCurve, .parameter = 50};
+
+    const struct
+    {
+      std::wstring_view params;
+      EAxis axis;
+      EAxisDirection direction;
+      const ResponseCurve* responseCurve;
+    } kAxisMapperTestItems[] = {
+        {L"x", EAxis::X, EAxisDirection::Both, nullptr},
+        {L"x, Exponential(200)",
+         EAxis::X,
+         EAxisDirection::Both,
+         &ResponseCurve::Get(kExponentialSpec)},
+        {L"RotY, +, exp(200)",
+         EAxis::RotY,
+         EAxisDirection::Positive,
+         &ResponseCurve::Get(kExponentialSpec)},
+        {L"z, -, SCurve( 50 )",
+         EAxis::Z,
+         EAxisDirection::Negative,
+         &ResponseCurve::Get(kSCurveSpec)},
+    };
+
+    for (auto& axisMapperTestItem : kAxisMapperTestItems)
+    {
+      ElementMapperOrError maybeAxisMapper = MapperParser::MakeAxisMapper(axisMapperTestItem.params);
+      TEST_ASSERT(true == maybeAxisMapper.HasValue());
+
+      const AxisMapper* const axisMapper =
+          dynamic_cast<const AxisMapper*>(maybeAxisMapper.Value().get());
+      TEST_ASSERT(nullptr != axisMapper);
+      TEST_ASSERT(axisMapperTestItem.axis == axisMapper->GetAxis());
+      TEST_ASSERT(axisMapperTestItem.direction == axisMapper->GetAxisDirection());
+      TEST_ASSERT(axisMapperTestItem.responseCurve == axisMapper->GetResponseCurve());
+    }
+  }
+
   // Verifies correct construction of button mapper objects in the nominal case of valid parameter
   // strings being passed.
   TEST_CASE(MapperParser_MakeButtonMapper_Nominal)
@@ -1365,4 +1416,69 @@ namespace XidiTest
       TEST_ASSERT(false == maybeActualForceFeedbackActuator.HasValue());
     }
   }
+
+  // Verifies successful parsing of response curve strings into response curves with the correct
+  // descriptions.
+  TEST_CASE(MapperParser_ParseResponseCurve_Valid)
+  {
+    constexpr std::wstring_view kTestStrings[] = {
+        L"Exponential(10)",
+        L"exp(1000)",
+        L"SCurve(100)",
+        L"Piecewise(50:20)",
+        L"piecewise( 10:0 , 20:5, 99:100 )"};
+    const ResponseCurve::SSpec kExpectedSpecs[] = {
+        {.type = ResponseCurve::EType::Exponential, .parameter = 10},
+        {.type = ResponseCurve::EType::Exponential, .parameter = 1000},
+        {.type = ResponseCurve::EType::SCurve, .parameter = 100},
+        {.type = ResponseCurve::EType::Piecewise,
+         .pointCount = 1,
+         .points = {{{.inputPercent = 50, .outputPercent = 20}}}},
+        {.type = ResponseCurve::EType::Piecewise,
+         .pointCount = 3,
+         .points = {
+             {{.inputPercent = 10, .outputPercent = 0},
+              {.inputPercent = 20, .outputPercent = 5},
+              {.inputPercent = 99, .outputPercent = 100}}}}};
+    static_assert(
+        _countof(kExpectedSpecs) == _countof(kTestStrings),
+        "Mismatch between input and expected output array lengths.");
+
+    for (int i = 0; i < _countof(kTestStrings); ++i)
+    {
+      const MapperParser::ResponseCurveOrError maybeResponseCurve =
+          MapperParser::ParseResponseCurve(kTestStrings[i]);
+      TEST_ASSERT(true == maybeResponseCurve.HasValue());
+      TEST_ASSERT(kExpectedSpecs[i] == maybeResponseCurve.Value()->GetSpec());
+    }
+  }
+
+  // Verifies failure to parse response curve strings that are invalid.
+  TEST_CASE(MapperParser_ParseResponseCurve_Invalid)
+  {
+    constexpr std::wstring_view kTestStrings[] = {
+        L"Exponential",
+        L"Exponential()",
+        L"Exponential(9)",
+        L"Exponential(1001)",
+        L"Exponential(2.5)",
+        L"SCurve(0)",
+        L"SCurve(101)",
+        L"Piecewise(50)",
+        L"Piecewise(0:10)",
+        L"Piecewise(100:10)",
+        L"Piecewise(50:101)",
+        L"Piecewise(50:20, 50:30)",
+        L"Piecewise(50:20, 40:30)",
+        L"Piecewise(1:1, 2:2, 3:3, 4:4, 5:5, 6:6, 7:7, 8:8, 9:9)",
+        L"Linear(50)",
+        L"Exponential(200), SCurve(50)"};
+
+    for (int i = 0; i < _countof(kTestStrings); ++i)
+    {
+      const MapperParser::ResponseCurveOrError maybeResponseCurve =
+          MapperParser::ParseResponseCurve(kTestStrings[i]);
+      TEST_ASSERT(true == maybeResponseCurve.HasError());
+    }
+  }
 } // namespace XidiTest
@@ -13,6 +13,7 @@
 
 #include "Mapper.h"
 
+#include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <limits>
@@ -25,7 +26,12 @@
 #include "ControllerTypes.h"
 #include "ElementMapper.h"
 #include "ForceFeedbackTypes.h"
+#include "Keyboard.h"
 #include "MockElementMapper.h"
+#include "MockKeyboard.h"
+#include "MockMouse.h"
+#include "Mouse.h"
+#include "TransformProfile.h"
 
 namespace XidiTest
 {
@@ -35,6 +41,8 @@ namespace XidiTest
   using ::Xidi::Controller::ForceFeedback::TEffectValue;
   using ::Xidi::Controller::ForceFeedback::TOrderedMagnitudeComponents;
   using ::Xidi::Controller::ForceFeedback::TPhysicalActuatorValue;
+  using ::Xidi::Keyboard::TKeyIdentifier;
+  using ::Xidi::Mouse::EMouseAxis;
 
   /// Opaque source identifier used for many mapper tests in this file.
   static constexpr uint32_t kOpaqueSourceIdentifier = 100;
@@ -275,6 +283,35 @@ namespace XidiTest
     }
   }
 
+  // Verifies that opaque source identifiers for all physical controllers are dense, covering a
+  // contiguous range starting at zero that fits within the fixed number of mouse movement
+  // contribution slots.
+  TEST_CASE(Mapper_OpaqueSourceIdentifier_DenseAcrossAllControllers)
+  {
+    std::unordered_set<uint32_t> seenSourceIdentifiers;
+
+    for (uint32_t controllerIdentifier = 0; controllerIdentifier < kPhysicalControllerCount;
+         ++controllerIdentifier)
+    {
+      const Mapper testMapper(kFullyMockedMapper);
+      testMapper.MapNeutralPhysicalToVirtual(controllerIdentifier);
+
+      for (const auto& elementMapper : testMapper.ElementMap().all)
+      {
+        const uint32_t sourceIdentifier = static_cast<const MockElementMapper*>(elementMapper.get())
+                                              ->GetSourceIdentifier()
+                                              .value();
+
+        TEST_ASSERT(sourceIdentifier < ::Xidi::Mouse::kMouseMovementSourceCount);
+        TEST_ASSERT(sourceIdentifier < (kPhysicalControllerCount * Mapper::kElementMapCount));
+        TEST_ASSERT(true == seenSourceIdentifiers.insert(sourceIdentifier).second);
+      }
+    }
+
+    TEST_ASSERT(
+        (kPhysicalControllerCount * Mapper::kElementMapCount) == seenSourceIdentifiers.size());
+  }
+
   // In this context, "route" means that the correct element mapper is invoked with the correct
   // value source (analog for left and right stick axes, trigger for LT and RT, and buttons for all
   // controller buttons including the d-pad).
@@ -1148,6 +1185,221 @@ namespace XidiTest
     TEST_ASSERT(actualState == expectedState);
   }
 
+  // Incremental mapping is expected to produce exactly the same result as full mapping for an
+  // arbitrary sequence of physical controller states. This test uses a mapper with multiple element
+  // mappers contributing to the same virtual controller elements, so that recombination of
+  // separately-computed contributions is exercised for axes, buttons, and POV directions.
+  TEST_CASE(Mapper_State_IncrementalMatchesFull)
+  {
+    const Mapper mapper(
+        {.stickLeftX = std::make_unique<AxisMapper>(EAxis::X),
+         .stickLeftY = std::make_unique<SplitMapper>(
+             std::make_unique<ButtonMapper>(EButton::B3),
+             std::make_unique<AxisMapper>(EAxis::Y, EAxisDirection::Negative)),
+         .stickRightX = std::make_unique<AxisMapper>(EAxis::X),
+         .stickRightY = std::make_unique<AxisMapper>(EAxis::Y),
+         .dpadUp = std::make_unique<PovMapper>(EPovDirection::Up),
+         .dpadDown = std::make_unique<PovMapper>(EPovDirection::Down),
+         .dpadLeft = std::make_unique<CompoundMapper>(CompoundMapper::TElementMappers{
+             std::make_unique<PovMapper>(EPovDirection::Up),
+             std::make_unique<ButtonMapper>(EButton::B2)}),
+         .dpadRight = std::make_unique<InvertMapper>(std::make_unique<AxisMapper>(EAxis::X)),
+         .triggerLT = std::make_unique<AxisMapper>(EAxis::Z, EAxisDirection::Positive),
+         .triggerRT = std::make_unique<AxisMapper>(EAxis::Z, EAxisDirection::Negative),
+         .buttonA = std::make_unique<ButtonMapper>(EButton::B1),
+         .buttonB = std::make_unique<ButtonMapper>(EButton::B1),
+         .buttonX = std::make_unique<ButtonMapper>(EButton::B2),
+         .buttonY = std::make_unique<DigitalAxisMapper>(EAxis::RotZ)});
+
+    // Simple deterministic linear congruential generator, so that test results are repeatable.
+    uint32_t randomState = 12345;
+    auto nextRandom = [&randomState]() -> uint32_t
+    {
+      randomState = (randomState * 1664525u) + 1013904223u;
+      return (randomState >> 8);
+    };
+
+    SPhysicalState physicalState = {.deviceStatus = EPhysicalDeviceStatus::Ok};
+    Mapper::SIncrementalMappingCache mappingCache;
+
+    for (int iteration = 0; iteration < 2000; ++iteration)
+    {
+      // Change one physical controller element at a time most of the time, but occasionally
+      // change several at once.
+      const int numChanges = ((0 == (iteration % 16)) ? 4 : 1);
+      for (int change = 0; change < numChanges; ++change)
+      {
+        switch (nextRandom() % 3)
+        {
+          case 0:
+            physicalState.stick[nextRandom() % physicalState.stick.size()] =
+                (int16_t)(nextRandom() & 0xffff);
+            break;
+
+          case 1:
+            physicalState.trigger[nextRandom() % physicalState.trigger.size()] =
+                (uint8_t)(nextRandom() & 0xff);
+            break;
+
+          default:
+            physicalState.button.flip(nextRandom() % physicalState.button.size());
+            break;
+        }
+      }
+
+      const SState expectedState =
+          mapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier);
+      const SState actualState =
+          mapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier, mappingCache);
+      TEST_ASSERT(actualState == expectedState);
+    }
+  }
+
+  // Incremental mapping is expected to invoke only those element mappers whose physical controller
+  // inputs changed since the last mapping operation.
+  TEST_CASE(Mapper_State_IncrementalInvokesOnlyChangedElements)
+  {
+    int numContributionsStickLeftX = 0;
+    int numContributionsTriggerLT = 0;
+    int numContributionsButtonA = 0;
+    int numContributionsButtonB = 0;
+
+    const Mapper mapper(
+        {.stickLeftX = std::make_unique<MockElementMapper>(
+             MockElementMapper::EExpectedSource::Analog, std::nullopt, &numContributionsStickLeftX),
+         .triggerLT = std::make_unique<MockElementMapper>(
+             MockElementMapper::EExpectedSource::Trigger, std::nullopt, &numContributionsTriggerLT),
+         .buttonA = std::make_unique<MockElementMapper>(
+             MockElementMapper::EExpectedSource::Button, std::nullopt, &numContributionsButtonA),
+         .buttonB = std::make_unique<MockElementMapper>(
+             MockElementMapper::EExpectedSource::Button, std::nullopt, &numContributionsButtonB)});
+
+    SPhysicalState physicalState = {.deviceStatus = EPhysicalDeviceStatus::Ok};
+    Mapper::SIncrementalMappingCache mappingCache;
+
+    // First mapping operation is a full remap because the cache is not yet valid.
+    mapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier, mappingCache);
+    TEST_ASSERT(1 == numContributionsStickLeftX);
+    TEST_ASSERT(1 == numContributionsTriggerLT);
+    TEST_ASSERT(1 == numContributionsButtonA);
+    TEST_ASSERT(1 == numContributionsButtonB);
+
+    // Nothing changed, so nothing should be invoked.
+    mapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier, mappingCache);
+    TEST_ASSERT(1 == numContributionsStickLeftX);
+    TEST_ASSERT(1 == numContributionsTriggerLT);
+    TEST_ASSERT(1 == numContributionsButtonA);
+    TEST_ASSERT(1 == numContributionsButtonB);
+
+    // Only the A button changed.
+    physicalState[EPhysicalButton::A] = true;
+    mapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier, mappingCache);
+    TEST_ASSERT(1 == numContributionsStickLeftX);
+    TEST_ASSERT(1 == numContributionsTriggerLT);
+    TEST_ASSERT(2 == numContributionsButtonA);
+    TEST_ASSERT(1 == numContributionsButtonB);
+
+    // Stick and trigger both changed.
+    physicalState[EPhysicalStick::LeftX] = 1000;
+    physicalState[EPhysicalTrigger::LT] = 100;
+    mapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier, mappingCache);
+    TEST_ASSERT(2 == numContributionsStickLeftX);
+    TEST_ASSERT(2 == numContributionsTriggerLT);
+    TEST_ASSERT(2 == numContributionsButtonA);
+    TEST_ASSERT(1 == numContributionsButtonB);
+
+    // Invalidating the cache forces a full remap.
+    mappingCache.Invalidate();
+    mapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier, mappingCache);
+    TEST_ASSERT(3 == numContributionsStickLeftX);
+    TEST_ASSERT(3 == numContributionsTriggerLT);
+    TEST_ASSERT(3 == numContributionsButtonA);
+    TEST_ASSERT(2 == numContributionsButtonB);
+  }
+
+  // When an analog stick is processed radially, each of its axes depends on the other, so a change
+  // to only one axis must still cause the element mapper for the other axis to be invoked during
+  // incremental mapping. This test places the left stick's horizontal axis within the deadzone by
+  // itself and then moves only the vertical axis far enough that the stick leaves the deadzone.
+  TEST_CASE(Mapper_State_IncrementalRadialStick)
+  {
+    const TransformProfile kTestTransformProfile(
+        {{{20, 100}, {20, 100}, {0, 100}, {0, 100}}},
+        {{{0, 100}, {0, 100}}},
+        {{{.isEnabled = true, .antiDeadzonePercent = 0, .circleToSquare = false},
+          TransformProfile::kAxialParameters}});
+
+    const Mapper mapper({.stickLeftX = std::make_unique<AxisMapper>(EAxis::X)});
+
+    SPhysicalState physicalState = {.deviceStatus = EPhysicalDeviceStatus::Ok};
+    physicalState[EPhysicalStick::LeftX] = 5000;
+    Mapper::SIncrementalMappingCache mappingCache;
+
+    const SState neutralState = mapper.MapStatePhysicalToVirtual(
+        physicalState, kOpaqueSourceIdentifier, mappingCache, kTestTransformProfile);
+    TEST_ASSERT(kAnalogValueNeutral == neutralState[EAxis::X]);
+
+    physicalState[EPhysicalStick::LeftY] = 5000;
+
+    const SState expectedState = mapper.MapStatePhysicalToVirtual(
+        physicalState, kOpaqueSourceIdentifier, kTestTransformProfile);
+    const SState actualState = mapper.MapStatePhysicalToVirtual(
+        physicalState, kOpaqueSourceIdentifier, mappingCache, kTestTransformProfile);
+    TEST_ASSERT(kAnalogValueNeutral != expectedState[EAxis::X]);
+    TEST_ASSERT(actualState == expectedState);
+  }
+
+  // Replacing the mapper used for a physical controller, as happens when the configuration file is
+  // reloaded, is expected to release the keyboard keys and stop the mouse movement contributed by
+  // the previous mapper, even though the new mapper maps the same physical controller elements to
+  // virtual controller buttons. This is achieved by mapping neutral physical controller state with
+  // the previous mapper before mapping with the new mapper.
+  TEST_CASE(Mapper_State_ReplacedMapperReleasesKeyboardAndMouse)
+  {
+    constexpr TKeyIdentifier kTestKey = 55;
+
+    const Mapper previousMapper(
+        {.stickLeftX = std::make_unique<MouseAxisMapper>(EMouseAxis::X),
+         .buttonA = std::make_unique<KeyboardMapper>(kTestKey)});
+    const Mapper newMapper(
+        {.stickLeftX = std::make_unique<ButtonMapper>(EButton::B1),
+         .buttonA = std::make_unique<ButtonMapper>(EButton::B2)});
+
+    SPhysicalState physicalState = {.deviceStatus = EPhysicalDeviceStatus::Ok};
+    physicalState[EPhysicalStick::LeftX] = kAnalogValueMax;
+    physicalState[EPhysicalButton::A] = true;
+
+    SState expectedState = {};
+    expectedState[EButton::B1] = true;
+    expectedState[EButton::B2] = true;
+
+    MockKeyboard expectedKeyboard;
+    MockMouse expectedMouse;
+    expectedKeyboard.BeginCapture();
+    expectedMouse.BeginCapture();
+    previousMapper.MapNeutralPhysicalToVirtual(kOpaqueSourceIdentifier);
+    expectedKeyboard.EndCapture();
+    expectedMouse.EndCapture();
+
+    MockKeyboard actualKeyboard;
+    MockMouse actualMouse;
+    actualKeyboard.BeginCapture();
+    actualMouse.BeginCapture();
+
+    Mapper::SIncrementalMappingCache mappingCache;
+    previousMapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier, mappingCache);
+    TEST_ASSERT(actualKeyboard != expectedKeyboard);
+    TEST_ASSERT(actualMouse != expectedMouse);
+
+    previousMapper.MapNeutralPhysicalToVirtual(kOpaqueSourceIdentifier);
+    mappingCache.Invalidate();
+    const SState actualState =
+        newMapper.MapStatePhysicalToVirtual(physicalState, kOpaqueSourceIdentifier, mappingCache);
+    TEST_ASSERT(actualState == expectedState);
+    TEST_ASSERT(actualKeyboard == expectedKeyboard);
+    TEST_ASSERT(actualMouse == expectedMouse);
+  }
+
   // Nominal case of some actuators mapped in single axis mode and using axes with the default of
   // both directions.
   TEST_CASE(Mapper_ForceFeedback_Nominal_SingleAxis)
@@ -0,0 +1,290 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file MappingConfigurationTest.cpp
+ *   Unit tests for replacing the per-controller mapping configuration at runtime.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "MappingConfiguration.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "Configuration.h"
+#include "ControllerTypes.h"
+#include "ElementMapper.h"
+#include "Mapper.h"
+#include "MapperBuilder.h"
+#include "Strings.h"
+#include "TransformProfile.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi;
+  using namespace ::Xidi::Controller;
+  using ::Xidi::Configuration::ConfigurationData;
+  using ::Xidi::Configuration::TStringValue;
+
+  /// Name of the built-in mapper used as a template for test mappers whose capabilities match it.
+  static constexpr std::wstring_view kTemplateMapperName = L"StandardGamepad";
+
+  /// Raw analog transformations used as the replacement transform profile in tests.
+  static const TransformProfile kTestTransformProfile(
+      {TransformProfile::SParameters{.deadzonePercent = 10, .saturationPercent = 90},
+       TransformProfile::SParameters{.deadzonePercent = 10, .saturationPercent = 90},
+       TransformProfile::SParameters{.deadzonePercent = 20, .saturationPercent = 80},
+       TransformProfile::SParameters{.deadzonePercent = 20, .saturationPercent = 80}},
+      {TransformProfile::kIdentityParameters, TransformProfile::kIdentityParameters});
+
+  /// Builds a mapper using the specified detached builder whose capabilities are identical to those
+  /// of the template mapper.
+  /// @param [in, out] builder Detached builder to use.
+  /// @param [in] mapperName Name of the mapper to build.
+  /// @return Pointer to the built mapper.
+  static const Mapper* BuildMatchingMapper(MapperBuilder& builder, std::wstring_view mapperName)
+  {
+    TEST_ASSERT(true == builder.CreateBlueprint(mapperName));
+    TEST_ASSERT(true == builder.SetBlueprintTemplate(mapperName, kTemplateMapperName));
+
+    const Mapper* const mapper = builder.Build(mapperName);
+    TEST_ASSERT(nullptr != mapper);
+    TEST_ASSERT(
+        mapper->GetCapabilities() == Mapper::GetByName(kTemplateMapperName)->GetCapabilities());
+    return mapper;
+  }
+
+  /// Builds a mapper using the specified detached builder whose capabilities differ from those of
+  /// the template mapper.
+  /// @param [in, out] builder Detached builder to use.
+  /// @param [in] mapperName Name of the mapper to build.
+  /// @return Pointer to the built mapper.
+  static const Mapper* BuildMismatchedMapper(MapperBuilder& builder, std::wstring_view mapperName)
+  {
+    TEST_ASSERT(true == builder.CreateBlueprint(mapperName));
+    TEST_ASSERT(
+        true ==
+        builder.SetBlueprintElementMapper(
+            mapperName, ELEMENT_MAP_INDEX_OF(buttonA), ButtonMapper(EButton::B15).Clone()));
+
+    const Mapper* const mapper = builder.Build(mapperName);
+    TEST_ASSERT(nullptr != mapper);
+    TEST_ASSERT(
+        mapper->GetCapabilities() != Mapper::GetByName(kTemplateMapperName)->GetCapabilities());
+    return mapper;
+  }
+
+  /// Verifies that the specified transform profile has the same parameters as the test transform
+  /// profile and flags a test failure if not.
+  /// @param [in] transformProfile Transform profile to check.
+  static void VerifyIsTestTransformProfile(const TransformProfile& transformProfile)
+  {
+    for (int stickIdx = 0; stickIdx < (int)EPhysicalStick::Count; ++stickIdx)
+      TEST_ASSERT(
+          kTestTransformProfile.GetStickParameters((EPhysicalStick)stickIdx) ==
+          transformProfile.GetStickParameters((EPhysicalStick)stickIdx));
+  }
+
+  // Verifies that a built-in mapper with matching capabilities replaces the current mapper, and
+  // that no owner is attached to it because the mapper registry owns it.
+  TEST_CASE(MappingConfiguration_ResolveReplacement_BuiltInMapper)
+  {
+    MapperBuilder oldBuilder(true);
+    const Mapper* const oldMapper = BuildMatchingMapper(oldBuilder, L"ResolveOldTestMapper");
+    const SMappingConfiguration currentConfiguration = {
+        .mapper = oldMapper,
+        .transformProfile = TransformProfile(),
+        .mapperOwner = oldBuilder.GetDetachedMappers().at(L"ResolveOldTestMapper")};
+
+    const MapperBuilder newBuilder(true);
+    const Mapper* const newMapper = Mapper::GetByName(kTemplateMapperName);
+
+    const SMappingConfiguration replacement = MappingConfiguration::ResolveReplacement(
+        currentConfiguration, newMapper, kTestTransformProfile, newBuilder);
+    TEST_ASSERT(replacement.mapper == newMapper);
+    TEST_ASSERT(nullptr == replacement.mapperOwner);
+    VerifyIsTestTransformProfile(replacement.transformProfile);
+  }
+
+  // Verifies that a detached mapper with matching capabilities replaces the current mapper, and
+  // that the replacement shares ownership of it with the builder that built it, so that it
+  // outlives the builder.
+  TEST_CASE(MappingConfiguration_ResolveReplacement_DetachedMapper)
+  {
+    constexpr std::wstring_view kMapperName = L"ResolveDetachedTestMapper";
+
+    const SMappingConfiguration currentConfiguration = {
+        .mapper = Mapper::GetByName(kTemplateMapperName),
+        .transformProfile = TransformProfile(),
+        .mapperOwner = nullptr};
+
+    std::weak_ptr<const Mapper> newMapperWatcher;
+    std::unique_ptr<SMappingConfiguration> replacement = nullptr;
+
+    {
+      MapperBuilder newBuilder(true);
+      const Mapper* const newMapper = BuildMatchingMapper(newBuilder, kMapperName);
+      newMapperWatcher = newBuilder.GetDetachedMappers().at(kMapperName);
+
+      replacement = std::make_unique<SMappingConfiguration>(
+          MappingConfiguration::ResolveReplacement(
+              currentConfiguration, newMapper, kTestTransformProfile, newBuilder));
+      TEST_ASSERT(replacement->mapper == newMapper);
+      TEST_ASSERT(replacement->mapperOwner.get() == newMapper);
+      TEST_ASSERT(2 == newMapperWatcher.use_count());
+    }
+
+    TEST_ASSERT(false == newMapperWatcher.expired());
+    TEST_ASSERT(1 == newMapperWatcher.use_count());
+    VerifyIsTestTransformProfile(replacement->transformProfile);
+
+    replacement.reset();
+    TEST_ASSERT(true == newMapperWatcher.expired());
+  }
+
+  // Verifies that a mapper whose name matches a detached mapper but which was not built by the
+  // builder is not given an owner.
+  TEST_CASE(MappingConfiguration_ResolveReplacement_DetachedNameOnly)
+  {
+    constexpr std::wstring_view kMapperName = L"ResolveDetachedNameOnlyTestMapper";
+
+    const SMappingConfiguration currentConfiguration = {
+        .mapper = Mapper::GetByName(kTemplateMapperName),
+        .transformProfile = TransformProfile(),
+        .mapperOwner = nullptr};
+
+    MapperBuilder otherBuilder(true);
+    const Mapper* const newMapper = BuildMatchingMapper(otherBuilder, kMapperName);
+
+    MapperBuilder newBuilder(true);
+    BuildMatchingMapper(newBuilder, kMapperName);
+
+    const SMappingConfiguration replacement = MappingConfiguration::ResolveReplacement(
+        currentConfiguration, newMapper, kTestTransformProfile, newBuilder);
+    TEST_ASSERT(replacement.mapper == newMapper);
+    TEST_ASSERT(nullptr == replacement.mapperOwner);
+  }
+
+  // Verifies that a mapper with different capabilities does not replace the current mapper, that
+  // the current mapper's owner is kept along with it, and that the new raw analog transformations
+  // are still used.
+  TEST_CASE(MappingConfiguration_ResolveReplacement_CapabilityMismatch)
+  {
+    std::weak_ptr<const Mapper> oldMapperWatcher;
+    std::unique_ptr<SMappingConfiguration> replacement = nullptr;
+
+    {
+      MapperBuilder oldBuilder(true);
+      const Mapper* const oldMapper = BuildMatchingMapper(oldBuilder, L"MismatchOldTestMapper");
+      oldMapperWatcher = oldBuilder.GetDetachedMappers().at(L"MismatchOldTestMapper");
+
+      SMappingConfiguration currentConfiguration = {
+          .mapper = oldMapper,
+          .transformProfile = TransformProfile(),
+          .mapperOwner = oldBuilder.GetDetachedMappers().at(L"MismatchOldTestMapper")};
+
+      MapperBuilder newBuilder(true);
+      const Mapper* const newMapper = BuildMismatchedMapper(newBuilder, L"MismatchNewTestMapper");
+
+      replacement = std::make_unique<SMappingConfiguration>(
+          MappingConfiguration::ResolveReplacement(
+              currentConfiguration, newMapper, kTestTransformProfile, newBuilder));
+      TEST_ASSERT(replacement->mapper == oldMapper);
+      TEST_ASSERT(replacement->mapperOwner == currentConfiguration.mapperOwner);
+    }
+
+    TEST_ASSERT(1 == oldMapperWatcher.use_count());
+    VerifyIsTestTransformProfile(replacement->transformProfile);
+  }
+
+  // Verifies that publishing replaces the mapping configuration of every controller and bumps its
+  // generation, so that anything cached against the previous configuration is invalidated. Detached
+  // mappers are kept alive for as long as they are published, mappers with different capabilities
+  // are rejected, and the last configuration published leaves every controller with the default
+  // mapper.
+  TEST_CASE(MappingConfiguration_Publish)
+  {
+    constexpr std::wstring_view kMatchingMapperName = L"PublishMatchingTestMapper";
+    constexpr std::wstring_view kMismatchedMapperName = L"PublishMismatchedTestMapper";
+
+    std::array<uint64_t, kPhysicalControllerCount> lastGeneration;
+    for (TControllerIdentifier i = 0; i < kPhysicalControllerCount; ++i)
+      lastGeneration[i] = MappingConfiguration::Read(i).GetGeneration();
+
+    // Start from a known state, in which every controller uses the default mapper.
+    MappingConfiguration::Publish(ConfigurationData(), MapperBuilder(true));
+    for (TControllerIdentifier i = 0; i < kPhysicalControllerCount; ++i)
+    {
+      const MappingConfiguration::TReadGuard configuration = MappingConfiguration::Read(i);
+      TEST_ASSERT(configuration.GetGeneration() > lastGeneration[i]);
+      TEST_ASSERT(configuration->mapper == Mapper::GetDefault());
+      TEST_ASSERT(nullptr == configuration->mapperOwner);
+      lastGeneration[i] = configuration.GetGeneration();
+    }
+
+    std::weak_ptr<const Mapper> matchingMapperWatcher;
+
+    {
+      MapperBuilder customMapperBuilder(true);
+      const Mapper* const matchingMapper =
+          BuildMatchingMapper(customMapperBuilder, kMatchingMapperName);
+      matchingMapperWatcher = customMapperBuilder.GetDetachedMappers().at(kMatchingMapperName);
+
+      ConfigurationData configData;
+      configData.Insert(
+          Strings::kStrConfigurationSectionMapper,
+          Strings::kStrConfigurationSettingMapperType,
+          TStringValue(kMatchingMapperName));
+
+      MappingConfiguration::Publish(configData, customMapperBuilder);
+      for (TControllerIdentifier i = 0; i < kPhysicalControllerCount; ++i)
+      {
+        const MappingConfiguration::TReadGuard configuration = MappingConfiguration::Read(i);
+        TEST_ASSERT(configuration.GetGeneration() > lastGeneration[i]);
+        TEST_ASSERT(configuration->mapper == matchingMapper);
+        TEST_ASSERT(configuration->mapperOwner.get() == matchingMapper);
+        lastGeneration[i] = configuration.GetGeneration();
+      }
+    }
+
+    TEST_ASSERT(false == matchingMapperWatcher.expired());
+
+    {
+      MapperBuilder customMapperBuilder(true);
+      BuildMismatchedMapper(customMapperBuilder, kMismatchedMapperName);
+
+      ConfigurationData configData;
+      configData.Insert(
+          Strings::kStrConfigurationSectionMapper,
+          Strings::kStrConfigurationSettingMapperType,
+          TStringValue(kMismatchedMapperName));
+
+      MappingConfiguration::Publish(configData, customMapperBuilder);
+      for (TControllerIdentifier i = 0; i < kPhysicalControllerCount; ++i)
+      {
+        const MappingConfiguration::TReadGuard configuration = MappingConfiguration::Read(i);
+        TEST_ASSERT(configuration.GetGeneration() > lastGeneration[i]);
+        TEST_ASSERT(configuration->mapper == matchingMapperWatcher.lock().get());
+        TEST_ASSERT(configuration->mapperOwner == matchingMapperWatcher.lock());
+        lastGeneration[i] = configuration.GetGeneration();
+      }
+    }
+
+    MappingConfiguration::Publish(ConfigurationData(), MapperBuilder(true));
+    for (TControllerIdentifier i = 0; i < kPhysicalControllerCount; ++i)
+    {
+      const MappingConfiguration::TReadGuard configuration = MappingConfiguration::Read(i);
+      TEST_ASSERT(configuration.GetGeneration() > lastGeneration[i]);
+      TEST_ASSERT(configuration->mapper == Mapper::GetDefault());
+    }
+
+    TEST_ASSERT(true == matchingMapperWatcher.expired());
+  }
+} // namespace XidiTest
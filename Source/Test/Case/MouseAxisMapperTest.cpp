@@ -23,7 +23,7 @@ namespace XidiTest
   using ::Xidi::Mouse::EMouseAxis;
 
   /// Opaque source identifier used for many tests in this file.
-  static constexpr uint32_t kOpaqueSourceIdentifier = 1234;
+  static constexpr uint32_t kOpaqueSourceIdentifier = 37;
 
   // Creates one mouse axis mapper for various possible mouse axes and verifies two things.
   // First, verifies that it does not map to any virtual controller element.
@@ -0,0 +1,340 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file PhysicalControllerRecordingTest.cpp
+ *   Unit tests for recording and replaying physical controller state streams.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "PhysicalControllerRecording.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "ApiWindows.h"
+#include "ControllerTypes.h"
+#include "Mapper.h"
+#include "PhysicalControllerSource.h"
+#include "Utilities.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+  using ::Xidi::Controller::Recording::Player;
+  using ::Xidi::Controller::Recording::Recorder;
+  using ::Xidi::Controller::Recording::SRecord;
+  using ::Xidi::Controller::Recording::SRecordingFileHeader;
+
+  /// Timestamp frequency used for in-memory recordings created by tests in this file.
+  static constexpr uint64_t kTestTimestampFrequency = 1000;
+
+  /// Creates the contents of a recording file in memory.
+  /// @param [in] records Records to be placed into the recording.
+  /// @param [in] claimedRecordCount Record count to write into the header, which by default is
+  /// the actual number of records.
+  /// @return Buffer holding the recording file contents.
+  static std::vector<uint8_t> CreateRecordingContents(
+      const std::vector<SRecord>& records, uint64_t claimedRecordCount = UINT64_MAX)
+  {
+    const SRecordingFileHeader header = {
+        .signature = Recording::kRecordingFileSignature,
+        .version = Recording::kRecordingFileVersion,
+        .recordSize = (uint16_t)sizeof(SRecord),
+        .timestampFrequency = kTestTimestampFrequency,
+        .recordCount =
+            ((UINT64_MAX == claimedRecordCount) ? (uint64_t)records.size() : claimedRecordCount)};
+
+    std::vector<uint8_t> recordingContents(
+        sizeof(SRecordingFileHeader) + (records.size() * sizeof(SRecord)));
+    std::memcpy(recordingContents.data(), &header, sizeof(header));
+    if (false == records.empty())
+      std::memcpy(
+          &recordingContents[sizeof(header)], records.data(), records.size() * sizeof(SRecord));
+
+    return recordingContents;
+  }
+
+  // Verifies that converting a physical state to a record and back again is lossless.
+  TEST_CASE(PhysicalControllerRecording_Record_RoundTrip)
+  {
+    for (unsigned int seed = 0; seed < 100; ++seed)
+    {
+      const SPhysicalState expectedPhysicalState = CreatePhysicalState(seed);
+      const SRecord record = Recording::RecordFromPhysicalState(seed, 2, expectedPhysicalState);
+
+      TEST_ASSERT(seed == record.timestamp);
+      TEST_ASSERT(2 == record.controllerIdentifier);
+      TEST_ASSERT(0 == record.reserved);
+
+      const SPhysicalState actualPhysicalState = Recording::PhysicalStateFromRecord(record);
+      TEST_ASSERT(actualPhysicalState == expectedPhysicalState);
+    }
+  }
+
+  // Verifies that a record with an unrecognized device status is reported as an error.
+  TEST_CASE(PhysicalControllerRecording_Record_InvalidDeviceStatus)
+  {
+    SRecord record = Recording::RecordFromPhysicalState(0, 0, CreatePhysicalState(1));
+    record.deviceStatus = (uint8_t)EPhysicalDeviceStatus::Count;
+
+    TEST_ASSERT(
+        EPhysicalDeviceStatus::Error == Recording::PhysicalStateFromRecord(record).deviceStatus);
+  }
+
+  // Verifies that state lookups by timestamp produce the state most recently recorded for each
+  // controller, and that controllers without a record yet are reported as not connected.
+  TEST_CASE(PhysicalControllerRecording_Player_GetStateAt)
+  {
+    const std::vector<SRecord> records = {
+        Recording::RecordFromPhysicalState(10, 0, CreatePhysicalState(1)),
+        Recording::RecordFromPhysicalState(20, 1, CreatePhysicalState(2)),
+        Recording::RecordFromPhysicalState(30, 0, CreatePhysicalState(3)),
+        Recording::RecordFromPhysicalState(30, 1, CreatePhysicalState(4)),
+        Recording::RecordFromPhysicalState(50, 0, CreatePhysicalState(5)),
+    };
+
+    const std::vector<uint8_t> recordingContents = CreateRecordingContents(records);
+    const Player player(recordingContents.data(), recordingContents.size());
+
+    TEST_ASSERT(true == player.IsValid());
+    TEST_ASSERT(records.size() == player.GetRecordCount());
+    TEST_ASSERT(50 == player.GetDuration());
+
+    TEST_ASSERT(EPhysicalDeviceStatus::NotConnected == player.GetStateAt(0, 9).deviceStatus);
+    TEST_ASSERT(CreatePhysicalState(1) == player.GetStateAt(0, 10));
+    TEST_ASSERT(CreatePhysicalState(1) == player.GetStateAt(0, 29));
+    TEST_ASSERT(CreatePhysicalState(3) == player.GetStateAt(0, 30));
+    TEST_ASSERT(CreatePhysicalState(3) == player.GetStateAt(0, 49));
+    TEST_ASSERT(CreatePhysicalState(5) == player.GetStateAt(0, 50));
+    TEST_ASSERT(CreatePhysicalState(5) == player.GetStateAt(0, 1000000));
+
+    TEST_ASSERT(EPhysicalDeviceStatus::NotConnected == player.GetStateAt(1, 19).deviceStatus);
+    TEST_ASSERT(CreatePhysicalState(2) == player.GetStateAt(1, 20));
+    TEST_ASSERT(CreatePhysicalState(4) == player.GetStateAt(1, 30));
+    TEST_ASSERT(CreatePhysicalState(4) == player.GetStateAt(1, 1000000));
+
+    TEST_ASSERT(EPhysicalDeviceStatus::NotConnected == player.GetStateAt(2, 1000000).deviceStatus);
+    TEST_ASSERT(
+        EPhysicalDeviceStatus::Error ==
+        player.GetStateAt(kPhysicalControllerCount, 1000000).deviceStatus);
+  }
+
+  // Verifies that a recording whose header claims more records than are actually present, as
+  // would happen if recording were interrupted, is limited to the records that are present.
+  TEST_CASE(PhysicalControllerRecording_Player_TruncatedRecording)
+  {
+    const std::vector<SRecord> records = {
+        Recording::RecordFromPhysicalState(10, 0, CreatePhysicalState(1)),
+        Recording::RecordFromPhysicalState(20, 0, CreatePhysicalState(2)),
+    };
+
+    std::vector<uint8_t> recordingContents = CreateRecordingContents(records, 1000);
+    recordingContents.resize(recordingContents.size() - (sizeof(SRecord) / 2));
+
+    const Player player(recordingContents.data(), recordingContents.size());
+
+    TEST_ASSERT(true == player.IsValid());
+    TEST_ASSERT(1 == player.GetRecordCount());
+    TEST_ASSERT(CreatePhysicalState(1) == player.GetStateAt(0, 1000));
+  }
+
+  // Verifies that malformed recordings are rejected.
+  TEST_CASE(PhysicalControllerRecording_Player_InvalidRecording)
+  {
+    const std::vector<SRecord> records = {
+        Recording::RecordFromPhysicalState(10, 0, CreatePhysicalState(1)),
+    };
+
+    const std::vector<uint8_t> validRecordingContents = CreateRecordingContents(records);
+
+    {
+      std::vector<uint8_t> recordingContents = validRecordingContents;
+      reinterpret_cast<SRecordingFileHeader*>(recordingContents.data())->signature += 1;
+      TEST_ASSERT(
+          false == Player(recordingContents.data(), recordingContents.size()).IsValid());
+    }
+
+    {
+      std::vector<uint8_t> recordingContents = validRecordingContents;
+      reinterpret_cast<SRecordingFileHeader*>(recordingContents.data())->version += 1;
+      TEST_ASSERT(
+          false == Player(recordingContents.data(), recordingContents.size()).IsValid());
+    }
+
+    {
+      std::vector<uint8_t> recordingContents = validRecordingContents;
+      reinterpret_cast<SRecordingFileHeader*>(recordingContents.data())->recordSize += 1;
+      TEST_ASSERT(
+          false == Player(recordingContents.data(), recordingContents.size()).IsValid());
+    }
+
+    TEST_ASSERT(false == Player(validRecordingContents.data(), 4).IsValid());
+    TEST_ASSERT(false == Player(nullptr, 0).IsValid());
+  }
+
+  // Verifies that records out of timestamp order cause the recording to be rejected.
+  TEST_CASE(PhysicalControllerRecording_Player_OutOfOrderRecording)
+  {
+    const std::vector<SRecord> records = {
+        Recording::RecordFromPhysicalState(20, 0, CreatePhysicalState(1)),
+        Recording::RecordFromPhysicalState(10, 1, CreatePhysicalState(2)),
+    };
+
+    const std::vector<uint8_t> recordingContents = CreateRecordingContents(records);
+    TEST_ASSERT(false == Player(recordingContents.data(), recordingContents.size()).IsValid());
+  }
+
+  // Records a stream of state changes to a file and then opens it for replay, verifying that the
+  // same states come back in the same order.
+  TEST_CASE(PhysicalControllerRecording_RecordAndReplayFile)
+  {
+    wchar_t tempDirectory[MAX_PATH] = {};
+    wchar_t tempFilename[MAX_PATH] = {};
+
+    TEST_ASSERT(0 != GetTempPathW(_countof(tempDirectory), tempDirectory));
+    TEST_ASSERT(0 != GetTempFileNameW(tempDirectory, L"Xid", 0, tempFilename));
+
+    // Enough records are appended to cause the recording file to grow at least once.
+    constexpr unsigned int kNumTestRecords = (unsigned int)(Recorder::kRecordGrowthIncrement + 10);
+
+    {
+      auto recorder = Recorder::Create(tempFilename);
+      TEST_ASSERT(nullptr != recorder);
+
+      for (unsigned int i = 0; i < kNumTestRecords; ++i)
+        TEST_ASSERT(
+            true ==
+            recorder->Append(
+                (TControllerIdentifier)(i % kPhysicalControllerCount), CreatePhysicalState(i)));
+
+      TEST_ASSERT(kNumTestRecords == recorder->GetRecordCount());
+    }
+
+    // Once the recorder is destroyed the file should no longer contain any unused space.
+    WIN32_FILE_ATTRIBUTE_DATA fileAttributes = {};
+    TEST_ASSERT(
+        FALSE != GetFileAttributesExW(tempFilename, GetFileExInfoStandard, &fileAttributes));
+    TEST_ASSERT(0 == fileAttributes.nFileSizeHigh);
+    TEST_ASSERT(
+        (sizeof(SRecordingFileHeader) + (kNumTestRecords * sizeof(SRecord))) ==
+        fileAttributes.nFileSizeLow);
+
+    auto player = Player::Open(tempFilename, 100);
+    DeleteFileW(tempFilename);
+
+    TEST_ASSERT(nullptr != player);
+    TEST_ASSERT(kNumTestRecords == player->GetRecordCount());
+
+    for (unsigned int i = 0; i < kNumTestRecords; ++i)
+    {
+      const SRecord& record = player->GetRecord(i);
+
+      TEST_ASSERT((i % kPhysicalControllerCount) == record.controllerIdentifier);
+      TEST_ASSERT(CreatePhysicalState(i) == Recording::PhysicalStateFromRecord(record));
+
+      if (i > 0) TEST_ASSERT(record.timestamp >= player->GetRecord(i - 1).timestamp);
+    }
+  }
+
+  // Replays a recording through a mapper at explicitly-specified times, which is how replay is
+  // intended to be used for deterministic testing. The resulting virtual controller states should
+  // be identical to those produced by mapping the original physical states directly.
+  TEST_CASE(PhysicalControllerRecording_Player_DeterministicMapping)
+  {
+    const Mapper* const mapper = Mapper::GetByName(L"StandardGamepad");
+    TEST_ASSERT(nullptr != mapper);
+
+    std::vector<SRecord> records;
+    for (unsigned int i = 0; i < 100; ++i)
+      records.push_back(Recording::RecordFromPhysicalState(i * 10, 0, CreatePhysicalState(i)));
+
+    const std::vector<uint8_t> recordingContents = CreateRecordingContents(records);
+    const Player player(recordingContents.data(), recordingContents.size());
+    TEST_ASSERT(true == player.IsValid());
+
+    Mapper::SIncrementalMappingCache mappingCache;
+
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+      const SState expectedState = mapper->MapStatePhysicalToVirtual(CreatePhysicalState(i), 0);
+      const SState actualState =
+          mapper->MapStatePhysicalToVirtual(player.GetStateAt(0, (i * 10) + 5), 0, mappingCache);
+      TEST_ASSERT(actualState == expectedState);
+    }
+  }
+
+  // Replays a recording through a stepped replay source, which is how replay drives the full
+  // pipeline deterministically. Each read of a controller should produce that controller's next
+  // recorded state regardless of timestamps or of how reads of different controllers are
+  // interleaved, and mapping the states read should match mapping the original states directly.
+  TEST_CASE(PhysicalControllerRecording_ReplaySource_Stepped)
+  {
+    constexpr unsigned int kNumRecordsPerController = 25;
+    constexpr unsigned int kNumReadsPerController = kNumRecordsPerController + 5;
+
+    const Mapper* const mapper = Mapper::GetByName(L"StandardGamepad");
+    TEST_ASSERT(nullptr != mapper);
+
+    // Controllers 0 and 1 take turns changing state, and some records share a timestamp.
+    std::vector<SRecord> records;
+    for (unsigned int i = 0; i < (2 * kNumRecordsPerController); ++i)
+      records.push_back(Recording::RecordFromPhysicalState(i / 3, i % 2, CreatePhysicalState(i)));
+
+    const std::vector<uint8_t> recordingContents = CreateRecordingContents(records);
+
+    ReplayPhysicalControllerSource sourceSequential(
+        std::make_unique<Player>(recordingContents.data(), recordingContents.size()), true);
+    ReplayPhysicalControllerSource sourceInterleaved(
+        std::make_unique<Player>(recordingContents.data(), recordingContents.size()), true);
+
+    std::vector<SPhysicalState> statesRead[2];
+    for (TControllerIdentifier controllerIdentifier = 0; controllerIdentifier < 2;
+         ++controllerIdentifier)
+    {
+      for (unsigned int i = 0; i < kNumReadsPerController; ++i)
+        statesRead[controllerIdentifier].push_back(
+            sourceSequential.ReadState(controllerIdentifier));
+    }
+
+    for (TControllerIdentifier controllerIdentifier = 0; controllerIdentifier < 2;
+         ++controllerIdentifier)
+    {
+      Mapper::SIncrementalMappingCache mappingCache;
+
+      for (unsigned int i = 0; i < kNumReadsPerController; ++i)
+      {
+        const unsigned int expectedStateSeed =
+            (2 * std::min(i, kNumRecordsPerController - 1)) + controllerIdentifier;
+        const SPhysicalState expectedState = CreatePhysicalState(expectedStateSeed);
+
+        TEST_ASSERT(expectedState == statesRead[controllerIdentifier][i]);
+        TEST_ASSERT(
+            mapper->MapStatePhysicalToVirtual(expectedState, controllerIdentifier) ==
+            mapper->MapStatePhysicalToVirtual(
+                statesRead[controllerIdentifier][i], controllerIdentifier, mappingCache));
+      }
+    }
+
+    for (unsigned int i = 0; i < kNumReadsPerController; ++i)
+    {
+      for (TControllerIdentifier controllerIdentifier = 0; controllerIdentifier < 2;
+           ++controllerIdentifier)
+        TEST_ASSERT(
+            statesRead[controllerIdentifier][i] ==
+            sourceInterleaved.ReadState(controllerIdentifier));
+    }
+
+    // Controllers that have no records are reported as not connected, and replay does not involve
+    // hardware.
+    TEST_ASSERT(EPhysicalDeviceStatus::NotConnected == sourceSequential.ReadState(2).deviceStatus);
+    TEST_ASSERT(false == sourceSequential.IsBackedByHardware());
+  }
+} // namespace XidiTest
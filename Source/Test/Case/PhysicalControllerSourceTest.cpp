@@ -0,0 +1,151 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file PhysicalControllerSourceTest.cpp
+ *   Unit tests for sources of physical controller state that do not involve hardware.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "PhysicalControllerSource.h"
+
+#include <cstdint>
+
+#include "ControllerTypes.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+
+  /// Sweep period used for synthetic sources created by tests in this file.
+  static constexpr unsigned int kTestSweepPeriodMilliseconds = 1000;
+
+  /// Button mash rate used for synthetic sources created by tests in this file.
+  static constexpr unsigned int kTestButtonMashRatePerSecond = 20;
+
+  /// Mask of the physical buttons that are never pressed because they are unused.
+  static constexpr uint16_t kUnusedButtonMask =
+      (uint16_t)((1u << (unsigned int)EPhysicalButton::UnusedGuide) |
+                 (1u << (unsigned int)EPhysicalButton::UnusedShare));
+
+  // Verifies that two synthetic sources with identical parameters generate identical states, that
+  // all controllers are reported as connected, and that unused buttons are never pressed.
+  TEST_CASE(PhysicalControllerSource_Synthetic_Deterministic)
+  {
+    const SSyntheticSourceParameters parameters = {
+        .sweepPeriodMilliseconds = kTestSweepPeriodMilliseconds,
+        .buttonMashRatePerSecond = kTestButtonMashRatePerSecond,
+        .seed = 1234};
+
+    const SyntheticPhysicalControllerSource sourceA(parameters);
+    const SyntheticPhysicalControllerSource sourceB(parameters);
+
+    for (TControllerIdentifier controllerIdentifier = 0;
+         controllerIdentifier < kPhysicalControllerCount;
+         ++controllerIdentifier)
+    {
+      for (uint64_t elapsedMilliseconds = 0; elapsedMilliseconds < 5000; elapsedMilliseconds += 7)
+      {
+        const SPhysicalState stateA = sourceA.GetStateAt(controllerIdentifier, elapsedMilliseconds);
+        const SPhysicalState stateB = sourceB.GetStateAt(controllerIdentifier, elapsedMilliseconds);
+
+        TEST_ASSERT(stateA == stateB);
+        TEST_ASSERT(EPhysicalDeviceStatus::Ok == stateA.deviceStatus);
+        TEST_ASSERT(0 == (stateA.button.to_ulong() & kUnusedButtonMask));
+      }
+    }
+  }
+
+  // Verifies that analog sticks and triggers follow the expected sweep pattern for the first
+  // controller, which has no phase offset.
+  TEST_CASE(PhysicalControllerSource_Synthetic_Sweep)
+  {
+    const SyntheticPhysicalControllerSource source(
+        {.sweepPeriodMilliseconds = kTestSweepPeriodMilliseconds, .buttonMashRatePerSecond = 0});
+
+    const SPhysicalState stateStart = source.GetStateAt(0, 0);
+    TEST_ASSERT(0 == stateStart.stick[(int)EPhysicalStick::LeftX]);
+    TEST_ASSERT(32767 == stateStart.stick[(int)EPhysicalStick::LeftY]);
+    TEST_ASSERT(0 == stateStart.trigger[(int)EPhysicalTrigger::LT]);
+    TEST_ASSERT(255 == stateStart.trigger[(int)EPhysicalTrigger::RT]);
+
+    const SPhysicalState stateQuarter = source.GetStateAt(0, kTestSweepPeriodMilliseconds / 4);
+    TEST_ASSERT(32767 == stateQuarter.stick[(int)EPhysicalStick::LeftX]);
+    TEST_ASSERT(0 == stateQuarter.stick[(int)EPhysicalStick::LeftY]);
+
+    const SPhysicalState stateHalf = source.GetStateAt(0, kTestSweepPeriodMilliseconds / 2);
+    TEST_ASSERT(255 == stateHalf.trigger[(int)EPhysicalTrigger::LT]);
+    TEST_ASSERT(0 == stateHalf.trigger[(int)EPhysicalTrigger::RT]);
+
+    TEST_ASSERT(stateStart == source.GetStateAt(0, kTestSweepPeriodMilliseconds));
+  }
+
+  // Verifies that each controller is offset in phase from the previous controller by an equal
+  // fraction of the sweep period.
+  TEST_CASE(PhysicalControllerSource_Synthetic_PhaseOffset)
+  {
+    const SyntheticPhysicalControllerSource source(
+        {.sweepPeriodMilliseconds = kTestSweepPeriodMilliseconds, .buttonMashRatePerSecond = 0});
+    constexpr uint64_t kPhaseOffset = kTestSweepPeriodMilliseconds / kPhysicalControllerCount;
+
+    for (TControllerIdentifier controllerIdentifier = 1;
+         controllerIdentifier < kPhysicalControllerCount;
+         ++controllerIdentifier)
+    {
+      for (uint64_t elapsedMilliseconds = 0; elapsedMilliseconds < 2000; elapsedMilliseconds += 13)
+        TEST_ASSERT(
+            source.GetStateAt(controllerIdentifier, elapsedMilliseconds) ==
+            source.GetStateAt(controllerIdentifier - 1, elapsedMilliseconds + kPhaseOffset));
+    }
+  }
+
+  // Verifies that the set of pressed buttons stays constant within each mash interval and changes
+  // from one interval to the next, and that no buttons are ever pressed if mashing is disabled.
+  TEST_CASE(PhysicalControllerSource_Synthetic_ButtonMash)
+  {
+    constexpr uint64_t kMashIntervalMilliseconds = 1000 / kTestButtonMashRatePerSecond;
+    constexpr unsigned int kNumMashIntervals = 100;
+
+    const SyntheticPhysicalControllerSource sourceMash(
+        {.sweepPeriodMilliseconds = kTestSweepPeriodMilliseconds,
+         .buttonMashRatePerSecond = kTestButtonMashRatePerSecond});
+    const SyntheticPhysicalControllerSource sourceNoMash(
+        {.sweepPeriodMilliseconds = kTestSweepPeriodMilliseconds, .buttonMashRatePerSecond = 0});
+
+    unsigned int numButtonChanges = 0;
+
+    for (unsigned int mashInterval = 0; mashInterval < kNumMashIntervals; ++mashInterval)
+    {
+      const uint64_t intervalStart = mashInterval * kMashIntervalMilliseconds;
+      const auto intervalButtons = sourceMash.GetStateAt(0, intervalStart).button;
+
+      for (uint64_t offset = 1; offset < kMashIntervalMilliseconds; ++offset)
+        TEST_ASSERT(intervalButtons == sourceMash.GetStateAt(0, intervalStart + offset).button);
+
+      if ((mashInterval > 0) &&
+          (intervalButtons != sourceMash.GetStateAt(0, intervalStart - 1).button))
+        numButtonChanges += 1;
+
+      TEST_ASSERT(sourceNoMash.GetStateAt(0, intervalStart).button.none());
+    }
+
+    // Changes are pseudo-random, so it is possible but extremely unlikely for two consecutive
+    // intervals to have the same buttons pressed.
+    TEST_ASSERT(numButtonChanges >= (kNumMashIntervals * 9 / 10));
+  }
+
+  // Verifies that sources not backed by hardware identify themselves as such and accept force
+  // feedback actuator values.
+  TEST_CASE(PhysicalControllerSource_Synthetic_NotBackedByHardware)
+  {
+    SyntheticPhysicalControllerSource source({});
+
+    TEST_ASSERT(false == source.IsBackedByHardware());
+    TEST_ASSERT(true == source.WriteVibration(0, {.leftMotor = 1000, .rightMotor = 2000}));
+    TEST_ASSERT(EPhysicalDeviceStatus::Ok == source.ReadState(0).deviceStatus);
+  }
+} // namespace XidiTest
@@ -0,0 +1,162 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ReadCopyUpdateTest.cpp
+ *   Unit tests for publishing read-only objects that can be replaced while they are being read.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "ReadCopyUpdate.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace XidiTest
+{
+  using namespace ::Xidi;
+
+  /// Object type used for tests. Destruction overwrites the contents, so that readers using an
+  /// object after it was destroyed are likely to notice.
+  struct STestObject
+  {
+    /// Value that identifies the object.
+    int value;
+
+    /// Copy of the identifying value, used to detect objects that were destroyed.
+    int check;
+
+    STestObject(int value) : value(value), check(value) {}
+
+    ~STestObject(void)
+    {
+      value = -1;
+      check = -2;
+    }
+  };
+
+  // Verifies that the initial object is published as generation 0.
+  TEST_CASE(ReadCopyUpdate_Read_Initial)
+  {
+    const ReadCopyUpdate<STestObject> rcu(std::make_unique<const STestObject>(10));
+    const ReadCopyUpdate<STestObject>::ReadGuard guard = rcu.Read();
+
+    TEST_ASSERT(0 == guard.GetGeneration());
+    TEST_ASSERT(10 == guard->value);
+    TEST_ASSERT(10 == (*guard).check);
+  }
+
+  // Verifies that each publish operation returns the previously-published object, increments the
+  // generation, and causes subsequent reads to see the new object.
+  TEST_CASE(ReadCopyUpdate_Publish_Nominal)
+  {
+    ReadCopyUpdate<STestObject> rcu(std::make_unique<const STestObject>(0));
+
+    for (int i = 1; i <= 5; ++i)
+    {
+      const std::unique_ptr<const STestObject> oldObject =
+          rcu.Publish(std::make_unique<const STestObject>(i));
+      TEST_ASSERT(nullptr != oldObject);
+      TEST_ASSERT((i - 1) == oldObject->value);
+
+      const ReadCopyUpdate<STestObject>::ReadGuard guard = rcu.Read();
+      TEST_ASSERT((uint64_t)i == guard.GetGeneration());
+      TEST_ASSERT(i == guard->value);
+    }
+  }
+
+  // Verifies that a publish operation does not return the previously-published object until the
+  // reader that is using it is finished, and that the reader continues to see the old object in
+  // the meantime.
+  TEST_CASE(ReadCopyUpdate_Publish_WaitsForReader)
+  {
+    ReadCopyUpdate<STestObject> rcu(std::make_unique<const STestObject>(1));
+    std::atomic<bool> publishFinished = false;
+    std::unique_ptr<const STestObject> oldObject;
+
+    std::unique_ptr<ReadCopyUpdate<STestObject>::ReadGuard> guard(
+        new ReadCopyUpdate<STestObject>::ReadGuard(rcu.Read()));
+
+    std::thread writer(
+        [&rcu, &publishFinished, &oldObject]() -> void
+        {
+          oldObject = rcu.Publish(std::make_unique<const STestObject>(2));
+          publishFinished = true;
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    TEST_ASSERT(false == publishFinished);
+    TEST_ASSERT(1 == (*guard)->value);
+    TEST_ASSERT(1 == (*guard)->check);
+
+    // Readers that arrive while the writer is waiting see the new object and do not block.
+    do
+    {
+      const ReadCopyUpdate<STestObject>::ReadGuard newGuard = rcu.Read();
+      TEST_ASSERT(1 == newGuard.GetGeneration());
+      TEST_ASSERT(2 == newGuard->value);
+    } while (false);
+
+    guard = nullptr;
+    writer.join();
+
+    TEST_ASSERT(true == publishFinished);
+    TEST_ASSERT(nullptr != oldObject);
+    TEST_ASSERT(1 == oldObject->value);
+  }
+
+  // Verifies that readers running concurrently with a writer never observe an object that was
+  // already destroyed, and that generations observed by each reader never decrease.
+  TEST_CASE(ReadCopyUpdate_ConcurrentReadPublish)
+  {
+    constexpr int kNumPublishes = 20000;
+    constexpr unsigned int kNumReaders = 3;
+
+    ReadCopyUpdate<STestObject> rcu(std::make_unique<const STestObject>(0));
+    std::atomic<bool> writerFinished = false;
+    std::atomic<unsigned int> numInvalidObservations = 0;
+
+    std::thread readers[kNumReaders];
+    for (auto& reader : readers)
+    {
+      reader = std::thread(
+          [&rcu, &writerFinished, &numInvalidObservations]() -> void
+          {
+            uint64_t lastGeneration = 0;
+
+            while (false == writerFinished)
+            {
+              const ReadCopyUpdate<STestObject>::ReadGuard guard = rcu.Read();
+
+              if ((guard->value != guard->check) || (guard->value < 0) ||
+                  ((uint64_t)guard->value != guard.GetGeneration()) ||
+                  (guard.GetGeneration() < lastGeneration))
+                numInvalidObservations += 1;
+
+              lastGeneration = guard.GetGeneration();
+            }
+          });
+    }
+
+    for (int i = 1; i <= kNumPublishes; ++i)
+    {
+      const std::unique_ptr<const STestObject> oldObject =
+          rcu.Publish(std::make_unique<const STestObject>(i));
+      if ((i - 1) != oldObject->value) numInvalidObservations += 1;
+    }
+
+    writerFinished = true;
+    for (auto& reader : readers)
+      reader.join();
+
+    TEST_ASSERT(0 == numInvalidObservations);
+    TEST_ASSERT(kNumPublishes == rcu.Read()->value);
+  }
+} // namespace XidiTest
@@ -0,0 +1,141 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file ResponseCurveTest.cpp
+ *   Unit tests for response curves that reshape analog values before they are contributed to
+ *   virtual controller axes.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "ResponseCurve.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "ControllerTypes.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+
+  /// Response curve descriptions exercised by most of the tests in this file.
+  static const ResponseCurve::SSpec kTestSpecs[] = {
+      {.type = ResponseCurve::EType::Exponential, .parameter = ResponseCurve::kExponentPercentMin},
+      {.type = ResponseCurve::EType::Exponential, .parameter = 200},
+      {.type = ResponseCurve::EType::Exponential, .parameter = ResponseCurve::kExponentPercentMax},
+      {.type = ResponseCurve::EType::SCurve, .parameter = ResponseCurve::kStrengthPercentMin},
+      {.type = ResponseCurve::EType::SCurve, .parameter = ResponseCurve::kStrengthPercentMax},
+      {.type = ResponseCurve::EType::Piecewise,
+       .pointCount = 1,
+       .points = {{{.inputPercent = 50, .outputPercent = 20}}}},
+      {.type = ResponseCurve::EType::Piecewise,
+       .pointCount = 3,
+       .points = {
+           {{.inputPercent = 10, .outputPercent = 0},
+            {.inputPercent = 60, .outputPercent = 30},
+            {.inputPercent = 90, .outputPercent = 100}}}}};
+
+  // Verifies that every curve maps neutral to neutral and both extremes to themselves, for both
+  // analog and trigger values.
+  TEST_CASE(ResponseCurve_NeutralAndExtremes)
+  {
+    for (const auto& spec : kTestSpecs)
+    {
+      const ResponseCurve& responseCurve = ResponseCurve::Get(spec);
+
+      TEST_ASSERT(kAnalogValueNeutral == responseCurve.ApplyToAnalog(kAnalogValueNeutral));
+      TEST_ASSERT(kAnalogValueMax == responseCurve.ApplyToAnalog(kAnalogValueMax));
+      TEST_ASSERT(kAnalogValueMin == responseCurve.ApplyToAnalog(kAnalogValueMin));
+      TEST_ASSERT(
+          kAnalogValueMin == responseCurve.ApplyToAnalog(std::numeric_limits<int16_t>::min()));
+
+      TEST_ASSERT(kTriggerValueMin == responseCurve.ApplyToTrigger(kTriggerValueMin));
+      TEST_ASSERT(kTriggerValueMax == responseCurve.ApplyToTrigger(kTriggerValueMax));
+    }
+  }
+
+  // Verifies that every curve treats displacements in the positive and negative directions
+  // identically, apart from their sign.
+  TEST_CASE(ResponseCurve_Symmetry)
+  {
+    for (const auto& spec : kTestSpecs)
+    {
+      const ResponseCurve& responseCurve = ResponseCurve::Get(spec);
+
+      for (int32_t analogValue = kAnalogValueNeutral; analogValue <= kAnalogValueMax;
+           ++analogValue)
+        TEST_ASSERT(
+            responseCurve.ApplyToAnalog((int16_t)analogValue) ==
+            -responseCurve.ApplyToAnalog((int16_t)-analogValue));
+    }
+  }
+
+  // Verifies that the lookup tables hold the result of evaluating each curve directly, to within
+  // rounding, for every possible analog and trigger value.
+  TEST_CASE(ResponseCurve_MatchesDirectEvaluation)
+  {
+    for (const auto& spec : kTestSpecs)
+    {
+      const ResponseCurve& responseCurve = ResponseCurve::Get(spec);
+
+      for (int32_t analogValue = kAnalogValueNeutral; analogValue <= kAnalogValueMax;
+           ++analogValue)
+      {
+        const double expectedValue = ResponseCurve::EvaluateNormalized(
+                                         spec, (double)analogValue / (double)kAnalogValueMax) *
+            (double)kAnalogValueMax;
+        const double actualValue = (double)responseCurve.ApplyToAnalog((int16_t)analogValue);
+        TEST_ASSERT(std::abs(actualValue - expectedValue) <= 0.5);
+      }
+
+      for (int32_t triggerValue = kTriggerValueMin; triggerValue <= kTriggerValueMax;
+           ++triggerValue)
+      {
+        const double expectedValue = ResponseCurve::EvaluateNormalized(
+                                         spec, (double)triggerValue / (double)kTriggerValueMax) *
+            (double)kTriggerValueMax;
+        const double actualValue = (double)responseCurve.ApplyToTrigger((uint8_t)triggerValue);
+        TEST_ASSERT(std::abs(actualValue - expectedValue) <= 0.5);
+      }
+    }
+  }
+
+  // Verifies that piecewise curves pass exactly through their control points and interpolate
+  // linearly between them.
+  TEST_CASE(ResponseCurve_Piecewise_ControlPoints)
+  {
+    const ResponseCurve::SSpec kSpec = {
+        .type = ResponseCurve::EType::Piecewise,
+        .pointCount = 2,
+        .points = {
+            {{.inputPercent = 25, .outputPercent = 50},
+             {.inputPercent = 75, .outputPercent = 60}}}};
+
+    TEST_ASSERT(0.0 == ResponseCurve::EvaluateNormalized(kSpec, 0.0));
+    TEST_ASSERT(0.25 == ResponseCurve::EvaluateNormalized(kSpec, 0.125));
+    TEST_ASSERT(0.5 == ResponseCurve::EvaluateNormalized(kSpec, 0.25));
+    TEST_ASSERT(0.55 == ResponseCurve::EvaluateNormalized(kSpec, 0.5));
+    TEST_ASSERT(0.6 == ResponseCurve::EvaluateNormalized(kSpec, 0.75));
+    TEST_ASSERT(1.0 == ResponseCurve::EvaluateNormalized(kSpec, 1.0));
+  }
+
+  // Verifies that requesting the same curve twice produces the same object and that different
+  // curves produce different objects.
+  TEST_CASE(ResponseCurve_Sharing)
+  {
+    const ResponseCurve::SSpec kSpecA = {
+        .type = ResponseCurve::EType::Exponential, .parameter = 150};
+    const ResponseCurve::SSpec kSpecB = {
+        .type = ResponseCurve::EType::Exponential, .parameter = 151};
+
+    TEST_ASSERT(&ResponseCurve::Get(kSpecA) == &ResponseCurve::Get(kSpecA));
+    TEST_ASSERT(&ResponseCurve::Get(kSpecA) != &ResponseCurve::Get(kSpecB));
+    TEST_ASSERT(kSpecA == ResponseCurve::Get(kSpecA).GetSpec());
+  }
+} // namespace XidiTest
@@ -0,0 +1,91 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file SeqLockTest.cpp
+ *   Unit tests for publishing small values that can be read concurrently with being written.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "SeqLock.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace XidiTest
+{
+  using namespace ::Xidi;
+
+  /// Value type used for tests. Spans several words, all of which hold the same number, so that a
+  /// torn value is easy to detect.
+  struct STestValue
+  {
+    /// Identical copies of the same number.
+    std::array<int32_t, 9> copies;
+
+    constexpr STestValue(int32_t number = 0) : copies()
+    {
+      copies.fill(number);
+    }
+  };
+
+  // Verifies that the initial value is published and that stored values replace it.
+  TEST_CASE(SeqLock_StoreAndLoad)
+  {
+    SeqLock<STestValue> seqLock(STestValue(10));
+    TEST_ASSERT(STestValue(10).copies == seqLock.Load().copies);
+
+    seqLock.Store(STestValue(20));
+    TEST_ASSERT(STestValue(20).copies == seqLock.Load().copies);
+
+    seqLock.Store(STestValue(30));
+    TEST_ASSERT(STestValue(30).copies == seqLock.Load().copies);
+  }
+
+  // Verifies that readers running concurrently with a writer never observe a torn value and never
+  // observe values going backwards.
+  TEST_CASE(SeqLock_ConcurrentReadWrite)
+  {
+    constexpr int32_t kNumStores = 200000;
+    SeqLock<STestValue> seqLock(STestValue(0));
+    std::atomic<bool> writerFinished = false;
+
+    std::thread writer(
+        [&seqLock, &writerFinished]() -> void
+        {
+          for (int32_t i = 1; i <= kNumStores; ++i)
+            seqLock.Store(STestValue(i));
+
+          writerFinished = true;
+        });
+
+    unsigned int numTornValues = 0;
+    unsigned int numBackwardsValues = 0;
+    int32_t lastObservedNumber = 0;
+
+    while (false == writerFinished)
+    {
+      const STestValue value = seqLock.Load();
+
+      for (const auto number : value.copies)
+      {
+        if (number != value.copies[0]) numTornValues += 1;
+      }
+
+      if (value.copies[0] < lastObservedNumber) numBackwardsValues += 1;
+      lastObservedNumber = value.copies[0];
+    }
+
+    writer.join();
+
+    TEST_ASSERT(0 == numTornValues);
+    TEST_ASSERT(0 == numBackwardsValues);
+    TEST_ASSERT(STestValue(kNumStores).copies == seqLock.Load().copies);
+  }
+} // namespace XidiTest
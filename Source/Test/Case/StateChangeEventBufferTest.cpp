@@ -13,8 +13,11 @@
 
 #include "StateChangeEventBuffer.h"
 
+#include <atomic>
 #include <cstdint>
+#include <thread>
 
+#include "Clock.h"
 #include "ControllerTypes.h"
 
 namespace XidiTest
@@ -52,7 +55,7 @@ namespace XidiTest
 
   /// Dummy timestamp value to use.
   /// This set of tests does not exercise timestamp generation functionality.
-  constexpr uint32_t kTimestamp = 0;
+  constexpr ::Xidi::Clock::TTimestamp kTimestamp = 0;
 
   // Verifies correct behavior in the nominal case of inserting some events and then removing them
   // in order. The event buffer capacity is well above number of events being inserted, so there is
@@ -297,4 +300,279 @@ namespace XidiTest
     testEventBuffer.SetCapacity(0);
     TEST_ASSERT(false == testEventBuffer.IsEnabled());
   }
+
+  // Verifies that peeking at events returns the oldest events without removing them and without
+  // clearing an overflow condition.
+  TEST_CASE(StateChangeEventBuffer_ReadPeek)
+  {
+    constexpr uint32_t kEventBufferCapacity = _countof(kTestEventData) / 2;
+    constexpr uint32_t kExpectedEventCount = kEventBufferCapacity - 1;
+    constexpr uint32_t kNumEventsToPeek = kExpectedEventCount / 2;
+
+    StateChangeEventBuffer testEventBuffer;
+    testEventBuffer.SetCapacity(kEventBufferCapacity);
+
+    for (const auto& testEventData : kTestEventData)
+      testEventBuffer.AppendEvent(testEventData, kTimestamp);
+
+    TEST_ASSERT(true == testEventBuffer.IsOverflowed());
+
+    uint32_t numEventsVisited = 0;
+    const StateChangeEventBuffer::SReadResult readResult = testEventBuffer.ReadOldestEvents(
+        kNumEventsToPeek,
+        false,
+        [&numEventsVisited](uint32_t index, const StateChangeEventBuffer::SEvent& event) -> void
+        {
+          const int eventIndex = (_countof(kTestEventData) - kExpectedEventCount) + index;
+          TEST_ASSERT(index == numEventsVisited);
+          TEST_ASSERT(kTestEventData[eventIndex] == event.data);
+          numEventsVisited += 1;
+        });
+
+    TEST_ASSERT(kNumEventsToPeek == readResult.numEvents);
+    TEST_ASSERT(kNumEventsToPeek == numEventsVisited);
+    TEST_ASSERT(true == readResult.overflowed);
+    TEST_ASSERT(true == testEventBuffer.IsOverflowed());
+    TEST_ASSERT(kExpectedEventCount == testEventBuffer.GetCount());
+  }
+
+  // Verifies that reading events with removal removes exactly the events that were read and clears
+  // an overflow condition, while still reporting the overflow condition that was present at the
+  // time of reading. Reading 0 events should be a no-op, just like popping 0 events.
+  TEST_CASE(StateChangeEventBuffer_ReadRemove)
+  {
+    constexpr uint32_t kEventBufferCapacity = _countof(kTestEventData) / 2;
+    constexpr uint32_t kExpectedEventCount = kEventBufferCapacity - 1;
+    constexpr uint32_t kNumEventsToRemove = kExpectedEventCount / 2;
+
+    StateChangeEventBuffer testEventBuffer;
+    testEventBuffer.SetCapacity(kEventBufferCapacity);
+
+    for (const auto& testEventData : kTestEventData)
+      testEventBuffer.AppendEvent(testEventData, kTimestamp);
+
+    const auto kIgnoreEvent = [](uint32_t, const StateChangeEventBuffer::SEvent&) -> void {};
+
+    StateChangeEventBuffer::SReadResult readResult =
+        testEventBuffer.ReadOldestEvents(0, true, kIgnoreEvent);
+    TEST_ASSERT(0 == readResult.numEvents);
+    TEST_ASSERT(true == readResult.overflowed);
+    TEST_ASSERT(true == testEventBuffer.IsOverflowed());
+
+    readResult = testEventBuffer.ReadOldestEvents(kNumEventsToRemove, true, kIgnoreEvent);
+    TEST_ASSERT(kNumEventsToRemove == readResult.numEvents);
+    TEST_ASSERT(true == readResult.overflowed);
+    TEST_ASSERT(false == testEventBuffer.IsOverflowed());
+    TEST_ASSERT((kExpectedEventCount - kNumEventsToRemove) == testEventBuffer.GetCount());
+
+    const int firstRemainingEventIndex =
+        (_countof(kTestEventData) - kExpectedEventCount) + kNumEventsToRemove;
+    TEST_ASSERT(kTestEventData[firstRemainingEventIndex] == testEventBuffer[0].data);
+
+    // Asking for more events than are present should read and remove all of them.
+    readResult = testEventBuffer.ReadOldestEvents(kEventBufferCapacity, true, kIgnoreEvent);
+    TEST_ASSERT((kExpectedEventCount - kNumEventsToRemove) == readResult.numEvents);
+    TEST_ASSERT(false == readResult.overflowed);
+    TEST_ASSERT(0 == testEventBuffer.GetCount());
+  }
+
+  // Verifies that a buffer with capacity 1 never holds any events, since one space must always be
+  // free, and therefore overflows whenever an event is appended.
+  TEST_CASE(StateChangeEventBuffer_OverflowCapacityOne)
+  {
+    StateChangeEventBuffer testEventBuffer;
+    testEventBuffer.SetCapacity(1);
+
+    testEventBuffer.AppendEvent(kTestEventData[0], kTimestamp);
+    TEST_ASSERT(0 == testEventBuffer.GetCount());
+    TEST_ASSERT(true == testEventBuffer.IsOverflowed());
+
+    testEventBuffer.PopOldestEvents(1);
+    TEST_ASSERT(false == testEventBuffer.IsOverflowed());
+  }
+
+  // Verifies that a consumer reading and removing events concurrently with a producer appending
+  // them only ever observes complete events, in order, with no gaps other than those caused by
+  // the producer discarding the oldest events on overflow.
+  TEST_CASE(StateChangeEventBuffer_ConcurrentAppendAndRead)
+  {
+    constexpr int32_t kNumAppends = 200000;
+    constexpr uint32_t kEventBufferCapacity = 64;
+
+    StateChangeEventBuffer testEventBuffer;
+    testEventBuffer.SetCapacity(kEventBufferCapacity);
+    std::atomic<bool> producerFinished = false;
+
+    std::thread producer(
+        [&testEventBuffer, &producerFinished]() -> void
+        {
+          for (int32_t i = 1; i <= kNumAppends; ++i)
+            testEventBuffer.AppendEvent(
+                {.element = {.type = EElementType::Axis, .axis = EAxis::X}, .value = {.axis = i}},
+                (uint32_t)i);
+
+          producerFinished = true;
+        });
+
+    unsigned int numInvalidEvents = 0;
+    unsigned int numGapsWithoutOverflow = 0;
+    int32_t lastValueSeen = 0;
+
+    while (true)
+    {
+      const bool producerFinishedBeforeRead = producerFinished;
+      int32_t firstValueRead = 0;
+      int32_t lastValueRead = 0;
+
+      const StateChangeEventBuffer::SReadResult readResult = testEventBuffer.ReadOldestEvents(
+          kEventBufferCapacity,
+          true,
+          [&](uint32_t index, const StateChangeEventBuffer::SEvent& event) -> void
+          {
+            if ((event.data.value.axis != (int32_t)event.timestamp) ||
+                ((index > 0) && (event.data.value.axis != (lastValueRead + 1))))
+              numInvalidEvents += 1;
+
+            if (0 == index) firstValueRead = event.data.value.axis;
+            lastValueRead = event.data.value.axis;
+          });
+
+      TEST_ASSERT(readResult.numEvents < kEventBufferCapacity);
+
+      if (readResult.numEvents > 0)
+      {
+        if ((firstValueRead != (lastValueSeen + 1)) && (false == readResult.overflowed))
+          numGapsWithoutOverflow += 1;
+
+        lastValueSeen = lastValueRead;
+      }
+      else if (true == producerFinishedBeforeRead)
+      {
+        break;
+      }
+    }
+
+    producer.join();
+
+    TEST_ASSERT(0 == numInvalidEvents);
+    TEST_ASSERT(0 == numGapsWithoutOverflow);
+    TEST_ASSERT(kNumAppends == lastValueSeen);
+  }
+
+  // Verifies that, when coalescing axis events, an axis event updates the unread event for the
+  // same axis in place, keeping its position and sequence number, but only if no button or POV
+  // event was appended after it and only if it has not already been removed. Button and POV events
+  // are always appended.
+  TEST_CASE(StateChangeEventBuffer_CoalesceAxisEvents)
+  {
+    constexpr uint32_t kEventBufferCapacity = 16;
+    constexpr StateChangeEventBuffer::SEventData kTestButtonEventData = {
+        .element = {.type = EElementType::Button, .button = EButton::B1},
+        .value = {.button = true}};
+
+    StateChangeEventBuffer testEventBuffer(true);
+    testEventBuffer.SetCapacity(kEventBufferCapacity);
+    TEST_ASSERT(true == testEventBuffer.IsCoalescingAxisEvents());
+
+    testEventBuffer.AppendEvent(
+        {.element = {.type = EElementType::Axis, .axis = EAxis::X}, .value = {.axis = 1}}, 1);
+    testEventBuffer.AppendEvent(
+        {.element = {.type = EElementType::Axis, .axis = EAxis::Y}, .value = {.axis = 2}}, 2);
+    const uint32_t kExpectedSequenceX = testEventBuffer[0].sequence;
+
+    testEventBuffer.AppendEvent(
+        {.element = {.type = EElementType::Axis, .axis = EAxis::X}, .value = {.axis = 3}}, 3);
+    TEST_ASSERT(2 == testEventBuffer.GetCount());
+    TEST_ASSERT(EAxis::X == testEventBuffer[0].data.element.axis);
+    TEST_ASSERT(3 == testEventBuffer[0].data.value.axis);
+    TEST_ASSERT(3 == testEventBuffer[0].timestamp);
+    TEST_ASSERT(kExpectedSequenceX == testEventBuffer[0].sequence);
+    TEST_ASSERT(EAxis::Y == testEventBuffer[1].data.element.axis);
+    TEST_ASSERT(2 == testEventBuffer[1].data.value.axis);
+
+    // Events for the same button are never coalesced.
+    testEventBuffer.AppendEvent(kTestButtonEventData, 4);
+    testEventBuffer.AppendEvent(kTestButtonEventData, 5);
+    TEST_ASSERT(4 == testEventBuffer.GetCount());
+
+    // The axis event that was coalesced into earlier now precedes button events.
+    testEventBuffer.AppendEvent(
+        {.element = {.type = EElementType::Axis, .axis = EAxis::X}, .value = {.axis = 6}}, 6);
+    TEST_ASSERT(5 == testEventBuffer.GetCount());
+    TEST_ASSERT(6 == testEventBuffer[4].data.value.axis);
+    TEST_ASSERT(testEventBuffer[4].sequence > testEventBuffer[3].sequence);
+
+    // Events that have been removed cannot be coalesced into.
+    testEventBuffer.PopOldestEvents(kEventBufferCapacity);
+    testEventBuffer.AppendEvent(
+        {.element = {.type = EElementType::Axis, .axis = EAxis::X}, .value = {.axis = 7}}, 7);
+    TEST_ASSERT(1 == testEventBuffer.GetCount());
+    TEST_ASSERT(7 == testEventBuffer[0].data.value.axis);
+    TEST_ASSERT(false == testEventBuffer.IsOverflowed());
+  }
+
+  // Verifies that a consumer reading and removing events concurrently with a producer coalescing
+  // them never removes an event without observing its most recent value. A single axis is moved
+  // continuously, so the buffer never holds more than one event and never overflows, and the
+  // consumer must eventually observe the final axis value.
+  TEST_CASE(StateChangeEventBuffer_ConcurrentCoalesceAndRead)
+  {
+    constexpr int32_t kNumAppends = 200000;
+    constexpr uint32_t kEventBufferCapacity = 4;
+
+    StateChangeEventBuffer testEventBuffer(true);
+    testEventBuffer.SetCapacity(kEventBufferCapacity);
+    std::atomic<bool> producerFinished = false;
+
+    std::thread producer(
+        [&testEventBuffer, &producerFinished]() -> void
+        {
+          for (int32_t i = 1; i <= kNumAppends; ++i)
+            testEventBuffer.AppendEvent(
+                {.element = {.type = EElementType::Axis, .axis = EAxis::X}, .value = {.axis = i}},
+                (uint32_t)i);
+
+          producerFinished = true;
+        });
+
+    unsigned int numInvalidEvents = 0;
+    unsigned int numOverflows = 0;
+    int32_t lastValueSeen = 0;
+
+    while (true)
+    {
+      const bool producerFinishedBeforeRead = producerFinished;
+      int32_t lastValueRead = 0;
+
+      const StateChangeEventBuffer::SReadResult readResult = testEventBuffer.ReadOldestEvents(
+          kEventBufferCapacity,
+          true,
+          [&](uint32_t index, const StateChangeEventBuffer::SEvent& event) -> void
+          {
+            if ((event.data.value.axis != (int32_t)event.timestamp) ||
+                (event.data.value.axis <= lastValueRead))
+              numInvalidEvents += 1;
+
+            lastValueRead = event.data.value.axis;
+          });
+
+      if (true == readResult.overflowed) numOverflows += 1;
+
+      if (readResult.numEvents > 0)
+      {
+        if (lastValueRead <= lastValueSeen) numInvalidEvents += 1;
+        lastValueSeen = lastValueRead;
+      }
+      else if (true == producerFinishedBeforeRead)
+      {
+        break;
+      }
+    }
+
+    producer.join();
+
+    TEST_ASSERT(0 == numInvalidEvents);
+    TEST_ASSERT(0 == numOverflows);
+    TEST_ASSERT(kNumAppends == lastValueSeen);
+  }
 } // namespace XidiTest
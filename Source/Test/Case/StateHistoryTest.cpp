@@ -0,0 +1,126 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file StateHistoryTest.cpp
+ *   Unit tests for the lock-free history of recent timestamped virtual controller states.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "StateHistory.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "ControllerTypes.h"
+#include "Utilities.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+
+  // Verifies that an empty history has no state as of any time.
+  TEST_CASE(StateHistory_Empty)
+  {
+    const auto history = std::make_unique<StateHistory>();
+
+    TEST_ASSERT(0 == history->GetAppendCount());
+    TEST_ASSERT(false == history->GetEntry(0).has_value());
+    TEST_ASSERT(false == history->GetStateAsOf(0).has_value());
+    TEST_ASSERT(false == history->GetStateAsOf(UINT64_MAX).has_value());
+  }
+
+  // Verifies that the state as of any given time is the most recent state appended at or before
+  // that time, and that times earlier than the first state resolve to the first state.
+  TEST_CASE(StateHistory_StateAsOf)
+  {
+    const auto history = std::make_unique<StateHistory>();
+
+    history->Append(100, CreateState(1));
+    history->Append(200, CreateState(2));
+    history->Append(300, CreateState(3));
+
+    TEST_ASSERT(3 == history->GetAppendCount());
+    TEST_ASSERT(CreateState(1) == history->GetStateAsOf(0));
+    TEST_ASSERT(CreateState(1) == history->GetStateAsOf(100));
+    TEST_ASSERT(CreateState(1) == history->GetStateAsOf(199));
+    TEST_ASSERT(CreateState(2) == history->GetStateAsOf(200));
+    TEST_ASSERT(CreateState(2) == history->GetStateAsOf(299));
+    TEST_ASSERT(CreateState(3) == history->GetStateAsOf(300));
+    TEST_ASSERT(CreateState(3) == history->GetStateAsOf(UINT64_MAX));
+  }
+
+  // Verifies that once the history wraps around only the most recent entries are retained, and
+  // that queries for times older than the retained entries resolve to the oldest retained entry.
+  TEST_CASE(StateHistory_WrapAround)
+  {
+    constexpr unsigned int kNumAppends = StateHistory::kCapacity * 3;
+    const auto history = std::make_unique<StateHistory>();
+
+    for (unsigned int i = 0; i < kNumAppends; ++i)
+      history->Append((uint64_t)(10 * i), CreateState((int32_t)i));
+
+    const unsigned int kOldestRetained = kNumAppends - StateHistory::kCapacity;
+
+    TEST_ASSERT(false == history->GetEntry(kOldestRetained - 1).has_value());
+    TEST_ASSERT(true == history->GetEntry(kOldestRetained).has_value());
+    TEST_ASSERT(false == history->GetEntry(kNumAppends).has_value());
+
+    for (unsigned int i = kOldestRetained; i < kNumAppends; ++i)
+    {
+      const auto maybeEntry = history->GetEntry(i);
+      TEST_ASSERT(true == maybeEntry.has_value());
+      TEST_ASSERT(i == maybeEntry->index);
+      TEST_ASSERT((uint64_t)(10 * i) == maybeEntry->timestamp);
+      TEST_ASSERT(CreateState((int32_t)i) == maybeEntry->state);
+      TEST_ASSERT(CreateState((int32_t)i) == history->GetStateAsOf((uint64_t)(10 * i) + 5));
+    }
+
+    TEST_ASSERT(CreateState((int32_t)kOldestRetained) == history->GetStateAsOf(0));
+  }
+
+  // Verifies that readers running concurrently with a writer never observe a torn state.
+  TEST_CASE(StateHistory_ConcurrentReadWrite)
+  {
+    constexpr int32_t kNumAppends = 200000;
+    const auto history = std::make_unique<StateHistory>();
+    std::atomic<bool> writerFinished = false;
+
+    std::thread writer(
+        [&history, &writerFinished]() -> void
+        {
+          for (int32_t i = 1; i <= kNumAppends; ++i)
+            history->Append((uint64_t)i, CreateState(i));
+
+          writerFinished = true;
+        });
+
+    unsigned int numTornStates = 0;
+    int32_t lastObservedSeed = 0;
+
+    while (false == writerFinished)
+    {
+      const auto maybeState = history->GetStateAsOf(UINT64_MAX);
+      if (false == maybeState.has_value()) continue;
+
+      for (const auto axisValue : maybeState->axis)
+      {
+        if (axisValue != maybeState->axis[0]) numTornStates += 1;
+      }
+
+      lastObservedSeed = maybeState->axis[0];
+    }
+
+    writer.join();
+
+    TEST_ASSERT(0 == numTornStates);
+    TEST_ASSERT(lastObservedSeed <= kNumAppends);
+    TEST_ASSERT(CreateState(kNumAppends) == history->GetStateAsOf(UINT64_MAX));
+  }
+} // namespace XidiTest
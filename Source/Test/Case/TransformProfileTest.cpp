@@ -0,0 +1,307 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file TransformProfileTest.cpp
+ *   Unit tests for per-controller profiles of raw transformations applied to analog values read
+ *   from physical controllers.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "TransformProfile.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "Configuration.h"
+#include "ControllerMath.h"
+#include "ControllerTypes.h"
+#include "Strings.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi;
+  using namespace ::Xidi::Controller;
+  using ::Xidi::Configuration::ConfigurationData;
+  using ::Xidi::Configuration::TBooleanValue;
+  using ::Xidi::Configuration::TIntegerValue;
+
+  // Verifies that a default-constructed profile leaves every possible analog and trigger value
+  // unchanged.
+  TEST_CASE(TransformProfile_Identity)
+  {
+    const TransformProfile& identityProfile = TransformProfile::GetIdentity();
+
+    for (int analogValue = (int)std::numeric_limits<int16_t>::min();
+         analogValue <= (int)std::numeric_limits<int16_t>::max();
+         ++analogValue)
+    {
+      TEST_ASSERT(
+          (int16_t)analogValue ==
+          identityProfile.ApplyToStick(EPhysicalStick::LeftX, (int16_t)analogValue));
+      TEST_ASSERT(
+          (int16_t)analogValue ==
+          identityProfile.ApplyToStick(EPhysicalStick::RightY, (int16_t)analogValue));
+    }
+
+    for (int triggerValue = (int)std::numeric_limits<uint8_t>::min();
+         triggerValue <= (int)std::numeric_limits<uint8_t>::max();
+         ++triggerValue)
+    {
+      TEST_ASSERT(
+          (uint8_t)triggerValue ==
+          identityProfile.ApplyToTrigger(EPhysicalTrigger::LT, (uint8_t)triggerValue));
+      TEST_ASSERT(
+          (uint8_t)triggerValue ==
+          identityProfile.ApplyToTrigger(EPhysicalTrigger::RT, (uint8_t)triggerValue));
+    }
+  }
+
+  // Verifies that each analog stick axis and trigger is transformed using its own parameters.
+  TEST_CASE(TransformProfile_ExplicitParameters)
+  {
+    const TransformProfile::TStickParameters kTestStickParameters = {
+        {{10, 90}, {20, 80}, {30, 70}, {40, 60}}};
+    const TransformProfile::TTriggerParameters kTestTriggerParameters = {{{5, 95}, {45, 55}}};
+
+    const TransformProfile profile(kTestStickParameters, kTestTriggerParameters);
+
+    for (int stickIdx = 0; stickIdx < (int)EPhysicalStick::Count; ++stickIdx)
+    {
+      TEST_ASSERT(
+          kTestStickParameters[stickIdx] == profile.GetStickParameters((EPhysicalStick)stickIdx));
+
+      for (int analogValue = (int)std::numeric_limits<int16_t>::min();
+           analogValue <= (int)std::numeric_limits<int16_t>::max();
+           analogValue += 7)
+      {
+        const int16_t expectedValue = Math::ApplyRawAnalogTransform(
+            (int16_t)analogValue,
+            kTestStickParameters[stickIdx].deadzonePercent,
+            kTestStickParameters[stickIdx].saturationPercent);
+        const int16_t actualValue =
+            profile.ApplyToStick((EPhysicalStick)stickIdx, (int16_t)analogValue);
+        TEST_ASSERT(actualValue == expectedValue);
+      }
+    }
+
+    for (int triggerIdx = 0; triggerIdx < (int)EPhysicalTrigger::Count; ++triggerIdx)
+    {
+      TEST_ASSERT(
+          kTestTriggerParameters[triggerIdx] ==
+          profile.GetTriggerParameters((EPhysicalTrigger)triggerIdx));
+
+      for (int triggerValue = (int)std::numeric_limits<uint8_t>::min();
+           triggerValue <= (int)std::numeric_limits<uint8_t>::max();
+           ++triggerValue)
+      {
+        const uint8_t expectedValue = Math::ApplyRawTriggerTransform(
+            (uint8_t)triggerValue,
+            kTestTriggerParameters[triggerIdx].deadzonePercent,
+            kTestTriggerParameters[triggerIdx].saturationPercent);
+        const uint8_t actualValue =
+            profile.ApplyToTrigger((EPhysicalTrigger)triggerIdx, (uint8_t)triggerValue);
+        TEST_ASSERT(actualValue == expectedValue);
+      }
+    }
+  }
+
+  // Verifies that profiles resolved from empty configuration data do not transform anything.
+  TEST_CASE(TransformProfile_FromConfigurationData_Empty)
+  {
+    const ConfigurationData configData = {};
+
+    for (TControllerIdentifier i = 0; i < kPhysicalControllerCount; ++i)
+    {
+      const TransformProfile profile = TransformProfile::FromConfigurationData(configData, i);
+
+      for (int stickIdx = 0; stickIdx < (int)EPhysicalStick::Count; ++stickIdx)
+        TEST_ASSERT(
+            TransformProfile::kIdentityParameters ==
+            profile.GetStickParameters((EPhysicalStick)stickIdx));
+
+      for (int triggerIdx = 0; triggerIdx < (int)EPhysicalTrigger::Count; ++triggerIdx)
+        TEST_ASSERT(
+            TransformProfile::kIdentityParameters ==
+            profile.GetTriggerParameters((EPhysicalTrigger)triggerIdx));
+
+      for (unsigned int stickIdx = 0; stickIdx < TransformProfile::kStickCount; ++stickIdx)
+        TEST_ASSERT(TransformProfile::kAxialParameters == profile.GetRadialParameters(stickIdx));
+    }
+  }
+
+  // Verifies that controller-independent settings apply to all controllers, that per-controller
+  // settings override them only for the controller they name, and that settings for each analog
+  // stick and trigger are applied to the correct elements.
+  TEST_CASE(TransformProfile_FromConfigurationData_PerControllerOverride)
+  {
+    ConfigurationData configData;
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::kStrConfigurationSettingsPropertiesDeadzonePercentStickLeft,
+        TIntegerValue(10));
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::kStrConfigurationSettingsPropertiesSaturationPercentTriggerRT,
+        TIntegerValue(80));
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::PerControllerConfigurationNameString(
+            Strings::kStrConfigurationSettingsPropertiesDeadzonePercentStickLeft, 1),
+        TIntegerValue(25));
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::PerControllerConfigurationNameString(
+            Strings::kStrConfigurationSettingsPropertiesSaturationPercentStickRight, 3),
+        TIntegerValue(60));
+
+    for (TControllerIdentifier i = 0; i < kPhysicalControllerCount; ++i)
+    {
+      const TransformProfile profile = TransformProfile::FromConfigurationData(configData, i);
+
+      const TransformProfile::SParameters kExpectedStickLeftParameters = {
+          .deadzonePercent = ((1 == i) ? 25u : 10u), .saturationPercent = 100};
+      const TransformProfile::SParameters kExpectedStickRightParameters = {
+          .deadzonePercent = 0, .saturationPercent = ((3 == i) ? 60u : 100u)};
+      const TransformProfile::SParameters kExpectedTriggerLTParameters =
+          TransformProfile::kIdentityParameters;
+      const TransformProfile::SParameters kExpectedTriggerRTParameters = {
+          .deadzonePercent = 0, .saturationPercent = 80};
+
+      TEST_ASSERT(
+          kExpectedStickLeftParameters == profile.GetStickParameters(EPhysicalStick::LeftX));
+      TEST_ASSERT(
+          kExpectedStickLeftParameters == profile.GetStickParameters(EPhysicalStick::LeftY));
+      TEST_ASSERT(
+          kExpectedStickRightParameters == profile.GetStickParameters(EPhysicalStick::RightX));
+      TEST_ASSERT(
+          kExpectedStickRightParameters == profile.GetStickParameters(EPhysicalStick::RightY));
+      TEST_ASSERT(
+          kExpectedTriggerLTParameters == profile.GetTriggerParameters(EPhysicalTrigger::LT));
+      TEST_ASSERT(
+          kExpectedTriggerRTParameters == profile.GetTriggerParameters(EPhysicalTrigger::RT));
+    }
+  }
+
+  // Verifies that transforming all analog stick axes at once produces the same results as
+  // transforming them one at a time when radial processing is disabled.
+  TEST_CASE(TransformProfile_ApplyToSticks_Axial)
+  {
+    const TransformProfile profile(
+        {{{10, 90}, {20, 80}, {30, 70}, {40, 60}}}, {{{0, 100}, {0, 100}}});
+
+    for (int analogValue = (int)std::numeric_limits<int16_t>::min();
+         analogValue <= (int)std::numeric_limits<int16_t>::max();
+         analogValue += 7)
+    {
+      std::array<int16_t, (int)EPhysicalStick::Count> stickValues = {
+          (int16_t)analogValue,
+          (int16_t)(-analogValue / 2),
+          (int16_t)(analogValue / 3),
+          (int16_t)(-analogValue / 4)};
+      const std::array<int16_t, (int)EPhysicalStick::Count> rawStickValues = stickValues;
+
+      profile.ApplyToSticks(stickValues);
+
+      for (int stickIdx = 0; stickIdx < (int)EPhysicalStick::Count; ++stickIdx)
+        TEST_ASSERT(
+            stickValues[stickIdx] ==
+            profile.ApplyToStick((EPhysicalStick)stickIdx, rawStickValues[stickIdx]));
+    }
+  }
+
+  // Verifies that an analog stick for which radial processing is enabled is transformed as a
+  // vector using its horizontal axis deadzone and saturation, while the other analog stick
+  // continues to be transformed one axis at a time.
+  TEST_CASE(TransformProfile_ApplyToSticks_Radial)
+  {
+    constexpr TransformProfile::SRadialParameters kTestRadialParameters = {
+        .isEnabled = true, .antiDeadzonePercent = 15, .circleToSquare = true};
+
+    const TransformProfile profile(
+        {{{10, 90}, {10, 90}, {30, 70}, {30, 70}}},
+        {{{0, 100}, {0, 100}}},
+        {{kTestRadialParameters, TransformProfile::kAxialParameters}});
+    const Math::RadialStickTransform expectedTransform(10, 90, 15, true);
+
+    TEST_ASSERT(kTestRadialParameters == profile.GetRadialParameters(0));
+    TEST_ASSERT(TransformProfile::kAxialParameters == profile.GetRadialParameters(1));
+
+    for (int analogValue = (int)std::numeric_limits<int16_t>::min() + 1;
+         analogValue <= (int)std::numeric_limits<int16_t>::max();
+         analogValue += 7)
+    {
+      std::array<int16_t, (int)EPhysicalStick::Count> stickValues = {
+          (int16_t)analogValue,
+          (int16_t)(-analogValue / 2),
+          (int16_t)(analogValue / 3),
+          (int16_t)(-analogValue / 4)};
+      const std::array<int16_t, (int)EPhysicalStick::Count> rawStickValues = stickValues;
+
+      profile.ApplyToSticks(stickValues);
+
+      int16_t expectedValueX = rawStickValues[(int)EPhysicalStick::LeftX];
+      int16_t expectedValueY = rawStickValues[(int)EPhysicalStick::LeftY];
+      expectedTransform.Apply(expectedValueX, expectedValueY);
+
+      TEST_ASSERT(stickValues[(int)EPhysicalStick::LeftX] == expectedValueX);
+      TEST_ASSERT(stickValues[(int)EPhysicalStick::LeftY] == expectedValueY);
+      TEST_ASSERT(
+          stickValues[(int)EPhysicalStick::RightX] ==
+          profile.ApplyToStick(
+              EPhysicalStick::RightX, rawStickValues[(int)EPhysicalStick::RightX]));
+      TEST_ASSERT(
+          stickValues[(int)EPhysicalStick::RightY] ==
+          profile.ApplyToStick(
+              EPhysicalStick::RightY, rawStickValues[(int)EPhysicalStick::RightY]));
+    }
+  }
+
+  // Verifies that radial processing settings are read for each analog stick and that
+  // per-controller settings override controller-independent settings.
+  TEST_CASE(TransformProfile_FromConfigurationData_Radial)
+  {
+    ConfigurationData configData;
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::kStrConfigurationSettingsPropertiesRadialStickLeft,
+        TBooleanValue(true));
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickLeft,
+        TIntegerValue(10));
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::PerControllerConfigurationNameString(
+            Strings::kStrConfigurationSettingsPropertiesRadialStickLeft, 0),
+        TBooleanValue(false));
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::PerControllerConfigurationNameString(
+            Strings::kStrConfigurationSettingsPropertiesRadialStickRight, 2),
+        TBooleanValue(true));
+    configData.Insert(
+        Strings::kStrConfigurationSectionProperties,
+        Strings::PerControllerConfigurationNameString(
+            Strings::kStrConfigurationSettingsPropertiesCircleToSquareStickRight, 2),
+        TBooleanValue(true));
+
+    for (TControllerIdentifier i = 0; i < kPhysicalControllerCount; ++i)
+    {
+      const TransformProfile profile = TransformProfile::FromConfigurationData(configData, i);
+
+      const TransformProfile::SRadialParameters kExpectedStickLeftRadialParameters = {
+          .isEnabled = (0 != i), .antiDeadzonePercent = 10, .circleToSquare = false};
+      const TransformProfile::SRadialParameters kExpectedStickRightRadialParameters = {
+          .isEnabled = (2 == i), .antiDeadzonePercent = 0, .circleToSquare = (2 == i)};
+
+      TEST_ASSERT(kExpectedStickLeftRadialParameters == profile.GetRadialParameters(0));
+      TEST_ASSERT(kExpectedStickRightRadialParameters == profile.GetRadialParameters(1));
+    }
+  }
+} // namespace XidiTest
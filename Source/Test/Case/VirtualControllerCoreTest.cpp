@@ -0,0 +1,188 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file VirtualControllerCoreTest.cpp
+ *   Unit tests for the part of a virtual controller that is shared among all virtual controller
+ *   objects associated with the same physical controller.
+ **************************************************************************************************/
+
+#include "TestCase.h"
+
+#include "VirtualControllerCore.h"
+
+#include <array>
+#include <bitset>
+#include <memory>
+
+#include "ApiWindows.h"
+#include "ControllerTypes.h"
+#include "ElementMapper.h"
+#include "Mapper.h"
+#include "MockPhysicalController.h"
+#include "VirtualController.h"
+
+namespace XidiTest
+{
+  using namespace ::Xidi::Controller;
+
+  /// Number of virtual controllers to create for the same physical controller in each test.
+  static constexpr unsigned int kNumVirtualControllers = 4;
+
+  /// Test mapper with a single axis and a single button.
+  static const Mapper kTestMapper(
+      {.stickLeftX = std::make_unique<AxisMapper>(EAxis::X),
+       .buttonA = std::make_unique<ButtonMapper>(EButton::B1)});
+
+  /// Physical states through which tests advance. The single mapped axis is moved to its extreme
+  /// and the single mapped button is pressed in the second state.
+  static constexpr SPhysicalState kTestPhysicalStates[] = {
+      {.deviceStatus = EPhysicalDeviceStatus::Ok},
+      {.deviceStatus = EPhysicalDeviceStatus::Ok,
+       .stick = {kAnalogValueMax, 0, 0, 0},
+       .button = std::bitset<(int)EPhysicalButton::Count>(1ull << (int)EPhysicalButton::A)}};
+
+  // Verifies that all virtual controllers associated with the same physical controller share the
+  // same core, which is destroyed once none of them remain.
+  TEST_CASE(VirtualControllerCore_SharedByVirtualControllers)
+  {
+    constexpr TControllerIdentifier kControllerIndex = 0;
+
+    MockPhysicalController physicalController(kControllerIndex, kTestMapper);
+    std::array<std::unique_ptr<VirtualController>, kNumVirtualControllers> controllers;
+    std::weak_ptr<VirtualControllerCore> weakCore;
+
+    for (unsigned int i = 0; i < kNumVirtualControllers; ++i)
+    {
+      controllers[i] = std::make_unique<VirtualController>(kControllerIndex);
+
+      const std::shared_ptr<VirtualControllerCore> core =
+          VirtualControllerCore::GetForController(kControllerIndex);
+      if (0 == i)
+        weakCore = core;
+      else
+        TEST_ASSERT(weakCore.lock() == core);
+    }
+
+    TEST_ASSERT(false == weakCore.expired());
+    controllers = {};
+    TEST_ASSERT(true == weakCore.expired());
+  }
+
+  // Verifies that virtual controllers are attached when created and detached when destroyed,
+  // regardless of the order in which they are destroyed.
+  TEST_CASE(VirtualControllerCore_AttachDetach)
+  {
+    constexpr TControllerIdentifier kControllerIndex = 1;
+    constexpr unsigned int kDestructionOrder[kNumVirtualControllers] = {1, 3, 0, 2};
+
+    MockPhysicalController physicalController(kControllerIndex, kTestMapper);
+    const std::shared_ptr<VirtualControllerCore> core =
+        VirtualControllerCore::GetForController(kControllerIndex);
+    std::array<std::unique_ptr<VirtualController>, kNumVirtualControllers> controllers;
+
+    TEST_ASSERT(0 == core->GetAttachedCount());
+
+    for (unsigned int i = 0; i < kNumVirtualControllers; ++i)
+    {
+      controllers[i] = std::make_unique<VirtualController>(kControllerIndex);
+      TEST_ASSERT((i + 1) == core->GetAttachedCount());
+    }
+
+    for (unsigned int i = 0; i < kNumVirtualControllers; ++i)
+    {
+      controllers[kDestructionOrder[i]] = nullptr;
+      TEST_ASSERT((kNumVirtualControllers - (i + 1)) == core->GetAttachedCount());
+    }
+  }
+
+  // Verifies that a single physical controller state change is delivered to every virtual
+  // controller associated with that physical controller, and that each one signals its own state
+  // change event before the update pass completes.
+  TEST_CASE(VirtualControllerCore_UpdateAll)
+  {
+    constexpr TControllerIdentifier kControllerIndex = 2;
+
+    MockPhysicalController physicalController(
+        kControllerIndex, kTestMapper, kTestPhysicalStates, _countof(kTestPhysicalStates));
+    std::array<std::unique_ptr<VirtualController>, kNumVirtualControllers> controllers;
+    std::array<HANDLE, kNumVirtualControllers> stateChangeEvents;
+
+    for (unsigned int i = 0; i < kNumVirtualControllers; ++i)
+    {
+      stateChangeEvents[i] = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+      TEST_ASSERT(
+          (nullptr != stateChangeEvents[i]) && (INVALID_HANDLE_VALUE != stateChangeEvents[i]));
+
+      controllers[i] = std::make_unique<VirtualController>(kControllerIndex);
+      controllers[i]->SetStateChangeEvent(stateChangeEvents[i]);
+      TEST_ASSERT(false == controllers[i]->GetState()[EButton::B1]);
+    }
+
+    physicalController.AdvancePhysicalState();
+
+    for (unsigned int i = 0; i < kNumVirtualControllers; ++i)
+    {
+      TEST_ASSERT(WAIT_OBJECT_0 == WaitForSingleObject(stateChangeEvents[i], 0));
+      TEST_ASSERT(true == controllers[i]->GetState()[EButton::B1]);
+    }
+
+    controllers = {};
+
+    for (HANDLE stateChangeEvent : stateChangeEvents)
+      CloseHandle(stateChangeEvent);
+  }
+
+  // Verifies that virtual controllers that remain attached continue to receive state changes
+  // after one in the middle of the list is destroyed.
+  TEST_CASE(VirtualControllerCore_UpdateAfterDetach)
+  {
+    constexpr TControllerIdentifier kControllerIndex = 3;
+    constexpr unsigned int kDestroyedControllerIndex = kNumVirtualControllers / 2;
+
+    MockPhysicalController physicalController(
+        kControllerIndex, kTestMapper, kTestPhysicalStates, _countof(kTestPhysicalStates));
+    std::array<std::unique_ptr<VirtualController>, kNumVirtualControllers> controllers;
+
+    for (unsigned int i = 0; i < kNumVirtualControllers; ++i)
+      controllers[i] = std::make_unique<VirtualController>(kControllerIndex);
+
+    controllers[kDestroyedControllerIndex] = nullptr;
+    physicalController.AdvancePhysicalState();
+
+    for (unsigned int i = 0; i < kNumVirtualControllers; ++i)
+    {
+      if (kDestroyedControllerIndex == i) continue;
+      TEST_ASSERT(true == controllers[i]->GetState()[EButton::B1]);
+    }
+  }
+
+  // Verifies that virtual controllers sharing a core still apply their own properties and buffer
+  // their own events during a single update pass.
+  TEST_CASE(VirtualControllerCore_PerControllerPropertiesAndEvents)
+  {
+    constexpr TControllerIdentifier kControllerIndex = 0;
+    constexpr int32_t kTestRangeMin = -100;
+    constexpr int32_t kTestRangeMax = 100;
+    constexpr uint32_t kTestEventBufferCapacity = 16;
+
+    MockPhysicalController physicalController(
+        kControllerIndex, kTestMapper, kTestPhysicalStates, _countof(kTestPhysicalStates));
+
+    VirtualController controllerDefault(kControllerIndex);
+    VirtualController controllerCustom(kControllerIndex);
+    controllerCustom.SetAxisRange(EAxis::X, kTestRangeMin, kTestRangeMax);
+    controllerCustom.SetEventBufferCapacity(kTestEventBufferCapacity);
+
+    physicalController.AdvancePhysicalState();
+
+    TEST_ASSERT(VirtualController::kRangeMaxDefault == controllerDefault.GetState()[EAxis::X]);
+    TEST_ASSERT(0 == controllerDefault.GetEventBufferCount());
+
+    TEST_ASSERT(kTestRangeMax == controllerCustom.GetState()[EAxis::X]);
+    TEST_ASSERT(2 == controllerCustom.GetEventBufferCount());
+  }
+} // namespace XidiTest
@@ -20,6 +20,7 @@
 #include <initializer_list>
 #include <memory>
 #include <optional>
+#include <utility>
 
 #include "ApiWindows.h"
 #include "ControllerTypes.h"
@@ -328,6 +329,30 @@ namespace XidiTest
     }
   }
 
+  // Verifies that state and properties can be read while the virtual controller is locked, which
+  // shows that readers never need to obtain the lock.
+  TEST_CASE(VirtualController_GetState_WhileLocked)
+  {
+    constexpr TControllerIdentifier kControllerIndex = 1;
+    constexpr SPhysicalState kPhysicalState = {
+        .deviceStatus = EPhysicalDeviceStatus::Ok, .button = ButtonSet({EPhysicalButton::B})};
+    constexpr Controller::SState kExpectedState = {.button = 0b0010};
+    constexpr uint32_t kTestDeadzone = 1234;
+
+    MockPhysicalController physicalController(kControllerIndex, kTestMapper);
+    VirtualController controller(kControllerIndex);
+    controller.SetAllAxisRange(Controller::kAnalogValueMin, Controller::kAnalogValueMax);
+    controller.SetAllAxisDeadzone(kTestDeadzone);
+    controller.RefreshState(kTestMapper.MapStatePhysicalToVirtual(kPhysicalState, kControllerIndex));
+
+    auto lock = controller.Lock();
+    TEST_ASSERT(kExpectedState == controller.GetState());
+    TEST_ASSERT(kTestDeadzone == controller.GetAxisDeadzone(EAxis::X));
+    TEST_ASSERT(
+        std::make_pair(Controller::kAnalogValueMin, Controller::kAnalogValueMax) ==
+        controller.GetAxisRange(EAxis::Y));
+  }
+
   // Verifies that virtual controllers report everything neutral when no controller input is
   // provided and no properties have been set. In this test case no physical state has been supplied
   // to the virtual controller.
@@ -993,6 +1018,71 @@ namespace XidiTest
     }
   }
 
+  // Refreshes the virtual controller with a state in which every controller element has changed at
+  // once, with some elements filtered out. Verifies that exactly one event is generated for each
+  // element that is not filtered out, in order of axes first, then buttons, then the POV.
+  TEST_CASE(VirtualController_EventBuffer_AllElementsChangeAtOnce)
+  {
+    constexpr TControllerIdentifier kControllerIndex = 0;
+    constexpr uint32_t kEventBufferCapacity = 64;
+    constexpr EAxis kFilteredAxis = EAxis::Y;
+    constexpr EButton kFilteredButton = EButton::B3;
+
+    MockPhysicalController physicalController(kControllerIndex, kTestMapper);
+    VirtualController controller(kControllerIndex);
+
+    controller.SetAllAxisRange(Controller::kAnalogValueMin, Controller::kAnalogValueMax);
+    controller.SetEventBufferCapacity(kEventBufferCapacity);
+    controller.EventFilterRemoveElement({.type = EElementType::Axis, .axis = kFilteredAxis});
+    controller.EventFilterRemoveElement({.type = EElementType::Button, .button = kFilteredButton});
+
+    Controller::SState newState = {.povDirection = {.components = {true, false, false, false}}};
+    for (int i = 0; i < (int)EAxis::Count; ++i)
+      newState.axis[i] = 1000 * (i + 1);
+    newState.button.set();
+
+    controller.RefreshState(newState);
+
+    std::deque<Controller::SElementIdentifier> expectedElements;
+    for (int i = 0; i < (int)EAxis::Count; ++i)
+    {
+      if (kFilteredAxis != (EAxis)i)
+        expectedElements.push_back({.type = EElementType::Axis, .axis = (EAxis)i});
+    }
+    for (int i = 0; i < (int)EButton::Count; ++i)
+    {
+      if (kFilteredButton != (EButton)i)
+        expectedElements.push_back({.type = EElementType::Button, .button = (EButton)i});
+    }
+    expectedElements.push_back({.type = EElementType::Pov});
+
+    TEST_ASSERT(expectedElements.size() == controller.GetEventBufferCount());
+
+    for (unsigned int i = 0; i < controller.GetEventBufferCount(); ++i)
+    {
+      const StateChangeEventBuffer::SEvent event = controller.GetEventBufferEvent(i);
+      TEST_ASSERT(event.data.element == expectedElements[i]);
+
+      switch (event.data.element.type)
+      {
+        case EElementType::Axis:
+          TEST_ASSERT(event.data.value.axis == newState[event.data.element.axis]);
+          break;
+
+        case EElementType::Button:
+          TEST_ASSERT(true == event.data.value.button);
+          break;
+
+        case EElementType::Pov:
+          TEST_ASSERT(event.data.value.povDirection == newState.povDirection);
+          break;
+
+        default:
+          TEST_FAILED_BECAUSE(L"Unexpected element type.");
+      }
+    }
+  }
+
   // Submits multiple physical state changes to the physical controller associated with a virtual
   // controller such that every single physical state change causes a virtual controller state
   // change. Enables state change notifications and verifies that each physical controller state
@@ -1026,7 +1116,7 @@ namespace XidiTest
 
     for (int i = 1; i < _countof(kPhysicalStates); ++i)
     {
-      physicalController.RequestAdvancePhysicalState();
+      physicalController.AdvancePhysicalState();
       TEST_ASSERT(
           WAIT_OBJECT_0 ==
           WaitForSingleObject(stateChangeEvent, kTestStateChangeEventTimeoutMilliseconds));
@@ -1080,12 +1170,12 @@ namespace XidiTest
 
     for (int i = 1; i < _countof(kPhysicalStates); i += 2)
     {
-      physicalController.RequestAdvancePhysicalState();
+      physicalController.AdvancePhysicalState();
       TEST_ASSERT(
           WAIT_OBJECT_0 ==
           WaitForSingleObject(stateChangeEvent, kTestStateChangeEventTimeoutMilliseconds));
 
-      physicalController.RequestAdvancePhysicalState();
+      physicalController.AdvancePhysicalState();
       TEST_ASSERT(
           WAIT_TIMEOUT ==
           WaitForSingleObject(stateChangeEvent, kTestStateChangeEventTimeoutMilliseconds));
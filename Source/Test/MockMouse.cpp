@@ -106,6 +106,13 @@ namespace XidiTest
           mouseMovementUnits,
           kMouseMovementUnitsMax);
 
+    if (sourceIdentifier >= kMouseMovementSourceCount)
+      TEST_FAILED_BECAUSE(
+          L"%s: Mouse movement source identifier %u is not below the limit of %u.",
+          __FUNCTIONW__,
+          (unsigned int)sourceIdentifier,
+          kMouseMovementSourceCount);
+
     virtualMouseMovementContributionBySource[(unsigned int)axis][sourceIdentifier] =
         mouseMovementUnits;
   }
@@ -22,6 +22,7 @@
 #include "ForceFeedbackDevice.h"
 #include "Mapper.h"
 #include "PhysicalController.h"
+#include "StateChangeDispatcher.h"
 #include "VirtualController.h"
 
 namespace XidiTest
@@ -50,7 +51,6 @@ namespace XidiTest
         kMockPhysicalStates(mockPhysicalStates),
         kMockPhysicalStateCount(mockPhysicalStateCount),
         currentPhysicalStateIndex(0),
-        advanceRequested(false),
         forceFeedbackDevice(0),
         mapper(mapper),
         forceFeedbackRegistration()
@@ -78,14 +78,24 @@ namespace XidiTest
 
   void MockPhysicalController::AdvancePhysicalState(void)
   {
-    if (kMockPhysicalStateCount == currentPhysicalStateIndex)
-      TEST_FAILED_BECAUSE(
-          L"%s: Test implementation error due to out-of-bounds physical state advancement for physical controller with identifier %u.",
-          __FUNCTIONW__,
-          kControllerIdentifier);
+    SState newRawVirtualState;
+
+    {
+      std::unique_lock lock(mockPhysicalStateGuard[kControllerIdentifier]);
 
-    currentPhysicalStateIndex += 1;
-    advanceRequested = false;
+      if (currentPhysicalStateIndex >= (kMockPhysicalStateCount - 1))
+        TEST_FAILED_BECAUSE(
+            L"%s: Test implementation error due to out-of-bounds physical state advancement for physical controller with identifier %u.",
+            __FUNCTIONW__,
+            kControllerIdentifier);
+
+      currentPhysicalStateIndex += 1;
+      newRawVirtualState = GetCurrentRawVirtualState();
+    }
+
+    // Same as the polling thread in the real implementation, but unconditional because virtual
+    // controllers ignore raw states that do not change their processed state anyway.
+    StateChangeDispatcher::Dispatch(kControllerIdentifier, newRawVirtualState);
   }
 
   SCapabilities MockPhysicalController::GetControllerCapabilities(void) const
@@ -104,25 +114,6 @@ namespace XidiTest
   {
     return mapper.MapStatePhysicalToVirtual(GetCurrentPhysicalState(), kControllerIdentifier);
   }
-
-  void MockPhysicalController::RequestAdvancePhysicalState(void)
-  {
-    std::unique_lock lock(mockPhysicalStateGuard[kControllerIdentifier]);
-
-    if (currentPhysicalStateIndex >= (kMockPhysicalStateCount - 1))
-      TEST_FAILED_BECAUSE(
-          L"%s: Test implementation error due to out-of-bounds physical state advancement for physical controller with identifier %u.",
-          __FUNCTIONW__,
-          kControllerIdentifier);
-
-    if (true == advanceRequested)
-      TEST_FAILED_BECAUSE(
-          L"%s: Test implementation error due to unconsumed advance request for physical controller with identifier %u.",
-          __FUNCTIONW__,
-          kControllerIdentifier);
-
-    advanceRequested = true;
-  }
 } // namespace XidiTest
 
 namespace Xidi
@@ -232,57 +223,16 @@ namespace Xidi
 
         if (nullptr != mockPhysicalController[controllerIdentifier])
         {
-          std::unique_lock lock(mockPhysicalStateGuard[controllerIdentifier]);
-
-          if (nullptr != mockPhysicalController[controllerIdentifier])
-          {
-            if (mockPhysicalController[controllerIdentifier]->IsAdvanceStateRequested())
-            {
-              mockPhysicalController[controllerIdentifier]->AdvancePhysicalState();
-
-              SPhysicalState newState =
-                  mockPhysicalController[controllerIdentifier]->GetCurrentPhysicalState();
-              if (newState != state)
-              {
-                state = newState;
-                return true;
-              }
-            }
-          }
-        }
-      }
-
-      return false;
-    }
-
-    bool WaitForRawVirtualControllerStateChange(
-        TControllerIdentifier controllerIdentifier, SState& state, std::stop_token stopToken)
-    {
-      if (controllerIdentifier >= kPhysicalControllerCount)
-        TEST_FAILED_BECAUSE(
-            L"%s: Invalid controller identifier (%u).", __FUNCTIONW__, controllerIdentifier);
-
-      while (false == stopToken.stop_requested())
-      {
-        Sleep(1);
-
-        if (nullptr != mockPhysicalController[controllerIdentifier])
-        {
-          std::unique_lock lock(mockPhysicalStateGuard[controllerIdentifier]);
+          std::shared_lock lock(mockPhysicalStateGuard[controllerIdentifier]);
 
           if (nullptr != mockPhysicalController[controllerIdentifier])
           {
-            if (mockPhysicalController[controllerIdentifier]->IsAdvanceStateRequested())
+            SPhysicalState newState =
+                mockPhysicalController[controllerIdentifier]->GetCurrentPhysicalState();
+            if (newState != state)
             {
-              mockPhysicalController[controllerIdentifier]->AdvancePhysicalState();
-
-              SState newState =
-                  mockPhysicalController[controllerIdentifier]->GetCurrentRawVirtualState();
-              if (newState != state)
-              {
-                state = newState;
-                return true;
-              }
+              state = newState;
+              return true;
             }
           }
         }
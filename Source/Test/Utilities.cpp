@@ -9,14 +9,44 @@
  *   Implementation of test utility functions.
  **************************************************************************************************/
 
+#include "Utilities.h"
+
 #include <sal.h>
 #include <windows.h>
 
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
 
+#include "ControllerTypes.h"
+
 namespace XidiTest
 {
+  using namespace ::Xidi::Controller;
+
+  SPhysicalState CreatePhysicalState(unsigned int seed)
+  {
+    return {
+        .deviceStatus = EPhysicalDeviceStatus::Ok,
+        .stick =
+            {(int16_t)(seed * 101),
+             (int16_t)(seed * -203),
+             (int16_t)(seed * 307),
+             (int16_t)(seed * -409)},
+        .trigger = {(uint8_t)(seed * 3), (uint8_t)(seed * 5)},
+        .button = (uint16_t)(seed * 0x1357)};
+  }
+
+  SState CreateState(int32_t seed)
+  {
+    SState state = {};
+
+    for (auto& axisValue : state.axis)
+      axisValue = seed;
+
+    return state;
+  }
+
   void Print(const wchar_t* const str)
   {
     if (IsDebuggerPresent())
@@ -0,0 +1,276 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file TransformProfile.cpp
+ *   Implementation of per-controller profiles of raw transformations applied to analog values read
+ *   from physical controllers.
+ **************************************************************************************************/
+
+#include "TransformProfile.h"
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Configuration.h"
+#include "ControllerMath.h"
+#include "ControllerTypes.h"
+#include "Globals.h"
+#include "Message.h"
+#include "Strings.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Reads a single transformation percentage from the properties section of the specified
+    /// configuration data. A per-controller setting takes precedence over the
+    /// controller-independent setting of the same name.
+    /// @param [in] configData Configuration data from which to read.
+    /// @param [in] settingName Controller-independent name of the configuration setting.
+    /// @param [in] controllerIdentifier Identifier of the controller whose setting is desired.
+    /// @param [in] defaultValue Value to use if neither setting is present.
+    /// @return Configured percentage.
+    static unsigned int ReadTransformPercent(
+        const Configuration::ConfigurationData& configData,
+        std::wstring_view settingName,
+        TControllerIdentifier controllerIdentifier,
+        unsigned int defaultValue)
+    {
+      const std::optional<Configuration::TIntegerView> maybePerControllerValue =
+          configData.GetFirstIntegerValue(
+              Strings::kStrConfigurationSectionProperties,
+              Strings::PerControllerConfigurationNameString(settingName, controllerIdentifier));
+      if (true == maybePerControllerValue.has_value())
+        return (unsigned int)maybePerControllerValue.value();
+
+      return (unsigned int)configData
+          .GetFirstIntegerValue(Strings::kStrConfigurationSectionProperties, settingName)
+          .value_or(defaultValue);
+    }
+
+    /// Reads a single transformation flag from the properties section of the specified
+    /// configuration data. A per-controller setting takes precedence over the
+    /// controller-independent setting of the same name.
+    /// @param [in] configData Configuration data from which to read.
+    /// @param [in] settingName Controller-independent name of the configuration setting.
+    /// @param [in] controllerIdentifier Identifier of the controller whose setting is desired.
+    /// @return Configured flag, or `false` if neither setting is present.
+    static bool ReadTransformFlag(
+        const Configuration::ConfigurationData& configData,
+        std::wstring_view settingName,
+        TControllerIdentifier controllerIdentifier)
+    {
+      const std::optional<Configuration::TBooleanView> maybePerControllerValue =
+          configData.GetFirstBooleanValue(
+              Strings::kStrConfigurationSectionProperties,
+              Strings::PerControllerConfigurationNameString(settingName, controllerIdentifier));
+      if (true == maybePerControllerValue.has_value()) return maybePerControllerValue.value();
+
+      return configData
+          .GetFirstBooleanValue(Strings::kStrConfigurationSectionProperties, settingName)
+          .value_or(false);
+    }
+
+    /// Produces a short human-readable description of the radial processing parameters of an
+    /// analog stick, suitable for appending to its deadzone and saturation percentages in a log
+    /// message.
+    /// @param [in] radialParameters Radial processing parameters to describe.
+    /// @return Description, which is empty if radial processing is disabled.
+    static std::wstring RadialParametersDescription(
+        const TransformProfile::SRadialParameters& radialParameters)
+    {
+      if (false == radialParameters.isEnabled) return std::wstring();
+
+      return Strings::FormatString(
+                 L" (radial, anti-deadzone %u%%%s)",
+                 radialParameters.antiDeadzonePercent,
+                 ((true == radialParameters.circleToSquare) ? L", circle-to-square" : L""))
+          .Data();
+    }
+
+    TransformProfile::TransformProfile(void)
+        : TransformProfile(
+              {kIdentityParameters, kIdentityParameters, kIdentityParameters, kIdentityParameters},
+              {kIdentityParameters, kIdentityParameters})
+    {}
+
+    TransformProfile::TransformProfile(
+        const TStickParameters& stickParameters,
+        const TTriggerParameters& triggerParameters,
+        const TRadialParameters& radialParameters)
+        : stickParameters(stickParameters),
+          triggerParameters(triggerParameters),
+          radialParameters(radialParameters),
+          stickTransform(),
+          triggerTransform(),
+          radialTransform()
+    {
+      for (int stickIdx = 0; stickIdx < (int)EPhysicalStick::Count; ++stickIdx)
+        stickTransform[stickIdx] = Math::RawAnalogTransformTable::Get(
+            stickParameters[stickIdx].deadzonePercent, stickParameters[stickIdx].saturationPercent);
+
+      for (int triggerIdx = 0; triggerIdx < (int)EPhysicalTrigger::Count; ++triggerIdx)
+        triggerTransform[triggerIdx] = Math::RawTriggerTransformTable::Get(
+            triggerParameters[triggerIdx].deadzonePercent,
+            triggerParameters[triggerIdx].saturationPercent);
+
+      for (unsigned int stickIdx = 0; stickIdx < kStickCount; ++stickIdx)
+      {
+        if (false == radialParameters[stickIdx].isEnabled) continue;
+
+        radialTransform[stickIdx] = Math::RadialStickTransform(
+            stickParameters[2 * stickIdx].deadzonePercent,
+            stickParameters[2 * stickIdx].saturationPercent,
+            radialParameters[stickIdx].antiDeadzonePercent,
+            radialParameters[stickIdx].circleToSquare);
+      }
+    }
+
+    TransformProfile TransformProfile::FromConfigurationData(
+        const Configuration::ConfigurationData& configData,
+        TControllerIdentifier controllerIdentifier)
+    {
+      const SParameters stickLeftParameters = {
+          .deadzonePercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesDeadzonePercentStickLeft,
+              controllerIdentifier,
+              kIdentityParameters.deadzonePercent),
+          .saturationPercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesSaturationPercentStickLeft,
+              controllerIdentifier,
+              kIdentityParameters.saturationPercent)};
+      const SParameters stickRightParameters = {
+          .deadzonePercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesDeadzonePercentStickRight,
+              controllerIdentifier,
+              kIdentityParameters.deadzonePercent),
+          .saturationPercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesSaturationPercentStickRight,
+              controllerIdentifier,
+              kIdentityParameters.saturationPercent)};
+      const SParameters triggerLTParameters = {
+          .deadzonePercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesDeadzonePercentTriggerLT,
+              controllerIdentifier,
+              kIdentityParameters.deadzonePercent),
+          .saturationPercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesSaturationPercentTriggerLT,
+              controllerIdentifier,
+              kIdentityParameters.saturationPercent)};
+      const SParameters triggerRTParameters = {
+          .deadzonePercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesDeadzonePercentTriggerRT,
+              controllerIdentifier,
+              kIdentityParameters.deadzonePercent),
+          .saturationPercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesSaturationPercentTriggerRT,
+              controllerIdentifier,
+              kIdentityParameters.saturationPercent)};
+
+      const SRadialParameters stickLeftRadialParameters = {
+          .isEnabled = ReadTransformFlag(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesRadialStickLeft,
+              controllerIdentifier),
+          .antiDeadzonePercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickLeft,
+              controllerIdentifier,
+              kAxialParameters.antiDeadzonePercent),
+          .circleToSquare = ReadTransformFlag(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesCircleToSquareStickLeft,
+              controllerIdentifier)};
+      const SRadialParameters stickRightRadialParameters = {
+          .isEnabled = ReadTransformFlag(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesRadialStickRight,
+              controllerIdentifier),
+          .antiDeadzonePercent = ReadTransformPercent(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickRight,
+              controllerIdentifier,
+              kAxialParameters.antiDeadzonePercent),
+          .circleToSquare = ReadTransformFlag(
+              configData,
+              Strings::kStrConfigurationSettingsPropertiesCircleToSquareStickRight,
+              controllerIdentifier)};
+
+      return TransformProfile(
+          {stickLeftParameters, stickLeftParameters, stickRightParameters, stickRightParameters},
+          {triggerLTParameters, triggerRTParameters},
+          {stickLeftRadialParameters, stickRightRadialParameters});
+    }
+
+    const TransformProfile& TransformProfile::GetConfigured(
+        TControllerIdentifier controllerIdentifier)
+    {
+      static std::array<TransformProfile, kPhysicalControllerCount> configuredProfiles;
+      static std::once_flag configuredProfilesFlag;
+
+      std::call_once(
+          configuredProfilesFlag,
+          []() -> void
+          {
+            const Configuration::ConfigurationData& configData = Globals::GetConfigurationData();
+
+            Message::Output(
+                Message::ESeverity::Info,
+                L"Raw analog transformations assigned to controllers, as deadzone and saturation percentages...");
+            for (TControllerIdentifier i = 0; i < (TControllerIdentifier)configuredProfiles.size();
+                 ++i)
+            {
+              configuredProfiles[i] = FromConfigurationData(configData, i);
+
+              const SParameters stickLeft =
+                  configuredProfiles[i].GetStickParameters(EPhysicalStick::LeftX);
+              const SParameters stickRight =
+                  configuredProfiles[i].GetStickParameters(EPhysicalStick::RightX);
+              const SParameters triggerLT =
+                  configuredProfiles[i].GetTriggerParameters(EPhysicalTrigger::LT);
+              const SParameters triggerRT =
+                  configuredProfiles[i].GetTriggerParameters(EPhysicalTrigger::RT);
+
+              Message::OutputFormatted(
+                  Message::ESeverity::Info,
+                  L"    [%u]: LS=%u/%u%s, RS=%u/%u%s, LT=%u/%u, RT=%u/%u",
+                  (unsigned int)(1 + i),
+                  stickLeft.deadzonePercent,
+                  stickLeft.saturationPercent,
+                  RadialParametersDescription(configuredProfiles[i].GetRadialParameters(0)).c_str(),
+                  stickRight.deadzonePercent,
+                  stickRight.saturationPercent,
+                  RadialParametersDescription(configuredProfiles[i].GetRadialParameters(1)).c_str(),
+                  triggerLT.deadzonePercent,
+                  triggerLT.saturationPercent,
+                  triggerRT.deadzonePercent,
+                  triggerRT.saturationPercent);
+            }
+          });
+
+      if (controllerIdentifier >= kPhysicalControllerCount) return GetIdentity();
+      return configuredProfiles[controllerIdentifier];
+    }
+
+    const TransformProfile& TransformProfile::GetIdentity(void)
+    {
+      static const TransformProfile kIdentityProfile;
+      return kIdentityProfile;
+    }
+  } // namespace Controller
+} // namespace Xidi
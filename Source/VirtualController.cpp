@@ -11,16 +11,30 @@
 
 #include "VirtualController.h"
 
+#include <algorithm>
+#include <bit>
 #include <cstdint>
-#include <stop_token>
-#include <thread>
+#include <optional>
 
+#include "Clock.h"
 #include "ControllerTypes.h"
 #include "ForceFeedbackTypes.h"
-#include "ImportApiWinMM.h"
+#include "Globals.h"
+#include "LatencyTrace.h"
 #include "Mapper.h"
 #include "Message.h"
 #include "PhysicalController.h"
+#include "StateHistory.h"
+#include "Strings.h"
+#include "VirtualControllerCore.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+
+/// Enables the vectorized implementation of virtual controller state comparison, which requires
+/// SSE2. This instruction set is guaranteed to be available on all supported target platforms.
+#define XIDI_VIRTUAL_CONTROLLER_USE_SSE2
+#endif
 
 namespace Xidi
 {
@@ -52,86 +66,127 @@ namespace Xidi
           (int32_t)((oldRangeValueDisp * newRangeMagnitudeMax) / oldRangeMagnitudeMax);
     }
 
-    /// Monitors for changes in an associated physical controller's state and, on state change,
-    /// causes a virtual controller to refresh its state. Intended to be the entry point for
-    /// per-virtual-controller background threads.
-    /// @param [in] thisController Controller object for which state is to be monitored.
-    /// @param [in] initialState Initial physical state of the controller. Used as the basis for
-    /// looking for changes.
-    /// @param [in] stopMonitoringToken Used to indicate that the monitoring should stop and the
-    /// thread should exit.
-    static void MonitorPhysicalControllerState(
-        VirtualController* thisController,
-        const SState& initialState,
-        std::stop_token stopMonitoringToken)
+    /// Reads the state sampling delay from the configuration file.
+    /// @return Configured state sampling delay in timestamp ticks, or 0 if none is configured.
+    static StateHistory::TTimestamp ConfiguredStateSamplingDelay(void)
+    {
+      const unsigned int stateSamplingDelayMilliseconds =
+          (unsigned int)Globals::GetConfigurationData()
+              .GetFirstIntegerValue(
+                  Strings::kStrConfigurationSectionProperties,
+                  Strings::kStrConfigurationSettingPropertiesStateSamplingDelayMilliseconds)
+              .value_or(0);
+
+      return StateHistory::TimestampTicksFromMilliseconds(stateSamplingDelayMilliseconds);
+    }
+
+    /// Reads from the configuration file whether or not buffered axis events should be coalesced.
+    /// @return `true` if axis events should be coalesced, `false` otherwise.
+    static bool ConfiguredAxisEventCoalescing(void)
     {
-      const TControllerIdentifier controllerIdentifier = thisController->GetIdentifier();
-      SState state = initialState;
+      return Globals::GetConfigurationData()
+          .GetFirstBooleanValue(
+              Strings::kStrConfigurationSectionProperties,
+              Strings::kStrConfigurationSettingPropertiesCoalesceAxisEvents)
+          .value_or(false);
+    }
+
+    /// Compares the axis values of two virtual controller state objects.
+    /// @param [in] oldState Old controller state.
+    /// @param [in] newState New controller state.
+    /// @return Mask with one bit per axis, in axis enumerator order, set if the axis value differs.
+    static inline uint32_t ChangedAxisMask(const SState& oldState, const SState& newState)
+    {
+      static_assert(6 == (int)EAxis::Count, "Axis comparison assumes six axes.");
+
+#ifdef XIDI_VIRTUAL_CONTROLLER_USE_SSE2
+      // The first four axes are compared with one instruction and the remaining two with another.
+      const __m128i axisEqualLow = _mm_cmpeq_epi32(
+          _mm_loadu_si128((const __m128i*)&oldState.axis[0]),
+          _mm_loadu_si128((const __m128i*)&newState.axis[0]));
+      const __m128i axisEqualHigh = _mm_cmpeq_epi32(
+          _mm_loadl_epi64((const __m128i*)&oldState.axis[4]),
+          _mm_loadl_epi64((const __m128i*)&newState.axis[4]));
+
+      const uint32_t axisEqualMask = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(axisEqualLow)) |
+          ((uint32_t)_mm_movemask_ps(_mm_castsi128_ps(axisEqualHigh)) << 4);
+
+      return (~axisEqualMask & 0b111111);
+#else
+      uint32_t axisChangedMask = 0;
 
-      while (false == stopMonitoringToken.stop_requested())
+      for (unsigned int i = 0; i < oldState.axis.size(); ++i)
       {
-        if (true ==
-            WaitForRawVirtualControllerStateChange(
-                controllerIdentifier, state, stopMonitoringToken))
-        {
-          if (true == thisController->RefreshState(state)) thisController->SignalStateChangeEvent();
-        }
+        if (oldState.axis[i] != newState.axis[i]) axisChangedMask |= (1u << i);
       }
+
+      return axisChangedMask;
+#endif
     }
 
     /// Looks for differences between two virtual controller state objects and submits them as
     /// events to the specified event buffer. Events are only submitted if the associated virtual
-    /// controller element is included in the event filter.
+    /// controller element is included in the event filter. Differences are computed for all
+    /// controller elements at once as a mask, using the same bit positions as the event filter, so
+    /// that the filter can be applied to all of them at once and only the elements that actually
+    /// generate events need to be visited. Events are submitted in the order of their bit
+    /// positions, which means axes first, followed by buttons, followed by the POV.
     /// @param [in] oldState Old controller state, the baseline.
     /// @param [in] newState New controller state, which is compared with the old controller state.
     /// If different, controller element values submitted to the event buffer come from this object.
     /// @param [in] eventFilter Filter which specifies which virtual controller elements are allowed
     /// to generate events.
+    /// @param [in] timestamp Timestamp to associate with all submitted events.
     /// @param [in,out] eventBuffer Event buffer object to which events are submitted.
     static inline void SubmitStateChangeEvents(
         const SState& oldState,
         const SState& newState,
         const VirtualController::EventFilter& eventFilter,
+        Clock::TTimestamp timestamp,
         StateChangeEventBuffer& eventBuffer)
     {
-      if (true == eventBuffer.IsEnabled())
+      if (false == eventBuffer.IsEnabled()) return;
+
+      const uint32_t changedButtonMask =
+          (uint32_t)(oldState.button.to_ulong() ^ newState.button.to_ulong());
+      const bool povChanged = (oldState.povDirection.all != newState.povDirection.all);
+
+      uint64_t eventMask = eventFilter.GetMask() &
+          (((uint64_t)ChangedAxisMask(oldState, newState)
+            << VirtualController::EventFilter::kBaseIndexAxis) |
+           ((uint64_t)changedButtonMask << VirtualController::EventFilter::kBaseIndexButton) |
+           ((uint64_t)povChanged << VirtualController::EventFilter::kBaseIndexPov));
+
+      if (0 == eventMask) return;
+
+      for (; 0 != eventMask; eventMask &= (eventMask - 1))
       {
-        const uint32_t timestamp = ImportApiWinMM::timeGetTime();
+        const unsigned int filterIndex = (unsigned int)std::countr_zero(eventMask);
 
-        for (unsigned int i = 0; i < oldState.axis.size(); ++i)
+        if (filterIndex < VirtualController::EventFilter::kBaseIndexButton)
         {
-          if (oldState.axis[i] != newState.axis[i])
-          {
-            const SElementIdentifier axisElement = {.type = EElementType::Axis, .axis = (EAxis)i};
-
-            if (eventFilter.Contains(axisElement))
-              eventBuffer.AppendEvent(
-                  {.element = axisElement, .value = {.axis = newState.axis[i]}}, timestamp);
-          }
+          const unsigned int axisIndex =
+              filterIndex - VirtualController::EventFilter::kBaseIndexAxis;
+          eventBuffer.AppendEvent(
+              {.element = {.type = EElementType::Axis, .axis = (EAxis)axisIndex},
+               .value = {.axis = newState.axis[axisIndex]}},
+              timestamp);
         }
-
-        for (unsigned int i = 0; i < oldState.button.size(); ++i)
+        else if (filterIndex < VirtualController::EventFilter::kBaseIndexPov)
         {
-          if (oldState.button[i] != newState.button[i])
-          {
-            const SElementIdentifier buttonElement = {
-                .type = EElementType::Button, .button = (EButton)i};
-
-            if (eventFilter.Contains(buttonElement))
-              eventBuffer.AppendEvent(
-                  {.element = buttonElement, .value = {.button = newState.button[i]}}, timestamp);
-          }
+          const unsigned int buttonIndex =
+              filterIndex - VirtualController::EventFilter::kBaseIndexButton;
+          eventBuffer.AppendEvent(
+              {.element = {.type = EElementType::Button, .button = (EButton)buttonIndex},
+               .value = {.button = newState.button[buttonIndex]}},
+              timestamp);
         }
-
-        if (oldState.povDirection.all != newState.povDirection.all)
+        else
         {
-          const SElementIdentifier povElement = {.type = EElementType::Pov};
-
-          if (eventFilter.Contains(povElement))
-            eventBuffer.AppendEvent(
-                {.element = povElement,
-                 .value = {.povDirection = {.all = newState.povDirection.all}}},
-                timestamp);
+          eventBuffer.AppendEvent(
+              {.element = {.type = EElementType::Pov},
+               .value = {.povDirection = {.all = newState.povDirection.all}}},
+              timestamp);
         }
       }
     }
@@ -177,27 +232,29 @@ namespace Xidi
 
     VirtualController::VirtualController(TControllerIdentifier controllerId)
         : kControllerIdentifier(controllerId),
+          kStateSamplingDelay(ConfiguredStateSamplingDelay()),
           controllerMutex(),
-          eventBuffer(),
+          eventBuffer(ConfiguredAxisEventCoalescing()),
           eventFilter(),
           properties(),
+          publishedProperties(),
           stateRaw(),
           stateProcessed(),
+          publishedStateProcessed(),
+          stateHistory(),
+          propertiesChangeTimestamp(0),
           stateChangeEventHandle(NULL),
-          physicalControllerMonitor(),
-          physicalControllerMonitorStop(),
-          physicalControllerForceFeedbackBuffer()
+          core(VirtualControllerCore::GetForController(controllerId)),
+          coreAttachment({.controller = this}),
+          physicalControllerForceFeedbackBuffer(),
+          latencyTraceOrigin(0)
     {
-      const SState initialState = GetCurrentRawVirtualControllerState(kControllerIdentifier);
-
-      RefreshState(initialState);
+      RefreshState(core->GetStateRaw());
       ReapplyProperties();
 
-      physicalControllerMonitor = std::thread(
-          MonitorPhysicalControllerState,
-          this,
-          initialState,
-          physicalControllerMonitorStop.get_token());
+      // Attaching refreshes the state again, which picks up any change that occurred since the
+      // initial state was obtained.
+      core->Attach(coreAttachment);
 
       Message::OutputFormatted(
           Message::ESeverity::Info,
@@ -207,11 +264,9 @@ namespace Xidi
 
     VirtualController::~VirtualController(void)
     {
+      core->Detach(coreAttachment);
       ForceFeedbackUnregister();
 
-      physicalControllerMonitorStop.request_stop();
-      physicalControllerMonitor.join();
-
       Message::OutputFormatted(
           Message::ESeverity::Info,
           L"Destroyed virtual controller object with identifier %u.",
@@ -220,8 +275,12 @@ namespace Xidi
 
     void VirtualController::ApplyProperties(SState& controllerState) const
     {
-      const SCapabilities capabilities = GetCapabilities();
+      ApplyProperties(controllerState, GetCapabilities());
+    }
 
+    void VirtualController::ApplyProperties(
+        SState& controllerState, const SCapabilities& capabilities) const
+    {
       for (int i = 0; i < capabilities.numAxes; ++i)
       {
         const EAxis axis = capabilities.axisCapabilities[i].type;
@@ -255,29 +314,55 @@ namespace Xidi
 
     SState VirtualController::GetState(void)
     {
-      auto lock = Lock();
-      return stateProcessed;
+      TraceApplicationRead();
+
+      if (0 != kStateSamplingDelay)
+      {
+        // States from before the most recent properties change were processed using different
+        // properties than the application expects, so they are never presented.
+        const StateHistory::TTimestamp samplingTimestamp = std::max(
+            StateHistory::CurrentTimestamp() - kStateSamplingDelay,
+            propertiesChangeTimestamp.load(std::memory_order_acquire));
+
+        const std::optional<SState> maybeDelayedState =
+            stateHistory.GetStateAsOf(samplingTimestamp);
+        if (true == maybeDelayedState.has_value()) return maybeDelayedState.value();
+      }
+
+      return publishedStateProcessed.Load();
     }
 
     void VirtualController::PopEventBufferOldestEvents(uint32_t numEventsToPop)
     {
-      auto lock = Lock();
       eventBuffer.PopOldestEvents(numEventsToPop);
     }
 
     void VirtualController::ReapplyProperties(void)
     {
+      publishedProperties.Store(properties);
+
       stateProcessed = stateRaw;
       ApplyProperties(stateProcessed);
+      publishedStateProcessed.Store(stateProcessed);
+
+      const StateHistory::TTimestamp newPropertiesChangeTimestamp =
+          StateHistory::CurrentTimestamp();
+      propertiesChangeTimestamp.store(newPropertiesChangeTimestamp, std::memory_order_release);
+      stateHistory.Append(newPropertiesChangeTimestamp, stateProcessed);
     }
 
     bool VirtualController::RefreshState(SState newStateRaw)
+    {
+      return RefreshState(VirtualControllerCore::PrepareUpdate(kControllerIdentifier, newStateRaw));
+    }
+
+    bool VirtualController::RefreshState(const VirtualControllerCore::SUpdate& update)
     {
       auto lock = Lock();
-      stateRaw = newStateRaw;
+      stateRaw = update.stateRaw;
 
-      SState newStateProcessed = newStateRaw;
-      ApplyProperties(newStateProcessed);
+      SState newStateProcessed = update.stateRaw;
+      ApplyProperties(newStateProcessed, update.capabilities);
 
       // Based on the mapper and the applied properties, a change in raw virtual controller state
       // might not necessarily mean a change in processed virtual controller state. For example,
@@ -286,8 +371,15 @@ namespace Xidi
       // influence the virtual controller state.
       if (newStateProcessed == stateProcessed) return false;
 
-      SubmitStateChangeEvents(stateProcessed, newStateProcessed, eventFilter, eventBuffer);
+      SubmitStateChangeEvents(
+          stateProcessed, newStateProcessed, eventFilter, update.eventTimestamp, eventBuffer);
       stateProcessed = newStateProcessed;
+      publishedStateProcessed.Store(newStateProcessed);
+      stateHistory.Append(StateHistory::CurrentTimestamp(), newStateProcessed);
+
+      LatencyTrace::RecordStage(
+          LatencyTrace::EStage::VirtualControllerRefresh, update.latencyTraceOrigin);
+      latencyTraceOrigin.store(update.latencyTraceOrigin, std::memory_order_relaxed);
       return true;
     }
 
@@ -421,6 +513,7 @@ namespace Xidi
       {
         auto lock = Lock();
         properties.device.SetFfGain(newFfGain);
+        publishedProperties.Store(properties);
         return true;
       }
 
@@ -437,7 +530,21 @@ namespace Xidi
       const HANDLE eventHandleToSignal = stateChangeEventHandle;
 
       if ((NULL != eventHandleToSignal) && (INVALID_HANDLE_VALUE != eventHandleToSignal))
+      {
         SetEvent(eventHandleToSignal);
+        LatencyTrace::RecordStage(
+            LatencyTrace::EStage::StateChangeEventSignal,
+            latencyTraceOrigin.load(std::memory_order_relaxed));
+      }
+    }
+
+    void VirtualController::TraceApplicationRead(void)
+    {
+      if (false == LatencyTrace::IsEnabled()) return;
+
+      LatencyTrace::RecordStage(
+          LatencyTrace::EStage::ApplicationRead,
+          latencyTraceOrigin.exchange(0, std::memory_order_relaxed));
     }
   } // namespace Controller
 } // namespace Xidi
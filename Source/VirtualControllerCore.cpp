@@ -0,0 +1,157 @@
+/***************************************************************************************************
+ * Xidi
+ *   DirectInput interface for XInput controllers.
+ ***************************************************************************************************
+ * Authored by Samuel Grossman
+ * Copyright (c) 2016-2023
+ ***********************************************************************************************//**
+ * @file VirtualControllerCore.cpp
+ *   Implementation of the part of a virtual controller that is shared among all virtual controller
+ *   objects associated with the same physical controller.
+ **************************************************************************************************/
+
+#include "VirtualControllerCore.h"
+
+#include <memory>
+#include <mutex>
+
+#include "Clock.h"
+#include "ControllerTypes.h"
+#include "LatencyTrace.h"
+#include "Message.h"
+#include "PhysicalController.h"
+#include "StateChangeDispatcher.h"
+#include "VirtualController.h"
+
+namespace Xidi
+{
+  namespace Controller
+  {
+    /// Cores that currently exist, one per physical controller. Each is expired if no virtual
+    /// controller objects exist for the associated physical controller.
+    static std::weak_ptr<VirtualControllerCore> existingCore[kPhysicalControllerCount];
+
+    /// Serializes lookup and creation of cores.
+    static std::mutex existingCoreMutex;
+
+    VirtualControllerCore::VirtualControllerCore(TControllerIdentifier controllerIdentifier)
+        : kControllerIdentifier(controllerIdentifier),
+          coreMutex(),
+          stateRaw(),
+          attachmentListHead(nullptr),
+          attachmentCount(0)
+    {
+      // Registration also obtains the current raw state.
+      StateChangeDispatcher::Register(kControllerIdentifier, *this);
+
+      Message::OutputFormatted(
+          Message::ESeverity::Debug,
+          L"Created shared virtual controller core for identifier %u.",
+          (1 + kControllerIdentifier));
+    }
+
+    VirtualControllerCore::~VirtualControllerCore(void)
+    {
+      StateChangeDispatcher::Unregister(kControllerIdentifier, *this);
+
+      Message::OutputFormatted(
+          Message::ESeverity::Debug,
+          L"Destroyed shared virtual controller core for identifier %u.",
+          (1 + kControllerIdentifier));
+    }
+
+    std::shared_ptr<VirtualControllerCore> VirtualControllerCore::GetForController(
+        TControllerIdentifier controllerIdentifier)
+    {
+      // Invalid identifiers produce cores that are never shared and never receive updates.
+      if (controllerIdentifier >= kPhysicalControllerCount)
+        return std::shared_ptr<VirtualControllerCore>(
+            new VirtualControllerCore(controllerIdentifier));
+
+      std::unique_lock lock(existingCoreMutex);
+
+      std::shared_ptr<VirtualControllerCore> core = existingCore[controllerIdentifier].lock();
+      if (nullptr == core)
+      {
+        core = std::shared_ptr<VirtualControllerCore>(
+            new VirtualControllerCore(controllerIdentifier));
+        existingCore[controllerIdentifier] = core;
+      }
+
+      return core;
+    }
+
+    void VirtualControllerCore::Attach(SAttachment& attachment)
+    {
+      std::unique_lock lock(coreMutex);
+
+      if ((nullptr != attachment.previous) || (&attachment == attachmentListHead)) return;
+
+      attachment.previous = nullptr;
+      attachment.next = attachmentListHead;
+      if (nullptr != attachment.next) attachment.next->previous = &attachment;
+
+      attachmentListHead = &attachment;
+      attachmentCount += 1;
+
+      attachment.controller->RefreshState(PrepareUpdate(kControllerIdentifier, stateRaw));
+    }
+
+    void VirtualControllerCore::Detach(SAttachment& attachment)
+    {
+      std::unique_lock lock(coreMutex);
+
+      if ((nullptr == attachment.previous) && (&attachment != attachmentListHead)) return;
+
+      if (nullptr != attachment.previous)
+        attachment.previous->next = attachment.next;
+      else
+        attachmentListHead = attachment.next;
+
+      if (nullptr != attachment.next) attachment.next->previous = attachment.previous;
+
+      attachment.previous = nullptr;
+      attachment.next = nullptr;
+      attachmentCount -= 1;
+    }
+
+    unsigned int VirtualControllerCore::GetAttachedCount(void)
+    {
+      std::unique_lock lock(coreMutex);
+      return attachmentCount;
+    }
+
+    SState VirtualControllerCore::GetStateRaw(void)
+    {
+      std::unique_lock lock(coreMutex);
+      return stateRaw;
+    }
+
+    VirtualControllerCore::SUpdate VirtualControllerCore::PrepareUpdate(
+        TControllerIdentifier controllerIdentifier, const SState& stateRaw)
+    {
+      return {
+          .stateRaw = stateRaw,
+          .capabilities = GetControllerCapabilities(controllerIdentifier),
+          .eventTimestamp = Clock::Now(),
+          .latencyTraceOrigin = LatencyTrace::GetPublishedOrigin(controllerIdentifier)};
+    }
+
+    void VirtualControllerCore::Update(const SState& newStateRaw)
+    {
+      std::unique_lock lock(coreMutex);
+
+      stateRaw = newStateRaw;
+      if (nullptr == attachmentListHead) return;
+
+      const SUpdate update = PrepareUpdate(kControllerIdentifier, stateRaw);
+
+      for (SAttachment* attachment = attachmentListHead; nullptr != attachment;
+           attachment = attachment->next)
+      {
+        if (true == attachment->controller->RefreshState(update))
+          attachment->controller->SignalStateChangeEvent();
+      }
+    }
+  } // namespace Controller
+} // namespace Xidi
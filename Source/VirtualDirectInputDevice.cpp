@@ -24,6 +24,7 @@
 
 #include "ApiDirectInput.h"
 #include "ApiGUID.h"
+#include "Clock.h"
 #include "Configuration.h"
 #include "ControllerIdentification.h"
 #include "ControllerTypes.h"
@@ -31,6 +32,7 @@
 #include "ForceFeedbackDevice.h"
 #include "ForceFeedbackTypes.h"
 #include "Globals.h"
+#include "ImportApiWinMM.h"
 #include "Message.h"
 #include "PhysicalController.h"
 #include "Strings.h"
@@ -147,6 +149,26 @@ namespace Xidi
     }
   }
 
+  /// Converts the clock timestamp of a buffered event to the millisecond system time that
+  /// DirectInput applications expect, which has the same time base as `timeGetTime`, by
+  /// subtracting the age of the event from a reference system time. Events that are converted
+  /// using the same reference point therefore keep their precise relative spacing.
+  /// @param [in] eventTimestamp Clock timestamp of the event.
+  /// @param [in] referenceTimestamp Clock timestamp captured together with the reference system
+  /// time.
+  /// @param [in] referenceSystemTime Reference system time, in milliseconds.
+  /// @return DirectInput timestamp for the event.
+  static inline DWORD DirectInputEventTimestamp(
+      Clock::TTimestamp eventTimestamp,
+      Clock::TTimestamp referenceTimestamp,
+      DWORD referenceSystemTime)
+  {
+    // Events appended after the reference point was captured are treated as being brand new.
+    if (eventTimestamp >= referenceTimestamp) return referenceSystemTime;
+    return referenceSystemTime -
+        (DWORD)Clock::TicksToMilliseconds(referenceTimestamp - eventTimestamp);
+  }
+
   /// Returns a human-readable string that represents the specified force feedback effect GUID.
   /// @param [in] rguidEffect GUID to check.
   /// @return String representation of the GUID's semantics.
@@ -1706,50 +1728,62 @@ namespace Xidi
     if (false == controller->IsEventBufferEnabled())
       LOG_INVOCATION_AND_RETURN(DIERR_NOTBUFFERED, kMethodSeverityForError);
 
-    auto lock = controller->Lock();
-    const DWORD numEventsAffected = std::min(*pdwInOut, (DWORD)controller->GetEventBufferCount());
-    const bool eventBufferOverflowed = controller->IsEventBufferOverflowed();
     const bool shouldPopEvents = (0 == (dwFlags & DIGDD_PEEK));
+    bool eventElementTypeInvalid = false;
+
+    const Clock::TTimestamp referenceTimestamp = Clock::Now();
+    const DWORD referenceSystemTime = ImportApiWinMM::timeGetTime();
+
+    // Events are copied out of the event buffer without locking the controller, so the polling
+    // thread can keep appending events while this happens. The copy is retried if any events are
+    // discarded in the meantime, which simply overwrites the application buffer again.
+    const Controller::StateChangeEventBuffer::SReadResult readResult =
+        controller->ReadEventBufferEvents(
+            (uint32_t)*pdwInOut,
+            shouldPopEvents,
+            [this, rgdod, referenceTimestamp, referenceSystemTime, &eventElementTypeInvalid](
+                uint32_t index, const Controller::StateChangeEventBuffer::SEvent& event) -> void
+            {
+              if (nullptr == rgdod) return;
 
-    if (nullptr != rgdod)
-    {
-      for (DWORD i = 0; i < numEventsAffected; ++i)
-      {
-        const Controller::StateChangeEventBuffer::SEvent& event =
-            controller->GetEventBufferEvent(i);
-        ZeroMemory(&rgdod[i], sizeof(rgdod[i]));
-        rgdod[i].dwOfs = dataFormat->GetOffsetForElement(event.data.element)
-                             .value(); // A value should always be present.
-        rgdod[i].dwTimeStamp = event.timestamp;
-        rgdod[i].dwSequence = event.sequence;
-
-        switch (event.data.element.type)
-        {
-          case Controller::EElementType::Axis:
-            rgdod[i].dwData = (DWORD)DataFormat::DirectInputAxisValue(event.data.value.axis);
-            break;
+              ZeroMemory(&rgdod[index], sizeof(rgdod[index]));
+              rgdod[index].dwOfs = dataFormat->GetOffsetForElement(event.data.element)
+                                       .value(); // A value should always be present.
+              rgdod[index].dwTimeStamp = DirectInputEventTimestamp(
+                  event.timestamp, referenceTimestamp, referenceSystemTime);
+              rgdod[index].dwSequence = event.sequence;
 
-          case Controller::EElementType::Button:
-            rgdod[i].dwData = (DWORD)DataFormat::DirectInputButtonValue(event.data.value.button);
-            break;
-
-          case Controller::EElementType::Pov:
-            rgdod[i].dwData = (DWORD)DataFormat::DirectInputPovValue(event.data.value.povDirection);
-            break;
+              switch (event.data.element.type)
+              {
+                case Controller::EElementType::Axis:
+                  rgdod[index].dwData =
+                      (DWORD)DataFormat::DirectInputAxisValue(event.data.value.axis);
+                  break;
+
+                case Controller::EElementType::Button:
+                  rgdod[index].dwData =
+                      (DWORD)DataFormat::DirectInputButtonValue(event.data.value.button);
+                  break;
+
+                case Controller::EElementType::Pov:
+                  rgdod[index].dwData =
+                      (DWORD)DataFormat::DirectInputPovValue(event.data.value.povDirection);
+                  break;
+
+                default:
+                  eventElementTypeInvalid = true; // This should never happen.
+                  break;
+              }
+            });
 
-          default:
-            LOG_INVOCATION_AND_RETURN(
-                DIERR_GENERIC, kMethodSeverityForError); // This should never happen.
-            break;
-        }
-      }
-    }
+    if (true == eventElementTypeInvalid)
+      LOG_INVOCATION_AND_RETURN(DIERR_GENERIC, kMethodSeverityForError);
 
-    if (true == shouldPopEvents) controller->PopEventBufferOldestEvents(numEventsAffected);
+    if (readResult.numEvents > 0) controller->TraceApplicationRead();
 
-    *pdwInOut = numEventsAffected;
+    *pdwInOut = (DWORD)readResult.numEvents;
     LOG_INVOCATION_AND_RETURN(
-        ((true == eventBufferOverflowed) ? DI_BUFFEROVERFLOW : DI_OK), kMethodSeverity);
+        ((true == readResult.overflowed) ? DI_BUFFEROVERFLOW : DI_OK), kMethodSeverity);
   }
 
   template <ECharMode charMode> HRESULT VirtualDirectInputDevice<charMode>::GetDeviceInfo(
@@ -1788,8 +1822,6 @@ namespace Xidi
 
     bool writeDataPacketResult = false;
     {
-      auto lock = controller->Lock();
-
       Xidi::Controller::SState state = controller->GetState();
 
       cJSON* jsonArray = cJSON_Parse(jsonBuffer);
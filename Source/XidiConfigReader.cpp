@@ -73,12 +73,34 @@ namespace Xidi
                   Strings::kStrConfigurationSettingLogEnabled, EValueType::Boolean),
               ConfigurationFileLayoutNameAndValueType(
                   Strings::kStrConfigurationSettingLogLevel, EValueType::Integer),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingLogLatencyTrace, EValueType::Boolean),
           }),
       ConfigurationFileLayoutSection(
           Strings::kStrConfigurationSectionMapper,
           {
               ConfigurationFileLayoutNameAndValueType(
                   Strings::kStrConfigurationSettingMapperType, EValueType::String),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingMapperHotReload, EValueType::Boolean),
+          }),
+      ConfigurationFileLayoutSection(
+          Strings::kStrConfigurationSectionPhysicalController,
+          {
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingPhysicalControllerDisconnectedBackoffMaxMilliseconds,
+                  EValueType::Integer),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingPhysicalControllerDeviceArrivalNotification,
+                  EValueType::Boolean),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingPhysicalControllerSource, EValueType::String),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingPhysicalControllerSyntheticSweepPeriodMilliseconds,
+                  EValueType::Integer),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingPhysicalControllerSyntheticButtonMashRate,
+                  EValueType::Integer),
           }),
       ConfigurationFileLayoutSection(
           Strings::kStrConfigurationSectionProperties,
@@ -113,6 +135,43 @@ namespace Xidi
               ConfigurationFileLayoutNameAndValueType(
                   Strings::kStrConfigurationSettingsPropertiesSaturationPercentTriggerRT,
                   EValueType::Integer),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingsPropertiesRadialStickLeft,
+                  EValueType::Boolean),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingsPropertiesRadialStickRight,
+                  EValueType::Boolean),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickLeft,
+                  EValueType::Integer),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickRight,
+                  EValueType::Integer),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingsPropertiesCircleToSquareStickLeft,
+                  EValueType::Boolean),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingsPropertiesCircleToSquareStickRight,
+                  EValueType::Boolean),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingPropertiesStateSamplingDelayMilliseconds,
+                  EValueType::Integer),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingPropertiesCoalesceAxisEvents,
+                  EValueType::Boolean),
+          }),
+      ConfigurationFileLayoutSection(
+          Strings::kStrConfigurationSectionRecording,
+          {
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingRecordingRecordFile, EValueType::String),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingRecordingReplayFile, EValueType::String),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingRecordingReplaySpeedPercent,
+                  EValueType::Integer),
+              ConfigurationFileLayoutNameAndValueType(
+                  Strings::kStrConfigurationSettingRecordingReplayStepped, EValueType::Boolean),
           }),
       ConfigurationFileLayoutSection(
           Strings::kStrConfigurationSectionWorkarounds,
@@ -262,9 +321,64 @@ namespace Xidi
         else
           return EAction::Process;
       }
+      else if (name.starts_with(XIDI_CONFIG_PROPERTIES_PREFIX_ANTI_DEADZONE_PERCENT))
+      {
+        // Anti-deadzone percentages must be in the range of 0 to 50 inclusive.
+        // Larger values would leave too little of the analog range for fine control.
+
+        if ((value < 0) || (value > 50))
+          return EAction::Error;
+        else
+          return EAction::Process;
+      }
+      else if (Strings::kStrConfigurationSettingPropertiesStateSamplingDelayMilliseconds == name)
+      {
+        // State sampling delay must be in the range of 0 to 100 inclusive.
+        // Larger delays would make input feel sluggish and would usually reach further back than
+        // the state history can.
+
+        if ((value < 0) || (value > 100))
+          return EAction::Error;
+        else
+          return EAction::Process;
+      }
     }
 #endif
 
+    if ((Strings::kStrConfigurationSectionPhysicalController == section) &&
+        (Strings::kStrConfigurationSettingPhysicalControllerDisconnectedBackoffMaxMilliseconds ==
+         name))
+    {
+      // Maximum backoff period must be in the range of 100 to 60000 inclusive.
+      // The lower bound is the initial backoff period, and the upper bound ensures a controller
+      // that is connected is eventually detected even without device arrival notifications.
+      if ((value < 100) || (value > 60000))
+        return EAction::Error;
+      else
+        return EAction::Process;
+    }
+
+    if ((Strings::kStrConfigurationSectionPhysicalController == section) &&
+        (Strings::kStrConfigurationSettingPhysicalControllerSyntheticSweepPeriodMilliseconds ==
+         name))
+    {
+      // Sweep period must be positive, otherwise synthetic analog values would never move.
+      if (value <= 0)
+        return EAction::Error;
+      else
+        return EAction::Process;
+    }
+
+    if ((Strings::kStrConfigurationSectionRecording == section) &&
+        (Strings::kStrConfigurationSettingRecordingReplaySpeedPercent == name))
+    {
+      // Replay speed must be positive, otherwise replay would never make progress.
+      if (value <= 0)
+        return EAction::Error;
+      else
+        return EAction::Process;
+    }
+
     if (value >= 0) return EAction::Process;
 
     return EAction::Error;
@@ -364,6 +478,17 @@ namespace Xidi
     }
 #endif
 
+    if ((Strings::kStrConfigurationSectionPhysicalController == section) &&
+        (Strings::kStrConfigurationSettingPhysicalControllerSource == name))
+    {
+      // Physical controller source must be one of the known source types.
+      if ((Strings::kStrConfigurationValuePhysicalControllerSourceXInput != value) &&
+          (Strings::kStrConfigurationValuePhysicalControllerSourceSynthetic != value))
+        return EAction::Error;
+      else
+        return EAction::Process;
+    }
+
     return EAction::Process;
   }
 
@@ -383,6 +508,46 @@ namespace Xidi
             configurationFileLayout[Strings::kStrConfigurationSectionMapper]
                                    [Strings::MapperTypeConfigurationNameString(i)] =
                                        EValueType::String;
+
+          // Same for the per-controller raw analog transformation properties, each of which can
+          // override the corresponding controller-independent setting.
+          constexpr std::wstring_view kPerControllerPropertiesSettings[] = {
+              Strings::kStrConfigurationSettingsPropertiesDeadzonePercentStickLeft,
+              Strings::kStrConfigurationSettingsPropertiesDeadzonePercentStickRight,
+              Strings::kStrConfigurationSettingsPropertiesDeadzonePercentTriggerLT,
+              Strings::kStrConfigurationSettingsPropertiesDeadzonePercentTriggerRT,
+              Strings::kStrConfigurationSettingsPropertiesSaturationPercentStickLeft,
+              Strings::kStrConfigurationSettingsPropertiesSaturationPercentStickRight,
+              Strings::kStrConfigurationSettingsPropertiesSaturationPercentTriggerLT,
+              Strings::kStrConfigurationSettingsPropertiesSaturationPercentTriggerRT,
+              Strings::kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickLeft,
+              Strings::kStrConfigurationSettingsPropertiesAntiDeadzonePercentStickRight};
+
+          for (const auto& setting : kPerControllerPropertiesSettings)
+          {
+            for (Controller::TControllerIdentifier i = 0;
+                 i < Controller::kPhysicalControllerCount;
+                 ++i)
+              configurationFileLayout[Strings::kStrConfigurationSectionProperties]
+                                     [Strings::PerControllerConfigurationNameString(setting, i)] =
+                                         EValueType::Integer;
+          }
+
+          constexpr std::wstring_view kPerControllerPropertiesFlags[] = {
+              Strings::kStrConfigurationSettingsPropertiesRadialStickLeft,
+              Strings::kStrConfigurationSettingsPropertiesRadialStickRight,
+              Strings::kStrConfigurationSettingsPropertiesCircleToSquareStickLeft,
+              Strings::kStrConfigurationSettingsPropertiesCircleToSquareStickRight};
+
+          for (const auto& setting : kPerControllerPropertiesFlags)
+          {
+            for (Controller::TControllerIdentifier i = 0;
+                 i < Controller::kPhysicalControllerCount;
+                 ++i)
+              configurationFileLayout[Strings::kStrConfigurationSectionProperties]
+                                     [Strings::PerControllerConfigurationNameString(setting, i)] =
+                                         EValueType::Boolean;
+          }
         });
   }
 